@@ -0,0 +1,334 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "convolution.h"
+#include "fft_real.h"
+
+#define DIRECT_CHUNK 4096           // sorties calculées d'un coup par la méthode directe
+#define MIN_BLOCK_FFT 64
+#define MAX_BLOCK_FFT (1 << 20)
+#define SINGLE_FFT_MAX (1 << 24)    // au-delà, une seule FFT demanderait trop de mémoire
+#define FFT_COST_FACTOR 2.0         // une opération de FFT coûte plus qu'une multiplication-addition vectorisée
+
+struct Convolver {
+    ConvolutionMethod method;
+    int M;
+    double* taps;               // filtre dans l'ordre de la convolution (retourné pour la corrélation)
+    int fftSize, step;          // Nf et L = Nf - M + 1 sorties par bloc
+    RealFFTPlan* plan;
+    ComplexNumber* response;    // Nf/2+1 coefficients du filtre, divisés par Nf
+    ComplexNumber* spectrum;
+    double* block;              // overlap-save : [M - 1 précédents | L nouveaux] ; overlap-add :
+                                //   [L nouveaux | M - 1 zéros] ; directe : [M - 1 précédents | DIRECT_CHUNK]
+    double* result;
+    double* tail;               // overlap-add : fin du bloc précédent, à ajouter au suivant
+    int filled;                 // nouveaux échantillons dans block
+    long long inputs, emitted;
+    int flushing;
+};
+
+// Coût par échantillon de sortie d'un bloc de taille Nf : FFT réelle directe et inverse,
+// produit par la réponse, pour L = Nf - M + 1 sorties
+static double blockCost(int Nf, int M) {
+    double fft = FFT_COST_FACTOR * 2.5 * Nf * log2((double)Nf);
+    return (2 * fft + 3.0 * Nf) / (Nf - M + 1);
+}
+
+static int bestBlockSize(int M) {
+    int best = 0;
+    double bestCost = 0;
+    for (int Nf = MIN_BLOCK_FFT; Nf <= MAX_BLOCK_FFT; Nf *= 2) {
+        if (Nf < 2 * M) continue;
+        double cost = blockCost(Nf, M);
+        if (best == 0 || cost < bestCost) {
+            best = Nf;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+// Plus petite longueur paire 2^a 3^b 5^c >= n : rapide pour le moteur à base mixte
+static int nextFastSize(long long n) {
+    long long best = -1;
+    for (long long p2 = 2; p2 < 2 * n + 2; p2 *= 2) {
+        for (long long p3 = p2; p3 < 2 * n + 2; p3 *= 3) {
+            for (long long p5 = p3; p5 < 2 * n + 2; p5 *= 5) {
+                if (p5 >= n && (best < 0 || p5 < best)) best = p5;
+            }
+        }
+    }
+    return best > SINGLE_FFT_MAX || best < 0 ? -1 : (int)best;
+}
+
+ConvolutionMethod chooseConvolutionMethod(long long N, int M) {
+    double direct = 2.0 * M;
+    int Nf = bestBlockSize(M);
+    double block = Nf > 0 ? blockCost(Nf, M) : INFINITY;
+    double single = INFINITY;
+    if (N > 0) {
+        double outputs = (double)N + M - 1;
+        int Ns = nextFastSize((long long)outputs);
+        // FFT du signal, du filtre et inverse, toutes de longueur Ns
+        if (Ns > 0) single = (3 * FFT_COST_FACTOR * 2.5 * Ns * log2((double)Ns) + 3.0 * Ns) / outputs;
+        if (Nf > 0) block += FFT_COST_FACTOR * 2.5 * Nf * log2((double)Nf) / outputs;
+    }
+    if (direct <= block && direct <= single) return CONV_DIRECT;
+    return single < block ? CONV_SINGLE_FFT : CONV_OVERLAP_SAVE;
+}
+
+const char* convolutionMethodName(ConvolutionMethod method) {
+    switch (method) {
+    case CONV_DIRECT:       return "directe";
+    case CONV_SINGLE_FFT:   return "FFT unique";
+    case CONV_OVERLAP_SAVE: return "overlap-save";
+    case CONV_OVERLAP_ADD:  return "overlap-add";
+    default:                return "auto";
+    }
+}
+
+static void reverseIfCorrelation(const double* filter, int M, ConvolutionMode mode, double* taps) {
+    for (int m = 0; m < M; m++) taps[m] = mode == CONV_CORRELATION ? filter[M - 1 - m] : filter[m];
+}
+
+Convolver* createConvolver(const double* filter, int filterLength, ConvolutionMode mode,
+                           ConvolutionMethod method, int fftSize) {
+    int M = filterLength;
+    if (M < 1 || method == CONV_SINGLE_FFT) return NULL;
+    if (method == CONV_AUTO) method = chooseConvolutionMethod(0, M);
+    Convolver* conv = (Convolver*)calloc(1, sizeof(Convolver));
+    if (conv == NULL) return NULL;
+    conv->method = method;
+    conv->M = M;
+    conv->taps = (double*)malloc(M * sizeof(double));
+    if (conv->taps == NULL) {
+        destroyConvolver(conv);
+        return NULL;
+    }
+    reverseIfCorrelation(filter, M, mode, conv->taps);
+
+    if (method == CONV_DIRECT) {
+        conv->step = DIRECT_CHUNK;
+        conv->block = (double*)calloc(M - 1 + DIRECT_CHUNK, sizeof(double));
+        conv->result = (double*)malloc(DIRECT_CHUNK * sizeof(double));
+        if (conv->block == NULL || conv->result == NULL) {
+            destroyConvolver(conv);
+            return NULL;
+        }
+        return conv;
+    }
+
+    int Nf = fftSize > 0 ? fftSize : bestBlockSize(M);
+    if (Nf < M + 1 || Nf % 2 != 0) {
+        destroyConvolver(conv);
+        return NULL;
+    }
+    conv->fftSize = Nf;
+    conv->step = Nf - M + 1;
+    int bins = Nf / 2 + 1;
+    conv->plan = createRealFFTPlan(Nf);
+    conv->response = (ComplexNumber*)malloc(bins * sizeof(ComplexNumber));
+    conv->spectrum = (ComplexNumber*)malloc(bins * sizeof(ComplexNumber));
+    conv->block = (double*)calloc(Nf, sizeof(double));
+    conv->result = (double*)malloc(Nf * sizeof(double));
+    conv->tail = (double*)calloc(M, sizeof(double));
+    if (conv->plan == NULL || conv->response == NULL || conv->spectrum == NULL || conv->block == NULL ||
+        conv->result == NULL || conv->tail == NULL) {
+        destroyConvolver(conv);
+        return NULL;
+    }
+    // Réponse en fréquence calculée une fois ; 1/Nf y est inclus pour l'inverse non normalisée
+    memcpy(conv->block, conv->taps, M * sizeof(double));
+    executeRealFFT(conv->plan, conv->block, conv->response);
+    for (int k = 0; k < bins; k++) {
+        conv->response[k].real /= Nf;
+        conv->response[k].imag /= Nf;
+    }
+    memset(conv->block, 0, Nf * sizeof(double));
+    return conv;
+}
+
+void destroyConvolver(Convolver* conv) {
+    if (conv == NULL) return;
+    free(conv->taps);
+    destroyRealFFTPlan(conv->plan);
+    free(conv->response);
+    free(conv->spectrum);
+    free(conv->block);
+    free(conv->result);
+    free(conv->tail);
+    free(conv);
+}
+
+ConvolutionMethod convolverMethod(const Convolver* conv) {
+    return conv->method;
+}
+
+int convolverFFTSize(const Convolver* conv) {
+    return conv->fftSize;
+}
+
+// Pendant convolverFlush, seules les N + M - 1 sorties de la convolution complète sont émises
+static void emitOutputs(Convolver* conv, const double* samples, int count, OutputCallback emit, void* context) {
+    if (conv->flushing) {
+        long long left = conv->inputs + conv->M - 1 - conv->emitted;
+        if (count > left) count = (int)left;
+    }
+    if (count <= 0) return;
+    conv->emitted += count;
+    emit(context, samples, count);
+}
+
+static void processDirect(Convolver* conv, OutputCallback emit, void* context) {
+    int M = conv->M, n = conv->filled;
+    const double* taps = conv->taps;
+    for (int i = 0; i < n; i++) {
+        const double* x = conv->block + M - 1 + i;     // x[0] : échantillon courant
+        double sum = 0;
+        for (int m = 0; m < M; m++) sum += taps[m] * x[-m];
+        conv->result[i] = sum;
+    }
+    memmove(conv->block, conv->block + n, (M - 1) * sizeof(double));
+    conv->filled = 0;
+    emitOutputs(conv, conv->result, n, emit, context);
+}
+
+static void processBlock(Convolver* conv, OutputCallback emit, void* context) {
+    int Nf = conv->fftSize, M = conv->M, L = conv->step, bins = Nf / 2 + 1;
+    executeRealFFT(conv->plan, conv->block, conv->spectrum);
+    for (int k = 0; k < bins; k++) {
+        double xr = conv->spectrum[k].real, xi = conv->spectrum[k].imag;
+        double hr = conv->response[k].real, hi = conv->response[k].imag;
+        conv->spectrum[k].real = xr * hr - xi * hi;
+        conv->spectrum[k].imag = xr * hi + xi * hr;
+    }
+    executeInverseRealFFT(conv->plan, conv->spectrum, conv->result);
+    conv->filled = 0;
+    if (conv->method == CONV_OVERLAP_SAVE) {
+        // Les M - 1 premières sorties sont repliées par la convolution circulaire : rejetées
+        memmove(conv->block, conv->block + L, (M - 1) * sizeof(double));
+        emitOutputs(conv, conv->result + M - 1, L, emit, context);
+    } else {
+        for (int i = 0; i < M - 1; i++) conv->result[i] += conv->tail[i];
+        memcpy(conv->tail, conv->result + L, (M - 1) * sizeof(double));
+        emitOutputs(conv, conv->result, L, emit, context);
+    }
+}
+
+// samples == NULL : zéros (fin du signal)
+static void feed(Convolver* conv, const double* samples, int count, OutputCallback emit, void* context) {
+    int offset = conv->method == CONV_OVERLAP_ADD ? 0 : conv->M - 1;
+    while (count > 0) {
+        int n = conv->step - conv->filled;
+        if (n > count) n = count;
+        double* dst = conv->block + offset + conv->filled;
+        if (samples != NULL) {
+            memcpy(dst, samples, n * sizeof(double));
+            samples += n;
+        } else {
+            memset(dst, 0, n * sizeof(double));
+        }
+        conv->filled += n;
+        count -= n;
+        if (conv->filled == conv->step) {
+            if (conv->method == CONV_DIRECT) processDirect(conv, emit, context);
+            else processBlock(conv, emit, context);
+        }
+    }
+    // La méthode directe n'a pas besoin de blocs complets : pas de latence
+    if (conv->method == CONV_DIRECT && conv->filled > 0) processDirect(conv, emit, context);
+}
+
+void convolverPush(Convolver* conv, const double* samples, int count, OutputCallback emit, void* context) {
+    conv->inputs += count;
+    feed(conv, samples, count, emit, context);
+}
+
+void convolverFlush(Convolver* conv, OutputCallback emit, void* context) {
+    conv->flushing = 1;
+    while (conv->emitted < conv->inputs + conv->M - 1) {
+        int zeros = conv->method == CONV_DIRECT ? conv->M - 1 : conv->step - conv->filled;
+        feed(conv, NULL, zeros, emit, context);
+    }
+    conv->flushing = 0;
+    conv->inputs = conv->emitted = 0;
+    conv->filled = 0;
+    int history = conv->method == CONV_DIRECT ? conv->M - 1 + DIRECT_CHUNK : conv->fftSize;
+    memset(conv->block, 0, history * sizeof(double));
+    if (conv->tail != NULL) memset(conv->tail, 0, conv->M * sizeof(double));
+}
+
+typedef struct {
+    double* output;
+    long long position;
+} OutputArray;
+
+static void appendOutputs(void* context, const double* samples, int count) {
+    OutputArray* out = (OutputArray*)context;
+    memcpy(out->output + out->position, samples, count * sizeof(double));
+    out->position += count;
+}
+
+static int convolveSingleFFT(const double* input, int N, const double* taps, int M, double* output) {
+    int Ns = nextFastSize((long long)N + M - 1);
+    if (Ns < 0) return 0;
+    int bins = Ns / 2 + 1;
+    RealFFTPlan* plan = createRealFFTPlan(Ns);
+    double* padded = (double*)calloc(Ns, sizeof(double));
+    ComplexNumber* X = (ComplexNumber*)malloc(bins * sizeof(ComplexNumber));
+    ComplexNumber* H = (ComplexNumber*)malloc(bins * sizeof(ComplexNumber));
+    int ok = plan != NULL && padded != NULL && X != NULL && H != NULL;
+    if (ok) {
+        memcpy(padded, taps, M * sizeof(double));
+        executeRealFFT(plan, padded, H);
+        memset(padded, 0, M * sizeof(double));
+        memcpy(padded, input, N * sizeof(double));
+        executeRealFFT(plan, padded, X);
+        for (int k = 0; k < bins; k++) {
+            double xr = X[k].real, xi = X[k].imag;
+            X[k].real = (xr * H[k].real - xi * H[k].imag) / Ns;
+            X[k].imag = (xr * H[k].imag + xi * H[k].real) / Ns;
+        }
+        executeInverseRealFFT(plan, X, padded);
+        memcpy(output, padded, ((size_t)N + M - 1) * sizeof(double));
+    }
+    destroyRealFFTPlan(plan);
+    free(padded);
+    free(X);
+    free(H);
+    return ok;
+}
+
+int convolve(const double* input, int N, const double* filter, int M, ConvolutionMode mode,
+             ConvolutionMethod method, double* output) {
+    if (N < 1 || M < 1) return -1;
+    if (method == CONV_AUTO) method = chooseConvolutionMethod(N, M);
+
+    if (method == CONV_DIRECT || method == CONV_SINGLE_FFT) {
+        double* taps = (double*)malloc(M * sizeof(double));
+        if (taps == NULL) return -1;
+        reverseIfCorrelation(filter, M, mode, taps);
+        int ok = 1;
+        if (method == CONV_SINGLE_FFT) {
+            ok = convolveSingleFFT(input, N, taps, M, output);
+        } else {
+            for (long long n = 0; n < (long long)N + M - 1; n++) {
+                int first = n - (N - 1) > 0 ? (int)(n - (N - 1)) : 0;
+                int last = n < M - 1 ? (int)n : M - 1;
+                double sum = 0;
+                for (int m = first; m <= last; m++) sum += taps[m] * input[n - m];
+                output[n] = sum;
+            }
+        }
+        free(taps);
+        return ok ? (int)method : -1;
+    }
+
+    Convolver* conv = createConvolver(filter, M, mode, method, 0);
+    if (conv == NULL) return -1;
+    OutputArray out = {output, 0};
+    convolverPush(conv, input, N, appendOutputs, &out);
+    convolverFlush(conv, appendOutputs, &out);
+    destroyConvolver(conv);
+    return (int)method;
+}
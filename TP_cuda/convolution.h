@@ -0,0 +1,56 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+// Convolution et corrélation rapides de signaux réels par un filtre de M coefficients.
+//   convolution : y[n] = somme_m h[m] x[n - m], N + M - 1 sorties (convolution linéaire complète)
+//   corrélation : c[k] = somme_m h[m] x[k + m] ; la sortie d'indice n est le décalage
+//                 k = n - (M - 1), de -(M - 1) à N - 1 (convolution par le filtre retourné)
+// Trois méthodes :
+//  - directe, O(N M), la plus rapide pour les filtres courts ;
+//  - une seule FFT réelle de longueur >= N + M - 1, pour un signal court connu d'avance ;
+//  - par blocs (overlap-save ou overlap-add) : FFT de taille Nf fixe, L = Nf - M + 1 sorties
+//    par bloc. La réponse en fréquence du filtre est calculée une fois à la création du
+//    Convolver ; un signal de longueur quelconque passe ensuite en mémoire bornée (O(Nf)).
+// CONV_AUTO choisit selon un modèle de coût (opérations par échantillon de sortie).
+
+typedef enum {
+    CONV_AUTO,
+    CONV_DIRECT,
+    CONV_SINGLE_FFT,    // convolve uniquement : un flux n'a pas de longueur connue
+    CONV_OVERLAP_SAVE,
+    CONV_OVERLAP_ADD
+} ConvolutionMethod;
+
+typedef enum {
+    CONV_CONVOLUTION,
+    CONV_CORRELATION
+} ConvolutionMode;
+
+// Appelée pour chaque bloc de sorties ; samples n'est valide que pendant l'appel
+typedef void (*OutputCallback)(void* context, const double* samples, int count);
+
+typedef struct Convolver Convolver;
+
+// fftSize : taille des blocs FFT (0 : choisie d'après M, ignorée en méthode directe).
+// Renvoie NULL si la mémoire manque ou pour CONV_SINGLE_FFT.
+Convolver* createConvolver(const double* filter, int filterLength, ConvolutionMode mode,
+                           ConvolutionMethod method, int fftSize);
+// Ajoute count échantillons ; les sorties sont émises par blocs dès qu'ils sont complets
+void convolverPush(Convolver* conv, const double* samples, int count, OutputCallback emit, void* context);
+// Fin du signal : émet les sorties restantes (N + M - 1 au total) puis remet le Convolver à
+// zéro pour un nouveau signal, avec la même réponse en fréquence
+void convolverFlush(Convolver* conv, OutputCallback emit, void* context);
+ConvolutionMethod convolverMethod(const Convolver* conv);
+int convolverFFTSize(const Convolver* conv);
+void destroyConvolver(Convolver* conv);
+
+// Signal entier en mémoire : output reçoit N + M - 1 valeurs. Renvoie la méthode utilisée,
+// -1 en cas d'erreur.
+int convolve(const double* input, int N, const double* filter, int M, ConvolutionMode mode,
+             ConvolutionMethod method, double* output);
+
+// Méthode que CONV_AUTO retiendrait pour ces tailles (N <= 0 : flux de longueur inconnue)
+ConvolutionMethod chooseConvolutionMethod(long long N, int M);
+const char* convolutionMethodName(ConvolutionMethod method);
+
+#endif
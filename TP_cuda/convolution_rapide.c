@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "convolution.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define PI 3.14159265358979323846
+#define BENCH_N (1 << 20)
+#define DIRECT_MAX_WORK 1e10        // au-delà, la méthode directe n'est pas mesurée
+#define STREAM_BLOCK 65536          // échantillons lus par bloc en mode flux
+
+void fillRandom(double* x, int n, unsigned int seed) {
+    srand(seed);
+    for (int i = 0; i < n; i++) x[i] = rand() / (double)RAND_MAX - 0.5;
+}
+
+double relativeError(const double* ref, const double* x, long long n) {
+    double maxErr = 0, maxRef = 0;
+    for (long long i = 0; i < n; i++) {
+        maxErr = fmax(maxErr, fabs(ref[i] - x[i]));
+        maxRef = fmax(maxRef, fabs(ref[i]));
+    }
+    return maxRef > 0 ? maxErr / maxRef : maxErr;
+}
+
+typedef struct {
+    double* output;
+    long long position;
+} Collector;
+
+void collect(void* context, const double* samples, int count) {
+    Collector* c = (Collector*)context;
+    memcpy(c->output + c->position, samples, count * sizeof(double));
+    c->position += count;
+}
+
+// Chaque méthode contre la méthode directe, en un appel puis en flux par morceaux irréguliers
+int checkSizes(int N, int M, ConvolutionMode mode) {
+    long long outputs = (long long)N + M - 1;
+    double* x = (double*)malloc(N * sizeof(double));
+    double* h = (double*)malloc(M * sizeof(double));
+    double* ref = (double*)malloc(outputs * sizeof(double));
+    double* y = (double*)malloc(outputs * sizeof(double));
+    fillRandom(x, N, 1);
+    fillRandom(h, M, 2);
+    convolve(x, N, h, M, mode, CONV_DIRECT, ref);
+
+    int ok = 1;
+    printf("N = %6d, M = %5d, %-11s :", N, M, mode == CONV_CORRELATION ? "corrélation" : "convolution");
+    ConvolutionMethod methods[] = {CONV_SINGLE_FFT, CONV_OVERLAP_SAVE, CONV_OVERLAP_ADD};
+    for (int i = 0; i < 3; i++) {
+        convolve(x, N, h, M, mode, methods[i], y);
+        double err = relativeError(ref, y, outputs);
+        ok &= err < 1e-12;
+        printf(" %s %.1e", convolutionMethodName(methods[i]), err);
+    }
+    ConvolutionMethod streamed[] = {CONV_DIRECT, CONV_OVERLAP_SAVE, CONV_OVERLAP_ADD};
+    double worst = 0;
+    for (int i = 0; i < 3; i++) {
+        Convolver* conv = createConvolver(h, M, mode, streamed[i], 0);
+        // Deux signaux de suite : le Convolver est réutilisé après convolverFlush
+        for (int pass = 0; pass < 2; pass++) {
+            Collector c = {y, 0};
+            srand(3 + pass);
+            for (int done = 0; done < N;) {
+                int n = 1 + rand() % 3000;
+                if (n > N - done) n = N - done;
+                convolverPush(conv, x + done, n, collect, &c);
+                done += n;
+            }
+            convolverFlush(conv, collect, &c);
+            worst = fmax(worst, c.position == outputs ? relativeError(ref, y, outputs) : 1);
+        }
+        destroyConvolver(conv);
+    }
+    ok &= worst < 1e-12;
+    printf(" | flux %.1e %s\n", worst, ok ? "OK" : "ECHEC");
+    free(x);
+    free(h);
+    free(ref);
+    free(y);
+    return ok;
+}
+
+// Motif caché dans du bruit : le maximum de la corrélation doit tomber sur sa position
+int checkCorrelationPeak(void) {
+    int N = 200000, M = 512, position = 123457;
+    double* x = (double*)malloc(N * sizeof(double));
+    double* h = (double*)malloc(M * sizeof(double));
+    double* c = (double*)malloc((N + M - 1) * sizeof(double));
+    fillRandom(x, N, 4);
+    fillRandom(h, M, 5);
+    for (int m = 0; m < M; m++) x[position + m] += h[m];
+    int method = convolve(x, N, h, M, CONV_CORRELATION, CONV_AUTO, c);
+    int best = 0;
+    for (int n = 1; n < N + M - 1; n++) {
+        if (c[n] > c[best]) best = n;
+    }
+    int lag = best - (M - 1);
+    printf("Corrélation (%s) : motif trouvé au décalage %d (attendu %d) %s\n",
+           convolutionMethodName((ConvolutionMethod)method), lag, position, lag == position ? "OK" : "ECHEC");
+    free(x);
+    free(h);
+    free(c);
+    return lag == position;
+}
+
+// Opérations selon la méthode, avec le modèle de coût de convolution.c : 2 M par sortie en
+// directe ; sinon FFT réelles de 2.5 Nf log2 Nf et produit spectral de 3 Nf par bloc, le
+// signal entier formant un seul bloc de N + M - 1 points pour la FFT unique
+double methodFlops(long long outputs, int M, ConvolutionMethod method, int fftSize) {
+    if (method == CONV_DIRECT) return 2.0 * M * outputs;
+    double Nf = method == CONV_SINGLE_FFT ? (double)outputs : fftSize;
+    double fft = 2.5 * Nf * log2(Nf);
+    double blocks = method == CONV_SINGLE_FFT ? 1 : ceil(outputs / (Nf - M + 1));
+    return blocks * (2 * fft + 3.0 * Nf) + fft;
+}
+
+// Signal, filtre et sortie passent une fois par la mémoire
+double timeMethod(const double* x, int N, const double* h, int M, ConvolutionMethod method, double* y,
+                  perf_region* region) {
+    int fftSize = 0;
+    if (method == CONV_OVERLAP_SAVE || method == CONV_OVERLAP_ADD) {
+        Convolver* conv = createConvolver(h, M, CONV_CONVOLUTION, method, 0);
+        fftSize = convolverFFTSize(conv);
+        destroyConvolver(conv);
+    }
+    perf_region_begin(region, 0);
+    convolve(x, N, h, M, CONV_CONVOLUTION, method, y);
+    perf_region_end(region, 0);
+    perf_region_add_work(region, methodFlops((long long)N + M - 1, M, method, fftSize),
+                         (2.0 * N + 2.0 * M - 1) * sizeof(double));
+    return perf_region_seconds(region);
+}
+
+void benchmark(void) {
+    int N = BENCH_N;
+    int lengths[] = {4, 16, 64, 256, 1024, 4096, 16384, 65536};
+    int count = (int)(sizeof(lengths) / sizeof(lengths[0]));
+    double* x = (double*)malloc(N * sizeof(double));
+    double* h = (double*)malloc(lengths[count - 1] * sizeof(double));
+    double* y = (double*)malloc((N + lengths[count - 1]) * sizeof(double));
+    fillRandom(x, N, 6);
+    fillRandom(h, lengths[count - 1], 7);
+
+    printf("\nN = %d : temps (ms) par méthode\n", N);
+    printf("%6s | %10s | %10s | %12s | %11s | %s\n", "M", "directe", "FFT unique", "overlap-save", "overlap-add",
+           "choix automatique");
+    ConvolutionMethod methods[] = {CONV_DIRECT, CONV_SINGLE_FFT, CONV_OVERLAP_SAVE, CONV_OVERLAP_ADD};
+    // Rapport détaillé de chaque méthode pour le plus long filtre mesuré, après le tableau
+    perf_region* longest[4] = {NULL, NULL, NULL, NULL};
+    for (int i = 0; i < count; i++) {
+        int M = lengths[i];
+        printf("%6d", M);
+        for (int k = 0; k < 4; k++) {
+            int width = k == 2 ? 12 : k == 3 ? 11 : 10;
+            if (methods[k] == CONV_DIRECT && (double)N * M > DIRECT_MAX_WORK) {
+                printf(" | %*s", width, "-");
+                continue;
+            }
+            perf_region_free(longest[k]);
+            longest[k] = perf_region_create(convolutionMethodName(methods[k]), 1);
+            printf(" | %*.2f", width, timeMethod(x, N, h, M, methods[k], y, longest[k]) * 1e3);
+        }
+        printf(" | %s\n", convolutionMethodName(chooseConvolutionMethod(N, M)));
+    }
+    for (int k = 0; k < 4; k++) {
+        perf_region_report(longest[k], stdout);
+        perf_region_free(longest[k]);
+    }
+    free(x);
+    free(h);
+    free(y);
+}
+
+// Mode flux : filtre passe-bas (sinus cardinal fenêtré, fréquence de coupure relative 0.1)
+// appliqué aux échantillons float32 de l'entrée standard, écrits en float32 sur la sortie
+void writeFloats(void* context, const double* samples, int count) {
+    float* buffer = (float*)context;
+    for (int i = 0; i < count; i++) buffer[i] = (float)samples[i];
+    fwrite(buffer, sizeof(float), count, stdout);
+}
+
+int streamFilter(int M, int fftSize) {
+    double* h = (double*)malloc(M * sizeof(double));
+    for (int m = 0; m < M; m++) {
+        double t = m - (M - 1) / 2.0;
+        double sinc = t == 0 ? 0.2 : sin(0.2 * PI * t) / (PI * t);
+        double hann = M > 1 ? 0.5 - 0.5 * cos(2 * PI * m / (M - 1)) : 1;
+        h[m] = sinc * hann;
+    }
+    Convolver* conv = createConvolver(h, M, CONV_CONVOLUTION, CONV_AUTO, fftSize);
+    if (conv == NULL) {
+        fprintf(stderr, "Erreur : création du filtre impossible (M = %d, FFT = %d)\n", M, fftSize);
+        return 1;
+    }
+    float* raw = (float*)malloc(STREAM_BLOCK * sizeof(float));
+    double* block = (double*)malloc(STREAM_BLOCK * sizeof(double));
+    // Un bloc FFT émet au plus fftSize sorties, un bloc direct au plus 4096
+    int outMax = convolverFFTSize(conv) > 4096 ? convolverFFTSize(conv) : 4096;
+    float* out = (float*)malloc(outMax * sizeof(float));
+    long long samples = 0;
+    // Le temps inclut la lecture et l'écriture des échantillons
+    perf_region* region = perf_region_create("filtre en flux", 1);
+    perf_region_begin(region, 0);
+    size_t n;
+    while ((n = fread(raw, sizeof(float), STREAM_BLOCK, stdin)) > 0) {
+        for (size_t i = 0; i < n; i++) block[i] = raw[i];
+        convolverPush(conv, block, (int)n, writeFloats, out);
+        samples += n;
+    }
+    convolverFlush(conv, writeFloats, out);
+    fflush(stdout);
+    perf_region_end(region, 0);
+    double t = perf_region_seconds(region);
+    fprintf(stderr, "%lld échantillons filtrés (M = %d, %s, FFT de %d) en %.3f s, %.1f Méch/s\n", samples, M,
+            convolutionMethodName(convolverMethod(conv)), convolverFFTSize(conv), t, samples / t / 1e6);
+    // float32 lus et écrits
+    perf_region_add_work(region, methodFlops(samples + M - 1, M, convolverMethod(conv), convolverFFTSize(conv)),
+                         2.0 * samples * sizeof(float));
+    perf_region_report(region, stderr);
+    perf_region_free(region);
+    destroyConvolver(conv);
+    free(h);
+    free(raw);
+    free(block);
+    free(out);
+    return 0;
+}
+
+// Usage : ./convolution_rapide                  vérification et comparaison des méthodes
+//         ./convolution_rapide flux M [taille FFT] < entree.f32 > sortie.f32
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "flux") == 0) {
+        int M = argc > 2 ? atoi(argv[2]) : 255;
+        int fftSize = argc > 3 ? atoi(argv[3]) : 0;
+        if (M < 1) {
+            fprintf(stderr, "Usage : %s flux M [taille FFT] < entree.f32 > sortie.f32\n", argv[0]);
+            return 1;
+        }
+        return streamFilter(M, fftSize);
+    }
+
+    printf("Erreur relative de chaque méthode contre la convolution directe :\n");
+    int sizes[][2] = {{1000, 1}, {1000, 7}, {5000, 300}, {100, 2000}, {20000, 1500}, {50000, 4099}};
+    int allOk = 1;
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+        allOk &= checkSizes(sizes[i][0], sizes[i][1], CONV_CONVOLUTION);
+        allOk &= checkSizes(sizes[i][0], sizes[i][1], CONV_CORRELATION);
+    }
+    allOk &= checkCorrelationPeak();
+    benchmark();
+    return allOk ? 0 : 1;
+}
@@ -1,37 +1,48 @@
-%%cuda
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include <sys/time.h>
 #include <cuda_runtime.h>
 #include <cuComplex.h>
 
+// Backend GPU de dft_backend.h ; le programme principal est dft_main.c
+#ifndef DFT_WITH_CUDA
+#define DFT_WITH_CUDA
+#endif
+#include "dft_backend.h"
+#include "pipeline.h"
+
 #define PI 3.14159265358979323846
 #define BLOCK_SIZE 256
+#define PIPELINE_SLOTS 3  // morceaux en vol : préparation, transferts et calcul se recouvrent
 
-typedef struct {
-    double real;
-    double imag;
-} ComplexNumber;
+// Table des facteurs de rotation cos/sin(2π*m/N), m < N, gardée sur le GPU
+// tant que N ne change pas : les appels suivants de même taille ne recalculent rien.
+static double *d_twiddle_cos = NULL, *d_twiddle_sin = NULL;
+static int twiddleN = 0;
 
 // Kernel CUDA pour le calcul de la TFD
 __global__ void dftKernel(double* signal_real, double* signal_imag, 
+                         const double* twiddle_cos, const double* twiddle_sin,
                          cuDoubleComplex* result, int N) {
     int k = blockIdx.x * blockDim.x + threadIdx.x;
     
     if (k < N) {
         cuDoubleComplex sum = make_cuDoubleComplex(0.0, 0.0);
         
+        // index = (k*n) mod N, tenu à jour sans multiplication ni débordement
+        int index = 0;
         for (int n = 0; n < N; n++) {
-            double angle = 2 * PI * k * n / N;
-            double cos_angle = cos(angle);
-            double sin_angle = sin(angle);
+            double cos_angle = twiddle_cos[index];
+            double sin_angle = twiddle_sin[index];
             
-            // Multiplication complexe
+            // Multiplication complexe par e^(-j*angle)
             double real_part = signal_real[n] * cos_angle + signal_imag[n] * sin_angle;
             double imag_part = signal_imag[n] * cos_angle - signal_real[n] * sin_angle;
             
-            sum = cuCadd(sum, make_cuDoubleComplex(real_part, -imag_part));
+            sum = cuCadd(sum, make_cuDoubleComplex(real_part, imag_part));
+
+            index += k;
+            if (index >= N) index -= N;
         }
         
         result[k] = sum;
@@ -45,93 +56,190 @@ void checkCudaError(cudaError_t error, const char *message) {
     }
 }
 
-void computeDFT_CUDA(ComplexNumber* signal, int N, ComplexNumber* result) {
-    double *d_signal_real, *d_signal_imag;
-    cuDoubleComplex *d_result;
-    
-    double* signal_real = (double*)malloc(N * sizeof(double));
-    double* signal_imag = (double*)malloc(N * sizeof(double));
-    
-    for (int i = 0; i < N; i++) {
-        signal_real[i] = signal[i].real;
-        signal_imag[i] = signal[i].imag;
+// Sans pilote ni GPU, cudaGetDeviceCount retourne une erreur au lieu d'interrompre le
+// programme : le même exécutable peut alors se rabattre sur le backend CPU
+int cudaDeviceAvailable(void) {
+    int count = 0;
+    return cudaGetDeviceCount(&count) == cudaSuccess && count > 0;
+}
+
+void prepareTwiddles_CUDA(int N) {
+    if (twiddleN == N) return;
+
+    if (twiddleN != 0) {
+        cudaFree(d_twiddle_cos);
+        cudaFree(d_twiddle_sin);
     }
-    checkCudaError(cudaMalloc((void**)&d_signal_real, N * sizeof(double)), 
-                  "Allocation signal réel");
-    checkCudaError(cudaMalloc((void**)&d_signal_imag, N * sizeof(double)), 
-                  "Allocation signal imaginaire");
-    checkCudaError(cudaMalloc((void**)&d_result, N * sizeof(cuDoubleComplex)), 
-                  "Allocation résultat");
-    
-    checkCudaError(cudaMemcpy(d_signal_real, signal_real, N * sizeof(double), 
-                  cudaMemcpyHostToDevice), "Copie signal réel vers GPU");
-    checkCudaError(cudaMemcpy(d_signal_imag, signal_imag, N * sizeof(double), 
-                  cudaMemcpyHostToDevice), "Copie signal imaginaire vers GPU");
-    
-    int numBlocks = (N + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    dim3 gridDim(numBlocks);
-    dim3 blockDim(BLOCK_SIZE);
-    
-    dftKernel<<<gridDim, blockDim>>>(d_signal_real, d_signal_imag, d_result, N);
-    
+
+    double* twiddle_cos = (double*)malloc(N * sizeof(double));
+    double* twiddle_sin = (double*)malloc(N * sizeof(double));
+    for (int m = 0; m < N; m++) {
+        double angle = 2 * PI * m / N;
+        twiddle_cos[m] = cos(angle);
+        twiddle_sin[m] = sin(angle);
+    }
+
+    checkCudaError(cudaMalloc((void**)&d_twiddle_cos, N * sizeof(double)), 
+                  "Allocation table cos");
+    checkCudaError(cudaMalloc((void**)&d_twiddle_sin, N * sizeof(double)), 
+                  "Allocation table sin");
+    checkCudaError(cudaMemcpy(d_twiddle_cos, twiddle_cos, N * sizeof(double), 
+                  cudaMemcpyHostToDevice), "Copie table cos vers GPU");
+    checkCudaError(cudaMemcpy(d_twiddle_sin, twiddle_sin, N * sizeof(double), 
+                  cudaMemcpyHostToDevice), "Copie table sin vers GPU");
+    twiddleN = N;
+
+    free(twiddle_cos);
+    free(twiddle_sin);
+}
+
+// Exécuteur du pipeline sur des flux CUDA : un flux par emplacement, tampons de transit
+// hôte verrouillés en mémoire pour que cudaMemcpyAsync soit réellement asynchrone
+typedef struct {
+    PipelineExecutor base;
+    cudaStream_t streams[PIPELINE_SLOTS];
+    int N;
+} CudaExecutor;
+
+static void* streamAllocateHost(void* self, size_t bytes) {
+    void* ptr = NULL;
+    (void)self;
+    return cudaMallocHost(&ptr, bytes) == cudaSuccess ? ptr : NULL;
+}
+
+static void streamFreeHost(void* self, void* ptr) {
+    (void)self;
+    cudaFreeHost(ptr);
+}
+
+static void* streamAllocateDevice(void* self, size_t bytes) {
+    void* ptr = NULL;
+    (void)self;
+    return cudaMalloc(&ptr, bytes) == cudaSuccess ? ptr : NULL;
+}
+
+static void streamFreeDevice(void* self, void* ptr) {
+    (void)self;
+    cudaFree(ptr);
+}
+
+static void streamCopyToDevice(void* self, int lane, void* device, const void* host, size_t bytes) {
+    CudaExecutor* ex = (CudaExecutor*)self;
+    checkCudaError(cudaMemcpyAsync(device, host, bytes, cudaMemcpyHostToDevice, ex->streams[lane]),
+                   "Copie asynchrone vers GPU");
+}
+
+static void streamCopyToHost(void* self, int lane, void* host, const void* device, size_t bytes) {
+    CudaExecutor* ex = (CudaExecutor*)self;
+    checkCudaError(cudaMemcpyAsync(host, device, bytes, cudaMemcpyDeviceToHost, ex->streams[lane]),
+                   "Copie asynchrone vers CPU");
+}
+
+// Un morceau = un signal : parties réelles puis imaginaires, N cuDoubleComplex en sortie
+static void streamComputeDFT(void* self, int lane, int chunk, const void* deviceIn, void* deviceOut) {
+    CudaExecutor* ex = (CudaExecutor*)self;
+    double* signal = (double*)deviceIn;
+    int numBlocks = (ex->N + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    (void)chunk;
+    dftKernel<<<numBlocks, BLOCK_SIZE, 0, ex->streams[lane]>>>(signal, signal + ex->N, d_twiddle_cos, d_twiddle_sin,
+                                                               (cuDoubleComplex*)deviceOut, ex->N);
     checkCudaError(cudaGetLastError(), "Lancement du kernel");
-    checkCudaError(cudaDeviceSynchronize(), "Synchronisation du kernel");
-    
-    cuDoubleComplex* h_result = (cuDoubleComplex*)malloc(N * sizeof(cuDoubleComplex));
-    checkCudaError(cudaMemcpy(h_result, d_result, N * sizeof(cuDoubleComplex), 
-                  cudaMemcpyDeviceToHost), "Copie résultats vers CPU");
-    
-    for (int i = 0; i < N; i++) {
-        result[i].real = h_result[i].x;
-        result[i].imag = h_result[i].y;
+}
+
+static void streamWait(void* self, int lane) {
+    CudaExecutor* ex = (CudaExecutor*)self;
+    checkCudaError(cudaStreamSynchronize(ex->streams[lane]), "Synchronisation du flux");
+}
+
+// Pipeline conservé tant que N ne change pas : plus d'allocation ni de libération par appel
+static CudaExecutor* executor = NULL;
+static StagedPipeline* pipeline = NULL;
+
+static void releasePipeline(void) {
+    if (pipeline == NULL) return;
+    destroyStagedPipeline(pipeline);
+    for (int s = 0; s < PIPELINE_SLOTS; s++) cudaStreamDestroy(executor->streams[s]);
+    free(executor);
+    pipeline = NULL;
+    executor = NULL;
+}
+
+// Table des facteurs de rotation, flux et tampons de transit pour N
+void prepareDFT_CUDA(int N) {
+    prepareTwiddles_CUDA(N);
+    if (pipeline != NULL && executor->N == N) return;
+    releasePipeline();
+
+    executor = (CudaExecutor*)calloc(1, sizeof(CudaExecutor));
+    if (executor == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        exit(EXIT_FAILURE);
     }
-    
-    free(signal_real);
-    free(signal_imag);
-    free(h_result);
-    cudaFree(d_signal_real);
-    cudaFree(d_signal_imag);
-    cudaFree(d_result);
-}
-
-int main() {
-    int N = 10240;
-    ComplexNumber* signal = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
-    ComplexNumber* result = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
-    
-    if (signal == NULL || result == NULL) {
-        printf("Erreur d'allocation mémoire.\n");
-        return 1;
+    executor->N = N;
+    for (int s = 0; s < PIPELINE_SLOTS; s++) {
+        checkCudaError(cudaStreamCreate(&executor->streams[s]), "Création d'un flux");
     }
-    
-    printf("Création du signal complexe...\n");
-    for (int i = 0; i < N; i++) {
-        signal[i].real = sin(2 * PI * 50 * i / N);
-        signal[i].imag = cos(2 * PI * 120 * i / N);
+    PipelineExecutor* base = &executor->base;
+    base->self = executor;
+    base->allocateHost = streamAllocateHost;
+    base->freeHost = streamFreeHost;
+    base->allocateDevice = streamAllocateDevice;
+    base->freeDevice = streamFreeDevice;
+    base->copyToDevice = streamCopyToDevice;
+    base->compute = streamComputeDFT;
+    base->copyToHost = streamCopyToHost;
+    base->wait = streamWait;
+
+    pipeline = createStagedPipeline(base, PIPELINE_SLOTS, 2 * N * sizeof(double), N * sizeof(cuDoubleComplex));
+    if (pipeline == NULL) {
+        fprintf(stderr, "CUDA Error: allocation des tampons de transit\n");
+        exit(EXIT_FAILURE);
     }
-    
-    printf("Calcul de la DFT avec CUDA...\n");
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
-    
-    computeDFT_CUDA(signal, N, result);
-    
-    gettimeofday(&end, NULL);
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + 
-                       (end.tv_usec - start.tv_usec) / 1e6;
-    
-    printf("Temps d'exécution CUDA : %f secondes\n", time_spent);
-    printf("Résultats de la DFT (partiels) :\n");
-    for (int k = 0; k < 10; k++) {
-        double magnitude = sqrt(result[k].real * result[k].real + 
-                              result[k].imag * result[k].imag);
-        double phase = atan2(result[k].imag, result[k].real);
-        printf("k = %d : Magnitude = %.5f, Phase = %.5f radians\n", 
-               k, magnitude, phase);
+}
+
+typedef struct {
+    ComplexNumber* signals;
+    ComplexNumber* results;
+    int N;
+} BatchContext;
+
+static void packSignal(void* context, int chunk, void* hostIn) {
+    BatchContext* c = (BatchContext*)context;
+    const ComplexNumber* signal = c->signals + (size_t)chunk * c->N;
+    double* real = (double*)hostIn;
+    double* imag = real + c->N;
+    for (int i = 0; i < c->N; i++) {
+        real[i] = signal[i].real;
+        imag[i] = signal[i].imag;
     }
-    
-    free(signal);
-    free(result);
-    
-    return 0;
-}
\ No newline at end of file
+}
+
+static void unpackResult(void* context, int chunk, const void* hostOut) {
+    BatchContext* c = (BatchContext*)context;
+    const cuDoubleComplex* h_result = (const cuDoubleComplex*)hostOut;
+    ComplexNumber* result = c->results + (size_t)chunk * c->N;
+    for (int i = 0; i < c->N; i++) {
+        result[i].real = h_result[i].x;
+        result[i].imag = h_result[i].y;
+    }
+}
+
+void computeDFTBatch_CUDA(ComplexNumber* signals, int count, int N, ComplexNumber* results) {
+    prepareDFT_CUDA(N);
+    BatchContext context = {signals, results, N};
+    runStagedPipeline(pipeline, count, packSignal, unpackResult, &context);
+}
+
+void computeDFT_CUDA(ComplexNumber* signal, int N, ComplexNumber* result) {
+    computeDFTBatch_CUDA(signal, 1, N, result);
+}
+
+void releaseDFT_CUDA(void) {
+    releasePipeline();
+    if (twiddleN != 0) {
+        cudaFree(d_twiddle_cos);
+        cudaFree(d_twiddle_sin);
+        d_twiddle_cos = d_twiddle_sin = NULL;
+        twiddleN = 0;
+    }
+}
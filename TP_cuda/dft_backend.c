@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dft_backend.h"
+
+static const DFTBackend cpuBackend = {"cpu", prepareDFT_CPU, computeDFT_CPU, releaseDFT_CPU};
+
+#ifdef DFT_WITH_CUDA
+static const DFTBackend cudaBackend = {"cuda", prepareDFT_CUDA, computeDFT_CUDA, releaseDFT_CUDA};
+#endif
+
+const DFTBackend* selectDFTBackend(void) {
+    const char* requested = getenv("DFT_BACKEND");
+    if (requested == NULL || requested[0] == '\0') requested = "auto";
+
+    if (strcmp(requested, "cpu") == 0) return &cpuBackend;
+    if (strcmp(requested, "cuda") == 0) {
+#ifdef DFT_WITH_CUDA
+        if (cudaDeviceAvailable()) return &cudaBackend;
+        fprintf(stderr, "DFT_BACKEND=cuda : aucun GPU disponible.\n");
+#else
+        fprintf(stderr, "DFT_BACKEND=cuda : programme compilé sans CUDA.\n");
+#endif
+        return NULL;
+    }
+    if (strcmp(requested, "auto") != 0) {
+        fprintf(stderr, "DFT_BACKEND=%s inconnu (cuda, cpu ou auto).\n", requested);
+        return NULL;
+    }
+
+#ifdef DFT_WITH_CUDA
+    if (cudaDeviceAvailable()) return &cudaBackend;
+#endif
+    return &cpuBackend;
+}
@@ -0,0 +1,45 @@
+#ifndef DFT_BACKEND_H
+#define DFT_BACKEND_H
+
+// Choix à l'exécution de l'implémentation de computeDFT_CUDA(signal, N, result) :
+//  - "cuda" : kernel de cuda.cu, disponible si le programme est compilé avec nvcc et
+//    -DDFT_WITH_CUDA et qu'un GPU est présent ;
+//  - "cpu"  : FFT SIMD multithreadée (fft_parallel.c), compilable avec gcc seul.
+// La variable d'environnement DFT_BACKEND (cuda, cpu ou auto) force le choix ; par défaut
+// le GPU est utilisé s'il y en a un, le CPU sinon.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "fft.h"
+
+typedef struct {
+    const char* name;
+    void (*prepare)(int N);  // tables et plans pour N, hors du temps de calcul
+    void (*compute)(ComplexNumber* signal, int N, ComplexNumber* result);
+    void (*release)(void);
+} DFTBackend;
+
+// NULL si le backend demandé par DFT_BACKEND n'est pas disponible
+const DFTBackend* selectDFTBackend(void);
+
+void prepareDFT_CPU(int N);
+void computeDFT_CPU(ComplexNumber* signal, int N, ComplexNumber* result);
+void releaseDFT_CPU(void);
+
+#ifdef DFT_WITH_CUDA
+int cudaDeviceAvailable(void);
+void prepareTwiddles_CUDA(int N);
+void prepareDFT_CUDA(int N);
+void computeDFT_CUDA(ComplexNumber* signal, int N, ComplexNumber* result);
+// count signaux de N points à la suite, traités par le pipeline à flux multiples (pipeline.h)
+void computeDFTBatch_CUDA(ComplexNumber* signals, int count, int N, ComplexNumber* results);
+void releaseDFT_CUDA(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dft_backend.h"
+#include "fft_parallel.h"
+
+// Pool de threads et plan conservés d'un appel à l'autre tant que N ne change pas,
+// comme la table des facteurs de rotation du backend CUDA. Pour N = 10240 (dft_main), le
+// plan découpe la transformée en 80 x 128 sur le pool dès que cela bat le plan séquentiel
+// avec les coeurs disponibles ; le choix est fait une fois, dans prepareDFT_CPU.
+static ThreadPool* pool = NULL;
+static ParallelFFTPlan* plan = NULL;
+static int planN = 0;
+
+void prepareDFT_CPU(int N) {
+    if (planN == N) return;
+    if (pool == NULL) {
+        pool = createThreadPool(0);
+        if (pool == NULL) {
+            fprintf(stderr, "Erreur de création du pool de threads.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    destroyParallelFFTPlan(plan);
+    plan = createParallelFFTPlan(N, FFT_FORWARD, pool);
+    if (plan == NULL) {
+        fprintf(stderr, "Erreur de création du plan FFT.\n");
+        exit(EXIT_FAILURE);
+    }
+    planN = N;
+}
+
+void computeDFT_CPU(ComplexNumber* signal, int N, ComplexNumber* result) {
+    prepareDFT_CPU(N);
+    executeParallelFFT(plan, signal, result);
+}
+
+void releaseDFT_CPU(void) {
+    destroyParallelFFTPlan(plan);
+    destroyThreadPool(pool);
+    plan = NULL;
+    pool = NULL;
+    planN = 0;
+}
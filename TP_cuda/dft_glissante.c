@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sliding_dft.h"
+#include "fft_real.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define PI 3.14159265358979323846
+#define NUM_SAMPLES 20000000
+#define REPETITIONS_FFT 200
+
+// Signal réel de sequentiel.c plus un bruit pseudo-aléatoire reproductible
+double signalAt(long long i, int N) {
+    unsigned long long h = (unsigned long long)i * 6364136223846793005ULL + 1442695040888963407ULL;
+    double noise = (double)(h >> 11) / 9007199254740992.0 - 0.5;
+    return sin(2 * PI * 50 * i / N) + cos(2 * PI * 120 * i / N) + 0.1 * noise;
+}
+
+// Écart max entre les coefficients suivis et Goertzel sur la fenêtre finale
+double finalError(const SlidingDFT* sdft, const int* bins, int numBins, const double* window, int N) {
+    const ComplexNumber* values = slidingDFTBins(sdft);
+    double maxErr = 0, maxRef = 0;
+    for (int b = 0; b < numBins; b++) {
+        ComplexNumber ref = goertzel(window, N, bins[b]);
+        double err = hypot(ref.real - values[b].real, ref.imag - values[b].imag);
+        double mag = hypot(ref.real, ref.imag);
+        if (err > maxErr) maxErr = err;
+        if (mag > maxRef) maxRef = mag;
+    }
+    return maxRef > 0 ? maxErr / maxRef : maxErr;
+}
+
+// Temps moyen par échantillon (secondes) sur NUM_SAMPLES échantillons, génération comprise.
+// Par échantillon et par coefficient : différence et produit complexe (8 opérations) ; le
+// tampon de la fenêtre est lu et écrit une fois
+double runStream(SlidingDFT* sdft, int N, int numBins, perf_region* region) {
+    perf_region_begin(region, 0);
+    for (long long i = 0; i < NUM_SAMPLES; i++) {
+        slidingDFTUpdate(sdft, signalAt(i, N));
+    }
+    perf_region_end(region, 0);
+    perf_region_add_work(region, 8.0 * numBins * NUM_SAMPLES, 2.0 * sizeof(double) * NUM_SAMPLES);
+    return perf_region_seconds(region) / NUM_SAMPLES;
+}
+
+int main() {
+    int N = 10240;
+    int bins[] = {50, 120, 1000};
+    int numBins = (int)(sizeof(bins) / sizeof(bins[0]));
+
+    double* window = (double*)malloc(N * sizeof(double));
+    ComplexNumber* spectrum = (ComplexNumber*)malloc((N / 2 + 1) * sizeof(ComplexNumber));
+    if (window == NULL || spectrum == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+    for (int n = 0; n < N; n++) window[n] = signalAt(NUM_SAMPLES - N + n, N);
+
+    // Coût de référence : génération du signal seule
+    volatile double sink = 0;
+    double start = perf_now();
+    for (long long i = 0; i < NUM_SAMPLES; i++) sink += signalAt(i, N);
+    double timeSignal = (perf_now() - start) / NUM_SAMPLES;
+
+    printf("DFT glissante sur %d échantillons, fenêtre N = %d, %d coefficients suivis...\n",
+           NUM_SAMPLES, N, numBins);
+    SlidingDFT* synced = createSlidingDFT(N, bins, numBins, N);
+    SlidingDFT* drifting = createSlidingDFT(N, bins, numBins, 0);
+    if (synced == NULL || drifting == NULL) {
+        printf("Erreur de création de la DFT glissante.\n");
+        return 1;
+    }
+    perf_region* regions[4];
+    regions[0] = perf_region_create("DFT glissante resynchronisée", 1);
+    regions[1] = perf_region_create("DFT glissante sans resynchronisation", 1);
+    double timeSynced = runStream(synced, N, numBins, regions[0]) - timeSignal;
+    double timeDrifting = runStream(drifting, N, numBins, regions[1]) - timeSignal;
+    double errSynced = finalError(synced, bins, numBins, window, N);
+    double errDrifting = finalError(drifting, bins, numBins, window, N);
+
+    // Sans mise à jour incrémentale : une FFT réelle complète par nouvel échantillon
+    RealFFTPlan* plan = createRealFFTPlan(N);
+    regions[2] = perf_region_create("FFT réelle complète", 1);
+    perf_region_begin(regions[2], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeRealFFT(plan, window, spectrum);
+    }
+    perf_region_end(regions[2], 0);
+    perf_region_add_work(regions[2], REPETITIONS_FFT * 2.5 * N * log2(N), REPETITIONS_FFT * 2.0 * N * sizeof(double));
+    double timeFFT = perf_region_seconds(regions[2]) / REPETITIONS_FFT;
+
+    // Goertzel : une multiplication et deux additions par échantillon et par coefficient
+    regions[3] = perf_region_create("Goertzel", 1);
+    perf_region_begin(regions[3], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        for (int b = 0; b < numBins; b++) {
+            ComplexNumber X = goertzel(window, N, bins[b]);
+            sink += X.real;
+        }
+    }
+    perf_region_end(regions[3], 0);
+    perf_region_add_work(regions[3], REPETITIONS_FFT * 3.0 * numBins * N, REPETITIONS_FFT * (double)numBins * N * sizeof(double));
+    double timeGoertzel = perf_region_seconds(regions[3]) / REPETITIONS_FFT;
+
+    printf("Mise à jour glissante, resynchronisation tous les %d échantillons : %.1f ns/échantillon, erreur %.2e\n",
+           N, timeSynced * 1e9, errSynced);
+    printf("Mise à jour glissante sans resynchronisation : %.1f ns/échantillon, erreur %.2e\n",
+           timeDrifting * 1e9, errDrifting);
+    printf("Goertzel sur la fenêtre (%d coefficients) : %f ms/échantillon\n", numBins, timeGoertzel * 1e3);
+    printf("FFT réelle complète : %f ms/échantillon (x%.0f)\n", timeFFT * 1e3, timeFFT / timeSynced);
+    for (int r = 0; r < 4; r++) {
+        perf_region_report(regions[r], stdout);
+        perf_region_free(regions[r]);
+    }
+
+    const ComplexNumber* values = slidingDFTBins(synced);
+    for (int b = 0; b < numBins; b++) {
+        printf("k = %d : Magnitude = %.5f, Phase = %.5f radians\n", bins[b],
+               hypot(values[b].real, values[b].imag), atan2(values[b].imag, values[b].real));
+    }
+
+    destroySlidingDFT(synced);
+    destroySlidingDFT(drifting);
+    destroyRealFFTPlan(plan);
+    free(window);
+    free(spectrum);
+    return errSynced < 1e-9 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "dft_backend.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define PI 3.14159265358979323846
+#define CHECKED_BINS 64       // raies recalculées par la DFT directe
+#define TOLERANCE 1e-9        // erreur maximale relative à la norme de la transformée
+
+// Compare CHECKED_BINS raies régulièrement espacées (dont k = 0..9 affichées) à la somme
+// directe en O(N) par raie. L'erreur est rapportée à la norme de la transformée exacte,
+// sqrt(N * somme |x|^2) (Parseval), les raies vérifiées pouvant être presque nulles.
+double checkDFT(const ComplexNumber* signal, const ComplexNumber* result, int N) {
+    double maxErr = 0, energy = 0;
+    for (int n = 0; n < N; n++) {
+        energy += signal[n].real * signal[n].real + signal[n].imag * signal[n].imag;
+    }
+    for (int b = 0; b < CHECKED_BINS; b++) {
+        int k = b < 10 ? b : (int)((long long)b * N / CHECKED_BINS);
+        double sumReal = 0, sumImag = 0;
+        for (int n = 0; n < N; n++) {
+            // k*n réduit modulo N pour garder l'angle exact
+            double angle = -2 * PI * (double)((long long)k * n % N) / N;
+            double c = cos(angle), s = sin(angle);
+            sumReal += signal[n].real * c - signal[n].imag * s;
+            sumImag += signal[n].real * s + signal[n].imag * c;
+        }
+        double err = hypot(result[k].real - sumReal, result[k].imag - sumImag);
+        if (err > maxErr) maxErr = err;
+    }
+    double norm = sqrt(N * energy);
+    return norm > 0 ? maxErr / norm : maxErr;
+}
+
+int main() {
+    int N = 10240;
+    ComplexNumber* signal = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* result = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    
+    if (signal == NULL || result == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+
+    const DFTBackend* backend = selectDFTBackend();
+    if (backend == NULL) return 1;
+    printf("Backend : %s\n", backend->name);
+    
+    printf("Création du signal complexe...\n");
+    for (int i = 0; i < N; i++) {
+        signal[i].real = sin(2 * PI * 50 * i / N);
+        signal[i].imag = cos(2 * PI * 120 * i / N);
+    }
+    
+    printf("Calcul de la table des facteurs de rotation...\n");
+    double start = perf_now();
+    backend->prepare(N);
+    double table_time = perf_now() - start;
+    
+    printf("Calcul de la DFT (%s)...\n", backend->name);
+    // Les compteurs sont ceux du thread appelant : les threads de la FFT CPU et le GPU n'y
+    // figurent pas, le temps couvre tout le calcul
+    perf_region* region = perf_region_create(backend->name, 1);
+    perf_region_begin(region, 0);
+    
+    backend->compute(signal, N, result);
+    
+    perf_region_end(region, 0);
+    // Modèle FFT : 5 N log2 N opérations, signal lu et résultat écrit une fois
+    perf_region_add_work(region, 5.0 * N * log2(N), 2.0 * N * sizeof(ComplexNumber));
+    double time_spent = perf_region_seconds(region);
+    
+    printf("Temps de création de la table : %f secondes\n", table_time);
+    printf("Temps d'exécution %s : %f secondes\n", backend->name, time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
+    printf("Résultats de la DFT (partiels) :\n");
+    for (int k = 0; k < 10; k++) {
+        double magnitude = sqrt(result[k].real * result[k].real + 
+                              result[k].imag * result[k].imag);
+        double phase = atan2(result[k].imag, result[k].real);
+        printf("k = %d : Magnitude = %.5f, Phase = %.5f radians\n", 
+               k, magnitude, phase);
+    }
+    
+    double error = checkDFT(signal, result, N);
+    int ok = error < TOLERANCE;
+    printf("Vérification de %d raies contre la DFT directe : erreur relative = %.2e %s\n",
+           CHECKED_BINS, error, ok ? "OK" : "ECHEC");
+
+    backend->release();
+    free(signal);
+    free(result);
+    
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,650 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "fft.h"
+
+#define PI 3.14159265358979323846
+#define MAX_STAGES 32
+#define MAX_GENERIC_RADIX 31  // au-delà, un facteur premier est traité par Bluestein
+
+// Tables immuables d'une transformée (N, direction, précision) : partagées par tous les plans
+// de mêmes paramètres, y compris entre threads, et gardées par le cache jusqu'à clearFFTPlanCache
+typedef struct FFTTables FFTTables;
+
+struct FFTTables {
+    int N;
+    int direction;
+    int precision;
+
+    // Étapes de Stockham : la longueur courante n est divisée par radix[s] à chaque étape
+    int numStages;
+    int radix[MAX_STAGES];
+    int twiddleOffset[MAX_STAGES];
+    int rootsOffset[MAX_STAGES];
+
+    // Toutes les tables sont séparées en parties réelle et imaginaire (double ou float
+    // selon la précision du plan) pour que les étapes se vectorisent.
+    void* twiddlesReal;   // pour chaque étape : w_n^(j*u), j < n/p, 1 <= u < p
+    void* twiddlesImag;
+    void* rootsReal;      // racines p-ièmes des bases génériques (p > 5, p != 8)
+    void* rootsImag;
+
+    // Bluestein : convolution circulaire de longueur M (puissance de 2 >= 2N-1)
+    int M;
+    void* chirpReal;      // exp(direction * i * pi * n^2 / N)
+    void* chirpImag;
+    void* chirpFFTReal;   // FFT_M du chirp conjugué, divisée par M
+    void* chirpFFTImag;
+    FFTTables* forwardM;
+    FFTTables* inverseM;
+
+    int references;       // plans et cache, protégé par planCacheMutex
+};
+
+// Un plan : les tables partagées et ses propres tampons, alloués une fois (l'exécution
+// n'alloue rien). Seuls les tampons empêchent d'exécuter un plan sur deux threads à la fois.
+struct FFTPlan {
+    FFTTables* tables;
+    void* workReal;       // N éléments (M pour Bluestein)
+    void* workImag;
+    void* auxReal;        // N éléments, séparation des entrées entrelacées
+    void* auxImag;
+    void* subReal;        // M éléments, étapes des sous-transformées de Bluestein
+    void* subImag;
+};
+
+static size_t realSize(int precision) {
+    return precision == FFT_FLOAT ? sizeof(float) : sizeof(double);
+}
+
+static void storeExpI(void* tableReal, void* tableImag, int precision, int index, double angle) {
+    if (precision == FFT_FLOAT) {
+        ((float*)tableReal)[index] = (float)cos(angle);
+        ((float*)tableImag)[index] = (float)sin(angle);
+    } else {
+        ((double*)tableReal)[index] = cos(angle);
+        ((double*)tableImag)[index] = sin(angle);
+    }
+}
+
+// Découpe N en bases, les plus grandes d'abord ; retourne 0 si un facteur premier
+// dépasse MAX_GENERIC_RADIX.
+static int factorize(int N, int* radix, int* numStages) {
+    int count = 0;
+    while (N % 8 == 0) { radix[count++] = 8; N /= 8; }
+    if (N % 4 == 0) { radix[count++] = 4; N /= 4; }
+    if (N % 2 == 0) { radix[count++] = 2; N /= 2; }
+    while (N % 5 == 0) { radix[count++] = 5; N /= 5; }
+    while (N % 3 == 0) { radix[count++] = 3; N /= 3; }
+    for (int p = 7; N > 1; p += 2) {
+        while (N % p == 0) {
+            if (p > MAX_GENERIC_RADIX) return 0;
+            radix[count++] = p;
+            N /= p;
+        }
+    }
+    *numStages = count;
+    return 1;
+}
+
+static int isGenericRadix(int p) {
+    return p > 5 && p != 8;
+}
+
+// Instances de l'étape de Stockham : scalaire, puis AVX-512 ou AVX2+FMA selon la cible
+// de compilation (-march=native). Les opérations complexes s'écrivent en FMA.
+
+#define VADD(a, b) ((a) + (b))
+#define VSUB(a, b) ((a) - (b))
+#define VMUL(a, b) ((a) * (b))
+#define VFMA(a, b, c) ((a) * (b) + (c))
+#define VFMS(a, b, c) ((a) * (b) - (c))
+#define VSET1(x) ((VEC)(x))
+#define VLOAD(p) (*(p))
+#define VSTORE(p, v) (*(p) = (v))
+#define LANES 1
+
+#define REAL double
+#define VEC double
+#define VSUFFIX(name) name##ScalarDouble
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef VSUFFIX
+
+#define REAL float
+#define VEC float
+#define VSUFFIX(name) name##ScalarFloat
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef VSUFFIX
+
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMA
+#undef VFMS
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+#undef LANES
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define FFT_SIMD_NAME "AVX-512"
+#define LANES_DOUBLE 8
+#define LANES_FLOAT 16
+
+#define REAL double
+#define VEC __m512d
+#define LANES 8
+#define VSUFFIX(name) name##VectorDouble
+#define VADD _mm512_add_pd
+#define VSUB _mm512_sub_pd
+#define VMUL _mm512_mul_pd
+#define VFMA _mm512_fmadd_pd
+#define VFMS _mm512_fmsub_pd
+#define VSET1 _mm512_set1_pd
+#define VLOAD _mm512_loadu_pd
+#define VSTORE _mm512_storeu_pd
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef LANES
+#undef VSUFFIX
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMA
+#undef VFMS
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+
+#define REAL float
+#define VEC __m512
+#define LANES 16
+#define VSUFFIX(name) name##VectorFloat
+#define VADD _mm512_add_ps
+#define VSUB _mm512_sub_ps
+#define VMUL _mm512_mul_ps
+#define VFMA _mm512_fmadd_ps
+#define VFMS _mm512_fmsub_ps
+#define VSET1 _mm512_set1_ps
+#define VLOAD _mm512_loadu_ps
+#define VSTORE _mm512_storeu_ps
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef LANES
+#undef VSUFFIX
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMA
+#undef VFMS
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define FFT_SIMD_NAME "AVX2+FMA"
+#define LANES_DOUBLE 4
+#define LANES_FLOAT 8
+
+#define REAL double
+#define VEC __m256d
+#define LANES 4
+#define VSUFFIX(name) name##VectorDouble
+#define VADD _mm256_add_pd
+#define VSUB _mm256_sub_pd
+#define VMUL _mm256_mul_pd
+#define VFMA _mm256_fmadd_pd
+#define VFMS _mm256_fmsub_pd
+#define VSET1 _mm256_set1_pd
+#define VLOAD _mm256_loadu_pd
+#define VSTORE _mm256_storeu_pd
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef LANES
+#undef VSUFFIX
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMA
+#undef VFMS
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+
+#define REAL float
+#define VEC __m256
+#define LANES 8
+#define VSUFFIX(name) name##VectorFloat
+#define VADD _mm256_add_ps
+#define VSUB _mm256_sub_ps
+#define VMUL _mm256_mul_ps
+#define VFMA _mm256_fmadd_ps
+#define VFMS _mm256_fmsub_ps
+#define VSET1 _mm256_set1_ps
+#define VLOAD _mm256_loadu_ps
+#define VSTORE _mm256_storeu_ps
+#include "fft_stage.h"
+#undef REAL
+#undef VEC
+#undef LANES
+#undef VSUFFIX
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMA
+#undef VFMS
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+
+#else
+#define FFT_SIMD_NAME "scalaire"
+#define LANES_DOUBLE 1
+#define LANES_FLOAT 1
+#define stageVectorDouble stageScalarDouble
+#define stageVectorFloat stageScalarFloat
+#define stageInterleavedVectorDouble stageInterleavedScalarDouble
+#define stageInterleavedVectorFloat stageInterleavedScalarFloat
+#endif
+
+#define REAL double
+#define COMPLEX ComplexNumber
+#define SUFFIX(name) name##Double
+#define VECTOR_LANES LANES_DOUBLE
+#define STAGE_VECTOR stageVectorDouble
+#define STAGE_SCALAR stageScalarDouble
+#define STAGE_INTERLEAVED_VECTOR stageInterleavedVectorDouble
+#define STAGE_INTERLEAVED_SCALAR stageInterleavedScalarDouble
+#include "fft_kernels.h"
+#undef REAL
+#undef COMPLEX
+#undef SUFFIX
+#undef VECTOR_LANES
+#undef STAGE_VECTOR
+#undef STAGE_SCALAR
+#undef STAGE_INTERLEAVED_VECTOR
+#undef STAGE_INTERLEAVED_SCALAR
+
+#define REAL float
+#define COMPLEX ComplexFloat
+#define SUFFIX(name) name##Float
+#define VECTOR_LANES LANES_FLOAT
+#define STAGE_VECTOR stageVectorFloat
+#define STAGE_SCALAR stageScalarFloat
+#define STAGE_INTERLEAVED_VECTOR stageInterleavedVectorFloat
+#define STAGE_INTERLEAVED_SCALAR stageInterleavedScalarFloat
+#include "fft_kernels.h"
+#undef REAL
+#undef COMPLEX
+#undef SUFFIX
+#undef VECTOR_LANES
+#undef STAGE_VECTOR
+#undef STAGE_SCALAR
+#undef STAGE_INTERLEAVED_VECTOR
+#undef STAGE_INTERLEAVED_SCALAR
+
+const char* fftSimdName(void) {
+    return FFT_SIMD_NAME;
+}
+
+// Caches : les tables par (N, direction, précision), référencées une fois par le cache ;
+// les plans de getFFTPlan par (N, direction, précision, thread)
+typedef struct {
+    int N;
+    int direction;
+    int precision;
+    FFTTables* tables;
+} TablesCacheEntry;
+
+typedef struct {
+    int N;
+    int direction;
+    int precision;
+    pthread_t owner;
+    FFTPlan* plan;
+} PlanCacheEntry;
+
+static TablesCacheEntry* tablesCache = NULL;
+static int tablesCacheSize = 0;
+static int tablesCacheCapacity = 0;
+static PlanCacheEntry* planCache = NULL;
+static int planCacheSize = 0;
+static int planCacheCapacity = 0;
+static pthread_mutex_t planCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static FFTTables* acquireTables(int N, int direction, int precision);
+
+static void releaseTables(FFTTables* tables) {
+    if (tables == NULL) return;
+    pthread_mutex_lock(&planCacheMutex);
+    int last = --tables->references == 0;
+    pthread_mutex_unlock(&planCacheMutex);
+    if (!last) return;
+    free(tables->twiddlesReal);
+    free(tables->twiddlesImag);
+    free(tables->rootsReal);
+    free(tables->rootsImag);
+    free(tables->chirpReal);
+    free(tables->chirpImag);
+    free(tables->chirpFFTReal);
+    free(tables->chirpFFTImag);
+    releaseTables(tables->forwardM);
+    releaseTables(tables->inverseM);
+    free(tables);
+}
+
+static FFTTables* buildBluesteinTables(FFTTables* tables) {
+    int N = tables->N;
+    int precision = tables->precision;
+    size_t size = realSize(precision);
+    int M = 1;
+    while (M < 2 * N - 1) M *= 2;
+    tables->M = M;
+    tables->chirpReal = malloc(N * size);
+    tables->chirpImag = malloc(N * size);
+    tables->chirpFFTReal = calloc(M, size);
+    tables->chirpFFTImag = calloc(M, size);
+    tables->forwardM = acquireTables(M, FFT_FORWARD, precision);
+    tables->inverseM = acquireTables(M, FFT_INVERSE, precision);
+    if (tables->chirpReal == NULL || tables->chirpImag == NULL || tables->chirpFFTReal == NULL ||
+        tables->chirpFFTImag == NULL || tables->forwardM == NULL || tables->inverseM == NULL) {
+        releaseTables(tables);
+        return NULL;
+    }
+
+    // Noyau de convolution b_m = conj(chirp_|m|) / M, replié circulairement sur M points,
+    // calculé en double puis transformé dans la précision du plan
+    double* bReal = (double*)calloc(M, sizeof(double));
+    double* bImag = (double*)calloc(M, sizeof(double));
+    FFTPlan* forwardDouble = createFFTPlan(M, FFT_FORWARD);
+    if (bReal == NULL || bImag == NULL || forwardDouble == NULL) {
+        free(bReal);
+        free(bImag);
+        destroyFFTPlan(forwardDouble);
+        releaseTables(tables);
+        return NULL;
+    }
+    for (int n = 0; n < N; n++) {
+        // n^2 mod 2N garde l'angle petit et donc précis
+        long long n2 = (long long)n * n % (2LL * N);
+        double angle = tables->direction * PI * (double)n2 / N;
+        storeExpI(tables->chirpReal, tables->chirpImag, precision, n, angle);
+        bReal[n] = cos(angle) / M;
+        bImag[n] = -sin(angle) / M;
+        if (n > 0) {
+            bReal[M - n] = bReal[n];
+            bImag[M - n] = bImag[n];
+        }
+    }
+    executeFFTSplit(forwardDouble, bReal, bImag, bReal, bImag);
+    for (int k = 0; k < M; k++) {
+        if (precision == FFT_FLOAT) {
+            ((float*)tables->chirpFFTReal)[k] = (float)bReal[k];
+            ((float*)tables->chirpFFTImag)[k] = (float)bImag[k];
+        } else {
+            ((double*)tables->chirpFFTReal)[k] = bReal[k];
+            ((double*)tables->chirpFFTImag)[k] = bImag[k];
+        }
+    }
+    destroyFFTPlan(forwardDouble);
+    free(bReal);
+    free(bImag);
+    return tables;
+}
+
+// Tables neuves avec une référence, celle de l'appelant
+static FFTTables* buildTables(int N, int direction, int precision) {
+    FFTTables* tables = (FFTTables*)calloc(1, sizeof(FFTTables));
+    if (tables == NULL) return NULL;
+    tables->N = N;
+    tables->direction = direction;
+    tables->precision = precision;
+    tables->references = 1;
+
+    if (!factorize(N, tables->radix, &tables->numStages)) {
+        return buildBluesteinTables(tables);
+    }
+
+    int totalTwiddles = 0;
+    int totalRoots = 0;
+    for (int s = 0, n = N; s < tables->numStages; n /= tables->radix[s], s++) {
+        int p = tables->radix[s];
+        tables->twiddleOffset[s] = totalTwiddles;
+        tables->rootsOffset[s] = totalRoots;
+        totalTwiddles += (n / p) * (p - 1);
+        if (isGenericRadix(p)) totalRoots += p;
+    }
+
+    size_t size = realSize(precision);
+    tables->twiddlesReal = malloc((totalTwiddles + 1) * size);
+    tables->twiddlesImag = malloc((totalTwiddles + 1) * size);
+    tables->rootsReal = malloc((totalRoots + 1) * size);
+    tables->rootsImag = malloc((totalRoots + 1) * size);
+    if (tables->twiddlesReal == NULL || tables->twiddlesImag == NULL ||
+        tables->rootsReal == NULL || tables->rootsImag == NULL) {
+        releaseTables(tables);
+        return NULL;
+    }
+
+    for (int s = 0, n = N; s < tables->numStages; n /= tables->radix[s], s++) {
+        int p = tables->radix[s];
+        int m = n / p;
+        for (int j = 0; j < m; j++) {
+            for (int u = 1; u < p; u++) {
+                // j*u < n : l'angle reste dans [0, 2*pi[
+                storeExpI(tables->twiddlesReal, tables->twiddlesImag, precision,
+                          tables->twiddleOffset[s] + j * (p - 1) + (u - 1),
+                          direction * 2 * PI * (double)(j * u) / n);
+            }
+        }
+        if (isGenericRadix(p)) {
+            for (int t = 0; t < p; t++)
+                storeExpI(tables->rootsReal, tables->rootsImag, precision, tables->rootsOffset[s] + t,
+                          direction * 2 * PI * (double)t / p);
+        }
+    }
+    return tables;
+}
+
+// Appelé avec planCacheMutex verrouillé
+static FFTTables* findTables(int N, int direction, int precision) {
+    for (int i = 0; i < tablesCacheSize; i++) {
+        TablesCacheEntry* e = &tablesCache[i];
+        if (e->N == N && e->direction == direction && e->precision == precision) return e->tables;
+    }
+    return NULL;
+}
+
+// Tables du cache avec une référence de plus pour l'appelant. La construction se fait hors du
+// verrou (Bluestein acquiert les tables de longueur M) ; si un autre thread a construit les
+// mêmes tables entre-temps, les siennes l'emportent.
+static FFTTables* acquireTables(int N, int direction, int precision) {
+    pthread_mutex_lock(&planCacheMutex);
+    FFTTables* tables = findTables(N, direction, precision);
+    if (tables != NULL) tables->references++;
+    pthread_mutex_unlock(&planCacheMutex);
+    if (tables != NULL) return tables;
+
+    FFTTables* built = buildTables(N, direction, precision);
+    if (built == NULL) return NULL;
+    pthread_mutex_lock(&planCacheMutex);
+    tables = findTables(N, direction, precision);
+    if (tables != NULL) {
+        tables->references++;
+        pthread_mutex_unlock(&planCacheMutex);
+        releaseTables(built);
+        return tables;
+    }
+    if (tablesCacheSize == tablesCacheCapacity) {
+        int capacity = tablesCacheCapacity ? 2 * tablesCacheCapacity : 16;
+        TablesCacheEntry* entries = (TablesCacheEntry*)realloc(tablesCache, capacity * sizeof(TablesCacheEntry));
+        if (entries != NULL) {
+            tablesCache = entries;
+            tablesCacheCapacity = capacity;
+        }
+    }
+    // Faute de place, les tables servent sans être mises en cache
+    if (tablesCacheSize < tablesCacheCapacity) {
+        TablesCacheEntry e = {N, direction, precision, built};
+        tablesCache[tablesCacheSize++] = e;
+        built->references++;
+    }
+    pthread_mutex_unlock(&planCacheMutex);
+    return built;
+}
+
+FFTPlan* createFFTPlanPrecision(int N, int direction, int precision) {
+    if (N < 1 || (direction != FFT_FORWARD && direction != FFT_INVERSE) ||
+        (precision != FFT_DOUBLE && precision != FFT_FLOAT)) return NULL;
+
+    FFTPlan* plan = (FFTPlan*)calloc(1, sizeof(FFTPlan));
+    if (plan == NULL) return NULL;
+    plan->tables = acquireTables(N, direction, precision);
+    if (plan->tables == NULL) {
+        free(plan);
+        return NULL;
+    }
+    int M = plan->tables->M;
+    size_t size = realSize(precision);
+    plan->workReal = malloc((M > 0 ? M : N) * size);
+    plan->workImag = malloc((M > 0 ? M : N) * size);
+    plan->auxReal = malloc(N * size);
+    plan->auxImag = malloc(N * size);
+    if (M > 0) {
+        plan->subReal = malloc(M * size);
+        plan->subImag = malloc(M * size);
+    }
+    if (plan->workReal == NULL || plan->workImag == NULL || plan->auxReal == NULL || plan->auxImag == NULL ||
+        (M > 0 && (plan->subReal == NULL || plan->subImag == NULL))) {
+        destroyFFTPlan(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+FFTPlan* createFFTPlan(int N, int direction) {
+    return createFFTPlanPrecision(N, direction, FFT_DOUBLE);
+}
+
+void destroyFFTPlan(FFTPlan* plan) {
+    if (plan == NULL) return;
+    free(plan->workReal);
+    free(plan->workImag);
+    free(plan->auxReal);
+    free(plan->auxImag);
+    free(plan->subReal);
+    free(plan->subImag);
+    releaseTables(plan->tables);
+    free(plan);
+}
+
+static void checkPrecision(const FFTPlan* plan, int precision) {
+    if (plan->tables->precision != precision) {
+        fprintf(stderr, "Erreur : plan FFT %s utilisé avec des données %s.\n",
+                plan->tables->precision == FFT_DOUBLE ? "double précision" : "simple précision",
+                precision == FFT_DOUBLE ? "double" : "float");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void executeFFT(const FFTPlan* plan, const ComplexNumber* input, ComplexNumber* output) {
+    checkPrecision(plan, FFT_DOUBLE);
+    executeInterleavedDouble(plan, input, output);
+}
+
+void executeFFTFloat(const FFTPlan* plan, const ComplexFloat* input, ComplexFloat* output) {
+    checkPrecision(plan, FFT_FLOAT);
+    executeInterleavedFloat(plan, input, output);
+}
+
+void executeFFTSplit(const FFTPlan* plan, const double* inReal, const double* inImag,
+                     double* outReal, double* outImag) {
+    checkPrecision(plan, FFT_DOUBLE);
+    executeSplitDouble(plan, inReal, inImag, outReal, outImag);
+}
+
+void executeFFTSplitFloat(const FFTPlan* plan, const float* inReal, const float* inImag,
+                          float* outReal, float* outImag) {
+    checkPrecision(plan, FFT_FLOAT);
+    executeSplitFloat(plan, inReal, inImag, outReal, outImag);
+}
+
+void splitComplex(const ComplexNumber* input, int N, double* real, double* imag) {
+    for (int i = 0; i < N; i++) {
+        real[i] = input[i].real;
+        imag[i] = input[i].imag;
+    }
+}
+
+void interleaveComplex(const double* real, const double* imag, int N, ComplexNumber* output) {
+    for (int i = 0; i < N; i++) {
+        output[i].real = real[i];
+        output[i].imag = imag[i];
+    }
+}
+
+FFTPlan* getFFTPlan(int N, int direction, int precision) {
+    pthread_t self = pthread_self();
+    FFTPlan* plan = NULL;
+    pthread_mutex_lock(&planCacheMutex);
+    for (int i = 0; i < planCacheSize; i++) {
+        PlanCacheEntry* e = &planCache[i];
+        if (e->N == N && e->direction == direction && e->precision == precision && pthread_equal(e->owner, self)) {
+            plan = e->plan;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&planCacheMutex);
+    if (plan != NULL) return plan;
+
+    // Seul ce thread peut ajouter une entrée à son nom : pas de doublon possible
+    plan = createFFTPlanPrecision(N, direction, precision);
+    if (plan == NULL) return NULL;
+    pthread_mutex_lock(&planCacheMutex);
+    if (planCacheSize == planCacheCapacity) {
+        int capacity = planCacheCapacity ? 2 * planCacheCapacity : 16;
+        PlanCacheEntry* entries = (PlanCacheEntry*)realloc(planCache, capacity * sizeof(PlanCacheEntry));
+        if (entries == NULL) {
+            pthread_mutex_unlock(&planCacheMutex);
+            destroyFFTPlan(plan);
+            return NULL;
+        }
+        planCache = entries;
+        planCacheCapacity = capacity;
+    }
+    PlanCacheEntry e = {N, direction, precision, self, plan};
+    planCache[planCacheSize++] = e;
+    pthread_mutex_unlock(&planCacheMutex);
+    return plan;
+}
+
+void clearFFTPlanCache(void) {
+    pthread_mutex_lock(&planCacheMutex);
+    PlanCacheEntry* plans = planCache;
+    int numPlans = planCacheSize;
+    TablesCacheEntry* tables = tablesCache;
+    int numTables = tablesCacheSize;
+    planCache = NULL;
+    planCacheSize = planCacheCapacity = 0;
+    tablesCache = NULL;
+    tablesCacheSize = tablesCacheCapacity = 0;
+    pthread_mutex_unlock(&planCacheMutex);
+
+    // Les libérations reprennent le verrou ; les tables encore utilisées par des plans vivants
+    // survivent jusqu'à leur destruction
+    for (int i = 0; i < numPlans; i++) destroyFFTPlan(plans[i].plan);
+    for (int i = 0; i < numTables; i++) releaseTables(tables[i].tables);
+    free(plans);
+    free(tables);
+}
@@ -0,0 +1,61 @@
+#ifndef FFT_H
+#define FFT_H
+
+// Moteur FFT de Cooley-Tukey à base mixte (2, 3, 4, 5, 8, petites bases premières)
+// avec repli sur l'algorithme de Bluestein pour les longueurs ayant un grand facteur premier.
+// Les transformées ne sont pas normalisées : inverse(avant(x)) = N * x.
+//
+// Un plan précalcule une fois tous les facteurs de rotation et son tampon de travail :
+// l'exécution n'alloue rien et n'appelle aucune fonction trigonométrique. Les tables de
+// facteurs, immuables, sont mises en cache et partagées par tous les plans de mêmes
+// (N, direction, précision), quel que soit le thread ; le tampon est propre à chaque plan,
+// qui ne doit donc pas être exécuté par plusieurs threads en même temps.
+//
+// Les étapes travaillent sur des parties réelle et imaginaire séparées (SoA) et sont
+// vectorisées en AVX-512 ou AVX2+FMA selon la cible de compilation (-march=native).
+// executeFFTSplit lit et écrit directement des tableaux séparés, sans copie ;
+// executeFFT sépare l'entrée entrelacée dans un tampon du plan et réentrelace la sortie.
+
+#define FFT_FORWARD -1
+#define FFT_INVERSE 1
+
+#define FFT_DOUBLE 0
+#define FFT_FLOAT 1
+
+typedef struct {
+    double real;
+    double imag;
+} ComplexNumber;
+
+typedef struct {
+    float real;
+    float imag;
+} ComplexFloat;
+
+typedef struct FFTPlan FFTPlan;
+
+FFTPlan* createFFTPlan(int N, int direction);
+FFTPlan* createFFTPlanPrecision(int N, int direction, int precision);
+void executeFFT(const FFTPlan* plan, const ComplexNumber* input, ComplexNumber* output);
+void executeFFTFloat(const FFTPlan* plan, const ComplexFloat* input, ComplexFloat* output);
+void executeFFTSplit(const FFTPlan* plan, const double* inReal, const double* inImag,
+                     double* outReal, double* outImag);
+void executeFFTSplitFloat(const FFTPlan* plan, const float* inReal, const float* inImag,
+                          float* outReal, float* outImag);
+void destroyFFTPlan(FFTPlan* plan);
+
+// Conversions entre le tableau de ComplexNumber et les tableaux séparés
+void splitComplex(const ComplexNumber* input, int N, double* real, double* imag);
+void interleaveComplex(const double* real, const double* imag, int N, ComplexNumber* output);
+
+// Jeu d'instructions utilisé par les étapes ("AVX-512", "AVX2+FMA" ou "scalaire")
+const char* fftSimdName(void);
+
+// Plan du thread appelant pour (N, direction, précision), créé au premier appel : deux threads
+// reçoivent deux plans distincts (mêmes tables). Les plans retournés appartiennent au cache :
+// ne pas les passer à destroyFFTPlan. clearFFTPlanCache les détruit tous et libère les tables
+// qui ne servent plus à aucun plan ; aucun thread ne doit alors utiliser un plan du cache.
+FFTPlan* getFFTPlan(int N, int direction, int precision);
+void clearFFTPlanCache(void);
+
+#endif
@@ -0,0 +1,150 @@
+// Exécution FFT sur données séparées (SoA), incluse deux fois par fft.c : une fois en
+// double précision (REAL = double, COMPLEX = ComplexNumber) et une fois en simple précision.
+// Macros attendues avant l'inclusion : REAL, COMPLEX, SUFFIX(nom), VECTOR_LANES,
+// STAGE_VECTOR, STAGE_SCALAR, STAGE_INTERLEAVED_VECTOR et STAGE_INTERLEAVED_SCALAR
+// (instances de fft_stage.h pour ce type REAL).
+
+// Une étape : les q multiples de VECTOR_LANES en SIMD, le reste en scalaire. Quand le pas
+// est plus petit qu'un vecteur (premières étapes), les voies portent des papillons voisins.
+static void SUFFIX(stockhamStage)(const FFTTables* tables, int stage, int n, int s,
+                                  const REAL* xr, const REAL* xi, REAL* yr, REAL* yi) {
+    int p = tables->radix[stage];
+    int m = n / p;
+    const REAL* twR = (const REAL*)tables->twiddlesReal + tables->twiddleOffset[stage];
+    const REAL* twI = (const REAL*)tables->twiddlesImag + tables->twiddleOffset[stage];
+    const REAL* rootsR = (const REAL*)tables->rootsReal + tables->rootsOffset[stage];
+    const REAL* rootsI = (const REAL*)tables->rootsImag + tables->rootsOffset[stage];
+    int qVector = s - s % VECTOR_LANES;
+
+    if (s < VECTOR_LANES) {
+        int count = s * m;
+        int kVector = count - count % VECTOR_LANES;
+        if (kVector > 0)
+            STAGE_INTERLEAVED_VECTOR(p, tables->direction, m, s, 0, kVector, xr, xi, yr, yi, twR, twI, rootsR, rootsI);
+        if (kVector < count)
+            STAGE_INTERLEAVED_SCALAR(p, tables->direction, m, s, kVector, count, xr, xi, yr, yi, twR, twI, rootsR,
+                                     rootsI);
+        return;
+    }
+    if (qVector > 0)
+        STAGE_VECTOR(p, tables->direction, m, s, 0, qVector, xr, xi, yr, yi, twR, twI, rootsR, rootsI);
+    if (qVector < s)
+        STAGE_SCALAR(p, tables->direction, m, s, qVector, s, xr, xi, yr, yi, twR, twI, rootsR, rootsI);
+}
+
+// Enchaîne les étapes de in vers out en alternant avec work (in peut être égal à out,
+// mais pas à work). Le premier tampon de destination est choisi pour finir dans out.
+static void SUFFIX(runStages)(const FFTTables* tables, const REAL* inR, const REAL* inI,
+                              REAL* outR, REAL* outI, REAL* workR, REAL* workI) {
+    int N = tables->N;
+    int S = tables->numStages;
+    if (S == 0) {
+        if (outR != inR) {
+            memcpy(outR, inR, N * sizeof(REAL));
+            memcpy(outI, inI, N * sizeof(REAL));
+        }
+        return;
+    }
+
+    const REAL* srcR = inR;
+    const REAL* srcI = inI;
+    REAL* dstR = (S % 2 == 1) ? outR : workR;
+    REAL* dstI = (S % 2 == 1) ? outI : workI;
+    if (dstR == inR) {
+        // Transformée en place avec un nombre impair d'étapes : une copie préalable
+        memcpy(workR, inR, N * sizeof(REAL));
+        memcpy(workI, inI, N * sizeof(REAL));
+        srcR = workR;
+        srcI = workI;
+    }
+
+    for (int s = 0, n = N, stride = 1; s < S; s++) {
+        SUFFIX(stockhamStage)(tables, s, n, stride, srcR, srcI, dstR, dstI);
+        n /= tables->radix[s];
+        stride *= tables->radix[s];
+        srcR = dstR;
+        srcI = dstI;
+        dstR = (dstR == outR) ? workR : outR;
+        dstI = (dstI == outI) ? workI : outI;
+    }
+}
+
+// Bluestein : X_k = chirp_k * (chirp . x) (*) conj(chirp), convolution de longueur M
+static void SUFFIX(executeBluestein)(const FFTPlan* plan, const REAL* inR, const REAL* inI,
+                                     REAL* outR, REAL* outI) {
+    const FFTTables* tables = plan->tables;
+    int N = tables->N, M = tables->M;
+    const REAL* chirpR = (const REAL*)tables->chirpReal;
+    const REAL* chirpI = (const REAL*)tables->chirpImag;
+    const REAL* bR = (const REAL*)tables->chirpFFTReal;
+    const REAL* bI = (const REAL*)tables->chirpFFTImag;
+    REAL* aR = (REAL*)plan->workReal;
+    REAL* aI = (REAL*)plan->workImag;
+    REAL* subR = (REAL*)plan->subReal;
+    REAL* subI = (REAL*)plan->subImag;
+
+    for (int n = 0; n < N; n++) {
+        REAL xr = inR[n], xi = inI[n];
+        aR[n] = xr * chirpR[n] - xi * chirpI[n];
+        aI[n] = xr * chirpI[n] + xi * chirpR[n];
+    }
+    memset(aR + N, 0, (M - N) * sizeof(REAL));
+    memset(aI + N, 0, (M - N) * sizeof(REAL));
+
+    SUFFIX(runStages)(tables->forwardM, aR, aI, aR, aI, subR, subI);
+    for (int k = 0; k < M; k++) {
+        REAL xr = aR[k], xi = aI[k];
+        aR[k] = xr * bR[k] - xi * bI[k];
+        aI[k] = xr * bI[k] + xi * bR[k];
+    }
+    SUFFIX(runStages)(tables->inverseM, aR, aI, aR, aI, subR, subI);
+
+    for (int k = 0; k < N; k++) {
+        REAL xr = aR[k], xi = aI[k];
+        outR[k] = xr * chirpR[k] - xi * chirpI[k];
+        outI[k] = xr * chirpI[k] + xi * chirpR[k];
+    }
+}
+
+static void SUFFIX(executeSplit)(const FFTPlan* plan, const REAL* inR, const REAL* inI,
+                                 REAL* outR, REAL* outI) {
+    if (plan->tables->M > 0) {
+        SUFFIX(executeBluestein)(plan, inR, inI, outR, outI);
+    } else {
+        SUFFIX(runStages)(plan->tables, inR, inI, outR, outI, (REAL*)plan->workReal, (REAL*)plan->workImag);
+    }
+}
+
+// Entrée/sortie entrelacées : séparation dans aux, étapes SoA, puis réentrelacement
+static void SUFFIX(executeInterleaved)(const FFTPlan* plan, const COMPLEX* input, COMPLEX* output) {
+    int N = plan->tables->N;
+    REAL* auxR = (REAL*)plan->auxReal;
+    REAL* auxI = (REAL*)plan->auxImag;
+    REAL* resR = auxR;
+    REAL* resI = auxI;
+
+    for (int i = 0; i < N; i++) {
+        auxR[i] = input[i].real;
+        auxI[i] = input[i].imag;
+    }
+
+    if (plan->tables->M > 0) {
+        SUFFIX(executeBluestein)(plan, auxR, auxI, auxR, auxI);
+    } else {
+        // Le résultat finit dans work si le nombre d'étapes est impair : aucune copie
+        REAL* workR = (REAL*)plan->workReal;
+        REAL* workI = (REAL*)plan->workImag;
+        if (plan->tables->numStages % 2 == 1) {
+            resR = workR;
+            resI = workI;
+            SUFFIX(runStages)(plan->tables, auxR, auxI, workR, workI, auxR, auxI);
+        } else {
+            SUFFIX(runStages)(plan->tables, auxR, auxI, auxR, auxI, workR, workI);
+        }
+    }
+
+    for (int i = 0; i < N; i++) {
+        output[i].real = resR[i];
+        output[i].imag = resI[i];
+    }
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "fft_nd.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define MIN_BENCH_TIME 0.2      // durée minimale de mesure par point (secondes)
+
+void fillVolume(double* real, double* imag, size_t total) {
+    for (size_t i = 0; i < total; i++) {
+        real[i] = sin(0.37 * i) + 0.25 * cos(1.3e-3 * (double)i);
+        imag[i] = cos(0.11 * i) - 0.5;
+    }
+}
+
+// Référence : chaque ligne de chaque axe est copiée, transformée par un plan 1D et remise en place
+void referenceFFT(int rank, const int* dims, double* real, double* imag) {
+    size_t total = 1;
+    for (int a = 0; a < rank; a++) total *= dims[a];
+    for (int axis = rank - 1; axis >= 0; axis--) {
+        int length = dims[axis];
+        size_t inner = 1;
+        for (int a = axis + 1; a < rank; a++) inner *= dims[a];
+        FFTPlan* plan = createFFTPlan(length, FFT_FORWARD);
+        double* lineReal = (double*)malloc(length * sizeof(double));
+        double* lineImag = (double*)malloc(length * sizeof(double));
+        for (size_t start = 0; start < total; start++) {
+            // Premier élément d'une ligne : coordonnée nulle sur l'axe
+            if ((start / inner) % length != 0) continue;
+            for (int k = 0; k < length; k++) {
+                lineReal[k] = real[start + k * inner];
+                lineImag[k] = imag[start + k * inner];
+            }
+            executeFFTSplit(plan, lineReal, lineImag, lineReal, lineImag);
+            for (int k = 0; k < length; k++) {
+                real[start + k * inner] = lineReal[k];
+                imag[start + k * inner] = lineImag[k];
+            }
+        }
+        destroyFFTPlan(plan);
+        free(lineReal);
+        free(lineImag);
+    }
+}
+
+double maxRelativeError(const double* refReal, const double* refImag, const double* real, const double* imag,
+                        size_t total, double scale) {
+    double maxErr = 0, maxRef = 0;
+    for (size_t i = 0; i < total; i++) {
+        double err = hypot(refReal[i] - real[i] * scale, refImag[i] - imag[i] * scale);
+        double mag = hypot(refReal[i], refImag[i]);
+        if (err > maxErr) maxErr = err;
+        if (mag > maxRef) maxRef = mag;
+    }
+    return maxRef > 0 ? maxErr / maxRef : maxErr;
+}
+
+// Compare la FFT multidimensionnelle à la référence et vérifie inverse(avant(x)) = N x
+int checkShape(ThreadPool* pool, int rank, const int* dims) {
+    size_t total = 1;
+    for (int a = 0; a < rank; a++) total *= dims[a];
+    double* real = (double*)malloc(total * sizeof(double));
+    double* imag = (double*)malloc(total * sizeof(double));
+    double* refReal = (double*)malloc(total * sizeof(double));
+    double* refImag = (double*)malloc(total * sizeof(double));
+    double* outReal = (double*)malloc(total * sizeof(double));
+    double* outImag = (double*)malloc(total * sizeof(double));
+    FFTPlanND* forward = createFFTPlanND(rank, dims, FFT_FORWARD, pool);
+    FFTPlanND* inverse = createFFTPlanND(rank, dims, FFT_INVERSE, pool);
+
+    fillVolume(real, imag, total);
+    memcpy(refReal, real, total * sizeof(double));
+    memcpy(refImag, imag, total * sizeof(double));
+    referenceFFT(rank, dims, refReal, refImag);
+    executeFFTNDSplit(forward, real, imag, outReal, outImag);
+    double errForward = maxRelativeError(refReal, refImag, outReal, outImag, total, 1);
+
+    fillVolume(refReal, refImag, total);
+    executeFFTNDSplit(inverse, outReal, outImag, outReal, outImag);
+    double errRoundTrip = maxRelativeError(refReal, refImag, outReal, outImag, total, 1.0 / total);
+
+    int ok = errForward < 1e-9 && errRoundTrip < 1e-12;
+    printf("%5d", dims[0]);
+    for (int a = 1; a < rank; a++) printf(" x %5d", dims[a]);
+    printf(" : référence = %.2e, aller-retour = %.2e %s\n", errForward, errRoundTrip, ok ? "OK" : "ECHEC");
+
+    destroyFFTPlanND(forward);
+    destroyFFTPlanND(inverse);
+    free(real);
+    free(imag);
+    free(refReal);
+    free(refImag);
+    free(outReal);
+    free(outImag);
+    return ok;
+}
+
+// Temps moyen d'une transformée en place, mesuré par le thread appelant dans region : les
+// compteurs ne couvrent que sa part du travail. Modèle : 5 N log2 N opérations, et chaque axe
+// relit et réécrit tout le volume
+double benchShape(ThreadPool* pool, int rank, const int* dims, double* real, double* imag, perf_region* region) {
+    FFTPlanND* plan = createFFTPlanND(rank, dims, FFT_FORWARD, pool);
+    if (plan == NULL) return -1;
+    executeFFTNDSplit(plan, real, imag, real, imag);
+
+    int repetitions = 0;
+    while (perf_region_seconds(region) < MIN_BENCH_TIME) {
+        perf_region_begin(region, 0);
+        executeFFTNDSplit(plan, real, imag, real, imag);
+        perf_region_end(region, 0);
+        repetitions++;
+    }
+    destroyFFTPlanND(plan);
+    double total = 1;
+    for (int a = 0; a < rank; a++) total *= dims[a];
+    perf_region_add_work(region, repetitions * 5.0 * total * log2(total),
+                         repetitions * rank * 4.0 * total * sizeof(double));
+    return perf_region_seconds(region) / repetitions;
+}
+
+// Usage : ./fft_multidim [côté 2D] [côté 3D] [threads max]
+// Par défaut 2048 x 2048 et 128^3 ; 4096 et 512 donnent les tailles de l'imagerie
+// (256 Mo et 2 Go par transformée).
+int main(int argc, char* argv[]) {
+    int side2 = argc > 1 ? atoi(argv[1]) : 2048;
+    int side3 = argc > 2 ? atoi(argv[2]) : 128;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int cores = argc > 3 ? atoi(argv[3]) : (online > 0 ? (int)online : 1);
+    if (side2 < 2 || side3 < 2 || cores < 1) {
+        printf("Usage : %s [côté 2D] [côté 3D] [threads max]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Vérification contre une FFT ligne par ligne (%d threads, %s) :\n", cores, fftSimdName());
+    ThreadPool* pool = createThreadPool(cores);
+    if (pool == NULL) {
+        printf("Erreur de création du pool de threads.\n");
+        return 1;
+    }
+    int shapes[][3] = {{1000, 0, 0}, {64, 48, 0}, {17, 100, 0}, {256, 256, 0},
+                       {8, 12, 10}, {32, 32, 32}, {5, 7, 33}, {64, 96, 80}};
+    int ranks[] = {1, 2, 2, 2, 3, 3, 3, 3};
+    int allOk = 1;
+    for (int s = 0; s < (int)(sizeof(ranks) / sizeof(ranks[0])); s++) allOk &= checkShape(pool, ranks[s], shapes[s]);
+    destroyThreadPool(pool);
+
+    int benchDims[2][3] = {{side2, side2, 0}, {side3, side3, side3}};
+    int benchRanks[2] = {2, 3};
+    perf_region* largest[2] = {NULL, NULL};  // dernière mesure, au plus grand nombre de threads
+    printf("\nTransformée en place : temps (ms), GFLOP/s (5 N log2 N) et accélération par nombre de threads\n");
+    for (int b = 0; b < 2; b++) {
+        int rank = benchRanks[b];
+        size_t total = 1;
+        for (int a = 0; a < rank; a++) total *= benchDims[b][a];
+        double* real = (double*)malloc(total * sizeof(double));
+        double* imag = (double*)malloc(total * sizeof(double));
+        if (real == NULL || imag == NULL) {
+            printf("Erreur d'allocation mémoire.\n");
+            return 1;
+        }
+        fillVolume(real, imag, total);
+        double flops = 5.0 * total * log2((double)total), base = 0;
+        printf("%5d^%d", benchDims[b][0], rank);
+        for (int t = 1;; t = t * 2 < cores ? t * 2 : cores) {
+            ThreadPool* p = createThreadPool(t);
+            perf_region_free(largest[b]);
+            largest[b] = perf_region_create(rank == 2 ? "FFT 2D" : "FFT 3D", 1);
+            double time = benchShape(p, rank, benchDims[b], real, imag, largest[b]);
+            destroyThreadPool(p);
+            if (t == 1) base = time;
+            printf(" | %3d thr %9.2f ms %6.2f GF x%4.2f", t, time * 1e3, flops / time / 1e9, base / time);
+            if (t == cores) break;
+        }
+        printf("\n");
+        free(real);
+        free(imag);
+    }
+    printf("\n");
+    for (int b = 0; b < 2; b++) {
+        perf_region_report(largest[b], stdout);
+        perf_region_free(largest[b]);
+    }
+    return allOk ? 0 : 1;
+}
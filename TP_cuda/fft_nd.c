@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fft_nd.h"
+
+struct FFTPlanND {
+    int rank;
+    int dims[FFT_ND_MAX_RANK];
+    size_t total;
+    int direction;
+    ThreadPool* pool;
+    int numThreads;
+    FFTPlan** axisPlans[FFT_ND_MAX_RANK];   // un plan par axe et par thread
+    ParallelFFTPlan* linePlan;              // rang 1 : FFT parallèle de fft_parallel.c, sans plans par axe
+    double* blockReal;                      // tuile transposée, une par thread
+    double* blockImag;
+    int blockStride;                        // éléments par tuile (FFT_ND_COLUMN_BLOCK * longueur max)
+    double* auxReal;                        // entrée séparée pour executeFFTND (allouée au besoin)
+    double* auxImag;
+};
+
+typedef struct {
+    FFTPlanND* plan;
+    int axis;
+    int length;
+    size_t inner;           // produit des dimensions après l'axe
+    int blocks;             // paquets de colonnes par tranche
+    const double* srcReal;
+    const double* srcImag;
+    double* dstReal;
+    double* dstImag;
+    const ComplexNumber* input;
+    ComplexNumber* output;
+} AxisContext;
+
+FFTPlanND* createFFTPlanND(int rank, const int* dims, int direction, ThreadPool* pool) {
+    if (rank < 1 || rank > FFT_ND_MAX_RANK) return NULL;
+    FFTPlanND* plan = (FFTPlanND*)calloc(1, sizeof(FFTPlanND));
+    if (plan == NULL) return NULL;
+    plan->rank = rank;
+    plan->direction = direction;
+    plan->pool = pool;
+    plan->numThreads = threadPoolSize(pool);
+    plan->total = 1;
+    int maxLength = 1;
+    for (int a = 0; a < rank; a++) {
+        if (dims[a] < 1) {
+            free(plan);
+            return NULL;
+        }
+        plan->dims[a] = dims[a];
+        plan->total *= dims[a];
+        if (dims[a] > maxLength) maxLength = dims[a];
+    }
+
+    if (rank == 1) {
+        plan->linePlan = createParallelFFTPlan(dims[0], direction, pool);
+        if (plan->linePlan == NULL) {
+            destroyFFTPlanND(plan);
+            return NULL;
+        }
+        return plan;
+    }
+    for (int a = 0; a < rank; a++) {
+        plan->axisPlans[a] = (FFTPlan**)calloc(plan->numThreads, sizeof(FFTPlan*));
+        if (plan->axisPlans[a] == NULL) {
+            destroyFFTPlanND(plan);
+            return NULL;
+        }
+        for (int t = 0; t < plan->numThreads; t++) {
+            plan->axisPlans[a][t] = createFFTPlan(dims[a], direction);
+            if (plan->axisPlans[a][t] == NULL) {
+                destroyFFTPlanND(plan);
+                return NULL;
+            }
+        }
+    }
+    plan->blockStride = FFT_ND_COLUMN_BLOCK * maxLength;
+    size_t blockSize = (size_t)plan->blockStride * plan->numThreads;
+    plan->blockReal = (double*)malloc(blockSize * sizeof(double));
+    plan->blockImag = (double*)malloc(blockSize * sizeof(double));
+    if (plan->blockReal == NULL || plan->blockImag == NULL) {
+        destroyFFTPlanND(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+void destroyFFTPlanND(FFTPlanND* plan) {
+    if (plan == NULL) return;
+    for (int a = 0; a < plan->rank; a++) {
+        if (plan->axisPlans[a] == NULL) continue;
+        for (int t = 0; t < plan->numThreads; t++) destroyFFTPlan(plan->axisPlans[a][t]);
+        free(plan->axisPlans[a]);
+    }
+    destroyParallelFFTPlan(plan->linePlan);
+    free(plan->blockReal);
+    free(plan->blockImag);
+    free(plan->auxReal);
+    free(plan->auxImag);
+    free(plan);
+}
+
+// Axe contigu : chaque tâche transforme des lignes entières (src -> dst, éventuellement en place)
+static void rowBody(void* context, int begin, int end, int worker) {
+    AxisContext* c = (AxisContext*)context;
+    FFTPlan* plan = c->plan->axisPlans[c->axis][worker];
+    for (int row = begin; row < end; row++) {
+        size_t offset = (size_t)row * c->length;
+        executeFFTSplit(plan, c->srcReal + offset, c->srcImag + offset, c->dstReal + offset, c->dstImag + offset);
+    }
+}
+
+// Autre axe : la tâche t traite, dans la tranche t / blocks, les colonnes
+// [j0, j0 + width) ; l'élément k de la colonne j est à base + k * inner + j
+static void columnBody(void* context, int begin, int end, int worker) {
+    AxisContext* c = (AxisContext*)context;
+    FFTPlanND* p = c->plan;
+    FFTPlan* plan = p->axisPlans[c->axis][worker];
+    int length = c->length;
+    size_t inner = c->inner;
+    double* tileReal = p->blockReal + (size_t)worker * p->blockStride;
+    double* tileImag = p->blockImag + (size_t)worker * p->blockStride;
+    for (int t = begin; t < end; t++) {
+        size_t slab = t / c->blocks;
+        size_t j0 = (size_t)(t % c->blocks) * FFT_ND_COLUMN_BLOCK;
+        int width = inner - j0 < FFT_ND_COLUMN_BLOCK ? (int)(inner - j0) : FFT_ND_COLUMN_BLOCK;
+        double* baseReal = c->dstReal + slab * length * inner + j0;
+        double* baseImag = c->dstImag + slab * length * inner + j0;
+
+        // Transposition de la tuile : lecture de width éléments contigus par ligne
+        for (int k = 0; k < length; k++) {
+            const double* rowReal = baseReal + (size_t)k * inner;
+            const double* rowImag = baseImag + (size_t)k * inner;
+            for (int j = 0; j < width; j++) {
+                tileReal[(size_t)j * length + k] = rowReal[j];
+                tileImag[(size_t)j * length + k] = rowImag[j];
+            }
+        }
+        for (int j = 0; j < width; j++) {
+            double* r = tileReal + (size_t)j * length;
+            double* i = tileImag + (size_t)j * length;
+            executeFFTSplit(plan, r, i, r, i);
+        }
+        for (int k = 0; k < length; k++) {
+            double* rowReal = baseReal + (size_t)k * inner;
+            double* rowImag = baseImag + (size_t)k * inner;
+            for (int j = 0; j < width; j++) {
+                rowReal[j] = tileReal[(size_t)j * length + k];
+                rowImag[j] = tileImag[(size_t)j * length + k];
+            }
+        }
+    }
+}
+
+static void transformAxis(FFTPlanND* plan, int axis, const double* srcReal, const double* srcImag,
+                          double* dstReal, double* dstImag) {
+    AxisContext c = {plan, axis, plan->dims[axis], 1, 1, srcReal, srcImag, dstReal, dstImag, NULL, NULL};
+    size_t outer = 1;
+    for (int a = 0; a < axis; a++) outer *= plan->dims[a];
+    for (int a = axis + 1; a < plan->rank; a++) c.inner *= plan->dims[a];
+
+    if (c.inner == 1) {
+        if (plan->linePlan != NULL) {
+            executeParallelFFTSplit(plan->linePlan, srcReal, srcImag, dstReal, dstImag);
+            return;
+        }
+        threadPoolParallelFor(plan->pool, 0, (int)outer, 1, rowBody, &c);
+        return;
+    }
+    if (srcReal != dstReal) {
+        memcpy(dstReal, srcReal, plan->total * sizeof(double));
+        memcpy(dstImag, srcImag, plan->total * sizeof(double));
+    }
+    c.blocks = (int)((c.inner + FFT_ND_COLUMN_BLOCK - 1) / FFT_ND_COLUMN_BLOCK);
+    threadPoolParallelFor(plan->pool, 0, (int)(outer * c.blocks), 1, columnBody, &c);
+}
+
+void executeFFTAxisSplit(FFTPlanND* plan, int axis, double* real, double* imag) {
+    if (axis < 0 || axis >= plan->rank) return;
+    transformAxis(plan, axis, real, imag, real, imag);
+}
+
+void executeFFTNDSplit(FFTPlanND* plan, const double* inReal, const double* inImag,
+                       double* outReal, double* outImag) {
+    // Axe contigu d'abord : il lit l'entrée et écrit la sortie, les autres travaillent en place
+    int last = plan->rank - 1;
+    transformAxis(plan, last, inReal, inImag, outReal, outImag);
+    for (int a = last - 1; a >= 0; a--) transformAxis(plan, a, outReal, outImag, outReal, outImag);
+}
+
+static void splitBody(void* context, int begin, int end, int worker) {
+    AxisContext* c = (AxisContext*)context;
+    (void)worker;
+    splitComplex(c->input + begin, end - begin, c->dstReal + begin, c->dstImag + begin);
+}
+
+static void interleaveBody(void* context, int begin, int end, int worker) {
+    AxisContext* c = (AxisContext*)context;
+    (void)worker;
+    interleaveComplex(c->srcReal + begin, c->srcImag + begin, end - begin, c->output + begin);
+}
+
+void executeFFTND(FFTPlanND* plan, const ComplexNumber* input, ComplexNumber* output) {
+    if (plan->auxReal == NULL) {
+        plan->auxReal = (double*)malloc(plan->total * sizeof(double));
+        plan->auxImag = (double*)malloc(plan->total * sizeof(double));
+        if (plan->auxReal == NULL || plan->auxImag == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire (FFT multidimensionnelle).\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    AxisContext c = {plan, 0, 0, 1, 1, plan->auxReal, plan->auxImag, plan->auxReal, plan->auxImag, input, output};
+    int grain = 4096;
+    threadPoolParallelFor(plan->pool, 0, (int)plan->total, grain, splitBody, &c);
+    executeFFTNDSplit(plan, plan->auxReal, plan->auxImag, plan->auxReal, plan->auxImag);
+    threadPoolParallelFor(plan->pool, 0, (int)plan->total, grain, interleaveBody, &c);
+}
@@ -0,0 +1,30 @@
+#ifndef FFT_ND_H
+#define FFT_ND_H
+
+#include "fft.h"
+#include "fft_parallel.h"
+#include "thread_pool.h"
+
+// FFT multidimensionnelle (images 2D, volumes 3D) construite sur les plans 1D de fft.c.
+// Les données sont rangées en ordre C : dims[0] est l'axe le plus lent, dims[rank - 1]
+// l'axe contigu. On transforme d'abord les lignes contiguës, puis chaque autre axe par
+// paquets de colonnes : une tuile longueur x FFT_ND_COLUMN_BLOCK est transposée dans un
+// tampon du thread (les colonnes y deviennent contiguës), transformée, puis transposée
+// en retour. Les lignes, plans et paquets de colonnes sont répartis sur le pool.
+// Comme pour fft.c, les transformées ne sont pas normalisées.
+
+#define FFT_ND_MAX_RANK 3
+#define FFT_ND_COLUMN_BLOCK 16   // colonnes par tuile : 128 octets contigus par ligne lue
+
+typedef struct FFTPlanND FFTPlanND;
+
+FFTPlanND* createFFTPlanND(int rank, const int* dims, int direction, ThreadPool* pool);
+// Transformée sur tous les axes ; out peut être confondu avec in
+void executeFFTNDSplit(FFTPlanND* plan, const double* inReal, const double* inImag,
+                       double* outReal, double* outImag);
+void executeFFTND(FFTPlanND* plan, const ComplexNumber* input, ComplexNumber* output);
+// Transformée en place le long du seul axe axis (utile pour une décomposition distribuée)
+void executeFFTAxisSplit(FFTPlanND* plan, int axis, double* real, double* imag);
+void destroyFFTPlanND(FFTPlanND* plan);
+
+#endif
@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "fft_parallel.h"
+
+#define PI 3.14159265358979323846
+#define SPLIT_MIN_SIZE (1 << 12)    // en dessous, le découpage ne peut pas amortir ses deux passes
+#define SPLIT_MIN_FACTOR 16
+#define BLOCK 16                    // colonnes traitées ensemble : 2 lignes de cache par accès
+#define TILE_PAD 8                  // décalage des lignes du tampon : évite les conflits de cache à pas 2^k
+#define CALIBRATION_RUNS 2          // meilleur de ces exécutions pour chaque stratégie
+
+struct ParallelFFTPlan {
+    int N;
+    int direction;
+    ThreadPool* pool;
+    int numThreads;
+
+    // Découpage N = N1 * N2, N1 <= N2 (N1 = 0 si la transformée est exécutée d'un bloc)
+    int N1, N2;
+    FFTPlan** columnPlans;     // un plan de longueur N1 par thread
+    FFTPlan** rowPlans;        // un plan de longueur N2 par thread
+    double* twiddleLowReal;    // w_N^lo, lo < N1
+    double* twiddleLowImag;
+    double* twiddleHighReal;   // w_N^(hi*N1), hi < N2
+    double* twiddleHighImag;
+    double* blockTwiddleReal;  // w_N^(j*k1), j < BLOCK, k1 < N1, rangés par j
+    double* blockTwiddleImag;
+    int tileStride;            // max(N1, N2) + TILE_PAD
+    double* tileReal;          // par thread : BLOCK lignes de tileStride éléments
+    double* tileImag;
+    double* baseReal;          // par thread : w_N^(c0*k1) de la colonne c0 du bloc courant
+    double* baseImag;
+    double* tempReal;          // tampon intermédiaire de N éléments
+    double* tempImag;
+    double* auxReal;           // entrée séparée pour executeParallelFFT (allouée au besoin)
+    double* auxImag;
+
+    FFTPlan** fullPlans;       // un plan de longueur N par thread (lots, petites tailles)
+};
+
+typedef struct {
+    ParallelFFTPlan* plan;
+    const double* srcReal;
+    const double* srcImag;
+    double* dstReal;
+    double* dstImag;
+    const ComplexNumber* input;
+    ComplexNumber* output;
+} ParallelContext;
+
+static int allocateFullPlans(ParallelFFTPlan* plan) {
+    if (plan->fullPlans[0] != NULL) return 1;
+    for (int t = 0; t < plan->numThreads; t++) {
+        plan->fullPlans[t] = createFFTPlan(plan->N, plan->direction);
+        if (plan->fullPlans[t] == NULL) return 0;
+    }
+    return 1;
+}
+
+// Libère le découpage : la transformée repasse par fullPlans[0]
+static void releaseSplit(ParallelFFTPlan* plan) {
+    for (int t = 0; t < plan->numThreads; t++) {
+        if (plan->columnPlans != NULL) destroyFFTPlan(plan->columnPlans[t]);
+        if (plan->rowPlans != NULL) destroyFFTPlan(plan->rowPlans[t]);
+    }
+    free(plan->columnPlans);
+    free(plan->rowPlans);
+    free(plan->twiddleLowReal);
+    free(plan->twiddleLowImag);
+    free(plan->twiddleHighReal);
+    free(plan->twiddleHighImag);
+    free(plan->blockTwiddleReal);
+    free(plan->blockTwiddleImag);
+    free(plan->tileReal);
+    free(plan->tileImag);
+    free(plan->baseReal);
+    free(plan->baseImag);
+    free(plan->tempReal);
+    free(plan->tempImag);
+    free(plan->auxReal);
+    free(plan->auxImag);
+    plan->columnPlans = plan->rowPlans = NULL;
+    plan->twiddleLowReal = plan->twiddleLowImag = plan->twiddleHighReal = plan->twiddleHighImag = NULL;
+    plan->blockTwiddleReal = plan->blockTwiddleImag = NULL;
+    plan->tileReal = plan->tileImag = plan->baseReal = plan->baseImag = NULL;
+    plan->tempReal = plan->tempImag = plan->auxReal = plan->auxImag = NULL;
+    plan->N1 = plan->N2 = 0;
+}
+
+// N1 : plus grand diviseur de N inférieur à sqrt(N), 0 si le découpage n'a pas de sens
+static int chooseN1(int N) {
+    if (N < SPLIT_MIN_SIZE) return 0;
+    for (int d = (int)sqrt((double)N); d >= SPLIT_MIN_FACTOR; d--) {
+        if (N % d == 0) return d;
+    }
+    return 0;
+}
+
+static int allocateSplit(ParallelFFTPlan* plan, int N1) {
+    int N = plan->N, N2 = N / N1, direction = plan->direction;
+    int T = plan->numThreads;
+    plan->N1 = N1;
+    plan->N2 = N2;
+    plan->tileStride = N2 + TILE_PAD;
+    plan->columnPlans = (FFTPlan**)calloc(T, sizeof(FFTPlan*));
+    plan->rowPlans = (FFTPlan**)calloc(T, sizeof(FFTPlan*));
+    plan->twiddleLowReal = (double*)malloc(N1 * sizeof(double));
+    plan->twiddleLowImag = (double*)malloc(N1 * sizeof(double));
+    plan->twiddleHighReal = (double*)malloc(N2 * sizeof(double));
+    plan->twiddleHighImag = (double*)malloc(N2 * sizeof(double));
+    plan->blockTwiddleReal = (double*)malloc((size_t)BLOCK * N1 * sizeof(double));
+    plan->blockTwiddleImag = (double*)malloc((size_t)BLOCK * N1 * sizeof(double));
+    plan->tileReal = (double*)malloc((size_t)T * BLOCK * plan->tileStride * sizeof(double));
+    plan->tileImag = (double*)malloc((size_t)T * BLOCK * plan->tileStride * sizeof(double));
+    plan->baseReal = (double*)malloc((size_t)T * N1 * sizeof(double));
+    plan->baseImag = (double*)malloc((size_t)T * N1 * sizeof(double));
+    plan->tempReal = (double*)malloc((size_t)N * sizeof(double));
+    plan->tempImag = (double*)malloc((size_t)N * sizeof(double));
+    if (plan->columnPlans == NULL || plan->rowPlans == NULL ||
+        plan->twiddleLowReal == NULL || plan->twiddleLowImag == NULL ||
+        plan->twiddleHighReal == NULL || plan->twiddleHighImag == NULL ||
+        plan->blockTwiddleReal == NULL || plan->blockTwiddleImag == NULL ||
+        plan->tileReal == NULL || plan->tileImag == NULL || plan->baseReal == NULL || plan->baseImag == NULL ||
+        plan->tempReal == NULL || plan->tempImag == NULL) return 0;
+    for (int t = 0; t < T; t++) {
+        plan->columnPlans[t] = createFFTPlan(N1, direction);
+        plan->rowPlans[t] = createFFTPlan(N2, direction);
+        if (plan->columnPlans[t] == NULL || plan->rowPlans[t] == NULL) return 0;
+    }
+
+    // w_N^(n2*k1) = w_N^(hi*N1) * w_N^lo avec n2*k1 = hi*N1 + lo : deux tables de
+    // taille N1 et N2 au lieu d'une table de N facteurs
+    for (int lo = 0; lo < N1; lo++) {
+        double angle = direction * 2 * PI * (double)lo / N;
+        plan->twiddleLowReal[lo] = cos(angle);
+        plan->twiddleLowImag[lo] = sin(angle);
+    }
+    for (int hi = 0; hi < N2; hi++) {
+        double angle = direction * 2 * PI * (double)hi / N2;
+        plan->twiddleHighReal[hi] = cos(angle);
+        plan->twiddleHighImag[hi] = sin(angle);
+    }
+    // Colonne c0 + j d'un bloc : w_N^((c0+j)*k1) = w_N^(c0*k1) * w_N^(j*k1), le second
+    // facteur ne dépend pas du bloc
+    for (int j = 0; j < BLOCK; j++) {
+        for (int k1 = 0; k1 < N1; k1++) {
+            double angle = direction * 2 * PI * (double)((long long)j * k1 % N) / N;
+            plan->blockTwiddleReal[(size_t)j * N1 + k1] = cos(angle);
+            plan->blockTwiddleImag[(size_t)j * N1 + k1] = sin(angle);
+        }
+    }
+    return 1;
+}
+
+// Colonnes [c0, c0 + BLOCK[ de la matrice N1 x N2 : copie dans le tampon du thread (une
+// ligne par colonne), FFT de longueur N1, facteurs w_N^(n2*k1), puis recopie en place
+static void columnPassBody(void* context, int begin, int end, int worker) {
+    ParallelContext* c = (ParallelContext*)context;
+    ParallelFFTPlan* plan = c->plan;
+    int N1 = plan->N1, N2 = plan->N2, S = plan->tileStride;
+    double* tr = plan->tileReal + (size_t)worker * BLOCK * S;
+    double* ti = plan->tileImag + (size_t)worker * BLOCK * S;
+    double* br = plan->baseReal + (size_t)worker * N1;
+    double* bi = plan->baseImag + (size_t)worker * N1;
+
+    for (int block = begin; block < end; block++) {
+        int c0 = block * BLOCK;
+        int width = (c0 + BLOCK < N2) ? BLOCK : N2 - c0;
+        for (int n1 = 0; n1 < N1; n1++) {
+            const double* sr = c->srcReal + (size_t)n1 * N2 + c0;
+            const double* si = c->srcImag + (size_t)n1 * N2 + c0;
+            for (int j = 0; j < width; j++) {
+                tr[(size_t)j * S + n1] = sr[j];
+                ti[(size_t)j * S + n1] = si[j];
+            }
+        }
+
+        // w_N^(c0*k1), c0*k1 = hi*N1 + lo avancé de c0 à chaque k1 sans division
+        int stepHigh = c0 / N1, stepLow = c0 % N1;
+        int hi = 0, lo = 0;
+        for (int k1 = 0; k1 < N1; k1++) {
+            br[k1] = plan->twiddleHighReal[hi] * plan->twiddleLowReal[lo] -
+                     plan->twiddleHighImag[hi] * plan->twiddleLowImag[lo];
+            bi[k1] = plan->twiddleHighReal[hi] * plan->twiddleLowImag[lo] +
+                     plan->twiddleHighImag[hi] * plan->twiddleLowReal[lo];
+            lo += stepLow;
+            hi += stepHigh;
+            if (lo >= N1) {
+                lo -= N1;
+                hi++;
+            }
+        }
+
+        for (int j = 0; j < width; j++) {
+            double* rowReal = tr + (size_t)j * S;
+            double* rowImag = ti + (size_t)j * S;
+            const double* wr = plan->blockTwiddleReal + (size_t)j * N1;
+            const double* wi = plan->blockTwiddleImag + (size_t)j * N1;
+            executeFFTSplit(plan->columnPlans[worker], rowReal, rowImag, rowReal, rowImag);
+            // Boucle contiguë sur k1 : vectorisée par le compilateur
+            for (int k1 = 0; k1 < N1; k1++) {
+                double twr = br[k1] * wr[k1] - bi[k1] * wi[k1];
+                double twi = br[k1] * wi[k1] + bi[k1] * wr[k1];
+                double xr = rowReal[k1], xi = rowImag[k1];
+                rowReal[k1] = xr * twr - xi * twi;
+                rowImag[k1] = xr * twi + xi * twr;
+            }
+        }
+
+        for (int k1 = 0; k1 < N1; k1++) {
+            double* dr = c->dstReal + (size_t)k1 * N2 + c0;
+            double* di = c->dstImag + (size_t)k1 * N2 + c0;
+            for (int j = 0; j < width; j++) {
+                dr[j] = tr[(size_t)j * S + k1];
+                di[j] = ti[(size_t)j * S + k1];
+            }
+        }
+    }
+}
+
+// Lignes [r0, r0 + BLOCK[ de longueur N2 : FFT vers le tampon du thread, puis écriture
+// transposée X[k1 + N1*k2], BLOCK valeurs contiguës par ligne de sortie
+static void rowPassBody(void* context, int begin, int end, int worker) {
+    ParallelContext* c = (ParallelContext*)context;
+    ParallelFFTPlan* plan = c->plan;
+    int N1 = plan->N1, N2 = plan->N2, S = plan->tileStride;
+    double* tr = plan->tileReal + (size_t)worker * BLOCK * S;
+    double* ti = plan->tileImag + (size_t)worker * BLOCK * S;
+
+    for (int block = begin; block < end; block++) {
+        int r0 = block * BLOCK;
+        int width = (r0 + BLOCK < N1) ? BLOCK : N1 - r0;
+        for (int j = 0; j < width; j++) {
+            executeFFTSplit(plan->rowPlans[worker], c->srcReal + (size_t)(r0 + j) * N2,
+                            c->srcImag + (size_t)(r0 + j) * N2, tr + (size_t)j * S, ti + (size_t)j * S);
+        }
+        for (int k2 = 0; k2 < N2; k2++) {
+            double* dr = c->dstReal + (size_t)k2 * N1 + r0;
+            double* di = c->dstImag + (size_t)k2 * N1 + r0;
+            for (int j = 0; j < width; j++) {
+                dr[j] = tr[(size_t)j * S + k2];
+                di[j] = ti[(size_t)j * S + k2];
+            }
+        }
+    }
+}
+
+// x[n1*N2 + n2] vu comme une matrice N1 x N2 : FFT des colonnes (avec les facteurs) de in
+// vers temp, puis FFT des lignes de temp écrites transposées dans out. in peut être égal à out.
+static void executeSplitPasses(ParallelFFTPlan* plan, const double* inReal, const double* inImag,
+                               double* outReal, double* outImag) {
+    ParallelContext c1 = {plan, inReal, inImag, plan->tempReal, plan->tempImag, NULL, NULL};
+    threadPoolParallelFor(plan->pool, 0, (plan->N2 + BLOCK - 1) / BLOCK, 1, columnPassBody, &c1);
+    ParallelContext c2 = {plan, plan->tempReal, plan->tempImag, outReal, outImag, NULL, NULL};
+    threadPoolParallelFor(plan->pool, 0, (plan->N1 + BLOCK - 1) / BLOCK, 1, rowPassBody, &c2);
+}
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Meilleur temps de CALIBRATION_RUNS transformées (découpées ou d'un bloc) sur real/imag
+static double calibrate(ParallelFFTPlan* plan, int split, double* real, double* imag) {
+    double best = 0;
+    for (int r = 0; r < CALIBRATION_RUNS; r++) {
+        double start = now();
+        if (split) executeSplitPasses(plan, real, imag, real, imag);
+        else executeFFTSplit(plan->fullPlans[0], real, imag, real, imag);
+        double t = now() - start;
+        if (r == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+ParallelFFTPlan* createParallelFFTPlanStrategy(int N, int direction, ThreadPool* pool, ParallelFFTStrategy strategy) {
+    ParallelFFTPlan* plan = (ParallelFFTPlan*)calloc(1, sizeof(ParallelFFTPlan));
+    if (plan == NULL) return NULL;
+    plan->N = N;
+    plan->direction = direction;
+    plan->pool = pool;
+    plan->numThreads = threadPoolSize(pool);
+    plan->fullPlans = (FFTPlan**)calloc(plan->numThreads, sizeof(FFTPlan*));
+    if (plan->fullPlans == NULL || !allocateFullPlans(plan)) {
+        destroyParallelFFTPlan(plan);
+        return NULL;
+    }
+
+    int N1 = strategy == FFT_STRATEGY_SEQUENTIAL ? 0 : chooseN1(N);
+    if (N1 == 0) return plan;
+    if (!allocateSplit(plan, N1)) {
+        destroyParallelFFTPlan(plan);
+        return NULL;
+    }
+    if (strategy == FFT_STRATEGY_SPLIT) return plan;
+
+    // Le découpage n'est gardé que s'il bat le plan d'un bloc avec les threads réels du pool
+    double* real = (double*)calloc((size_t)2 * N, sizeof(double));
+    if (real == NULL) {
+        releaseSplit(plan);
+        return plan;
+    }
+    double* imag = real + N;
+    for (int i = 0; i < N; i++) real[i] = sin(0.37 * i);
+    double timeFull = calibrate(plan, 0, real, imag);
+    double timeSplit = calibrate(plan, 1, real, imag);
+    free(real);
+    if (timeSplit >= timeFull) releaseSplit(plan);
+    return plan;
+}
+
+ParallelFFTPlan* createParallelFFTPlan(int N, int direction, ThreadPool* pool) {
+    return createParallelFFTPlanStrategy(N, direction, pool, FFT_STRATEGY_AUTO);
+}
+
+int parallelFFTIsSplit(const ParallelFFTPlan* plan) {
+    return plan->N1 > 0;
+}
+
+void destroyParallelFFTPlan(ParallelFFTPlan* plan) {
+    if (plan == NULL) return;
+    releaseSplit(plan);
+    for (int t = 0; t < plan->numThreads; t++) {
+        if (plan->fullPlans != NULL) destroyFFTPlan(plan->fullPlans[t]);
+    }
+    free(plan->fullPlans);
+    free(plan);
+}
+
+void executeParallelFFTSplit(ParallelFFTPlan* plan, const double* inReal, const double* inImag,
+                             double* outReal, double* outImag) {
+    if (plan->N1 == 0) {
+        executeFFTSplit(plan->fullPlans[0], inReal, inImag, outReal, outImag);
+        return;
+    }
+    executeSplitPasses(plan, inReal, inImag, outReal, outImag);
+}
+
+static void splitBody(void* context, int begin, int end, int worker) {
+    ParallelContext* c = (ParallelContext*)context;
+    (void)worker;
+    splitComplex(c->input + begin, end - begin, c->dstReal + begin, c->dstImag + begin);
+}
+
+static void interleaveBody(void* context, int begin, int end, int worker) {
+    ParallelContext* c = (ParallelContext*)context;
+    (void)worker;
+    interleaveComplex(c->srcReal + begin, c->srcImag + begin, end - begin, c->output + begin);
+}
+
+void executeParallelFFT(ParallelFFTPlan* plan, const ComplexNumber* input, ComplexNumber* output) {
+    if (plan->N1 == 0) {
+        executeFFT(plan->fullPlans[0], input, output);
+        return;
+    }
+    if (plan->auxReal == NULL) {
+        plan->auxReal = (double*)malloc((size_t)plan->N * sizeof(double));
+        plan->auxImag = (double*)malloc((size_t)plan->N * sizeof(double));
+        if (plan->auxReal == NULL || plan->auxImag == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire (FFT parallèle).\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ParallelContext c = {plan, plan->auxReal, plan->auxImag, plan->auxReal, plan->auxImag, input, output};
+    int grain = 4096;
+    threadPoolParallelFor(plan->pool, 0, plan->N, grain, splitBody, &c);
+    executeSplitPasses(plan, plan->auxReal, plan->auxImag, plan->auxReal, plan->auxImag);
+    threadPoolParallelFor(plan->pool, 0, plan->N, grain, interleaveBody, &c);
+}
+
+static void batchBody(void* context, int begin, int end, int worker) {
+    ParallelContext* c = (ParallelContext*)context;
+    int N = c->plan->N;
+    for (int i = begin; i < end; i++) {
+        executeFFT(c->plan->fullPlans[worker], c->input + (size_t)i * N, c->output + (size_t)i * N);
+    }
+}
+
+void executeFFTBatch(ParallelFFTPlan* plan, int count, const ComplexNumber* input, ComplexNumber* output) {
+    ParallelContext c = {plan, NULL, NULL, NULL, NULL, input, output};
+    threadPoolParallelFor(plan->pool, 0, count, 1, batchBody, &c);
+}
@@ -0,0 +1,37 @@
+#ifndef FFT_PARALLEL_H
+#define FFT_PARALLEL_H
+
+#include "fft.h"
+#include "thread_pool.h"
+
+// FFT multithreadée sur un pool à vol de tâches.
+//  - Une grande transformée N = N1 * N2 est découpée en deux passes réparties par blocs
+//    de 16 colonnes (ou lignes) sur le pool : N2 FFT de longueur N1 multipliées par
+//    w_N^(n2*k1) dans le même parcours, puis N1 FFT de longueur N2 écrites transposées.
+//    Les blocs passent par un tampon propre à chaque thread, sans transposition séparée.
+//  - En mode automatique, le découpage est chronométré à la création contre le plan
+//    séquentiel d'un bloc et n'est gardé que s'il est plus rapide avec le pool donné.
+//  - executeFFTBatch transforme de nombreux signaux indépendants en parallèle.
+// Chaque thread utilise ses propres plans : un même ParallelFFTPlan ne doit être
+// exécuté que par un appelant à la fois.
+
+typedef struct ParallelFFTPlan ParallelFFTPlan;
+
+typedef enum {
+    FFT_STRATEGY_AUTO,        // le plus rapide des deux, mesuré à la création
+    FFT_STRATEGY_SEQUENTIAL,  // plan d'un bloc (createFFTPlan) exécuté par l'appelant
+    FFT_STRATEGY_SPLIT        // découpage N1 * N2 dès que N le permet
+} ParallelFFTStrategy;
+
+ParallelFFTPlan* createParallelFFTPlan(int N, int direction, ThreadPool* pool);
+ParallelFFTPlan* createParallelFFTPlanStrategy(int N, int direction, ThreadPool* pool, ParallelFFTStrategy strategy);
+// 1 si la transformée est découpée sur le pool, 0 si elle passe par le plan séquentiel
+int parallelFFTIsSplit(const ParallelFFTPlan* plan);
+void executeParallelFFT(ParallelFFTPlan* plan, const ComplexNumber* input, ComplexNumber* output);
+void executeParallelFFTSplit(ParallelFFTPlan* plan, const double* inReal, const double* inImag,
+                             double* outReal, double* outImag);
+// count signaux de longueur N rangés les uns après les autres
+void executeFFTBatch(ParallelFFTPlan* plan, int count, const ComplexNumber* input, ComplexNumber* output);
+void destroyParallelFFTPlan(ParallelFFTPlan* plan);
+
+#endif
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <math.h>
+#include "fft_real.h"
+
+#define PI 3.14159265358979323846
+
+struct RealFFTPlan {
+    int N;
+    int M;                // N/2 si N est pair, N sinon
+    FFTPlan* forward;     // plans complexes de longueur M
+    FFTPlan* inverse;
+    double* twiddleReal;  // w_N^k = exp(-2*pi*i*k/N), k <= M/2 (N pair)
+    double* twiddleImag;
+    double* workReal;     // M éléments
+    double* workImag;
+};
+
+RealFFTPlan* createRealFFTPlan(int N) {
+    if (N < 1) return NULL;
+    RealFFTPlan* plan = (RealFFTPlan*)calloc(1, sizeof(RealFFTPlan));
+    if (plan == NULL) return NULL;
+    plan->N = N;
+    plan->M = (N % 2 == 0) ? N / 2 : N;
+    int M = plan->M;
+
+    plan->forward = createFFTPlan(M, FFT_FORWARD);
+    plan->inverse = createFFTPlan(M, FFT_INVERSE);
+    plan->workReal = (double*)malloc(M * sizeof(double));
+    plan->workImag = (double*)malloc(M * sizeof(double));
+    if (plan->forward == NULL || plan->inverse == NULL ||
+        plan->workReal == NULL || plan->workImag == NULL) {
+        destroyRealFFTPlan(plan);
+        return NULL;
+    }
+
+    if (M != N) {
+        plan->twiddleReal = (double*)malloc((M / 2 + 1) * sizeof(double));
+        plan->twiddleImag = (double*)malloc((M / 2 + 1) * sizeof(double));
+        if (plan->twiddleReal == NULL || plan->twiddleImag == NULL) {
+            destroyRealFFTPlan(plan);
+            return NULL;
+        }
+        for (int k = 0; k <= M / 2; k++) {
+            double angle = -2 * PI * (double)k / N;
+            plan->twiddleReal[k] = cos(angle);
+            plan->twiddleImag[k] = sin(angle);
+        }
+    }
+    return plan;
+}
+
+void destroyRealFFTPlan(RealFFTPlan* plan) {
+    if (plan == NULL) return;
+    destroyFFTPlan(plan->forward);
+    destroyFFTPlan(plan->inverse);
+    free(plan->twiddleReal);
+    free(plan->twiddleImag);
+    free(plan->workReal);
+    free(plan->workImag);
+    free(plan);
+}
+
+void executeRealFFT(const RealFFTPlan* plan, const double* input, ComplexNumber* output) {
+    int N = plan->N, M = plan->M;
+    double* zr = plan->workReal;
+    double* zi = plan->workImag;
+
+    if (M == N) {
+        for (int n = 0; n < N; n++) {
+            zr[n] = input[n];
+            zi[n] = 0;
+        }
+        executeFFTSplit(plan->forward, zr, zi, zr, zi);
+        interleaveComplex(zr, zi, N / 2 + 1, output);
+        return;
+    }
+
+    // z[n] = x[2n] + i x[2n+1], Z = FFT_M(z)
+    for (int n = 0; n < M; n++) {
+        zr[n] = input[2 * n];
+        zi[n] = input[2 * n + 1];
+    }
+    executeFFTSplit(plan->forward, zr, zi, zr, zi);
+
+    // Spectres des échantillons pairs E[k] = (Z[k] + conj(Z[M-k])) / 2 et impairs
+    // O[k] = (Z[k] - conj(Z[M-k])) / 2i, puis X[k] = E[k] + w_N^k O[k].
+    // Avec t = w_N^k O[k] et w_N^(M-k) = -conj(w_N^k) : X[M-k] = conj(E[k] - t),
+    // chaque paire (k, M-k) est donc calculée à partir des mêmes deux valeurs de Z.
+    output[0].real = zr[0] + zi[0];
+    output[0].imag = 0;
+    output[M].real = zr[0] - zi[0];
+    output[M].imag = 0;
+    for (int k = 1; k <= M / 2; k++) {
+        int j = M - k;
+        double evenReal = 0.5 * (zr[k] + zr[j]);
+        double evenImag = 0.5 * (zi[k] - zi[j]);
+        double oddReal = 0.5 * (zi[k] + zi[j]);
+        double oddImag = -0.5 * (zr[k] - zr[j]);
+        double wr = plan->twiddleReal[k], wi = plan->twiddleImag[k];
+        double tr = wr * oddReal - wi * oddImag;
+        double ti = wr * oddImag + wi * oddReal;
+        output[k].real = evenReal + tr;
+        output[k].imag = evenImag + ti;
+        output[j].real = evenReal - tr;
+        output[j].imag = ti - evenImag;
+    }
+}
+
+void executeInverseRealFFT(const RealFFTPlan* plan, const ComplexNumber* input, double* output) {
+    int N = plan->N, M = plan->M;
+    double* zr = plan->workReal;
+    double* zi = plan->workImag;
+
+    if (M == N) {
+        // Spectre complet reconstruit par symétrie hermitienne
+        for (int k = 0; k <= N / 2; k++) {
+            zr[k] = input[k].real;
+            zi[k] = input[k].imag;
+        }
+        for (int k = N / 2 + 1; k < N; k++) {
+            zr[k] = input[N - k].real;
+            zi[k] = -input[N - k].imag;
+        }
+        executeFFTSplit(plan->inverse, zr, zi, zr, zi);
+        for (int n = 0; n < N; n++) output[n] = zr[n];
+        return;
+    }
+
+    // Z[k] = 2E[k] + 2i O[k] avec S = 2E[k] = X[k] + conj(X[M-k]) et
+    // T = 2O[k] = (X[k] - conj(X[M-k])) conj(w_N^k) ; par symétrie Z[M-k] = conj(S) + i conj(T).
+    // La FFT inverse de longueur M redonne M * 2 * (x[2n] + i x[2n+1]) = N * z[n]
+    zr[0] = input[0].real + input[M].real - (input[0].imag + input[M].imag);
+    zi[0] = input[0].imag - input[M].imag + (input[0].real - input[M].real);
+    for (int k = 1; k <= M / 2; k++) {
+        int j = M - k;
+        double sr = input[k].real + input[j].real, si = input[k].imag - input[j].imag;
+        double dr = input[k].real - input[j].real, di = input[k].imag + input[j].imag;
+        double wr = plan->twiddleReal[k], wi = -plan->twiddleImag[k];
+        double tr = dr * wr - di * wi;
+        double ti = dr * wi + di * wr;
+        zr[k] = sr - ti;
+        zi[k] = si + tr;
+        zr[j] = sr + ti;
+        zi[j] = tr - si;
+    }
+    executeFFTSplit(plan->inverse, zr, zi, zr, zi);
+    for (int n = 0; n < M; n++) {
+        output[2 * n] = zr[n];
+        output[2 * n + 1] = zi[n];
+    }
+}
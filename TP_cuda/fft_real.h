@@ -0,0 +1,24 @@
+#ifndef FFT_REAL_H
+#define FFT_REAL_H
+
+#include "fft.h"
+
+// FFT d'un signal réel : le spectre est hermitien (X[N-k] = conj(X[k])), seuls les
+// N/2+1 premiers coefficients sont calculés et stockés.
+// Pour N pair, les échantillons pairs et impairs sont rangés comme parties réelle et
+// imaginaire d'un signal complexe de longueur N/2, transformé par un plan complexe
+// ordinaire puis séparé : environ deux fois moins de calcul et de mémoire que la FFT
+// complexe. Une longueur impaire passe par un plan complexe de longueur N.
+// Comme pour fft.h, les transformées ne sont pas normalisées et un plan ne doit pas
+// être exécuté par plusieurs threads en même temps.
+
+typedef struct RealFFTPlan RealFFTPlan;
+
+RealFFTPlan* createRealFFTPlan(int N);
+// input : N réels, output : N/2+1 coefficients
+void executeRealFFT(const RealFFTPlan* plan, const double* input, ComplexNumber* output);
+// input : N/2+1 coefficients, output : N réels multipliés par N
+void executeInverseRealFFT(const RealFFTPlan* plan, const ComplexNumber* input, double* output);
+void destroyRealFFTPlan(RealFFTPlan* plan);
+
+#endif
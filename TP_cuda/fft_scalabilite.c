@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include "fft_parallel.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define MIN_LOG2 10
+#define DEFAULT_MAX_LOG2 26
+#define MIN_BENCH_TIME 0.2     // durée minimale de mesure par point (secondes)
+#define BATCH_ELEMENTS (1 << 22) // nombre total d'échantillons d'un lot
+
+double relativeError(const ComplexNumber* ref, const ComplexNumber* x, int N) {
+    double maxErr = 0, maxRef = 0;
+    for (int k = 0; k < N; k++) {
+        double err = hypot(ref[k].real - x[k].real, ref[k].imag - x[k].imag);
+        double mag = hypot(ref[k].real, ref[k].imag);
+        if (err > maxErr) maxErr = err;
+        if (mag > maxRef) maxRef = mag;
+    }
+    return maxRef > 0 ? maxErr / maxRef : maxErr;
+}
+
+void fillSignal(ComplexNumber* signal, int N) {
+    for (int i = 0; i < N; i++) {
+        signal[i].real = sin(0.37 * i) + 0.25 * cos(1.3 * (double)i * i / N);
+        signal[i].imag = cos(0.11 * i) - 0.5;
+    }
+}
+
+// Compare la FFT parallèle découpée (entrelacée, SoA hors place et en place) au plan
+// séquentiel ; le découpage est imposé pour être vérifié même là où il n'est pas retenu
+int checkLength(ThreadPool* pool, int N) {
+    ComplexNumber* signal = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* ref = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* result = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    double* real = (double*)malloc(N * sizeof(double));
+    double* imag = (double*)malloc(N * sizeof(double));
+    double* outReal = (double*)malloc(N * sizeof(double));
+    double* outImag = (double*)malloc(N * sizeof(double));
+    FFTPlan* sequential = createFFTPlan(N, FFT_FORWARD);
+    ParallelFFTPlan* plan = createParallelFFTPlanStrategy(N, FFT_FORWARD, pool, FFT_STRATEGY_SPLIT);
+
+    fillSignal(signal, N);
+    executeFFT(sequential, signal, ref);
+
+    executeParallelFFT(plan, signal, result);
+    double errInterleaved = relativeError(ref, result, N);
+
+    splitComplex(signal, N, real, imag);
+    executeParallelFFTSplit(plan, real, imag, outReal, outImag);
+    interleaveComplex(outReal, outImag, N, result);
+    double errSplit = relativeError(ref, result, N);
+
+    executeParallelFFTSplit(plan, real, imag, real, imag);
+    interleaveComplex(real, imag, N, result);
+    double errInPlace = relativeError(ref, result, N);
+
+    int ok = errInterleaved < 1e-9 && errSplit < 1e-9 && errInPlace < 1e-9;
+    printf("N = %8d (%s) : entrelacé = %.2e, SoA = %.2e, en place = %.2e %s\n",
+           N, parallelFFTIsSplit(plan) ? "découpée" : "d'un bloc", errInterleaved, errSplit, errInPlace, ok ? "OK" : "ECHEC");
+
+    destroyParallelFFTPlan(plan);
+    destroyFFTPlan(sequential);
+    free(signal);
+    free(ref);
+    free(result);
+    free(real);
+    free(imag);
+    free(outReal);
+    free(outImag);
+    return ok;
+}
+
+// Les mesures passent par une région d'un emplacement, celui du thread appelant : le temps
+// couvre toute la transformée, les compteurs seulement la part exécutée par l'appelant. Le
+// travail déclaré pour une répétition est flops opérations et bytes octets (entrée et sortie).
+
+// Temps moyen d'une transformée SoA de longueur N sur le pool ; *split indique si le plan
+// automatique a retenu le découpage
+double benchTransform(ThreadPool* pool, int N, double* real, double* imag, double* outReal, double* outImag,
+                      int* split, perf_region* region, double flops, double bytes) {
+    ParallelFFTPlan* plan = createParallelFFTPlan(N, FFT_FORWARD, pool);
+    if (plan == NULL) return -1;
+    *split = parallelFFTIsSplit(plan);
+    executeParallelFFTSplit(plan, real, imag, outReal, outImag);
+
+    int repetitions = 0;
+    while (perf_region_seconds(region) < MIN_BENCH_TIME) {
+        perf_region_begin(region, 0);
+        executeParallelFFTSplit(plan, real, imag, outReal, outImag);
+        perf_region_end(region, 0);
+        repetitions++;
+    }
+    destroyParallelFFTPlan(plan);
+    perf_region_add_work(region, repetitions * flops, repetitions * bytes);
+    return perf_region_seconds(region) / repetitions;
+}
+
+// Temps moyen du plan séquentiel createFFTPlan, référence des accélérations
+double benchSequential(int N, double* real, double* imag, double* outReal, double* outImag,
+                       perf_region* region, double flops, double bytes) {
+    FFTPlan* plan = createFFTPlan(N, FFT_FORWARD);
+    if (plan == NULL) return -1;
+    executeFFTSplit(plan, real, imag, outReal, outImag);
+
+    int repetitions = 0;
+    while (perf_region_seconds(region) < MIN_BENCH_TIME) {
+        perf_region_begin(region, 0);
+        executeFFTSplit(plan, real, imag, outReal, outImag);
+        perf_region_end(region, 0);
+        repetitions++;
+    }
+    destroyFFTPlan(plan);
+    perf_region_add_work(region, repetitions * flops, repetitions * bytes);
+    return perf_region_seconds(region) / repetitions;
+}
+
+// Temps moyen d'un lot de count signaux de longueur N
+double benchBatch(ThreadPool* pool, int N, int count, const ComplexNumber* input, ComplexNumber* output,
+                  perf_region* region, double flops, double bytes) {
+    ParallelFFTPlan* plan = createParallelFFTPlan(N, FFT_FORWARD, pool);
+    if (plan == NULL) return -1;
+    executeFFTBatch(plan, count, input, output);
+
+    int repetitions = 0;
+    while (perf_region_seconds(region) < MIN_BENCH_TIME) {
+        perf_region_begin(region, 0);
+        executeFFTBatch(plan, count, input, output);
+        perf_region_end(region, 0);
+        repetitions++;
+    }
+    destroyParallelFFTPlan(plan);
+    perf_region_add_work(region, repetitions * flops, repetitions * bytes);
+    return perf_region_seconds(region) / repetitions;
+}
+
+// Nombres de threads mesurés : puissances de deux jusqu'au nombre de coeurs, puis ce nombre
+int threadCounts(int cores, int* counts) {
+    int n = 0;
+    for (int t = 1; t < cores; t *= 2) counts[n++] = t;
+    counts[n++] = cores;
+    return n;
+}
+
+// Usage : ./fft_scalabilite [log2 N max] [threads max]
+int main(int argc, char* argv[]) {
+    int maxLog2 = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_LOG2;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int cores = argc > 2 ? atoi(argv[2]) : (online > 0 ? (int)online : 1);
+    if (maxLog2 < MIN_LOG2 || maxLog2 > 28 || cores < 1) {
+        printf("Usage : %s [log2 N max (%d..28)] [threads max]\n", argv[0], MIN_LOG2);
+        return 1;
+    }
+
+    printf("Vérification de la FFT parallèle contre le plan séquentiel (%d threads, %s) :\n",
+           cores, fftSimdName());
+    ThreadPool* pool = createThreadPool(cores);
+    if (pool == NULL) {
+        printf("Erreur de création du pool de threads.\n");
+        return 1;
+    }
+    int lengths[] = {1000, 1 << 14, 3 * 5 * 7 * 11 * 13 * 2, 1 << 16, 100000, 1 << 18};
+    int allOk = 1;
+    for (int i = 0; i < (int)(sizeof(lengths) / sizeof(lengths[0])); i++) {
+        allOk &= checkLength(pool, lengths[i]);
+    }
+    destroyThreadPool(pool);
+
+    int maxN = 1 << maxLog2;
+    double* real = (double*)malloc((size_t)maxN * sizeof(double));
+    double* imag = (double*)malloc((size_t)maxN * sizeof(double));
+    double* outReal = (double*)malloc((size_t)maxN * sizeof(double));
+    double* outImag = (double*)malloc((size_t)maxN * sizeof(double));
+    ComplexNumber* batchIn = (ComplexNumber*)malloc(BATCH_ELEMENTS * sizeof(ComplexNumber));
+    ComplexNumber* batchOut = (ComplexNumber*)malloc(BATCH_ELEMENTS * sizeof(ComplexNumber));
+    if (real == NULL || imag == NULL || outReal == NULL || outImag == NULL ||
+        batchIn == NULL || batchOut == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+    for (int i = 0; i < maxN; i++) {
+        real[i] = sin(0.37 * i);
+        imag[i] = cos(0.11 * i) - 0.5;
+    }
+    fillSignal(batchIn, BATCH_ELEMENTS);
+
+    int counts[64];
+    int numCounts = threadCounts(cores, counts);
+
+    // Une transformée de longueur N, GFLOP/s selon la convention 5 N log2(N). L'accélération
+    // est rapportée au plan séquentiel createFFTPlan, pas au plan parallèle sur 1 thread :
+    // D = découpage retenu par le plan automatique, S = repli sur le plan séquentiel
+    printf("\nTransformée unique : temps (ms), GFLOP/s et accélération sur le plan séquentiel\n");
+    printf("%10s | %23s", "N", "séquentiel");
+    for (int c = 0; c < numCounts; c++) printf(" | %26d thr", counts[c]);
+    printf("\n");
+    // Le rapport détaillé (compteurs, roofline) n'est affiché que pour la plus grande longueur
+    // et le plus grand nombre de threads, après les tableaux
+    perf_region* largest[3] = {NULL, NULL, NULL};
+    for (int e = MIN_LOG2; e <= maxLog2; e++) {
+        int N = 1 << e;
+        double flops = 5.0 * N * e;
+        double bytes = 4.0 * N * sizeof(double);
+        perf_region* region = perf_region_create("FFT séquentielle", 1);
+        double base = benchSequential(N, real, imag, outReal, outImag, region, flops, bytes);
+        if (e == maxLog2) largest[0] = region;
+        else perf_region_free(region);
+        printf("%10d | %9.3f ms %6.2f GF", N, base * 1e3, flops / base / 1e9);
+        for (int c = 0; c < numCounts; c++) {
+            ThreadPool* p = createThreadPool(counts[c]);
+            int split = 0;
+            region = perf_region_create("FFT parallèle", 1);
+            double t = benchTransform(p, N, real, imag, outReal, outImag, &split, region, flops, bytes);
+            if (e == maxLog2 && c == numCounts - 1) largest[1] = region;
+            else perf_region_free(region);
+            destroyThreadPool(p);
+            printf(" | %9.3f ms %6.2f GF x%4.2f %c", t * 1e3, flops / t / 1e9, base / t, split ? 'D' : 'S');
+        }
+        printf("\n");
+    }
+
+    // Lots de signaux indépendants, BATCH_ELEMENTS échantillons au total
+    printf("\nLots (%d échantillons) : temps (ms) et accélération par nombre de threads\n", BATCH_ELEMENTS);
+    int lastBatchLog2 = maxLog2 < 16 ? maxLog2 - (maxLog2 - MIN_LOG2) % 2 : 16;
+    for (int e = MIN_LOG2; e <= lastBatchLog2; e += 2) {
+        int N = 1 << e;
+        int count = BATCH_ELEMENTS / N;
+        double base = 0;
+        printf("%5d x %6d", count, N);
+        for (int c = 0; c < numCounts; c++) {
+            ThreadPool* p = createThreadPool(counts[c]);
+            perf_region* region = perf_region_create("FFT par lots", 1);
+            double t = benchBatch(p, N, count, batchIn, batchOut, region, 5.0 * count * N * e,
+                                  2.0 * count * N * sizeof(ComplexNumber));
+            if (e == lastBatchLog2 && c == numCounts - 1) largest[2] = region;
+            else perf_region_free(region);
+            destroyThreadPool(p);
+            if (c == 0) base = t;
+            printf(" | %3d thr %8.3f ms x%4.2f", counts[c], t * 1e3, base / t);
+        }
+        printf("\n");
+    }
+    printf("\n");
+    for (int i = 0; i < 3; i++) {
+        perf_region_report(largest[i], stdout);
+        perf_region_free(largest[i]);
+    }
+
+    free(real);
+    free(imag);
+    free(outReal);
+    free(outImag);
+    free(batchIn);
+    free(batchOut);
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fft.h"
+#include "fft_real.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define PI 3.14159265358979323846
+#define REPETITIONS_FFT 100
+
+// DFT directe O(N^2) de sequentiel.c, conservée comme référence
+void computeDFT(ComplexNumber* signal, int N, ComplexNumber* result) {
+    for (int k = 0; k < N; k++) {
+        result[k].real = 0;
+        result[k].imag = 0;
+
+        for (int n = 0; n < N; n++) {
+            double angle = 2 * PI * k * n / N;
+            double c = cos(angle), s = -sin(angle);
+            result[k].real += signal[n].real * c - signal[n].imag * s;
+            result[k].imag += signal[n].real * s + signal[n].imag * c;
+        }
+    }
+}
+
+// Région d'un noyau exécuté repetitions fois sur N points : modèle FFT de 5 N log2 N
+// opérations (8 N² pour la DFT directe), entrée lue et sortie écrite une fois par passage
+perf_region* kernelRegion(const char* name, int N, int repetitions, double flops, size_t pointBytes) {
+    perf_region* region = perf_region_create(name, 1);
+    perf_region_add_work(region, repetitions * flops, 2.0 * repetitions * N * pointBytes);
+    return region;
+}
+
+// Écart max entre deux spectres, relatif à la plus grande magnitude de référence
+double relativeError(const ComplexNumber* ref, const ComplexNumber* x, int N) {
+    double maxErr = 0, maxRef = 0;
+    for (int k = 0; k < N; k++) {
+        double err = hypot(ref[k].real - x[k].real, ref[k].imag - x[k].imag);
+        double mag = hypot(ref[k].real, ref[k].imag);
+        if (err > maxErr) maxErr = err;
+        if (mag > maxRef) maxRef = mag;
+    }
+    return maxRef > 0 ? maxErr / maxRef : maxErr;
+}
+
+void fillSignal(ComplexNumber* signal, int N) {
+    for (int i = 0; i < N; i++) {
+        signal[i].real = sin(2 * PI * 50 * i / N);
+        signal[i].imag = cos(2 * PI * 120 * i / N);
+    }
+}
+
+// Compare la FFT à la DFT directe pour une longueur donnée (y compris l'aller-retour inverse)
+int checkLength(int N) {
+    ComplexNumber* signal = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* ref = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* result = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    FFTPlan* forward = createFFTPlan(N, FFT_FORWARD);
+    FFTPlan* inverse = createFFTPlan(N, FFT_INVERSE);
+
+    for (int i = 0; i < N; i++) {
+        signal[i].real = sin(0.37 * i) + 0.25 * cos(1.3 * i * i / N);
+        signal[i].imag = cos(0.11 * i) - 0.5;
+    }
+    computeDFT(signal, N, ref);
+    executeFFT(forward, signal, result);
+    double errForward = relativeError(ref, result, N);
+
+    executeFFT(inverse, result, result);
+    for (int i = 0; i < N; i++) {
+        result[i].real /= N;
+        result[i].imag /= N;
+    }
+    double errInverse = relativeError(signal, result, N);
+
+    // Chemin SoA, en place
+    double* real = (double*)malloc(N * sizeof(double));
+    double* imag = (double*)malloc(N * sizeof(double));
+    splitComplex(signal, N, real, imag);
+    executeFFTSplit(forward, real, imag, real, imag);
+    interleaveComplex(real, imag, N, result);
+    double errSplit = relativeError(ref, result, N);
+    free(real);
+    free(imag);
+
+    // Plan simple précision obtenu via le cache
+    ComplexFloat* signalFloat = (ComplexFloat*)malloc(N * sizeof(ComplexFloat));
+    for (int i = 0; i < N; i++) {
+        signalFloat[i].real = (float)signal[i].real;
+        signalFloat[i].imag = (float)signal[i].imag;
+    }
+    executeFFTFloat(getFFTPlan(N, FFT_FORWARD, FFT_FLOAT), signalFloat, signalFloat);
+    for (int i = 0; i < N; i++) {
+        result[i].real = signalFloat[i].real;
+        result[i].imag = signalFloat[i].imag;
+    }
+    double errFloat = relativeError(ref, result, N);
+    free(signalFloat);
+
+    // Signal réel : N/2+1 coefficients comparés à la DFT directe, puis aller-retour
+    RealFFTPlan* realPlan = createRealFFTPlan(N);
+    double* realSignal = (double*)malloc(N * sizeof(double));
+    for (int i = 0; i < N; i++) {
+        signal[i].imag = 0;
+        realSignal[i] = signal[i].real;
+    }
+    computeDFT(signal, N, ref);
+    executeRealFFT(realPlan, realSignal, result);
+    double errReal = relativeError(ref, result, N / 2 + 1);
+    executeInverseRealFFT(realPlan, result, realSignal);
+    double errRealInverse = 0;
+    for (int i = 0; i < N; i++) {
+        double err = fabs(realSignal[i] / N - signal[i].real);
+        if (err > errRealInverse) errRealInverse = err;
+    }
+    destroyRealFFTPlan(realPlan);
+    free(realSignal);
+
+    int ok = errForward < 1e-9 && errInverse < 1e-9 && errSplit < 1e-9 && errFloat < 1e-4 &&
+             errReal < 1e-9 && errRealInverse < 1e-9;
+    printf("N = %6d : erreur directe = %.2e, aller-retour = %.2e, SoA = %.2e, float = %.2e, "
+           "réel = %.2e / %.2e %s\n",
+           N, errForward, errInverse, errSplit, errFloat, errReal, errRealInverse, ok ? "OK" : "ECHEC");
+
+    destroyFFTPlan(forward);
+    destroyFFTPlan(inverse);
+    free(signal);
+    free(ref);
+    free(result);
+    return ok;
+}
+
+int main() {
+    int N = 10240;
+    ComplexNumber* signal = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* reference = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    ComplexNumber* result = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+
+    if (signal == NULL || reference == NULL || result == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+
+    printf("Vérification de la FFT contre la DFT directe :\n");
+    int lengths[] = {1, 2, 8, 12, 60, 97, 240, 1000, 1024, 1155, 2310, 4096, 4099, 7919};
+    int allOk = 1;
+    for (int i = 0; i < (int)(sizeof(lengths) / sizeof(lengths[0])); i++) {
+        allOk &= checkLength(lengths[i]);
+    }
+
+    printf("Création du signal complexe...\n");
+    fillSignal(signal, N);
+
+    printf("Calcul de la DFT séquentielle...\n");
+    double fftFlops = 5.0 * N * log2(N);
+    perf_region* regions[6];
+    regions[0] = kernelRegion("DFT directe", N, 1, 8.0 * N * N, sizeof(ComplexNumber));
+    perf_region_begin(regions[0], 0);
+    computeDFT(signal, N, reference);
+    perf_region_end(regions[0], 0);
+    double timeDFT = perf_region_seconds(regions[0]);
+
+    printf("Calcul de la FFT (%d répétitions)...\n", REPETITIONS_FFT);
+    double start = perf_now();
+    FFTPlan* plan = getFFTPlan(N, FFT_FORWARD, FFT_DOUBLE);
+    double timePlan = perf_now() - start;
+    if (plan == NULL) {
+        printf("Erreur de création du plan FFT.\n");
+        return 1;
+    }
+    start = perf_now();
+    FFTPlan* cached = getFFTPlan(N, FFT_FORWARD, FFT_DOUBLE);
+    double timeCacheHit = perf_now() - start;
+
+    regions[1] = kernelRegion("FFT", N, REPETITIONS_FFT, fftFlops, sizeof(ComplexNumber));
+    perf_region_begin(regions[1], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeFFT(cached, signal, result);
+    }
+    perf_region_end(regions[1], 0);
+    double timeFFT = perf_region_seconds(regions[1]) / REPETITIONS_FFT;
+
+    // Même plan sur des tableaux séparés : ni séparation ni réentrelacement
+    double* signalReal = (double*)malloc(N * sizeof(double));
+    double* signalImag = (double*)malloc(N * sizeof(double));
+    double* resultReal = (double*)malloc(N * sizeof(double));
+    double* resultImag = (double*)malloc(N * sizeof(double));
+    splitComplex(signal, N, signalReal, signalImag);
+    regions[2] = kernelRegion("FFT SoA", N, REPETITIONS_FFT, fftFlops, sizeof(ComplexNumber));
+    perf_region_begin(regions[2], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeFFTSplit(cached, signalReal, signalImag, resultReal, resultImag);
+    }
+    perf_region_end(regions[2], 0);
+    double timeFFTSplit = perf_region_seconds(regions[2]) / REPETITIONS_FFT;
+
+    // Même transformée en simple précision, plan distinct dans le cache
+    ComplexFloat* signalFloat = (ComplexFloat*)malloc(N * sizeof(ComplexFloat));
+    ComplexFloat* resultFloat = (ComplexFloat*)malloc(N * sizeof(ComplexFloat));
+    ComplexNumber* resultWiden = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    for (int i = 0; i < N; i++) {
+        signalFloat[i].real = (float)signal[i].real;
+        signalFloat[i].imag = (float)signal[i].imag;
+    }
+    start = perf_now();
+    FFTPlan* planFloat = getFFTPlan(N, FFT_FORWARD, FFT_FLOAT);
+    double timePlanFloat = perf_now() - start;
+    regions[3] = kernelRegion("FFT float", N, REPETITIONS_FFT, fftFlops, sizeof(ComplexFloat));
+    perf_region_begin(regions[3], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeFFTFloat(planFloat, signalFloat, resultFloat);
+    }
+    perf_region_end(regions[3], 0);
+    double timeFFTFloat = perf_region_seconds(regions[3]) / REPETITIONS_FFT;
+    for (int i = 0; i < N; i++) {
+        resultWiden[i].real = resultFloat[i].real;
+        resultWiden[i].imag = resultFloat[i].imag;
+    }
+    double errFloat = relativeError(reference, resultWiden, N);
+    allOk &= errFloat < 1e-4;
+
+    // Partie réelle seule du signal : FFT réelle de N/2+1 coefficients contre FFT complexe
+    double* realInput = (double*)malloc(N * sizeof(double));
+    ComplexNumber* realOutput = (ComplexNumber*)malloc((N / 2 + 1) * sizeof(ComplexNumber));
+    RealFFTPlan* realPlan = createRealFFTPlan(N);
+    if (realInput == NULL || realOutput == NULL || realPlan == NULL) {
+        printf("Erreur de création du plan FFT réel.\n");
+        return 1;
+    }
+    for (int i = 0; i < N; i++) {
+        realInput[i] = signal[i].real;
+        signalReal[i] = signal[i].real;
+        signalImag[i] = 0;
+    }
+    regions[4] = kernelRegion("FFT complexe d'un signal réel", N, REPETITIONS_FFT, fftFlops, sizeof(ComplexNumber));
+    perf_region_begin(regions[4], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeFFTSplit(cached, signalReal, signalImag, resultReal, resultImag);
+    }
+    perf_region_end(regions[4], 0);
+    double timeComplexOfReal = perf_region_seconds(regions[4]) / REPETITIONS_FFT;
+    regions[5] = kernelRegion("FFT réelle", N, REPETITIONS_FFT, fftFlops / 2, sizeof(double));
+    perf_region_begin(regions[5], 0);
+    for (int r = 0; r < REPETITIONS_FFT; r++) {
+        executeRealFFT(realPlan, realInput, realOutput);
+    }
+    perf_region_end(regions[5], 0);
+    double timeRealFFT = perf_region_seconds(regions[5]) / REPETITIONS_FFT;
+    double errReal = 0;
+    for (int k = 0; k <= N / 2; k++) {
+        double err = hypot(realOutput[k].real - resultReal[k], realOutput[k].imag - resultImag[k]);
+        if (err > errReal) errReal = err;
+    }
+    allOk &= errReal < 1e-9 * N;
+
+    double err = relativeError(reference, result, N);
+    allOk &= err < 1e-9;
+    printf("Temps d'exécution DFT : %f secondes\n", timeDFT);
+    printf("Création du plan FFT : %f secondes (cache : %f secondes)\n", timePlan, timeCacheHit);
+    printf("Temps d'exécution FFT : %f secondes (accélération x%.0f)\n", timeFFT, timeDFT / timeFFT);
+    printf("Temps d'exécution FFT SoA (%s) : %f secondes\n", fftSimdName(), timeFFTSplit);
+    printf("Erreur relative FFT / DFT : %.2e\n", err);
+    printf("Création du plan FFT float : %f secondes\n", timePlanFloat);
+    printf("Temps d'exécution FFT float : %f secondes, erreur relative : %.2e\n", timeFFTFloat, errFloat);
+    printf("Signal réel : FFT complexe %f secondes, FFT réelle %f secondes (x%.2f), écart %.2e\n",
+           timeComplexOfReal, timeRealFFT, timeComplexOfReal / timeRealFFT, errReal);
+    for (int i = 0; i < 6; i++) {
+        perf_region_report(regions[i], stdout);
+        perf_region_free(regions[i]);
+    }
+
+    printf("Résultats de la FFT (partiels) :\n");
+    for (int k = 0; k < 10; k++) {
+        double magnitude = sqrt(result[k].real * result[k].real +
+                                result[k].imag * result[k].imag);
+        double phase = atan2(result[k].imag, result[k].real);
+        printf("k = %d : Magnitude = %.5f, Phase = %.5f radians\n",
+               k, magnitude, phase);
+    }
+
+    clearFFTPlanCache();
+    destroyRealFFTPlan(realPlan);
+    free(realInput);
+    free(realOutput);
+    free(signalReal);
+    free(signalImag);
+    free(resultReal);
+    free(resultImag);
+    free(signalFloat);
+    free(resultFloat);
+    free(resultWiden);
+    free(signal);
+    free(reference);
+    free(result);
+
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+// Étape de Stockham sur données séparées (partie réelle / partie imaginaire), vectorisée
+// sur LANES valeurs consécutives de q (ou, pour les petits pas, sur LANES papillons voisins).
+// Incluse par fft.c une fois par type de vecteur (scalaire, AVX2, AVX-512). Macros attendues
+// avant l'inclusion :
+//   REAL, VEC, LANES, VSUFFIX(nom),
+//   VADD, VSUB, VMUL, VFMA(a,b,c) = a*b+c, VFMS(a,b,c) = a*b-c, VSET1, VLOAD, VSTORE
+
+// (ar + i ai) * (wr + i wi)
+#define CMUL_RE(ar, ai, wr, wi) VFMS(ar, wr, VMUL(ai, wi))
+#define CMUL_IM(ar, ai, wr, wi) VFMA(ar, wi, VMUL(ai, wr))
+
+// (xr + i xi) * (direction * i), résultat dans (yr, yi)
+#define MUL_I(xr, xi, yr, yi, direction)             \
+    do {                                             \
+        if ((direction) > 0) {                       \
+            yr = VSUB(VSET1(0), xi);                 \
+            yi = xr;                                 \
+        } else {                                     \
+            yr = xi;                                 \
+            yi = VSUB(VSET1(0), xr);                 \
+        }                                            \
+    } while (0)
+
+static inline void VSUFFIX(butterfly2)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi) {
+    br[0] = VADD(ar[0], ar[1]); bi[0] = VADD(ai[0], ai[1]);
+    br[1] = VSUB(ar[0], ar[1]); bi[1] = VSUB(ai[0], ai[1]);
+}
+
+static inline void VSUFFIX(butterfly3)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi, int direction) {
+    const VEC s60 = VSET1((REAL)0.86602540378443864676);
+    const VEC minusHalf = VSET1((REAL)-0.5);
+    VEC t1r = VADD(ar[1], ar[2]), t1i = VADD(ai[1], ai[2]);
+    VEC dr = VMUL(VSUB(ar[1], ar[2]), s60), di = VMUL(VSUB(ai[1], ai[2]), s60);
+    VEC t2r, t2i;
+    MUL_I(dr, di, t2r, t2i, direction);
+    VEC mr = VFMA(t1r, minusHalf, ar[0]), mi = VFMA(t1i, minusHalf, ai[0]);
+    br[0] = VADD(ar[0], t1r); bi[0] = VADD(ai[0], t1i);
+    br[1] = VADD(mr, t2r); bi[1] = VADD(mi, t2i);
+    br[2] = VSUB(mr, t2r); bi[2] = VSUB(mi, t2i);
+}
+
+static inline void VSUFFIX(butterfly4)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi, int direction) {
+    VEC t0r = VADD(ar[0], ar[2]), t0i = VADD(ai[0], ai[2]);
+    VEC t1r = VSUB(ar[0], ar[2]), t1i = VSUB(ai[0], ai[2]);
+    VEC t2r = VADD(ar[1], ar[3]), t2i = VADD(ai[1], ai[3]);
+    VEC dr = VSUB(ar[1], ar[3]), di = VSUB(ai[1], ai[3]);
+    VEC t3r, t3i;
+    MUL_I(dr, di, t3r, t3i, direction);
+    br[0] = VADD(t0r, t2r); bi[0] = VADD(t0i, t2i);
+    br[1] = VADD(t1r, t3r); bi[1] = VADD(t1i, t3i);
+    br[2] = VSUB(t0r, t2r); bi[2] = VSUB(t0i, t2i);
+    br[3] = VSUB(t1r, t3r); bi[3] = VSUB(t1i, t3i);
+}
+
+static inline void VSUFFIX(butterfly5)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi, int direction) {
+    const VEC c1 = VSET1((REAL)0.30901699437494742410), c2 = VSET1((REAL)-0.80901699437494742410);
+    const VEC s1 = VSET1((REAL)0.95105651629515357212), s2 = VSET1((REAL)0.58778525229247312917);
+    VEC t1r = VADD(ar[1], ar[4]), t1i = VADD(ai[1], ai[4]);
+    VEC t2r = VADD(ar[2], ar[3]), t2i = VADD(ai[2], ai[3]);
+    VEC t3r = VSUB(ar[1], ar[4]), t3i = VSUB(ai[1], ai[4]);
+    VEC t4r = VSUB(ar[2], ar[3]), t4i = VSUB(ai[2], ai[3]);
+    VEC m1r = VFMA(t1r, c1, VFMA(t2r, c2, ar[0])), m1i = VFMA(t1i, c1, VFMA(t2i, c2, ai[0]));
+    VEC m2r = VFMA(t1r, c2, VFMA(t2r, c1, ar[0])), m2i = VFMA(t1i, c2, VFMA(t2i, c1, ai[0]));
+    VEC e1r = VFMA(t3r, s1, VMUL(t4r, s2)), e1i = VFMA(t3i, s1, VMUL(t4i, s2));
+    VEC e2r = VFMS(t3r, s2, VMUL(t4r, s1)), e2i = VFMS(t3i, s2, VMUL(t4i, s1));
+    VEC n1r, n1i, n2r, n2i;
+    MUL_I(e1r, e1i, n1r, n1i, direction);
+    MUL_I(e2r, e2i, n2r, n2i, direction);
+    br[0] = VADD(ar[0], VADD(t1r, t2r)); bi[0] = VADD(ai[0], VADD(t1i, t2i));
+    br[1] = VADD(m1r, n1r); bi[1] = VADD(m1i, n1i);
+    br[4] = VSUB(m1r, n1r); bi[4] = VSUB(m1i, n1i);
+    br[2] = VADD(m2r, n2r); bi[2] = VADD(m2i, n2i);
+    br[3] = VSUB(m2r, n2r); bi[3] = VSUB(m2i, n2i);
+}
+
+static inline void VSUFFIX(butterfly8)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi, int direction) {
+    const VEC r = VSET1((REAL)0.70710678118654752440);
+    VEC evenR[4] = {ar[0], ar[2], ar[4], ar[6]}, evenI[4] = {ai[0], ai[2], ai[4], ai[6]};
+    VEC oddR[4] = {ar[1], ar[3], ar[5], ar[7]}, oddI[4] = {ai[1], ai[3], ai[5], ai[7]};
+    VEC Er[4], Ei[4], Or[4], Oi[4];
+    VSUFFIX(butterfly4)(evenR, evenI, Er, Ei, direction);
+    VSUFFIX(butterfly4)(oddR, oddI, Or, Oi, direction);
+
+    // O_u *= exp(direction * i * pi * u / 4)
+    VEC xr, xi;
+    MUL_I(Or[1], Oi[1], xr, xi, direction);          // O1 * (1 + direction*i) / sqrt(2)
+    Or[1] = VMUL(VADD(Or[1], xr), r); Oi[1] = VMUL(VADD(Oi[1], xi), r);
+    MUL_I(Or[2], Oi[2], xr, xi, direction);
+    Or[2] = xr; Oi[2] = xi;
+    MUL_I(Or[3], Oi[3], xr, xi, direction);          // O3 * (-1 + direction*i) / sqrt(2)
+    Or[3] = VMUL(VSUB(xr, Or[3]), r); Oi[3] = VMUL(VSUB(xi, Oi[3]), r);
+
+    for (int u = 0; u < 4; u++) {
+        br[u] = VADD(Er[u], Or[u]); bi[u] = VADD(Ei[u], Oi[u]);
+        br[u + 4] = VSUB(Er[u], Or[u]); bi[u + 4] = VSUB(Ei[u], Oi[u]);
+    }
+}
+
+static inline void VSUFFIX(butterflyGeneric)(const VEC* ar, const VEC* ai, VEC* br, VEC* bi, int p,
+                                             const REAL* rootsR, const REAL* rootsI) {
+    for (int u = 0; u < p; u++) {
+        VEC sumR = ar[0], sumI = ai[0];
+        int index = 0;
+        for (int t = 1; t < p; t++) {
+            index += u;
+            if (index >= p) index -= p;
+            VEC wr = VSET1(rootsR[index]), wi = VSET1(rootsI[index]);
+            sumR = VADD(sumR, CMUL_RE(ar[t], ai[t], wr, wi));
+            sumI = VADD(sumI, CMUL_IM(ar[t], ai[t], wr, wi));
+        }
+        br[u] = sumR;
+        bi[u] = sumI;
+    }
+}
+
+static inline void VSUFFIX(butterfly)(int p, int direction, const VEC* ar, const VEC* ai, VEC* br, VEC* bi,
+                                      const REAL* rootsR, const REAL* rootsI) {
+    switch (p) {
+        case 2: VSUFFIX(butterfly2)(ar, ai, br, bi); break;
+        case 3: VSUFFIX(butterfly3)(ar, ai, br, bi, direction); break;
+        case 4: VSUFFIX(butterfly4)(ar, ai, br, bi, direction); break;
+        case 5: VSUFFIX(butterfly5)(ar, ai, br, bi, direction); break;
+        case 8: VSUFFIX(butterfly8)(ar, ai, br, bi, direction); break;
+        default: VSUFFIX(butterflyGeneric)(ar, ai, br, bi, p, rootsR, rootsI); break;
+    }
+}
+
+// y[q + s*(p*j + u)] = w_n^(j*u) * DFT_p(x[q + s*(j + t*m)], t < p)[u]
+// pour j < m et q dans [qStart, qEnd[ (qEnd - qStart multiple de LANES)
+static void VSUFFIX(stage)(int p, int direction, int m, int s, int qStart, int qEnd,
+                           const REAL* xr, const REAL* xi, REAL* yr, REAL* yi,
+                           const REAL* twR, const REAL* twI, const REAL* rootsR, const REAL* rootsI) {
+    VEC ar[MAX_GENERIC_RADIX], ai[MAX_GENERIC_RADIX];
+    VEC br[MAX_GENERIC_RADIX], bi[MAX_GENERIC_RADIX];
+
+    for (int j = 0; j < m; j++) {
+        const REAL* wjR = twR + j * (p - 1);
+        const REAL* wjI = twI + j * (p - 1);
+        for (int q = qStart; q < qEnd; q += LANES) {
+            for (int t = 0; t < p; t++) {
+                ar[t] = VLOAD(xr + q + s * (j + t * m));
+                ai[t] = VLOAD(xi + q + s * (j + t * m));
+            }
+            VSUFFIX(butterfly)(p, direction, ar, ai, br, bi, rootsR, rootsI);
+            REAL* outR = yr + q + s * p * j;
+            REAL* outI = yi + q + s * p * j;
+            VSTORE(outR, br[0]);
+            VSTORE(outI, bi[0]);
+            for (int u = 1; u < p; u++) {
+                VEC wr = VSET1(wjR[u - 1]), wi = VSET1(wjI[u - 1]);
+                VSTORE(outR + s * u, CMUL_RE(br[u], bi[u], wr, wi));
+                VSTORE(outI + s * u, CMUL_IM(br[u], bi[u], wr, wi));
+            }
+        }
+    }
+}
+
+// Même étape pour les petits pas (s < LANES) : les voies portent des papillons voisins. Avec
+// k = s*j + q, l'entrée x[k + t*s*m] est contiguë en k ; les facteurs de rotation et les
+// sorties, qui dépendent de j, passent par un tampon de LANES valeurs (regroupement et
+// dispersion scalaires, les papillons et les multiplications restent vectoriels).
+// Traite k dans [kStart, kEnd[ (kEnd - kStart multiple de LANES)
+static void VSUFFIX(stageInterleaved)(int p, int direction, int m, int s, int kStart, int kEnd,
+                                      const REAL* xr, const REAL* xi, REAL* yr, REAL* yi,
+                                      const REAL* twR, const REAL* twI, const REAL* rootsR, const REAL* rootsI) {
+    VEC ar[MAX_GENERIC_RADIX], ai[MAX_GENERIC_RADIX];
+    VEC br[MAX_GENERIC_RADIX], bi[MAX_GENERIC_RADIX];
+    REAL bufferR[LANES], bufferI[LANES];
+    int output[LANES], twiddle[LANES];
+    int sm = s * m;
+    int j = kStart / s, q = kStart % s;
+
+    for (int k = kStart; k < kEnd; k += LANES) {
+        for (int l = 0; l < LANES; l++) {
+            output[l] = q + s * p * j;
+            twiddle[l] = j * (p - 1);
+            if (++q == s) {
+                q = 0;
+                j++;
+            }
+        }
+        for (int t = 0; t < p; t++) {
+            ar[t] = VLOAD(xr + k + t * sm);
+            ai[t] = VLOAD(xi + k + t * sm);
+        }
+        VSUFFIX(butterfly)(p, direction, ar, ai, br, bi, rootsR, rootsI);
+        for (int u = 0; u < p; u++) {
+            VEC outR = br[u], outI = bi[u];
+            if (u > 0) {
+                for (int l = 0; l < LANES; l++) {
+                    bufferR[l] = twR[twiddle[l] + u - 1];
+                    bufferI[l] = twI[twiddle[l] + u - 1];
+                }
+                VEC wr = VLOAD(bufferR), wi = VLOAD(bufferI);
+                outR = CMUL_RE(br[u], bi[u], wr, wi);
+                outI = CMUL_IM(br[u], bi[u], wr, wi);
+            }
+            VSTORE(bufferR, outR);
+            VSTORE(bufferI, outI);
+            for (int l = 0; l < LANES; l++) {
+                yr[output[l] + s * u] = bufferR[l];
+                yi[output[l] + s * u] = bufferI[l];
+            }
+        }
+    }
+}
+
+#undef CMUL_RE
+#undef CMUL_IM
+#undef MUL_I
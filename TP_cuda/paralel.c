@@ -2,7 +2,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <pthread.h>
-#include <sys/time.h>
+#include "../TP_pthreads/perf_counters.h"
 
 #define PI 3.14159265358979323846
 
@@ -14,9 +14,12 @@ typedef struct {
 typedef struct {
     ComplexNumber* signal;
     ComplexNumber* result;
+    const ComplexNumber* twiddles;
     int N;
     int start;
     int end;
+    perf_region* region;
+    int thread;
 } ThreadData;
 
 ComplexNumber multiplyComplex(ComplexNumber a, ComplexNumber b) {
@@ -33,27 +36,42 @@ ComplexNumber addComplex(ComplexNumber a, ComplexNumber b) {
     return result;
 }
 
+// Table des facteurs de rotation e^(-j*2π*m/N) pour m < N, partagée par tous les threads :
+// e^(-j*2π*k*n/N) = twiddles[(k*n) mod N]
+ComplexNumber* computeTwiddles(int N) {
+    ComplexNumber* twiddles = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    if (twiddles == NULL) return NULL;
+    for (int m = 0; m < N; m++) {
+        double angle = 2 * PI * m / N;
+        twiddles[m].real = cos(angle);
+        twiddles[m].imag = -sin(angle);
+    }
+    return twiddles;
+}
+
 void* computeDFTThread(void* arg) {
     ThreadData* data = (ThreadData*)arg;
     ComplexNumber* signal = data->signal;
     ComplexNumber* result = data->result;
+    const ComplexNumber* twiddles = data->twiddles;
     int N = data->N;
 
+    perf_region_begin(data->region, data->thread);
     for (int k = data->start; k < data->end; k++) {
         result[k].real = 0;
         result[k].imag = 0;
 
+        // index = (k*n) mod N, tenu à jour sans multiplication ni débordement
+        int index = 0;
         for (int n = 0; n < N; n++) {
-            double angle = 2 * PI * k * n / N;
-            ComplexNumber exponential = {
-                .real = cos(angle),
-                .imag = -sin(angle)
-            };
-
-            ComplexNumber temp = multiplyComplex(signal[n], exponential);
+            ComplexNumber temp = multiplyComplex(signal[n], twiddles[index]);
             result[k] = addComplex(result[k], temp);
+
+            index += k;
+            if (index >= N) index -= N;
         }
     }
+    perf_region_end(data->region, data->thread);
 
     return NULL;
 }
@@ -76,9 +94,18 @@ int main() {
         signal[i].imag = cos(2 * PI * 120 * i / N);
     }
 
+    printf("Calcul de la table des facteurs de rotation...\n");
+    double start = perf_now();
+    ComplexNumber* twiddles = computeTwiddles(N);
+    double table_time = perf_now() - start;
+    if (twiddles == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+
     printf("Calcul de la DFT parallèle avec %d threads...\n", numThreads);
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
+    perf_region* region = perf_region_create("DFT parallèle", numThreads);
+    start = perf_now();
 
     pthread_t threads[numThreads];
     ThreadData threadData[numThreads];
@@ -87,9 +114,12 @@ int main() {
     for (int t = 0; t < numThreads; t++) {
         threadData[t].signal = signal;
         threadData[t].result = result;
+        threadData[t].twiddles = twiddles;
         threadData[t].N = N;
         threadData[t].start = t * chunkSize;
         threadData[t].end = (t == numThreads - 1) ? N : (t + 1) * chunkSize;
+        threadData[t].region = region;
+        threadData[t].thread = t;
 
         pthread_create(&threads[t], NULL, computeDFTThread, &threadData[t]);
     }
@@ -98,11 +128,15 @@ int main() {
         pthread_join(threads[t], NULL);
     }
 
-    gettimeofday(&end, NULL);
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + 
-                        (end.tv_usec - start.tv_usec) / 1e6;
+    double time_spent = perf_now() - start;
+    // 8 opérations par terme (produit complexe puis accumulation) ; chaque thread relit signal
+    // et table depuis son cache, la mémoire ne voit passer que signal, table et résultat
+    perf_region_add_work(region, 8.0 * N * N, 3.0 * N * sizeof(ComplexNumber));
 
+    printf("Temps de cr\u00e9ation de la table : %f secondes\n", table_time);
     printf("Temps d'ex\u00e9cution parall\u00e8le : %f secondes\n", time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
     printf("R\u00e9sultats de la DFT (partiels) :\n");
     for (int k = 0; k < 10; k++) {
         double magnitude = sqrt(result[k].real * result[k].real + 
@@ -112,6 +146,7 @@ int main() {
                k, magnitude, phase);
     }
 
+    free(twiddles);
     free(signal);
     free(result);
 
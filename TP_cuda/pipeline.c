@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "pipeline.h"
+
+#define LANE_QUEUE 8  // opérations en attente par file (3 par morceau)
+
+struct StagedPipeline {
+    PipelineExecutor* executor;
+    int numSlots;
+    size_t inBytes;
+    size_t outBytes;
+    void** hostIn;
+    void** hostOut;
+    void** deviceIn;
+    void** deviceOut;
+};
+
+StagedPipeline* createStagedPipeline(PipelineExecutor* executor, int numSlots,
+                                     size_t inBytes, size_t outBytes) {
+    if (numSlots < 1) return NULL;
+    StagedPipeline* p = (StagedPipeline*)calloc(1, sizeof(StagedPipeline));
+    if (p == NULL) return NULL;
+    p->executor = executor;
+    p->numSlots = numSlots;
+    p->inBytes = inBytes;
+    p->outBytes = outBytes;
+    p->hostIn = (void**)calloc(numSlots, sizeof(void*));
+    p->hostOut = (void**)calloc(numSlots, sizeof(void*));
+    p->deviceIn = (void**)calloc(numSlots, sizeof(void*));
+    p->deviceOut = (void**)calloc(numSlots, sizeof(void*));
+    if (p->hostIn == NULL || p->hostOut == NULL || p->deviceIn == NULL || p->deviceOut == NULL) {
+        destroyStagedPipeline(p);
+        return NULL;
+    }
+    for (int s = 0; s < numSlots; s++) {
+        p->hostIn[s] = executor->allocateHost(executor->self, inBytes);
+        p->hostOut[s] = executor->allocateHost(executor->self, outBytes);
+        p->deviceIn[s] = executor->allocateDevice(executor->self, inBytes);
+        p->deviceOut[s] = executor->allocateDevice(executor->self, outBytes);
+        if (p->hostIn[s] == NULL || p->hostOut[s] == NULL ||
+            p->deviceIn[s] == NULL || p->deviceOut[s] == NULL) {
+            destroyStagedPipeline(p);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+void destroyStagedPipeline(StagedPipeline* p) {
+    if (p == NULL) return;
+    PipelineExecutor* ex = p->executor;
+    for (int s = 0; s < p->numSlots; s++) {
+        if (p->hostIn != NULL && p->hostIn[s] != NULL) ex->freeHost(ex->self, p->hostIn[s]);
+        if (p->hostOut != NULL && p->hostOut[s] != NULL) ex->freeHost(ex->self, p->hostOut[s]);
+        if (p->deviceIn != NULL && p->deviceIn[s] != NULL) ex->freeDevice(ex->self, p->deviceIn[s]);
+        if (p->deviceOut != NULL && p->deviceOut[s] != NULL) ex->freeDevice(ex->self, p->deviceOut[s]);
+    }
+    free(p->hostIn);
+    free(p->hostOut);
+    free(p->deviceIn);
+    free(p->deviceOut);
+    free(p);
+}
+
+void runStagedPipeline(StagedPipeline* p, int numChunks,
+                       PackFunction pack, UnpackFunction unpack, void* context) {
+    PipelineExecutor* ex = p->executor;
+    for (int k = 0; k < numChunks; k++) {
+        int s = k % p->numSlots;
+        // L'emplacement est libre quand le morceau k - numSlots est revenu sur l'hôte
+        if (k >= p->numSlots) {
+            ex->wait(ex->self, s);
+            unpack(context, k - p->numSlots, p->hostOut[s]);
+        }
+        pack(context, k, p->hostIn[s]);
+        ex->copyToDevice(ex->self, s, p->deviceIn[s], p->hostIn[s], p->inBytes);
+        ex->compute(ex->self, s, k, p->deviceIn[s], p->deviceOut[s]);
+        ex->copyToHost(ex->self, s, p->hostOut[s], p->deviceOut[s], p->outBytes);
+    }
+
+    int first = numChunks > p->numSlots ? numChunks - p->numSlots : 0;
+    for (int k = first; k < numChunks; k++) {
+        int s = k % p->numSlots;
+        ex->wait(ex->self, s);
+        unpack(context, k, p->hostOut[s]);
+    }
+}
+
+// Exécuteur de substitution : chaque file est un thread qui exécute ses opérations dans
+// l'ordre, comme un flux CUDA
+
+typedef enum { OP_COPY_TO_DEVICE, OP_COPY_TO_HOST, OP_COMPUTE } OperationType;
+
+typedef struct {
+    OperationType type;
+    int chunk;
+    void* dst;
+    const void* src;
+    size_t bytes;
+} Operation;
+
+typedef struct ThreadExecutor ThreadExecutor;
+
+typedef struct {
+    ThreadExecutor* owner;
+    int index;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    Operation queue[LANE_QUEUE];
+    int head;
+    int count;      // opérations en file, y compris celle en cours
+    int stop;
+} Lane;
+
+struct ThreadExecutor {
+    PipelineExecutor base;
+    int numLanes;
+    Lane* lanes;
+    ThreadKernel kernel;
+    void* context;
+    double bandwidth;
+    // Un seul lien PCIe, bidirectionnel : les copies d'un même sens se le partagent et
+    // passent l'une après l'autre, quelle que soit la file qui les émet
+    pthread_mutex_t link[2];
+};
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Copie ralentie au débit simulé du bus, qui reste occupé dans ce sens pendant toute sa durée
+static void simulatedCopy(ThreadExecutor* ex, int direction, void* dst, const void* src, size_t bytes) {
+    if (ex->bandwidth <= 0) {
+        memcpy(dst, src, bytes);
+        return;
+    }
+    pthread_mutex_lock(&ex->link[direction]);
+    double start = now();
+    memcpy(dst, src, bytes);
+    double remaining = bytes / ex->bandwidth - (now() - start);
+    if (remaining > 0) {
+        struct timespec t;
+        t.tv_sec = (time_t)remaining;
+        t.tv_nsec = (long)((remaining - t.tv_sec) * 1e9);
+        nanosleep(&t, NULL);
+    }
+    pthread_mutex_unlock(&ex->link[direction]);
+}
+
+static void* laneThread(void* arg) {
+    Lane* lane = (Lane*)arg;
+    ThreadExecutor* ex = lane->owner;
+    while (1) {
+        pthread_mutex_lock(&lane->lock);
+        while (lane->count == 0 && !lane->stop) pthread_cond_wait(&lane->changed, &lane->lock);
+        if (lane->count == 0) {
+            pthread_mutex_unlock(&lane->lock);
+            break;
+        }
+        Operation op = lane->queue[lane->head];
+        pthread_mutex_unlock(&lane->lock);
+
+        if (op.type != OP_COMPUTE) {
+            simulatedCopy(ex, op.type == OP_COPY_TO_HOST, op.dst, op.src, op.bytes);
+        } else {
+            ex->kernel(ex->context, lane->index, op.chunk, op.src, op.dst);
+        }
+
+        pthread_mutex_lock(&lane->lock);
+        lane->head = (lane->head + 1) % LANE_QUEUE;
+        lane->count--;
+        pthread_cond_broadcast(&lane->changed);
+        pthread_mutex_unlock(&lane->lock);
+    }
+    return NULL;
+}
+
+static void enqueue(ThreadExecutor* ex, int index, Operation op) {
+    Lane* lane = &ex->lanes[index];
+    pthread_mutex_lock(&lane->lock);
+    while (lane->count == LANE_QUEUE) pthread_cond_wait(&lane->changed, &lane->lock);
+    lane->queue[(lane->head + lane->count) % LANE_QUEUE] = op;
+    lane->count++;
+    pthread_cond_broadcast(&lane->changed);
+    pthread_mutex_unlock(&lane->lock);
+}
+
+static void* threadAllocate(void* self, size_t bytes) {
+    (void)self;
+    return malloc(bytes);
+}
+
+static void threadFree(void* self, void* ptr) {
+    (void)self;
+    free(ptr);
+}
+
+static void threadCopyToDevice(void* self, int lane, void* device, const void* host, size_t bytes) {
+    Operation op = {OP_COPY_TO_DEVICE, -1, device, host, bytes};
+    enqueue((ThreadExecutor*)self, lane, op);
+}
+
+static void threadCopyToHost(void* self, int lane, void* host, const void* device, size_t bytes) {
+    Operation op = {OP_COPY_TO_HOST, -1, host, device, bytes};
+    enqueue((ThreadExecutor*)self, lane, op);
+}
+
+static void threadCompute(void* self, int lane, int chunk, const void* deviceIn, void* deviceOut) {
+    Operation op = {OP_COMPUTE, chunk, deviceOut, deviceIn, 0};
+    enqueue((ThreadExecutor*)self, lane, op);
+}
+
+static void threadWait(void* self, int index) {
+    Lane* lane = &((ThreadExecutor*)self)->lanes[index];
+    pthread_mutex_lock(&lane->lock);
+    while (lane->count > 0) pthread_cond_wait(&lane->changed, &lane->lock);
+    pthread_mutex_unlock(&lane->lock);
+}
+
+PipelineExecutor* createThreadExecutor(int lanes, ThreadKernel kernel, void* context, double bandwidth) {
+    if (lanes < 1) return NULL;
+    ThreadExecutor* ex = (ThreadExecutor*)calloc(1, sizeof(ThreadExecutor));
+    if (ex == NULL) return NULL;
+    ex->lanes = (Lane*)calloc(lanes, sizeof(Lane));
+    if (ex->lanes == NULL) {
+        free(ex);
+        return NULL;
+    }
+    ex->numLanes = lanes;
+    ex->kernel = kernel;
+    ex->context = context;
+    ex->bandwidth = bandwidth;
+    pthread_mutex_init(&ex->link[0], NULL);
+    pthread_mutex_init(&ex->link[1], NULL);
+
+    PipelineExecutor* base = &ex->base;
+    base->self = ex;
+    base->allocateHost = threadAllocate;
+    base->freeHost = threadFree;
+    base->allocateDevice = threadAllocate;
+    base->freeDevice = threadFree;
+    base->copyToDevice = threadCopyToDevice;
+    base->compute = threadCompute;
+    base->copyToHost = threadCopyToHost;
+    base->wait = threadWait;
+
+    for (int l = 0; l < lanes; l++) {
+        Lane* lane = &ex->lanes[l];
+        lane->owner = ex;
+        lane->index = l;
+        pthread_mutex_init(&lane->lock, NULL);
+        pthread_cond_init(&lane->changed, NULL);
+        pthread_create(&lane->thread, NULL, laneThread, lane);
+    }
+    return base;
+}
+
+void destroyThreadExecutor(PipelineExecutor* executor) {
+    if (executor == NULL) return;
+    ThreadExecutor* ex = (ThreadExecutor*)executor->self;
+    for (int l = 0; l < ex->numLanes; l++) {
+        Lane* lane = &ex->lanes[l];
+        pthread_mutex_lock(&lane->lock);
+        lane->stop = 1;
+        pthread_cond_broadcast(&lane->changed);
+        pthread_mutex_unlock(&lane->lock);
+        pthread_join(lane->thread, NULL);
+        pthread_mutex_destroy(&lane->lock);
+        pthread_cond_destroy(&lane->changed);
+    }
+    pthread_mutex_destroy(&ex->link[0]);
+    pthread_mutex_destroy(&ex->link[1]);
+    free(ex->lanes);
+    free(ex);
+}
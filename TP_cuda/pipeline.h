@@ -0,0 +1,59 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+
+// Pipeline par morceaux hôte -> périphérique -> hôte :
+//   préparation (hôte) -> copie vers le périphérique -> calcul -> copie retour -> déballage (hôte)
+// Chaque emplacement possède ses tampons de transit hôte et périphérique, alloués une fois,
+// et une file d'exécution (flux CUDA ou thread). Pendant que le périphérique traite le
+// morceau k dans un emplacement, l'hôte prépare k+1 dans le suivant et déballe le
+// résultat de k+1-emplacements : préparation, transferts, calcul et déballage se recouvrent.
+//
+// L'exécuteur est interchangeable : flux CUDA dans cuda.cu, ou threads du processeur
+// (createThreadExecutor) pour tester et mesurer le pipeline sans GPU.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    void* self;
+    // Mémoire hôte de transit (verrouillée en mémoire pour CUDA) et mémoire du périphérique
+    void* (*allocateHost)(void* self, size_t bytes);
+    void (*freeHost)(void* self, void* ptr);
+    void* (*allocateDevice)(void* self, size_t bytes);
+    void (*freeDevice)(void* self, void* ptr);
+    // Opérations asynchrones, exécutées dans l'ordre sur la file lane
+    void (*copyToDevice)(void* self, int lane, void* device, const void* host, size_t bytes);
+    void (*compute)(void* self, int lane, int chunk, const void* deviceIn, void* deviceOut);
+    void (*copyToHost)(void* self, int lane, void* host, const void* device, size_t bytes);
+    // Attend la fin de toutes les opérations de la file lane
+    void (*wait)(void* self, int lane);
+} PipelineExecutor;
+
+// Exécutées par le thread appelant
+typedef void (*PackFunction)(void* context, int chunk, void* hostIn);
+typedef void (*UnpackFunction)(void* context, int chunk, const void* hostOut);
+
+typedef struct StagedPipeline StagedPipeline;
+
+// numSlots emplacements de inBytes / outBytes octets ; l'emplacement s utilise la file s
+StagedPipeline* createStagedPipeline(PipelineExecutor* executor, int numSlots,
+                                     size_t inBytes, size_t outBytes);
+void runStagedPipeline(StagedPipeline* pipeline, int numChunks,
+                       PackFunction pack, UnpackFunction unpack, void* context);
+void destroyStagedPipeline(StagedPipeline* pipeline);
+
+// Exécuteur de substitution : une file par thread, mémoire « périphérique » ordinaire.
+// bandwidth (octets/s, 0 = illimitée) simule la durée des transferts sur un lien PCIe
+// unique : les copies d'un même sens sont sérialisées entre les files, les deux sens se recouvrent.
+typedef void (*ThreadKernel)(void* context, int lane, int chunk, const void* in, void* out);
+PipelineExecutor* createThreadExecutor(int lanes, ThreadKernel kernel, void* context, double bandwidth);
+void destroyThreadExecutor(PipelineExecutor* executor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
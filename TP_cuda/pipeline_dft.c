@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "pipeline.h"
+#include "fft.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define PI 3.14159265358979323846
+#define NUM_SIGNALS 256
+#define MAX_SLOTS 4
+#define DEFAULT_BANDWIDTH 12e9  // octets/s, ordre de grandeur d'un lien PCIe 3.0 x16
+
+// Morceau k : signal k de N points ; transit en parties réelles puis imaginaires,
+// comme signal_real/signal_imag dans cuda.cu
+typedef struct {
+    const ComplexNumber* signals;
+    ComplexNumber* results;
+    int N;
+    FFTPlan* plans[MAX_SLOTS];  // un plan par file : un plan ne s'exécute pas en parallèle
+    perf_region* region;        // un emplacement par file, mesuré par le thread de la file
+} BatchContext;
+
+void packSignal(void* context, int chunk, void* hostIn) {
+    BatchContext* c = (BatchContext*)context;
+    double* real = (double*)hostIn;
+    splitComplex(c->signals + (size_t)chunk * c->N, c->N, real, real + c->N);
+}
+
+void unpackResult(void* context, int chunk, const void* hostOut) {
+    BatchContext* c = (BatchContext*)context;
+    const double* real = (const double*)hostOut;
+    interleaveComplex(real, real + c->N, c->N, c->results + (size_t)chunk * c->N);
+}
+
+// Calcul du « périphérique » simulé : FFT sur les tableaux séparés
+void fftKernel(void* context, int lane, int chunk, const void* in, void* out) {
+    BatchContext* c = (BatchContext*)context;
+    const double* x = (const double*)in;
+    double* y = (double*)out;
+    (void)chunk;
+    perf_region_begin(c->region, lane);
+    executeFFTSplit(c->plans[lane], x, x + c->N, y, y + c->N);
+    perf_region_end(c->region, lane);
+}
+
+double maxError(const ComplexNumber* ref, const ComplexNumber* x, size_t count) {
+    double maxErr = 0;
+    for (size_t i = 0; i < count; i++) {
+        double err = hypot(ref[i].real - x[i].real, ref[i].imag - x[i].imag);
+        if (err > maxErr) maxErr = err;
+    }
+    return maxErr;
+}
+
+// Usage : ./pipeline_dft [débit simulé en Go/s, 0 = illimité]
+int main(int argc, char* argv[]) {
+    int N = 10240;
+    double bandwidth = argc > 1 ? atof(argv[1]) * 1e9 : DEFAULT_BANDWIDTH;
+    size_t total = (size_t)NUM_SIGNALS * N;
+    ComplexNumber* signals = (ComplexNumber*)malloc(total * sizeof(ComplexNumber));
+    ComplexNumber* reference = (ComplexNumber*)malloc(total * sizeof(ComplexNumber));
+    ComplexNumber* results = (ComplexNumber*)malloc(total * sizeof(ComplexNumber));
+    if (signals == NULL || reference == NULL || results == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+
+    printf("Création de %d signaux de %d points...\n", NUM_SIGNALS, N);
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        for (int i = 0; i < N; i++) {
+            signals[(size_t)s * N + i].real = sin(2 * PI * (50 + s) * i / N);
+            signals[(size_t)s * N + i].imag = cos(2 * PI * 120 * i / N);
+        }
+    }
+
+    BatchContext context = {signals, results, N, {NULL}, NULL};
+    for (int l = 0; l < MAX_SLOTS; l++) {
+        context.plans[l] = createFFTPlan(N, FFT_FORWARD);
+        if (context.plans[l] == NULL) {
+            printf("Erreur de création du plan FFT.\n");
+            return 1;
+        }
+    }
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        executeFFT(context.plans[0], signals + (size_t)s * N, reference + (size_t)s * N);
+    }
+
+    printf("Débit simulé des transferts : %.1f Go/s\n", bandwidth / 1e9);
+    printf("%12s | %12s | %10s | %s\n", "emplacements", "temps (s)", "accél.", "erreur max");
+    int ok = 1;
+    double serial = 0;
+    for (int slots = 1; slots <= MAX_SLOTS; slots++) {
+        PipelineExecutor* executor = createThreadExecutor(slots, fftKernel, &context, bandwidth);
+        StagedPipeline* pipeline = createStagedPipeline(executor, slots, 2 * N * sizeof(double),
+                                                        2 * N * sizeof(double));
+        if (executor == NULL || pipeline == NULL) {
+            printf("Erreur de création du pipeline.\n");
+            return 1;
+        }
+
+        // Le temps couvre tout le pipeline ; la région ne compte que les FFT des files
+        perf_region_free(context.region);
+        context.region = perf_region_create("FFT des files du pipeline", slots);
+        double start = perf_now();
+        runStagedPipeline(pipeline, NUM_SIGNALS, packSignal, unpackResult, &context);
+        double t = perf_now() - start;
+        if (slots == 1) serial = t;
+
+        double err = maxError(reference, results, total);
+        ok &= err == 0;
+        // Un seul emplacement : préparation, transferts, calcul et déballage en série
+        printf("%12d | %12.4f | %9.2fx | %.2e%s\n", slots, t, serial / t, err,
+               slots == 1 ? " (séquentiel)" : "");
+
+        destroyStagedPipeline(pipeline);
+        destroyThreadExecutor(executor);
+    }
+
+    // Rapport du pipeline le plus large : temps de calcul par file et roofline du noyau
+    perf_region_add_work(context.region, 5.0 * NUM_SIGNALS * N * log2(N), 4.0 * total * sizeof(double));
+    perf_region_report(context.region, stdout);
+    perf_region_free(context.region);
+    for (int l = 0; l < MAX_SLOTS; l++) destroyFFTPlan(context.plans[l]);
+    free(signals);
+    free(reference);
+    free(results);
+    return ok ? 0 : 1;
+}
@@ -1,7 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include <sys/time.h>
+#include "../TP_pthreads/perf_counters.h"
 
 #define PI 3.14159265358979323846
 
@@ -25,23 +25,33 @@ ComplexNumber addComplex(ComplexNumber a, ComplexNumber b) {
     return result;
 }
 
-void computeDFT(ComplexNumber* signal, int N, ComplexNumber* result) {
+// Table des facteurs de rotation e^(-j*2π*m/N) pour m < N, calculée une seule fois :
+// e^(-j*2π*k*n/N) = twiddles[(k*n) mod N]
+ComplexNumber* computeTwiddles(int N) {
+    ComplexNumber* twiddles = (ComplexNumber*)malloc(N * sizeof(ComplexNumber));
+    if (twiddles == NULL) return NULL;
+    for (int m = 0; m < N; m++) {
+        double angle = 2 * PI * m / N;
+        twiddles[m].real = cos(angle);
+        twiddles[m].imag = -sin(angle);
+    }
+    return twiddles;
+}
+
+void computeDFT(ComplexNumber* signal, int N, ComplexNumber* result, const ComplexNumber* twiddles) {
     for (int k = 0; k < N; k++) {
         result[k].real = 0;
         result[k].imag = 0;
         
+        // index = (k*n) mod N, tenu à jour sans multiplication ni débordement
+        int index = 0;
         for (int n = 0; n < N; n++) {
-            double angle = 2 * PI * k * n / N;
-            
-            // Calcul de e^(-j*2π*k*n/N)
-            ComplexNumber exponential = {
-                .real = cos(angle),
-                .imag = -sin(angle)
-            };
-            
-            ComplexNumber temp = multiplyComplex(signal[n], exponential);
+            ComplexNumber temp = multiplyComplex(signal[n], twiddles[index]);
             
             result[k] = addComplex(result[k], temp);
+
+            index += k;
+            if (index >= N) index -= N;
         }
     }
 }
@@ -62,17 +72,31 @@ int main() {
         signal[i].imag = cos(2 * PI * 120 * i / N);
     }
     
+    printf("Calcul de la table des facteurs de rotation...\n");
+    double start = perf_now();
+    ComplexNumber* twiddles = computeTwiddles(N);
+    double table_time = perf_now() - start;
+    if (twiddles == NULL) {
+        printf("Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+    
     printf("Calcul de la DFT séquentielle...\n");
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
+    perf_region* region = perf_region_create("DFT séquentielle", 1);
+    perf_region_begin(region, 0);
     
-    computeDFT(signal, N, result);
+    computeDFT(signal, N, result, twiddles);
     
-    gettimeofday(&end, NULL);
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + 
-                       (end.tv_usec - start.tv_usec) / 1e6;
+    perf_region_end(region, 0);
+    // 8 opérations par terme (produit complexe puis accumulation) ; signal et table tiennent
+    // dans le cache, seuls signal, table et résultat passent par la mémoire
+    perf_region_add_work(region, 8.0 * N * N, 3.0 * N * sizeof(ComplexNumber));
+    double time_spent = perf_region_seconds(region);
     
+    printf("Temps de création de la table : %f secondes\n", table_time);
     printf("Temps d'exécution séquentiel : %f secondes\n", time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
     printf("Résultats de la DFT (partiels) :\n");
     for (int k = 0; k < 10; k++) {
         double magnitude = sqrt(result[k].real * result[k].real + 
@@ -82,6 +106,7 @@ int main() {
                k, magnitude, phase);
     }
     
+    free(twiddles);
     free(signal);
     free(result);
     
@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <math.h>
+#include "sliding_dft.h"
+#include "fft_real.h"
+
+#define PI 3.14159265358979323846
+#define GOERTZEL_GROUP 4  // coefficients calculés ensemble lors d'une resynchronisation
+
+struct SlidingDFT {
+    int N;
+    int numBins;
+    int* bins;
+    double* rotationReal;   // exp(2*pi*i*k/N) pour chaque coefficient suivi
+    double* rotationImag;
+    ComplexNumber* values;
+
+    double* ring;           // N derniers échantillons, ring[ringPos] est le plus ancien
+    int ringPos;
+    int resyncInterval;
+    int sinceResync;
+
+    // Resynchronisation par FFT réelle quand les coefficients suivis sont nombreux
+    RealFFTPlan* plan;
+    double* frame;
+    ComplexNumber* spectrum;
+};
+
+// Récurrence de Goertzel s[n] = x[n] + 2cos(w) s[n-1] - s[n-2], poursuivie sur plusieurs segments
+static void goertzelRun(const double* x, int n, double coeff, double* s1, double* s2) {
+    double a = *s1, b = *s2;
+    for (int i = 0; i < n; i++) {
+        double s0 = x[i] + coeff * a - b;
+        b = a;
+        a = s0;
+    }
+    *s1 = a;
+    *s2 = b;
+}
+
+static void goertzelRunGroup(const double* x, int n, const double* coeff, double* s1, double* s2) {
+    for (int i = 0; i < n; i++) {
+        for (int g = 0; g < GOERTZEL_GROUP; g++) {
+            double s0 = x[i] + coeff[g] * s1[g] - s2[g];
+            s2[g] = s1[g];
+            s1[g] = s0;
+        }
+    }
+}
+
+// X_k = exp(i w) s[N-1] - s[N-2] (le facteur exp(-i w N) vaut 1 pour k entier)
+static ComplexNumber goertzelResult(double s1, double s2, double omega) {
+    ComplexNumber X;
+    X.real = cos(omega) * s1 - s2;
+    X.imag = sin(omega) * s1;
+    return X;
+}
+
+ComplexNumber goertzel(const double* samples, int N, int k) {
+    double omega = 2 * PI * k / N;
+    double s1 = 0, s2 = 0;
+    goertzelRun(samples, N, 2 * cos(omega), &s1, &s2);
+    return goertzelResult(s1, s2, omega);
+}
+
+SlidingDFT* createSlidingDFT(int N, const int* bins, int numBins, int resyncInterval) {
+    if (N < 1 || numBins < 1) return NULL;
+    for (int b = 0; b < numBins; b++) {
+        if (bins[b] < 0 || bins[b] > N / 2) return NULL;
+    }
+
+    SlidingDFT* sdft = (SlidingDFT*)calloc(1, sizeof(SlidingDFT));
+    if (sdft == NULL) return NULL;
+    sdft->N = N;
+    sdft->numBins = numBins;
+    sdft->resyncInterval = resyncInterval;
+    sdft->bins = (int*)malloc(numBins * sizeof(int));
+    sdft->rotationReal = (double*)malloc(numBins * sizeof(double));
+    sdft->rotationImag = (double*)malloc(numBins * sizeof(double));
+    sdft->values = (ComplexNumber*)calloc(numBins, sizeof(ComplexNumber));
+    sdft->ring = (double*)calloc(N, sizeof(double));
+    if (sdft->bins == NULL || sdft->rotationReal == NULL || sdft->rotationImag == NULL ||
+        sdft->values == NULL || sdft->ring == NULL) {
+        destroySlidingDFT(sdft);
+        return NULL;
+    }
+    for (int b = 0; b < numBins; b++) {
+        sdft->bins[b] = bins[b];
+        sdft->rotationReal[b] = cos(2 * PI * bins[b] / N);
+        sdft->rotationImag[b] = sin(2 * PI * bins[b] / N);
+    }
+
+    // Goertzel coûte N opérations par coefficient, la FFT réelle environ N log2(N) au total
+    int log2N = 0;
+    while ((1 << log2N) < N) log2N++;
+    if (resyncInterval > 0 && numBins > log2N) {
+        sdft->plan = createRealFFTPlan(N);
+        sdft->frame = (double*)malloc(N * sizeof(double));
+        sdft->spectrum = (ComplexNumber*)malloc((N / 2 + 1) * sizeof(ComplexNumber));
+        if (sdft->plan == NULL || sdft->frame == NULL || sdft->spectrum == NULL) {
+            destroySlidingDFT(sdft);
+            return NULL;
+        }
+    }
+    return sdft;
+}
+
+void destroySlidingDFT(SlidingDFT* sdft) {
+    if (sdft == NULL) return;
+    free(sdft->bins);
+    free(sdft->rotationReal);
+    free(sdft->rotationImag);
+    free(sdft->values);
+    free(sdft->ring);
+    destroyRealFFTPlan(sdft->plan);
+    free(sdft->frame);
+    free(sdft->spectrum);
+    free(sdft);
+}
+
+void slidingDFTResync(SlidingDFT* sdft) {
+    int N = sdft->N;
+    const double* oldest = sdft->ring + sdft->ringPos;
+    int tail = N - sdft->ringPos;
+    sdft->sinceResync = 0;
+
+    if (sdft->plan != NULL) {
+        for (int i = 0; i < tail; i++) sdft->frame[i] = oldest[i];
+        for (int i = tail; i < N; i++) sdft->frame[i] = sdft->ring[i - tail];
+        executeRealFFT(sdft->plan, sdft->frame, sdft->spectrum);
+        for (int b = 0; b < sdft->numBins; b++) sdft->values[b] = sdft->spectrum[sdft->bins[b]];
+        return;
+    }
+
+    // Goertzel sur GOERTZEL_GROUP coefficients à la fois : les récurrences indépendantes
+    // se recouvrent au lieu d'attendre chacune la latence de la précédente
+    for (int b0 = 0; b0 < sdft->numBins; b0 += GOERTZEL_GROUP) {
+        int count = sdft->numBins - b0 < GOERTZEL_GROUP ? sdft->numBins - b0 : GOERTZEL_GROUP;
+        double coeff[GOERTZEL_GROUP] = {0}, s1[GOERTZEL_GROUP] = {0}, s2[GOERTZEL_GROUP] = {0};
+        for (int g = 0; g < count; g++) coeff[g] = 2 * cos(2 * PI * sdft->bins[b0 + g] / N);
+        goertzelRunGroup(oldest, tail, coeff, s1, s2);
+        goertzelRunGroup(sdft->ring, N - tail, coeff, s1, s2);
+        for (int g = 0; g < count; g++) {
+            sdft->values[b0 + g] = goertzelResult(s1[g], s2[g], 2 * PI * sdft->bins[b0 + g] / N);
+        }
+    }
+}
+
+void slidingDFTUpdate(SlidingDFT* sdft, double sample) {
+    double delta = sample - sdft->ring[sdft->ringPos];
+    sdft->ring[sdft->ringPos] = sample;
+    if (++sdft->ringPos == sdft->N) sdft->ringPos = 0;
+
+    for (int b = 0; b < sdft->numBins; b++) {
+        double xr = sdft->values[b].real + delta;
+        double xi = sdft->values[b].imag;
+        sdft->values[b].real = xr * sdft->rotationReal[b] - xi * sdft->rotationImag[b];
+        sdft->values[b].imag = xr * sdft->rotationImag[b] + xi * sdft->rotationReal[b];
+    }
+
+    if (sdft->resyncInterval > 0 && ++sdft->sinceResync >= sdft->resyncInterval) {
+        slidingDFTResync(sdft);
+    }
+}
+
+void slidingDFTPush(SlidingDFT* sdft, const double* samples, int count) {
+    for (int i = 0; i < count; i++) {
+        slidingDFTUpdate(sdft, samples[i]);
+    }
+}
+
+const ComplexNumber* slidingDFTBins(const SlidingDFT* sdft) {
+    return sdft->values;
+}
@@ -0,0 +1,28 @@
+#ifndef SLIDING_DFT_H
+#define SLIDING_DFT_H
+
+#include "fft.h"
+
+// Suivi de quelques coefficients de la DFT sur une fenêtre glissante de N échantillons
+// réels. À chaque nouvel échantillon x, chaque coefficient suivi est mis à jour en O(1) :
+//   X_k <- (X_k + x - x_sortant) * exp(2*pi*i*k/N)
+// Cette récurrence n'amortit pas les erreurs d'arrondi, qui s'accumulent lentement : tous
+// les resyncInterval échantillons, les coefficients sont recalculés exactement sur la
+// fenêtre (Goertzel pour peu de coefficients, FFT réelle sinon).
+
+typedef struct SlidingDFT SlidingDFT;
+
+// bins : indices k suivis (0 <= k <= N/2) ; resyncInterval <= 0 désactive la resynchronisation
+SlidingDFT* createSlidingDFT(int N, const int* bins, int numBins, int resyncInterval);
+void slidingDFTUpdate(SlidingDFT* sdft, double sample);
+void slidingDFTPush(SlidingDFT* sdft, const double* samples, int count);
+// Recalcule les coefficients sur la fenêtre courante
+void slidingDFTResync(SlidingDFT* sdft);
+// Coefficients courants, dans l'ordre de bins
+const ComplexNumber* slidingDFTBins(const SlidingDFT* sdft);
+void destroySlidingDFT(SlidingDFT* sdft);
+
+// Coefficient k de la DFT de x[0..N-1] par l'algorithme de Goertzel (N multiplications réelles)
+ComplexNumber goertzel(const double* samples, int N, int k);
+
+#endif
@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "stft.h"
+#include "fft_real.h"
+
+#define PI 3.14159265358979323846
+
+struct STFT {
+    int windowSize;
+    int hop;
+    int bins;
+    double* window;
+    double* ring;           // windowSize derniers échantillons
+    int ringPos;            // position du plus ancien échantillon (prochaine écriture)
+    int untilNextFrame;     // échantillons à recevoir avant la prochaine trame
+    long long frames;
+    double* frame;          // fenêtre pondérée, entrée de la FFT
+    ComplexNumber* spectrum;
+    RealFFTPlan* plan;
+};
+
+static void fillWindow(double* w, int N, STFTWindow window) {
+    for (int i = 0; i < N; i++) {
+        double x = N > 1 ? 2 * PI * i / (N - 1) : 0;
+        switch (window) {
+        case STFT_HANN:     w[i] = 0.5 - 0.5 * cos(x); break;
+        case STFT_HAMMING:  w[i] = 0.54 - 0.46 * cos(x); break;
+        case STFT_BLACKMAN: w[i] = 0.42 - 0.5 * cos(x) + 0.08 * cos(2 * x); break;
+        default:            w[i] = 1; break;
+        }
+    }
+}
+
+STFT* createSTFT(int windowSize, int hop, STFTWindow window) {
+    if (windowSize < 1 || hop < 1) return NULL;
+    STFT* stft = (STFT*)calloc(1, sizeof(STFT));
+    if (stft == NULL) return NULL;
+    stft->windowSize = windowSize;
+    stft->hop = hop;
+    stft->bins = windowSize / 2 + 1;
+    stft->untilNextFrame = windowSize;
+    stft->window = (double*)malloc(windowSize * sizeof(double));
+    stft->ring = (double*)calloc(windowSize, sizeof(double));
+    stft->frame = (double*)malloc(windowSize * sizeof(double));
+    stft->spectrum = (ComplexNumber*)malloc(stft->bins * sizeof(ComplexNumber));
+    stft->plan = createRealFFTPlan(windowSize);
+    if (stft->window == NULL || stft->ring == NULL || stft->frame == NULL ||
+        stft->spectrum == NULL || stft->plan == NULL) {
+        destroySTFT(stft);
+        return NULL;
+    }
+    fillWindow(stft->window, windowSize, window);
+    return stft;
+}
+
+void destroySTFT(STFT* stft) {
+    if (stft == NULL) return;
+    free(stft->window);
+    free(stft->ring);
+    free(stft->frame);
+    free(stft->spectrum);
+    destroyRealFFTPlan(stft->plan);
+    free(stft);
+}
+
+int stftBins(const STFT* stft) {
+    return stft->bins;
+}
+
+// Copie n échantillons dans le tampon circulaire ; seuls les windowSize derniers comptent
+static void writeRing(STFT* stft, const double* samples, int n) {
+    int W = stft->windowSize;
+    if (n >= W) {
+        memcpy(stft->ring, samples + (n - W), W * sizeof(double));
+        stft->ringPos = 0;
+        return;
+    }
+    int first = W - stft->ringPos;
+    if (first > n) first = n;
+    memcpy(stft->ring + stft->ringPos, samples, first * sizeof(double));
+    memcpy(stft->ring, samples + first, (n - first) * sizeof(double));
+    stft->ringPos = (stft->ringPos + n) % W;
+}
+
+static void computeFrame(STFT* stft, SpectrumCallback emit, void* context) {
+    int W = stft->windowSize;
+    int tail = W - stft->ringPos;  // du plus ancien échantillon jusqu'à la fin du tampon
+    for (int i = 0; i < tail; i++) {
+        stft->frame[i] = stft->ring[stft->ringPos + i] * stft->window[i];
+    }
+    for (int i = tail; i < W; i++) {
+        stft->frame[i] = stft->ring[i - tail] * stft->window[i];
+    }
+    executeRealFFT(stft->plan, stft->frame, stft->spectrum);
+    emit(context, stft->frames++, stft->spectrum, stft->bins);
+}
+
+void stftPush(STFT* stft, const double* samples, int count, SpectrumCallback emit, void* context) {
+    while (count > 0) {
+        int n = count < stft->untilNextFrame ? count : stft->untilNextFrame;
+        writeRing(stft, samples, n);
+        samples += n;
+        count -= n;
+        stft->untilNextFrame -= n;
+        if (stft->untilNextFrame == 0) {
+            computeFrame(stft, emit, context);
+            stft->untilNextFrame = stft->hop;
+        }
+    }
+}
+
+// Deux emplacements passés alternativement d'un thread producteur à un consommateur
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int full[2];
+} SlotPair;
+
+static void initSlots(SlotPair* s) {
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->changed, NULL);
+    s->full[0] = s->full[1] = 0;
+}
+
+static void destroySlots(SlotPair* s) {
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->changed);
+}
+
+static void waitSlot(SlotPair* s, int slot, int full) {
+    pthread_mutex_lock(&s->lock);
+    while (s->full[slot] != full) pthread_cond_wait(&s->changed, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void setSlot(SlotPair* s, int slot, int full) {
+    pthread_mutex_lock(&s->lock);
+    s->full[slot] = full;
+    pthread_cond_broadcast(&s->changed);
+    pthread_mutex_unlock(&s->lock);
+}
+
+typedef struct {
+    int windowSize;
+    int hop;
+    int bins;
+    SampleReader read;
+    void* readContext;
+    SpectrumCallback emit;
+    void* emitContext;
+
+    // Entrée : blocs d'échantillons remplis par le thread de lecture (0 = fin du flux)
+    SlotPair input;
+    double* blocks[2];
+    int blockCount[2];
+
+    // Sortie : une trame par emplacement, émise dès qu'elle est calculée
+    SlotPair output;
+    ComplexNumber* spectra[2];
+    long long frameIndex[2];
+    int frameLast[2];       // fin du flux, l'emplacement ne contient pas de trame
+    int currentFrame;
+} StreamPipeline;
+
+// Chaque lecture demande exactement les échantillons qui complètent la trame suivante :
+// la première fenêtre, puis un pas. Une trame est donc calculée dès que son dernier
+// échantillon est arrivé, sans attendre un bloc plus grand.
+static void* readerThread(void* arg) {
+    StreamPipeline* p = (StreamPipeline*)arg;
+    for (int b = 0;; b++) {
+        int slot = b % 2;
+        waitSlot(&p->input, slot, 0);
+        int n = p->read(p->readContext, p->blocks[slot], b == 0 ? p->windowSize : p->hop);
+        p->blockCount[slot] = n > 0 ? n : 0;
+        setSlot(&p->input, slot, 1);
+        if (n <= 0) break;
+    }
+    return NULL;
+}
+
+static void* emitterThread(void* arg) {
+    StreamPipeline* p = (StreamPipeline*)arg;
+    for (int f = 0;; f++) {
+        int slot = f % 2;
+        waitSlot(&p->output, slot, 1);
+        int last = p->frameLast[slot];
+        if (!last) p->emit(p->emitContext, p->frameIndex[slot], p->spectra[slot], p->bins);
+        setSlot(&p->output, slot, 0);
+        if (last) break;
+    }
+    return NULL;
+}
+
+// Confie une trame (ou la fin du flux) au thread d'émission ; l'émission de cette trame
+// recouvre le calcul de la suivante
+static void handOver(StreamPipeline* p, long long frame, const ComplexNumber* spectrum, int last) {
+    int slot = p->currentFrame;
+    waitSlot(&p->output, slot, 0);
+    if (!last) memcpy(p->spectra[slot], spectrum, p->bins * sizeof(ComplexNumber));
+    p->frameIndex[slot] = frame;
+    p->frameLast[slot] = last;
+    setSlot(&p->output, slot, 1);
+    p->currentFrame = 1 - slot;
+}
+
+static void collectFrame(void* context, long long frame, const ComplexNumber* spectrum, int bins) {
+    (void)bins;
+    handOver((StreamPipeline*)context, frame, spectrum, 0);
+}
+
+long long runSTFTStream(int windowSize, int hop, STFTWindow window,
+                        SampleReader read, void* readContext,
+                        SpectrumCallback emit, void* emitContext) {
+    STFT* stft = createSTFT(windowSize, hop, window);
+    if (stft == NULL) return -1;
+
+    StreamPipeline p;
+    memset(&p, 0, sizeof(p));
+    p.windowSize = windowSize;
+    p.hop = hop;
+    p.bins = stft->bins;
+    p.read = read;
+    p.readContext = readContext;
+    p.emit = emit;
+    p.emitContext = emitContext;
+    int blockSize = windowSize > hop ? windowSize : hop;
+    for (int s = 0; s < 2; s++) {
+        p.blocks[s] = (double*)malloc(blockSize * sizeof(double));
+        p.spectra[s] = (ComplexNumber*)malloc(p.bins * sizeof(ComplexNumber));
+    }
+    if (p.blocks[0] == NULL || p.blocks[1] == NULL || p.spectra[0] == NULL || p.spectra[1] == NULL) {
+        for (int s = 0; s < 2; s++) {
+            free(p.blocks[s]);
+            free(p.spectra[s]);
+        }
+        destroySTFT(stft);
+        return -1;
+    }
+    initSlots(&p.input);
+    initSlots(&p.output);
+
+    pthread_t reader, emitter;
+    pthread_create(&reader, NULL, readerThread, &p);
+    pthread_create(&emitter, NULL, emitterThread, &p);
+
+    // Le thread appelant calcule pendant que les deux autres lisent et émettent
+    for (int b = 0;; b++) {
+        int slot = b % 2;
+        waitSlot(&p.input, slot, 1);
+        int n = p.blockCount[slot];
+        if (n > 0) stftPush(stft, p.blocks[slot], n, collectFrame, &p);
+        setSlot(&p.input, slot, 0);
+        if (n == 0) break;
+    }
+    handOver(&p, 0, NULL, 1);
+
+    pthread_join(reader, NULL);
+    pthread_join(emitter, NULL);
+    long long frames = stft->frames;
+
+    destroySlots(&p.input);
+    destroySlots(&p.output);
+    for (int s = 0; s < 2; s++) {
+        free(p.blocks[s]);
+        free(p.spectra[s]);
+    }
+    destroySTFT(stft);
+    return frames;
+}
@@ -0,0 +1,43 @@
+#ifndef STFT_H
+#define STFT_H
+
+#include "fft.h"
+
+// Transformée de Fourier à court terme sur un flux continu d'échantillons réels.
+// Les échantillons sont accumulés dans un tampon circulaire de la taille de la fenêtre ;
+// une trame (fenêtre pondérée puis FFT réelle, N/2+1 coefficients) est produite tous
+// les hop échantillons dès que la première fenêtre est complète. Un seul plan FFT et
+// un seul tampon circulaire sont utilisés pendant toute la durée du flux.
+
+typedef enum {
+    STFT_RECTANGULAR,
+    STFT_HANN,
+    STFT_HAMMING,
+    STFT_BLACKMAN
+} STFTWindow;
+
+// Appelée pour chaque trame ; spectrum n'est valide que pendant l'appel
+typedef void (*SpectrumCallback)(void* context, long long frame, const ComplexNumber* spectrum, int bins);
+// Lit au plus count échantillons ; retourne le nombre lu, 0 en fin de flux. Pour qu'une trame
+// parte dès son dernier échantillon, la lecture ne doit rendre moins de count qu'en fin de flux.
+typedef int (*SampleReader)(void* context, double* samples, int count);
+
+typedef struct STFT STFT;
+
+STFT* createSTFT(int windowSize, int hop, STFTWindow window);
+// Ajoute count échantillons et appelle emit pour chaque trame complétée
+void stftPush(STFT* stft, const double* samples, int count, SpectrumCallback emit, void* context);
+int stftBins(const STFT* stft);
+void destroySTFT(STFT* stft);
+
+// Chaîne complète sur trois threads : lecture, calcul (thread appelant) et émission.
+// Chaque lecture demande les échantillons de la trame suivante (la fenêtre, puis hop) et
+// chaque trame est passée seule au thread d'émission : la latence d'une trame est celle de
+// son dernier échantillon plus une FFT. Entrée et sortie sont en double tampon, de sorte que
+// la lecture du pas suivant et l'écriture de la trame précédente recouvrent le calcul.
+// Retourne le nombre de trames émises, -1 en cas d'erreur.
+long long runSTFTStream(int windowSize, int hop, STFTWindow window,
+                        SampleReader read, void* readContext,
+                        SpectrumCallback emit, void* emitContext);
+
+#endif
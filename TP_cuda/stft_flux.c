@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "stft.h"
+#include "../TP_pthreads/perf_counters.h"
+
+#define DEFAULT_WINDOW 1024
+
+typedef enum { FORMAT_F32, FORMAT_F64, FORMAT_S16 } SampleFormat;
+
+typedef struct {
+    FILE* file;
+    SampleFormat format;
+    size_t sampleBytes;
+    unsigned char* raw;   // lecture brute (une fenêtre ou un pas) avant conversion en double
+    long long samples;
+} InputStream;
+
+typedef struct {
+    FILE* file;           // magnitudes float32, N/2+1 par trame ; NULL : texte sur stdout
+    double sampleRate;
+    int hop;
+    int windowSize;
+    float* magnitudes;
+} OutputStream;
+
+int readSamples(void* context, double* samples, int count) {
+    InputStream* in = (InputStream*)context;
+    size_t n = fread(in->raw, in->sampleBytes, count, in->file);
+    for (size_t i = 0; i < n; i++) {
+        switch (in->format) {
+        case FORMAT_F32: samples[i] = ((float*)in->raw)[i]; break;
+        case FORMAT_F64: samples[i] = ((double*)in->raw)[i]; break;
+        case FORMAT_S16: samples[i] = ((int16_t*)in->raw)[i] / 32768.0; break;
+        }
+    }
+    in->samples += n;
+    return (int)n;
+}
+
+// Écrit chaque trame dès qu'elle arrive et la vide aussitôt, pour qu'un lecteur en aval la
+// reçoive un pas après ses échantillons : magnitudes binaires ou pic dominant en texte
+void writeSpectrum(void* context, long long frame, const ComplexNumber* spectrum, int bins) {
+    OutputStream* out = (OutputStream*)context;
+    if (out->file != NULL) {
+        for (int k = 0; k < bins; k++) {
+            out->magnitudes[k] = (float)hypot(spectrum[k].real, spectrum[k].imag);
+        }
+        fwrite(out->magnitudes, sizeof(float), bins, out->file);
+        fflush(out->file);
+        return;
+    }
+
+    int peak = 0;
+    double peakMagnitude = 0;
+    for (int k = 1; k < bins; k++) {
+        double m = hypot(spectrum[k].real, spectrum[k].imag);
+        if (m > peakMagnitude) {
+            peakMagnitude = m;
+            peak = k;
+        }
+    }
+    double time = ((double)frame * out->hop + out->windowSize) / out->sampleRate;
+    printf("trame %lld : t = %.4f s, pic = %.1f Hz, magnitude = %.3f\n",
+           frame, time, peak * out->sampleRate / out->windowSize, peakMagnitude);
+    fflush(stdout);
+}
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "Usage : %s [-n taille] [-p pas] [-w rect|hann|hamming|blackman]\n"
+            "          [-f f32|f64|s16] [-r fréquence] [-o sortie] [fichier | -]\n"
+            "  Lit des échantillons bruts (fichier ou entrée standard) et produit un spectre\n"
+            "  tous les <pas> échantillons. Avec -o, les magnitudes sont écrites en float32\n"
+            "  (taille/2+1 valeurs par trame) ; sinon le pic de chaque trame est affiché.\n",
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    int windowSize = DEFAULT_WINDOW;
+    int hop = -1;
+    STFTWindow window = STFT_HANN;
+    InputStream in = {stdin, FORMAT_F32, sizeof(float), NULL, 0};
+    OutputStream out = {NULL, 44100, 0, 0, NULL};
+    const char* outputPath = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:p:w:f:r:o:")) != -1) {
+        switch (opt) {
+        case 'n': windowSize = atoi(optarg); break;
+        case 'p': hop = atoi(optarg); break;
+        case 'r': out.sampleRate = atof(optarg); break;
+        case 'o': outputPath = optarg; break;
+        case 'w':
+            if (strcmp(optarg, "rect") == 0) window = STFT_RECTANGULAR;
+            else if (strcmp(optarg, "hann") == 0) window = STFT_HANN;
+            else if (strcmp(optarg, "hamming") == 0) window = STFT_HAMMING;
+            else if (strcmp(optarg, "blackman") == 0) window = STFT_BLACKMAN;
+            else { usage(argv[0]); return 1; }
+            break;
+        case 'f':
+            if (strcmp(optarg, "f32") == 0) { in.format = FORMAT_F32; in.sampleBytes = sizeof(float); }
+            else if (strcmp(optarg, "f64") == 0) { in.format = FORMAT_F64; in.sampleBytes = sizeof(double); }
+            else if (strcmp(optarg, "s16") == 0) { in.format = FORMAT_S16; in.sampleBytes = sizeof(int16_t); }
+            else { usage(argv[0]); return 1; }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (hop < 0) hop = windowSize / 4;
+    if (windowSize < 2 || hop < 1 || out.sampleRate <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        in.file = fopen(argv[optind], "rb");
+        if (in.file == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+    if (outputPath != NULL) {
+        out.file = fopen(outputPath, "wb");
+        if (out.file == NULL) {
+            perror(outputPath);
+            return 1;
+        }
+    }
+    out.hop = hop;
+    out.windowSize = windowSize;
+    in.raw = (unsigned char*)malloc((windowSize > hop ? windowSize : hop) * in.sampleBytes);
+    out.magnitudes = (float*)malloc((windowSize / 2 + 1) * sizeof(float));
+    if (in.raw == NULL || out.magnitudes == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire.\n");
+        return 1;
+    }
+
+    // Le thread appelant fait le calcul : ses compteurs sont ceux des FFT, le temps inclut
+    // l'attente des entrées
+    perf_region* region = perf_region_create("STFT", 1);
+    perf_region_begin(region, 0);
+    long long frames = runSTFTStream(windowSize, hop, window, readSamples, &in, writeSpectrum, &out);
+    perf_region_end(region, 0);
+    if (frames < 0) {
+        fprintf(stderr, "Erreur de création de la STFT.\n");
+        return 1;
+    }
+
+    double t = perf_region_seconds(region);
+    fprintf(stderr, "%lld échantillons, %lld trames (fenêtre %d, pas %d) en %f secondes, %.1f Méch/s\n",
+            in.samples, frames, windowSize, hop, t, t > 0 ? in.samples / t / 1e6 : 0.0);
+    // Par trame : FFT réelle (2.5 N log2 N) et fenêtrage ; échantillons lus, magnitudes écrites
+    int bins = windowSize / 2 + 1;
+    perf_region_add_work(region, frames * (2.5 * windowSize * log2(windowSize) + windowSize),
+                         in.samples * (double)in.sampleBytes + frames * (double)bins * sizeof(float));
+    perf_region_report(region, stderr);
+    perf_region_free(region);
+
+    if (in.file != stdin) fclose(in.file);
+    if (out.file != NULL) fclose(out.file);
+    free(in.raw);
+    free(out.magnitudes);
+    return 0;
+}
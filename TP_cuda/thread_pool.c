@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+#define TASKS_PER_THREAD 4  // tranches créées par thread pour équilibrer la charge
+
+typedef struct {
+    atomic_int remaining;
+} TaskGroup;
+
+typedef struct {
+    ParallelBody body;
+    void* context;
+    int begin;
+    int end;
+    TaskGroup* group;
+} Task;
+
+// File double protégée par un verrou : le propriétaire pousse et dépile en queue,
+// les voleurs prennent en tête.
+typedef struct {
+    pthread_mutex_t lock;
+    Task* tasks;
+    int capacity;
+    int head;
+    int tail;
+} WorkDeque;
+
+typedef struct {
+    ThreadPool* pool;
+    int index;
+} WorkerArgs;
+
+struct ThreadPool {
+    int numThreads;
+    pthread_t* threads;
+    WorkerArgs* args;
+    WorkDeque* deques;
+    atomic_int queuedTasks;
+    atomic_int externalCaller;  // 1 tant qu'un thread extérieur occupe l'emplacement 0
+    int stop;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeUp;
+};
+
+// Pool et indice du thread courant ; un thread extérieur n'a d'indice que dans le pool
+// dont il exécute un threadPoolParallelFor (emplacement 0)
+static __thread ThreadPool* currentPool = NULL;
+static __thread int currentWorker = -1;
+
+static void pushTask(ThreadPool* pool, int worker, Task task) {
+    WorkDeque* d = &pool->deques[worker];
+    pthread_mutex_lock(&d->lock);
+    if (d->tail - d->head == d->capacity) {
+        int capacity = d->capacity * 2;
+        Task* tasks = (Task*)malloc(capacity * sizeof(Task));
+        if (tasks == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire (pool de threads).\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = d->head; i < d->tail; i++) {
+            tasks[i - d->head] = d->tasks[i % d->capacity];
+        }
+        free(d->tasks);
+        d->tasks = tasks;
+        d->tail -= d->head;
+        d->head = 0;
+        d->capacity = capacity;
+    }
+    d->tasks[d->tail % d->capacity] = task;
+    d->tail++;
+    pthread_mutex_unlock(&d->lock);
+    atomic_fetch_add(&pool->queuedTasks, 1);
+}
+
+static int popTask(ThreadPool* pool, int worker, Task* task) {
+    WorkDeque* d = &pool->deques[worker];
+    int found = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->tail > d->head) {
+        d->tail--;
+        *task = d->tasks[d->tail % d->capacity];
+        found = 1;
+        if (d->tail == d->head) d->head = d->tail = 0;
+    }
+    pthread_mutex_unlock(&d->lock);
+    if (found) atomic_fetch_sub(&pool->queuedTasks, 1);
+    return found;
+}
+
+static int stealTask(ThreadPool* pool, int thief, Task* task) {
+    for (int offset = 1; offset < pool->numThreads; offset++) {
+        WorkDeque* d = &pool->deques[(thief + offset) % pool->numThreads];
+        int found = 0;
+        pthread_mutex_lock(&d->lock);
+        if (d->tail > d->head) {
+            *task = d->tasks[d->head % d->capacity];
+            d->head++;
+            found = 1;
+            if (d->tail == d->head) d->head = d->tail = 0;
+        }
+        pthread_mutex_unlock(&d->lock);
+        if (found) {
+            atomic_fetch_sub(&pool->queuedTasks, 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int findTask(ThreadPool* pool, int worker, Task* task) {
+    return popTask(pool, worker, task) || stealTask(pool, worker, task);
+}
+
+static void runTask(Task* task, int worker) {
+    task->body(task->context, task->begin, task->end, worker);
+    atomic_fetch_sub(&task->group->remaining, 1);
+}
+
+static void* workerLoop(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    ThreadPool* pool = args->pool;
+    int worker = args->index;
+    currentPool = pool;
+    currentWorker = worker;
+
+    while (1) {
+        Task task;
+        if (findTask(pool, worker, &task)) {
+            runTask(&task, worker);
+            continue;
+        }
+        pthread_mutex_lock(&pool->sleepLock);
+        while (atomic_load(&pool->queuedTasks) == 0 && !pool->stop) {
+            pthread_cond_wait(&pool->wakeUp, &pool->sleepLock);
+        }
+        int stop = pool->stop;
+        pthread_mutex_unlock(&pool->sleepLock);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+ThreadPool* createThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = cores > 0 ? (int)cores : 1;
+    }
+
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    if (pool == NULL) return NULL;
+    pool->numThreads = numThreads;
+    pool->threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    pool->args = (WorkerArgs*)malloc(numThreads * sizeof(WorkerArgs));
+    pool->deques = (WorkDeque*)calloc(numThreads, sizeof(WorkDeque));
+    if (pool->threads == NULL || pool->args == NULL || pool->deques == NULL) {
+        free(pool->threads);
+        free(pool->args);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    atomic_init(&pool->queuedTasks, 0);
+    atomic_init(&pool->externalCaller, 0);
+    pthread_mutex_init(&pool->sleepLock, NULL);
+    pthread_cond_init(&pool->wakeUp, NULL);
+    for (int t = 0; t < numThreads; t++) {
+        pthread_mutex_init(&pool->deques[t].lock, NULL);
+        pool->deques[t].capacity = 64;
+        pool->deques[t].tasks = (Task*)malloc(64 * sizeof(Task));
+    }
+
+    // Le thread 0 est l'appelant : seuls les threads 1..numThreads-1 sont créés
+    for (int t = 1; t < numThreads; t++) {
+        pool->args[t].pool = pool;
+        pool->args[t].index = t;
+        pthread_create(&pool->threads[t], NULL, workerLoop, &pool->args[t]);
+    }
+    return pool;
+}
+
+void destroyThreadPool(ThreadPool* pool) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->sleepLock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wakeUp);
+    pthread_mutex_unlock(&pool->sleepLock);
+
+    for (int t = 1; t < pool->numThreads; t++) {
+        pthread_join(pool->threads[t], NULL);
+    }
+    for (int t = 0; t < pool->numThreads; t++) {
+        pthread_mutex_destroy(&pool->deques[t].lock);
+        free(pool->deques[t].tasks);
+    }
+    pthread_mutex_destroy(&pool->sleepLock);
+    pthread_cond_destroy(&pool->wakeUp);
+    free(pool->threads);
+    free(pool->args);
+    free(pool->deques);
+    free(pool);
+}
+
+int threadPoolSize(const ThreadPool* pool) {
+    return pool->numThreads;
+}
+
+static void parallelFor(ThreadPool* pool, int worker, int begin, int end, int grain,
+                        ParallelBody body, void* context) {
+    int count = end - begin;
+    if (grain < 1) grain = 1;
+    int chunk = (count + pool->numThreads * TASKS_PER_THREAD - 1) / (pool->numThreads * TASKS_PER_THREAD);
+    if (chunk < grain) chunk = grain;
+    int numTasks = (count + chunk - 1) / chunk;
+
+    if (numTasks == 1 || pool->numThreads == 1) {
+        body(context, begin, end, worker);
+        return;
+    }
+
+    TaskGroup group;
+    atomic_init(&group.remaining, numTasks);
+    // Poussées en ordre inverse : le propriétaire dépile les premières tranches,
+    // les voleurs prennent les dernières
+    for (int t = numTasks - 1; t >= 0; t--) {
+        int b = begin + t * chunk;
+        int e = (b + chunk < end) ? b + chunk : end;
+        Task task = {body, context, b, e, &group};
+        pushTask(pool, worker, task);
+    }
+
+    pthread_mutex_lock(&pool->sleepLock);
+    pthread_cond_broadcast(&pool->wakeUp);
+    pthread_mutex_unlock(&pool->sleepLock);
+
+    // L'appelant travaille (ses tâches ou celles des autres) jusqu'à la fin du groupe
+    while (atomic_load(&group.remaining) > 0) {
+        Task task;
+        if (findTask(pool, worker, &task)) {
+            runTask(&task, worker);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void threadPoolParallelFor(ThreadPool* pool, int begin, int end, int grain,
+                           ParallelBody body, void* context) {
+    if (end <= begin) return;
+    if (currentPool == pool) {
+        parallelFor(pool, currentWorker, begin, end, grain, body, context);
+        return;
+    }
+
+    // Thread extérieur : il prend l'emplacement 0 (file et tampons par thread de l'appelant)
+    // pendant l'appel, les appels imbriqués de ses tâches le gardent. Deux threads extérieurs
+    // simultanés se partageraient ces tampons : c'est une erreur de programmation.
+    if (atomic_exchange(&pool->externalCaller, 1)) {
+        fprintf(stderr, "Erreur : deux threads extérieurs utilisent le même pool de threads en même temps.\n");
+        abort();
+    }
+    ThreadPool* previousPool = currentPool;
+    int previousWorker = currentWorker;
+    currentPool = pool;
+    currentWorker = 0;
+    parallelFor(pool, 0, begin, end, grain, body, context);
+    currentPool = previousPool;
+    currentWorker = previousWorker;
+    atomic_store(&pool->externalCaller, 0);
+}
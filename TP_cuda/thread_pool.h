@@ -0,0 +1,26 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Pool de threads à vol de tâches : chaque thread possède une file double dont il dépile
+// les tâches par le bas ; un thread inactif vole les tâches les plus anciennes des autres.
+// Le thread appelant compte comme le thread 0 et participe au calcul : un seul thread
+// extérieur au pool peut l'utiliser à la fois (le programme s'arrête sinon).
+
+typedef struct ThreadPool ThreadPool;
+
+// body(context, begin, end, worker) traite l'intervalle [begin, end[ ; worker est l'indice
+// du thread qui l'exécute (0 <= worker < threadPoolSize), utile pour les tampons par thread.
+typedef void (*ParallelBody)(void* context, int begin, int end, int worker);
+
+// numThreads <= 0 : un thread par coeur disponible
+ThreadPool* createThreadPool(int numThreads);
+void destroyThreadPool(ThreadPool* pool);
+int threadPoolSize(const ThreadPool* pool);
+
+// Découpe [begin, end[ en tranches d'au moins grain éléments et attend qu'elles soient
+// toutes traitées. Peut être appelée depuis une tâche (parallélisme imbriqué), ou depuis
+// un thread d'un autre pool, qui est alors le thread extérieur de celui-ci.
+void threadPoolParallelFor(ThreadPool* pool, int begin, int end, int grain,
+                           ParallelBody body, void* context);
+
+#endif
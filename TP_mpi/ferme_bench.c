@@ -0,0 +1,178 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "ferme_taches.h"
+
+#define NB_ELEMENTS_DEFAUT 4000000
+#define VALEUR_MAX 46340 // le carré tient dans un int
+#define FICHIER_DEFAUT "ferme_resultats.bin"
+
+#define FERME_ORIGINALE 0
+#define FERME_DYNAMIQUE 1
+#define FERME_DISTRIBUEE 2
+
+#define VARIANTE_DETAILLEE 5 // « hybride, guidé » : compteurs détaillés de chaque esclave
+
+// Noyau de main.c : chaque élément est remplacé par son carré
+void noyau_carre(void* contexte, void* donnees, long premier, int nb) {
+    int* x = (int*)donnees;
+    (void)contexte;
+    (void)premier;
+    for (int i = 0; i < nb; i++) x[i] = x[i] * x[i];
+}
+
+// Noyau plus coûteux : *cout itérations d'un générateur congruentiel par élément
+void noyau_calcul(void* contexte, void* donnees, long premier, int nb) {
+    int cout = *(int*)contexte;
+    int* x = (int*)donnees;
+    (void)premier;
+    for (int i = 0; i < nb; i++) {
+        unsigned v = (unsigned)x[i];
+        for (int j = 0; j < cout; j++) v = v * 1664525u + 1013904223u;
+        x[i] = (int)(v & 0x7fffffff);
+    }
+}
+
+// Entrées calculables à partir des indices, pour que ferme_distribuee n'ait rien à centraliser
+void initialiser_morceau(void* contexte, void* donnees, long premier, int nb) {
+    int* x = (int*)donnees;
+    (void)contexte;
+    for (int i = 0; i < nb; i++) x[i] = (int)((premier + i) % VALEUR_MAX);
+}
+
+void initialiser(int* x, long n) {
+    initialiser_morceau(NULL, x, 0, (int)n);
+}
+
+// Relit le fichier écrit par ferme_distribuee
+void lire_resultats(const char* fichier, int* x, long n) {
+    FILE* f = fopen(fichier, "rb");
+    if (f == NULL || fread(x, sizeof(int), n, f) != (size_t)n) {
+        fprintf(stderr, "Impossible de relire %s.\n", fichier);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    fclose(f);
+}
+
+long verifier(const int* x, const int* reference, long n) {
+    long erreurs = 0;
+    for (long i = 0; i < n; i++) erreurs += x[i] != reference[i];
+    return erreurs;
+}
+
+// Usage : mpirun -np P ./ferme_bench [nb éléments] [coût du noyau de calcul] [threads par esclave]
+//                                     [fichier de résultats de la file distribuée]
+int main(int argc, char* argv[]) {
+    int rang, nb_processus;
+    int niveau = ferme_init_hybride(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rang);
+    MPI_Comm_size(MPI_COMM_WORLD, &nb_processus);
+
+    long n = argc > 1 ? atol(argv[1]) : NB_ELEMENTS_DEFAUT;
+    int cout = argc > 2 ? atoi(argv[2]) : 200;
+#ifdef _OPENMP
+    int nb_threads = argc > 3 ? atoi(argv[3]) : omp_get_max_threads();
+#else
+    int nb_threads = 1;
+#endif
+    const char* fichier = argc > 4 ? argv[4] : FICHIER_DEFAUT;
+
+    struct {
+        const char* nom;
+        int mode;
+        int morceau_min, morceau_max, prefetch, nb_threads;
+    } variantes[] = {
+        {"main.c, blocs de 10", FERME_ORIGINALE, 10, 10, 1, 1},
+        {"main.c, blocs de 4096", FERME_ORIGINALE, 4096, 4096, 1, 1},
+        {"prefetch 1, fixe 4096", FERME_DYNAMIQUE, 4096, 4096, 1, 1},
+        {"prefetch 2, guidé", FERME_DYNAMIQUE, 1024, 65536, 2, 1},
+        {"prefetch 4, guidé", FERME_DYNAMIQUE, 1024, 65536, 4, 1},
+        {"hybride, guidé", FERME_DYNAMIQUE, 1024, 65536, 2, nb_threads},
+        {"file distribuée (RMA)", FERME_DISTRIBUEE, 1024, 65536, 1, 1},
+    };
+    int nb_variantes = sizeof(variantes) / sizeof(variantes[0]);
+
+    struct {
+        const char* nom;
+        noyau_ferme noyau;
+    } noyaux[] = {{"carré", noyau_carre}, {"calcul", noyau_calcul}};
+
+    int* donnees = NULL;
+    int* reference = NULL;
+    if (rang == 0) {
+        donnees = (int*)malloc(n * sizeof(int));
+        reference = (int*)malloc(n * sizeof(int));
+        if (donnees == NULL || reference == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        printf("%ld éléments, %d processus (%d esclaves), coût du noyau de calcul : %d\n", n,
+               nb_processus, nb_processus - 1, cout);
+        printf("Mode hybride : %d threads par esclave, %s\n", nb_threads,
+               niveau == MPI_THREAD_MULTIPLE ? "MPI_THREAD_MULTIPLE" : "MPI_THREAD_FUNNELED");
+    }
+
+    int ok = 1;
+    perf_region* detail = NULL;
+    for (int k = 0; k < 2; k++) {
+        if (rang == 0) {
+            initialiser(reference, n);
+            noyaux[k].noyau(&cout, reference, 0, (int)n);
+            printf("\nNoyau %s\n%-24s | %10s | %10s | %10s | %9s | %12s | %s\n", noyaux[k].nom, "variante",
+                   "temps (s)", "calcul (s)", "morceaux", "messages", "Méléments/s", "erreurs");
+        }
+        for (int v = 0; v < nb_variantes; v++) {
+            char nom[64];
+            snprintf(nom, sizeof(nom), "rang %d, %s", rang, variantes[v].nom);
+            perf_region* region = perf_region_create(nom, variantes[v].nb_threads);
+            config_ferme c = {n, sizeof(int), variantes[v].morceau_min, variantes[v].morceau_max,
+                              variantes[v].prefetch, noyaux[k].noyau, &cout, variantes[v].nb_threads, region};
+            statistiques_ferme stats;
+            if (rang == 0) initialiser(donnees, n);
+            MPI_Barrier(MPI_COMM_WORLD);
+            if (variantes[v].mode == FERME_DISTRIBUEE) {
+                ferme_distribuee(&c, initialiser_morceau, fichier, MPI_COMM_WORLD, &stats);
+                if (rang == 0) lire_resultats(fichier, donnees, n);
+            } else if (variantes[v].mode == FERME_DYNAMIQUE) {
+                ferme_dynamique(&c, donnees, MPI_COMM_WORLD, &stats);
+            } else {
+                ferme_originale(&c, donnees, MPI_COMM_WORLD, &stats);
+            }
+            // Temps de calcul du rang le plus chargé : l'écart avec le temps total est le coût
+            // de la distribution
+            double calcul = perf_region_seconds(region);
+            double calcul_max = 0;
+            MPI_Reduce(&calcul, &calcul_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+            if (rang == 0) {
+                long erreurs = verifier(donnees, reference, n);
+                ok &= erreurs == 0;
+                printf("%-24s | %10.4f | %10.4f | %10ld | %9ld | %12.2f | %ld\n", variantes[v].nom, stats.temps,
+                       calcul_max, stats.morceaux, stats.messages, n / stats.temps / 1e6, erreurs);
+            }
+            if (k == 1 && v == VARIANTE_DETAILLEE) {
+                detail = region;
+            } else {
+                perf_region_free(region);
+            }
+        }
+    }
+
+    // Compteurs de chaque esclave pour la variante hybride du noyau de calcul, rang par rang
+    fflush(stdout);
+    for (int r = 1; r < nb_processus; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rang == r) {
+            perf_region_report(detail, stdout);
+            fflush(stdout);
+        }
+    }
+    perf_region_free(detail);
+
+    free(donnees);
+    free(reference);
+    MPI_Finalize();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ferme_taches.h"
+
+#define NB_ELEMENTS_DEFAUT 50000000
+#define TAILLE_LECTURE 1048576 // éléments relus à la fois pour la vérification
+#define VALEUR_MAX 46340
+
+void initialiser_morceau(void* contexte, void* donnees, long premier, int nb) {
+    int* x = (int*)donnees;
+    (void)contexte;
+    for (int i = 0; i < nb; i++) x[i] = (int)((premier + i) % VALEUR_MAX);
+}
+
+void noyau_identite(void* contexte, void* donnees, long premier, int nb) {
+    (void)contexte;
+    (void)donnees;
+    (void)premier;
+    (void)nb;
+}
+
+void noyau_calcul(void* contexte, void* donnees, long premier, int nb) {
+    int cout = *(int*)contexte;
+    int* x = (int*)donnees;
+    (void)premier;
+    for (int i = 0; i < nb; i++) {
+        unsigned v = (unsigned)x[i];
+        for (int j = 0; j < cout; j++) v = v * 1664525u + 1013904223u;
+        x[i] = (int)(v & 0x7fffffff);
+    }
+}
+
+// Relecture par morceaux : la mémoire du rang 0 ne dépend pas de la taille des données
+long verifier_fichier(const char* fichier, long n, int cout) {
+    FILE* f = fopen(fichier, "rb");
+    int* lu = (int*)malloc(TAILLE_LECTURE * sizeof(int));
+    int* attendu = (int*)malloc(TAILLE_LECTURE * sizeof(int));
+    if (f == NULL || lu == NULL || attendu == NULL) {
+        fprintf(stderr, "Impossible de relire %s.\n", fichier);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    long erreurs = 0;
+    for (long premier = 0; premier < n; premier += TAILLE_LECTURE) {
+        int nb = n - premier < TAILLE_LECTURE ? (int)(n - premier) : TAILLE_LECTURE;
+        if (fread(lu, sizeof(int), nb, f) != (size_t)nb) {
+            erreurs += n - premier;
+            break;
+        }
+        initialiser_morceau(NULL, attendu, premier, nb);
+        noyau_calcul(&cout, attendu, premier, nb);
+        for (int i = 0; i < nb; i++) erreurs += lu[i] != attendu[i];
+    }
+    fclose(f);
+    free(lu);
+    free(attendu);
+    return erreurs;
+}
+
+// Usage : mpirun -np P ./ferme_mpiio fichier [nb éléments] [coût du noyau] [fichier de sortie]
+// Sans fichier de sortie, les résultats remplacent les données d'entrée.
+int main(int argc, char* argv[]) {
+    int rang, nb_processus;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rang);
+    MPI_Comm_size(MPI_COMM_WORLD, &nb_processus);
+    if (argc < 2) {
+        if (rang == 0) fprintf(stderr, "Usage : %s fichier [nb éléments] [coût] [sortie]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+    const char* entree = argv[1];
+    long n = argc > 2 ? atol(argv[2]) : NB_ELEMENTS_DEFAUT;
+    int cout = argc > 3 ? atoi(argv[3]) : 50;
+    const char* sortie = argc > 4 ? argv[4] : entree;
+    statistiques_ferme stats;
+
+    // Données d'entrée écrites en parallèle, sans passer par le rang 0
+    config_ferme generation = {n, sizeof(int), 65536, 1 << 20, 1, noyau_identite, NULL, 1, NULL};
+    ferme_distribuee(&generation, initialiser_morceau, entree, MPI_COMM_WORLD, &stats);
+    if (rang == 0) {
+        printf("%ld éléments (%.1f Mo) générés dans %s en %.3f s\n", n, n * sizeof(int) / 1e6, entree,
+               stats.temps);
+    }
+
+    char nom[32];
+    snprintf(nom, sizeof(nom), "esclave %d", rang);
+    perf_region* region = perf_region_create(nom, 1);
+    config_ferme c = {n, sizeof(int), 4096, 1 << 20, 1, noyau_calcul, &cout, 1, region};
+    ferme_fichier(&c, entree, sortie, MPI_COMM_WORLD, &stats);
+
+    int ok = 1;
+    if (rang == 0) {
+        long erreurs = verifier_fichier(sortie, n, cout);
+        ok = erreurs == 0;
+        printf("Ferme sur fichier (%s) : %.3f s, %.2f Méléments/s\n", sortie == entree ? "en place" : sortie,
+               stats.temps, n / stats.temps / 1e6);
+        printf("Lots : %ld, messages du maître : %ld (indices seulement), erreurs : %ld\n", stats.morceaux,
+               stats.messages, erreurs);
+        fflush(stdout);
+    }
+    // Calcul seul de chaque esclave, hors lectures et écritures du fichier
+    for (int r = 1; r < nb_processus; r++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rang == r) {
+            perf_region_report(region, stdout);
+            fflush(stdout);
+        }
+    }
+    perf_region_free(region);
+    MPI_Finalize();
+    return ok ? 0 : 1;
+}
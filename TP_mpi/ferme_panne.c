@@ -0,0 +1,114 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ferme_taches.h"
+
+// Noyau de test de ferme_tolerante : des rangs peuvent être ralentis, bloqués, ou arrêter tout
+// le travail en traitant un indice donné (arrêt brutal, pour tester la reprise)
+typedef struct {
+    int cout;
+    int rang;
+    int rang_lent;
+    int nb_lents;        // rangs rang_lent .. rang_lent + nb_lents - 1
+    int pause_ms;        // par bloc sur ces rangs ; -1 : bloqué pour toujours
+    long indice_arret;   // -1 : jamais
+} panne;
+
+void noyau_panne(void* contexte, void* donnees, long premier, int nb) {
+    panne* p = (panne*)contexte;
+    int* x = (int*)donnees;
+    if (p->indice_arret >= premier && p->indice_arret < premier + nb) {
+        fprintf(stderr, "Rang %d : arrêt simulé sur l'élément %ld.\n", p->rang, p->indice_arret);
+        MPI_Abort(MPI_COMM_WORLD, 3);
+    }
+    if (p->rang_lent >= 0 && p->rang >= p->rang_lent && p->rang < p->rang_lent + p->nb_lents) {
+        if (p->pause_ms < 0) {
+            while (1) sleep(60);
+        }
+        usleep(p->pause_ms * 1000);
+    }
+    for (int i = 0; i < nb; i++) {
+        unsigned v = (unsigned)(premier + i);
+        for (int j = 0; j < p->cout; j++) v = v * 1664525u + 1013904223u;
+        x[i] = (int)(v & 0x7fffffff);
+    }
+}
+
+// Usage : mpirun -np P ./ferme_panne [-n éléments] [-b taille de bloc] [-c coût] [-d délai (s)]
+//                                    [-l premier rang lent] [-m nombre de rangs lents]
+//                                    [-p pause par bloc en ms, -1 = bloqué]
+//                                    [-k indice provoquant l'arrêt] [-r fichier de reprise]
+int main(int argc, char* argv[]) {
+    int rang, nb_processus;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rang);
+    MPI_Comm_size(MPI_COMM_WORLD, &nb_processus);
+
+    long n = 1000000;
+    int taille_bloc = 10000;
+    double delai = 0.5;
+    const char* reprise = NULL;
+    panne p = {100, rang, -1, 1, 0, -1};
+    int opt;
+    while ((opt = getopt(argc, argv, "n:b:c:d:l:m:p:k:r:")) != -1) {
+        switch (opt) {
+            case 'n': n = atol(optarg); break;
+            case 'b': taille_bloc = atoi(optarg); break;
+            case 'c': p.cout = atoi(optarg); break;
+            case 'd': delai = atof(optarg); break;
+            case 'l': p.rang_lent = atoi(optarg); break;
+            case 'm': p.nb_lents = atoi(optarg); break;
+            case 'p': p.pause_ms = atoi(optarg); break;
+            case 'k': p.indice_arret = atol(optarg); break;
+            case 'r': reprise = optarg; break;
+            default:
+                if (rang == 0) fprintf(stderr, "Option inconnue.\n");
+                MPI_Finalize();
+                return 1;
+        }
+    }
+
+    int* donnees = NULL;
+    if (rang == 0) {
+        donnees = (int*)calloc(n, sizeof(int));
+        if (donnees == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    config_ferme c = {n, sizeof(int), taille_bloc, taille_bloc, 1, noyau_panne, &p, 1, NULL};
+    statistiques_ferme stats;
+    ferme_tolerante(&c, donnees, reprise, delai, MPI_COMM_WORLD, &stats);
+
+    if (rang == 0) {
+        // Référence calculée sans panne
+        panne sans_panne = p;
+        sans_panne.rang_lent = -1;
+        sans_panne.indice_arret = -1;
+        int* reference = (int*)malloc(n * sizeof(int));
+        noyau_panne(&sans_panne, reference, 0, (int)n);
+        long erreurs = 0;
+        for (long i = 0; i < n; i++) erreurs += donnees[i] != reference[i];
+
+        printf("%ld éléments, blocs de %d, %d esclaves, délai minimal %.2f s\n", n, taille_bloc,
+               nb_processus - 1, delai);
+        printf("Temps : %.4f s\n", stats.temps);
+        printf("Blocs distribués : %ld, repris du fichier : %ld\n", stats.morceaux, stats.repris);
+        printf("Copies spéculatives : %ld, résultats en double : %ld\n", stats.reemis, stats.doublons);
+        printf("Esclaves perdus : %d\n", stats.perdus);
+        printf("Erreurs : %ld\n", erreurs);
+        free(reference);
+        free(donnees);
+        if (stats.perdus > 0) {
+            // Un esclave bloqué n'atteindra jamais MPI_Finalize
+            fflush(stdout);
+            MPI_Abort(MPI_COMM_WORLD, erreurs == 0 ? 0 : 1);
+        }
+        MPI_Finalize();
+        return erreurs == 0 ? 0 : 1;
+    }
+    MPI_Finalize();
+    return 0;
+}
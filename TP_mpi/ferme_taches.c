@@ -0,0 +1,888 @@
+#include <mpi.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "ferme_taches.h"
+
+#define TAG_MORCEAU 1
+#define TAG_RESULTAT 2
+#define TAG_FIN 3
+#define TAG_REQUETE_INITIALE 4
+#define TAG_DEMANDE 5 // ferme_fichier : un esclave demande un lot
+#define FACTEUR_GUIDE 2 // morceau = restant / (FACTEUR_GUIDE * nb_esclaves)
+#define SOUS_MORCEAUX_PAR_THREAD 4 // équilibrage entre threads d'un même esclave
+#define FACTEUR_ECHEANCE 4.0 // échéance d'un bloc : FACTEUR_ECHEANCE fois la durée moyenne
+#define COPIES_MAX 2 // exemplaires simultanés d'un même bloc encore dans leur délai
+#define ATTENTE_SCRUTATION 50 // microsecondes entre deux scrutations sans message
+#define SIGNATURE_REPRISE "FERMEv1"
+#define OCTETS_PAR_TOUR (256L << 20) // résultats écrits par tour de ferme_distribuee, tous rangs confondus
+
+// En-tête placé devant les données de chaque message de morceau ou de résultat
+typedef struct {
+    long premier;
+    int nb;
+    int reserve;
+} entete_morceau;
+
+static void* allouer(size_t taille) {
+    void* p = malloc(taille > 0 ? taille : 1);
+    if (p == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire (ferme de tâches).\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    return p;
+}
+
+// Appel du noyau mesuré dans l'emplacement thread de c->mesure : seul le calcul est compté,
+// pas les attentes de communication
+static void executer_noyau(const config_ferme* c, int thread, void* donnees, long premier, int nb) {
+    perf_region_begin(c->mesure, thread);
+    c->noyau(c->contexte, donnees, premier, nb);
+    perf_region_end(c->mesure, thread);
+}
+
+// Sans esclave, le maître traite lui-même tout le tableau
+static void traiter_localement(const config_ferme* c, void* donnees, statistiques_ferme* stats) {
+    char* octets = (char*)donnees;
+    for (long premier = 0; premier < c->nb_elements; premier += c->morceau_max) {
+        long restant = c->nb_elements - premier;
+        int nb = restant < c->morceau_max ? (int)restant : c->morceau_max;
+        executer_noyau(c, 0, octets + premier * c->taille_element, premier, nb);
+        stats->morceaux++;
+    }
+}
+
+void ferme_originale(const config_ferme* c, void* donnees, MPI_Comm comm, statistiques_ferme* stats) {
+    int rang, nb_processus;
+    MPI_Comm_rank(comm, &rang);
+    MPI_Comm_size(comm, &nb_processus);
+    int taille_bloc = c->morceau_min;
+    size_t octets_bloc = (size_t)taille_bloc * c->taille_element;
+    size_t taille_message = sizeof(entete_morceau) + octets_bloc;
+    long nb_blocs = (c->nb_elements + taille_bloc - 1) / taille_bloc;
+    char* message = (char*)allouer(taille_message);
+    entete_morceau* e = (entete_morceau*)message;
+    char* bloc = message + sizeof(entete_morceau);
+    MPI_Status statut;
+    double debut = MPI_Wtime();
+
+    if (rang == 0) {
+        char* matrice = (char*)donnees;
+        memset(stats, 0, sizeof(*stats));
+        if (nb_processus == 1) {
+            traiter_localement(c, donnees, stats);
+        }
+        long blocs_envoyes = 0;
+        int esclaves_actifs = nb_processus - 1;
+        // Même aller-retour que main.c, mais l'indice du bloc voyage dans un en-tête et non dans
+        // l'étiquette : MPI ne garantit pas d'étiquette au-delà de 32767 (MPI_TAG_UB)
+        while (esclaves_actifs > 0) {
+            MPI_Recv(message, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &statut);
+            stats->messages++;
+            if (statut.MPI_TAG == TAG_RESULTAT) {
+                memcpy(matrice + e->premier * c->taille_element, bloc, (size_t)e->nb * c->taille_element);
+            }
+            if (blocs_envoyes < nb_blocs) {
+                long restant = c->nb_elements - blocs_envoyes * taille_bloc;
+                e->premier = blocs_envoyes * taille_bloc;
+                e->nb = restant < taille_bloc ? (int)restant : taille_bloc;
+                size_t octets = (size_t)e->nb * c->taille_element;
+                memcpy(bloc, matrice + e->premier * c->taille_element, octets);
+                MPI_Send(message, (int)(sizeof(entete_morceau) + octets), MPI_BYTE, statut.MPI_SOURCE,
+                         TAG_MORCEAU, comm);
+                blocs_envoyes++;
+                stats->morceaux++;
+            } else {
+                MPI_Send(NULL, 0, MPI_BYTE, statut.MPI_SOURCE, TAG_FIN, comm);
+                esclaves_actifs--;
+            }
+            stats->messages++;
+        }
+        stats->temps = MPI_Wtime() - debut;
+    } else {
+        MPI_Send(NULL, 0, MPI_BYTE, 0, TAG_REQUETE_INITIALE, comm);
+        while (1) {
+            MPI_Recv(message, (int)taille_message, MPI_BYTE, 0, MPI_ANY_TAG, comm, &statut);
+            if (statut.MPI_TAG == TAG_FIN) break;
+            executer_noyau(c, 0, bloc, e->premier, e->nb);
+            MPI_Send(message, (int)(sizeof(entete_morceau) + (size_t)e->nb * c->taille_element), MPI_BYTE, 0,
+                     TAG_RESULTAT, comm);
+        }
+    }
+    free(message);
+}
+
+int ferme_init_hybride(int* argc, char*** argv) {
+    int fourni;
+    MPI_Init_thread(argc, argv, MPI_THREAD_MULTIPLE, &fourni);
+    if (fourni < MPI_THREAD_FUNNELED) {
+        fprintf(stderr, "La bibliothèque MPI ne permet pas MPI_THREAD_FUNNELED.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    return fourni;
+}
+
+// Applique le noyau à un morceau reçu, partagé entre les threads de l'esclave
+static void appliquer_noyau(const config_ferme* c, char* donnees, long premier, int nb) {
+    if (c->nb_threads <= 1) {
+        executer_noyau(c, 0, donnees, premier, nb);
+        return;
+    }
+    int nb_sous = c->nb_threads * SOUS_MORCEAUX_PAR_THREAD;
+    if (nb_sous > nb) nb_sous = nb;
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(c->nb_threads) schedule(dynamic, 1)
+#endif
+    for (int s = 0; s < nb_sous; s++) {
+        int debut = (int)((long)nb * s / nb_sous);
+        int fin = (int)((long)nb * (s + 1) / nb_sous);
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+#else
+        int thread = 0;
+#endif
+        executer_noyau(c, thread, donnees + (size_t)debut * c->taille_element, premier + debut, fin - debut);
+    }
+}
+
+// Mode hybride : un morceau occupe tous les threads d'un rang
+static config_ferme config_hybride(const config_ferme* config) {
+    config_ferme c = *config;
+    if (c.nb_threads > 1) {
+        c.morceau_min *= c.nb_threads;
+        c.morceau_max *= c.nb_threads;
+    }
+    return c;
+}
+
+// Ordonnancement guidé : gros morceaux au début, petits vers la fin pour équilibrer
+static int taille_guidee(const config_ferme* c, long restant, int nb_esclaves) {
+    long nb = restant / ((long)FACTEUR_GUIDE * nb_esclaves);
+    if (nb < c->morceau_min) nb = c->morceau_min;
+    if (nb > c->morceau_max) nb = c->morceau_max;
+    if (nb > restant) nb = restant;
+    return (int)nb;
+}
+
+typedef struct {
+    const config_ferme* c;
+    MPI_Comm comm;
+    char* donnees;
+    long prochain;          // premier élément non encore distribué
+    int nb_esclaves;
+    int* en_cours;          // morceaux en vol par esclave
+    char** tampons;         // prefetch tampons d'envoi par esclave
+    MPI_Request* envois;
+    int* prochain_tampon;
+    statistiques_ferme* stats;
+} etat_maitre;
+
+static void envoyer_morceau(etat_maitre* m, int esclave) {
+    const config_ferme* c = m->c;
+    int nb = taille_guidee(c, c->nb_elements - m->prochain, m->nb_esclaves);
+    int t = (esclave - 1) * c->prefetch + m->prochain_tampon[esclave];
+    m->prochain_tampon[esclave] = (m->prochain_tampon[esclave] + 1) % c->prefetch;
+
+    // Le tampon a servi au morceau précédent de cet esclave, dont le résultat est revenu
+    MPI_Wait(&m->envois[t], MPI_STATUS_IGNORE);
+    entete_morceau* e = (entete_morceau*)m->tampons[t];
+    e->premier = m->prochain;
+    e->nb = nb;
+    memcpy(m->tampons[t] + sizeof(entete_morceau), m->donnees + m->prochain * c->taille_element,
+           (size_t)nb * c->taille_element);
+    MPI_Isend(m->tampons[t], (int)(sizeof(entete_morceau) + (size_t)nb * c->taille_element), MPI_BYTE,
+              esclave, TAG_MORCEAU, m->comm, &m->envois[t]);
+
+    m->prochain += nb;
+    m->en_cours[esclave]++;
+    m->stats->morceaux++;
+    m->stats->messages++;
+}
+
+static void maitre_dynamique(const config_ferme* c, char* donnees, MPI_Comm comm, int nb_processus,
+                             statistiques_ferme* stats) {
+    size_t taille_message = sizeof(entete_morceau) + (size_t)c->morceau_max * c->taille_element;
+    etat_maitre m;
+    m.c = c;
+    m.comm = comm;
+    m.donnees = donnees;
+    m.prochain = 0;
+    m.nb_esclaves = nb_processus - 1;
+    m.en_cours = (int*)calloc(nb_processus, sizeof(int));
+    m.prochain_tampon = (int*)calloc(nb_processus, sizeof(int));
+    m.tampons = (char**)allouer((size_t)m.nb_esclaves * c->prefetch * sizeof(char*));
+    m.envois = (MPI_Request*)allouer((size_t)m.nb_esclaves * c->prefetch * sizeof(MPI_Request));
+    m.stats = stats;
+    for (int t = 0; t < m.nb_esclaves * c->prefetch; t++) {
+        m.tampons[t] = (char*)allouer(taille_message);
+        m.envois[t] = MPI_REQUEST_NULL;
+    }
+    char* recu = (char*)allouer(taille_message);
+
+    // Distribution initiale : prefetch morceaux par esclave, à tour de rôle
+    for (int k = 0; k < c->prefetch; k++) {
+        for (int w = 1; w < nb_processus && m.prochain < c->nb_elements; w++) {
+            envoyer_morceau(&m, w);
+        }
+    }
+    int actifs = 0;
+    for (int w = 1; w < nb_processus; w++) {
+        if (m.en_cours[w] > 0) {
+            actifs++;
+        } else {
+            MPI_Send(NULL, 0, MPI_BYTE, w, TAG_FIN, comm);
+            stats->messages++;
+        }
+    }
+
+    // Chaque résultat reçu libère une place : l'esclave reçoit aussitôt un nouveau morceau
+    while (actifs > 0) {
+        MPI_Status statut;
+        MPI_Recv(recu, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, TAG_RESULTAT, comm, &statut);
+        stats->messages++;
+        int w = statut.MPI_SOURCE;
+        entete_morceau* e = (entete_morceau*)recu;
+        memcpy(donnees + e->premier * c->taille_element, recu + sizeof(entete_morceau),
+               (size_t)e->nb * c->taille_element);
+        m.en_cours[w]--;
+
+        if (m.prochain < c->nb_elements) {
+            envoyer_morceau(&m, w);
+        } else if (m.en_cours[w] == 0) {
+            MPI_Send(NULL, 0, MPI_BYTE, w, TAG_FIN, comm);
+            stats->messages++;
+            actifs--;
+        }
+    }
+
+    MPI_Waitall(m.nb_esclaves * c->prefetch, m.envois, MPI_STATUSES_IGNORE);
+    for (int t = 0; t < m.nb_esclaves * c->prefetch; t++) free(m.tampons[t]);
+    free(m.tampons);
+    free(m.envois);
+    free(m.en_cours);
+    free(m.prochain_tampon);
+    free(recu);
+}
+
+static void esclave_dynamique(const config_ferme* c, MPI_Comm comm) {
+    // prefetch + 1 tampons : pendant qu'un résultat part, prefetch réceptions restent postées
+    int nb_tampons = c->prefetch + 1;
+    size_t taille_message = sizeof(entete_morceau) + (size_t)c->morceau_max * c->taille_element;
+    char** tampons = (char**)allouer(nb_tampons * sizeof(char*));
+    MPI_Request* requetes = (MPI_Request*)allouer(nb_tampons * sizeof(MPI_Request));
+    int* en_envoi = (int*)calloc(nb_tampons, sizeof(int));
+    for (int i = 0; i < nb_tampons; i++) {
+        tampons[i] = (char*)allouer(taille_message);
+        MPI_Irecv(tampons[i], (int)taille_message, MPI_BYTE, 0, MPI_ANY_TAG, comm, &requetes[i]);
+    }
+
+    while (1) {
+        int i;
+        MPI_Status statut;
+        MPI_Waitany(nb_tampons, requetes, &i, &statut);
+        if (en_envoi[i]) {
+            // Résultat parti : le tampon redevient une réception
+            en_envoi[i] = 0;
+            MPI_Irecv(tampons[i], (int)taille_message, MPI_BYTE, 0, MPI_ANY_TAG, comm, &requetes[i]);
+            continue;
+        }
+        // Le maître n'envoie la fin qu'une fois tous nos résultats reçus
+        if (statut.MPI_TAG == TAG_FIN) break;
+
+        entete_morceau* e = (entete_morceau*)tampons[i];
+        appliquer_noyau(c, tampons[i] + sizeof(entete_morceau), e->premier, e->nb);
+        MPI_Isend(tampons[i], (int)(sizeof(entete_morceau) + (size_t)e->nb * c->taille_element), MPI_BYTE,
+                  0, TAG_RESULTAT, comm, &requetes[i]);
+        en_envoi[i] = 1;
+    }
+
+    for (int i = 0; i < nb_tampons; i++) {
+        if (requetes[i] == MPI_REQUEST_NULL) continue;
+        if (!en_envoi[i]) MPI_Cancel(&requetes[i]);
+        MPI_Wait(&requetes[i], MPI_STATUS_IGNORE);
+    }
+    for (int i = 0; i < nb_tampons; i++) free(tampons[i]);
+    free(tampons);
+    free(requetes);
+    free(en_envoi);
+}
+
+void ferme_dynamique(const config_ferme* config, void* donnees, MPI_Comm comm, statistiques_ferme* stats) {
+    config_ferme hybride = config_hybride(config);
+    const config_ferme* c = &hybride;
+    int rang, nb_processus;
+    MPI_Comm_rank(comm, &rang);
+    MPI_Comm_size(comm, &nb_processus);
+
+    if (rang == 0) {
+        memset(stats, 0, sizeof(*stats));
+        double debut = MPI_Wtime();
+        if (nb_processus == 1) {
+            traiter_localement(c, donnees, stats);
+        } else {
+            maitre_dynamique(c, (char*)donnees, comm, nb_processus, stats);
+        }
+        stats->temps = MPI_Wtime() - debut;
+    } else {
+        esclave_dynamique(c, comm);
+    }
+}
+
+// Résultats d'un tour gardés localement jusqu'à son écriture collective
+typedef struct {
+    char* donnees;
+    size_t taille, capacite;
+    int nb_morceaux, capacite_morceaux;
+    int* longueurs;             // octets
+    MPI_Aint* deplacements;     // position dans le fichier, croissante
+} resultats_locaux;
+
+static char* reserver_resultat(resultats_locaux* r, long premier, int nb, int taille_element) {
+    size_t octets = (size_t)nb * taille_element;
+    if (r->taille + octets > r->capacite) {
+        r->capacite = 2 * (r->taille + octets);
+        r->donnees = (char*)realloc(r->donnees, r->capacite);
+    }
+    if (r->nb_morceaux == r->capacite_morceaux) {
+        r->capacite_morceaux = r->capacite_morceaux ? 2 * r->capacite_morceaux : 64;
+        r->longueurs = (int*)realloc(r->longueurs, r->capacite_morceaux * sizeof(int));
+        r->deplacements = (MPI_Aint*)realloc(r->deplacements, r->capacite_morceaux * sizeof(MPI_Aint));
+    }
+    if (r->donnees == NULL || r->longueurs == NULL || r->deplacements == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire (ferme de tâches).\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    char* zone = r->donnees + r->taille;
+    r->longueurs[r->nb_morceaux] = (int)octets;
+    r->deplacements[r->nb_morceaux] = (MPI_Aint)premier * taille_element;
+    r->nb_morceaux++;
+    r->taille += octets;
+    return zone;
+}
+
+// Chaque rang décrit les morceaux du tour comme une vue du fichier, puis tous écrivent en un
+// appel. Un tour couvre au plus OCTETS_PAR_TOUR octets, ce qui tient dans le compte int.
+static void ecrire_tour(resultats_locaux* r, MPI_File f) {
+    if (r->taille > (size_t)OCTETS_PAR_TOUR) {
+        fprintf(stderr, "Tour d'écriture trop grand (%zu octets).\n", r->taille);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Datatype vue = MPI_BYTE;
+    if (r->nb_morceaux > 0) {
+        MPI_Type_create_hindexed(r->nb_morceaux, r->longueurs, r->deplacements, MPI_BYTE, &vue);
+        MPI_Type_commit(&vue);
+    }
+    MPI_File_set_view(f, 0, MPI_BYTE, vue, "native", MPI_INFO_NULL);
+    MPI_File_write_all(f, r->donnees, (int)r->taille, MPI_BYTE, MPI_STATUS_IGNORE);
+    if (vue != MPI_BYTE) MPI_Type_free(&vue);
+    r->taille = 0;
+    r->nb_morceaux = 0;
+}
+
+void ferme_distribuee(const config_ferme* config, noyau_ferme initialiser, const char* fichier,
+                      MPI_Comm comm, statistiques_ferme* stats) {
+    config_ferme hybride = config_hybride(config);
+    const config_ferme* c = &hybride;
+    int rang, nb_processus;
+    MPI_Comm_rank(comm, &rang);
+    MPI_Comm_size(comm, &nb_processus);
+
+    // Le tableau est traité par tours de OCTETS_PAR_TOUR octets, chacun terminé par une
+    // écriture collective : un rang ne garde jamais plus d'un tour de résultats en mémoire.
+    // Un compteur par tour, hébergé par le rang 0 : prochain élément à distribuer dans le tour.
+    long elements_par_tour = OCTETS_PAR_TOUR / c->taille_element;
+    if (elements_par_tour < 1) elements_par_tour = 1;
+    long nb_tours = (c->nb_elements + elements_par_tour - 1) / elements_par_tour;
+    long* compteurs;
+    MPI_Win fenetre;
+    if (rang == 0) memset(stats, 0, sizeof(*stats));
+    MPI_Win_allocate(rang == 0 ? nb_tours * sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, comm, &compteurs,
+                     &fenetre);
+    if (rang == 0) memset(compteurs, 0, nb_tours * sizeof(long));
+
+    MPI_File f;
+    if (MPI_File_open(comm, fichier, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &f) != MPI_SUCCESS) {
+        fprintf(stderr, "Impossible d'ouvrir %s en écriture.\n", fichier);
+        MPI_Abort(comm, 1);
+    }
+    // Un fichier plus long d'une exécution précédente est tronqué
+    MPI_File_set_size(f, (MPI_Offset)c->nb_elements * c->taille_element);
+    MPI_Barrier(comm);
+    double debut = MPI_Wtime();
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, fenetre);
+
+    resultats_locaux r;
+    memset(&r, 0, sizeof(r));
+    statistiques_ferme locales;
+    memset(&locales, 0, sizeof(locales));
+    for (long tour = 0; tour < nb_tours; tour++) {
+        long debut_tour = tour * elements_par_tour;
+        long fin_tour = debut_tour + elements_par_tour < c->nb_elements ? debut_tour + elements_par_tour
+                                                                        : c->nb_elements;
+        long vu = debut_tour;  // dernière valeur lue du compteur, pour la taille guidée
+        while (1) {
+            // Tous les rangs travaillent : la taille guidée porte sur nb_processus et non plus
+            // sur les seuls esclaves
+            long demande = taille_guidee(c, c->nb_elements - vu > 0 ? c->nb_elements - vu : 1, nb_processus);
+            long decalage;
+            MPI_Fetch_and_op(&demande, &decalage, MPI_LONG, 0, tour, MPI_SUM, fenetre);
+            MPI_Win_flush(0, fenetre);
+            locales.messages++;
+            long premier = debut_tour + decalage;
+            if (premier >= fin_tour) break;
+            int nb = (int)(premier + demande > fin_tour ? fin_tour - premier : demande);
+            vu = premier + nb;
+
+            char* zone = reserver_resultat(&r, premier, nb, c->taille_element);
+            initialiser(c->contexte, zone, premier, nb);
+            appliquer_noyau(c, zone, premier, nb);
+            locales.morceaux++;
+        }
+        ecrire_tour(&r, f);
+    }
+    MPI_Win_unlock_all(fenetre);
+    MPI_File_close(&f);
+    locales.temps = MPI_Wtime() - debut;
+
+    MPI_Reduce(&locales.morceaux, &stats->morceaux, 1, MPI_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(&locales.messages, &stats->messages, 1, MPI_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(&locales.temps, &stats->temps, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+    MPI_Win_free(&fenetre);
+    free(r.donnees);
+    free(r.longueurs);
+    free(r.deplacements);
+}
+
+// Fichier de reprise : en-tête, un octet d'état par bloc, puis les résultats à leur place
+typedef struct {
+    char signature[8];
+    long nb_elements;
+    int taille_element;
+    int taille_bloc;
+} entete_reprise;
+
+#define BLOC_A_FAIRE 0
+#define BLOC_EN_COURS 1
+#define BLOC_TERMINE 2
+
+typedef struct {
+    int fd;
+    long nb_blocs;
+    off_t debut_donnees;
+} fichier_reprise;
+
+// Ouvre ou crée le fichier ; les blocs déjà terminés sont recopiés dans donnees
+static long ouvrir_reprise(fichier_reprise* f, const char* nom, const config_ferme* c, long nb_blocs,
+                           char* donnees, char* etats) {
+    entete_reprise attendu;
+    memset(&attendu, 0, sizeof(attendu));
+    strcpy(attendu.signature, SIGNATURE_REPRISE);
+    attendu.nb_elements = c->nb_elements;
+    attendu.taille_element = c->taille_element;
+    attendu.taille_bloc = c->morceau_max;
+    f->nb_blocs = nb_blocs;
+    f->debut_donnees = (off_t)sizeof(entete_reprise) + nb_blocs;
+
+    f->fd = open(nom, O_RDWR | O_CREAT, 0644);
+    if (f->fd < 0) {
+        fprintf(stderr, "Impossible d'ouvrir le fichier de reprise %s.\n", nom);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    entete_reprise lu;
+    long repris = 0;
+    if (pread(f->fd, &lu, sizeof(lu), 0) == (ssize_t)sizeof(lu) && memcmp(&lu, &attendu, sizeof(lu)) == 0 &&
+        pread(f->fd, etats, nb_blocs, sizeof(lu)) == (ssize_t)nb_blocs) {
+        for (long b = 0; b < nb_blocs; b++) {
+            if (etats[b] != BLOC_TERMINE) {
+                etats[b] = BLOC_A_FAIRE;
+                continue;
+            }
+            long premier = b * c->morceau_max;
+            long restant = c->nb_elements - premier;
+            size_t octets = (size_t)(restant < c->morceau_max ? restant : c->morceau_max) * c->taille_element;
+            if (pread(f->fd, donnees + premier * c->taille_element, octets,
+                      f->debut_donnees + (off_t)premier * c->taille_element) != (ssize_t)octets) {
+                etats[b] = BLOC_A_FAIRE;
+                continue;
+            }
+            repris++;
+        }
+        return repris;
+    }
+
+    // Absent ou d'une autre configuration : on repart de zéro
+    memset(etats, BLOC_A_FAIRE, nb_blocs);
+    if (ftruncate(f->fd, 0) != 0 || pwrite(f->fd, &attendu, sizeof(attendu), 0) != (ssize_t)sizeof(attendu) ||
+        pwrite(f->fd, etats, nb_blocs, sizeof(attendu)) != (ssize_t)nb_blocs) {
+        fprintf(stderr, "Erreur d'écriture du fichier de reprise %s.\n", nom);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    return 0;
+}
+
+// Les données d'abord, l'état ensuite : un arrêt entre les deux ne fait que refaire le bloc
+static void sauver_bloc(fichier_reprise* f, long b, const char* resultat, long premier, int nb,
+                        int taille_element) {
+    char termine = BLOC_TERMINE;
+    size_t octets = (size_t)nb * taille_element;
+    if (pwrite(f->fd, resultat, octets, f->debut_donnees + (off_t)premier * taille_element) != (ssize_t)octets ||
+        pwrite(f->fd, &termine, 1, (off_t)sizeof(entete_reprise) + b) != 1) {
+        fprintf(stderr, "Erreur d'écriture du fichier de reprise (bloc %ld).\n", b);
+    }
+}
+
+typedef struct {
+    long bloc;              // -1 : libre
+    double depart, echeance;
+    int expire;             // échéance dépassée : sa copie ne compte plus dans copies[bloc]
+    int vivant;
+} suivi_esclave;
+
+static void maitre_tolerant(const config_ferme* c, char* donnees, const char* reprise, double delai,
+                            MPI_Comm comm, int nb_processus, statistiques_ferme* stats) {
+    int taille_bloc = c->morceau_max;
+    long nb_blocs = (c->nb_elements + taille_bloc - 1) / taille_bloc;
+    size_t taille_message = sizeof(entete_morceau) + (size_t)taille_bloc * c->taille_element;
+    char* etats = (char*)allouer(nb_blocs);
+    int* copies = (int*)calloc(nb_blocs, sizeof(int));   // copies encore dans les délais
+    suivi_esclave* esclaves = (suivi_esclave*)allouer(nb_processus * sizeof(suivi_esclave));
+    char** tampons = (char**)allouer(nb_processus * sizeof(char*));
+    MPI_Request* envois = (MPI_Request*)allouer(nb_processus * sizeof(MPI_Request));
+    char* recu = (char*)allouer(taille_message);
+
+    fichier_reprise f = {-1, 0, 0};
+    if (reprise != NULL) {
+        stats->repris = ouvrir_reprise(&f, reprise, c, nb_blocs, donnees, etats);
+    } else {
+        memset(etats, BLOC_A_FAIRE, nb_blocs);
+    }
+    long restants = nb_blocs - stats->repris;
+    long prochain = 0;      // aucun bloc à faire avant cet indice
+    double duree_moyenne = 0;
+    long nb_durees = 0;
+
+    for (int w = 1; w < nb_processus; w++) {
+        esclaves[w].bloc = -1;
+        esclaves[w].expire = 0;
+        esclaves[w].vivant = 1;
+        tampons[w] = (char*)allouer(taille_message);
+        envois[w] = MPI_REQUEST_NULL;
+    }
+
+    MPI_Request reception;
+    MPI_Irecv(recu, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, TAG_RESULTAT, comm, &reception);
+
+    while (restants > 0) {
+        double maintenant = MPI_Wtime();
+        double echeance = duree_moyenne * FACTEUR_ECHEANCE > delai ? duree_moyenne * FACTEUR_ECHEANCE : delai;
+
+        // Une copie en retard sort du décompte : si toutes les copies d'un bloc sont sur des
+        // esclaves lents ou bloqués, le bloc peut encore partir vers un esclave libre
+        for (int w = 1; w < nb_processus; w++) {
+            if (esclaves[w].bloc >= 0 && !esclaves[w].expire && maintenant > esclaves[w].echeance) {
+                esclaves[w].expire = 1;
+                copies[esclaves[w].bloc]--;
+            }
+        }
+
+        // Esclaves libres : d'abord les blocs jamais distribués, puis une copie d'un bloc en retard
+        for (int w = 1; w < nb_processus; w++) {
+            if (!esclaves[w].vivant || esclaves[w].bloc >= 0) continue;
+            while (prochain < nb_blocs && etats[prochain] != BLOC_A_FAIRE) prochain++;
+            long b = -1;
+            if (prochain < nb_blocs) {
+                b = prochain;
+            } else {
+                for (int v = 1; v < nb_processus && b < 0; v++) {
+                    long candidat = esclaves[v].bloc;
+                    if (candidat >= 0 && maintenant > esclaves[v].echeance && etats[candidat] == BLOC_EN_COURS &&
+                        copies[candidat] < COPIES_MAX) {
+                        b = candidat;
+                    }
+                }
+                if (b < 0) break;
+                stats->reemis++;
+            }
+
+            long premier = b * taille_bloc;
+            long restant = c->nb_elements - premier;
+            int nb = restant < taille_bloc ? (int)restant : taille_bloc;
+            MPI_Wait(&envois[w], MPI_STATUS_IGNORE);
+            entete_morceau* e = (entete_morceau*)tampons[w];
+            e->premier = premier;
+            e->nb = nb;
+            memcpy(tampons[w] + sizeof(entete_morceau), donnees + premier * c->taille_element,
+                   (size_t)nb * c->taille_element);
+            if (MPI_Isend(tampons[w], (int)(sizeof(entete_morceau) + (size_t)nb * c->taille_element), MPI_BYTE,
+                          w, TAG_MORCEAU, comm, &envois[w]) != MPI_SUCCESS) {
+                // Avec MPI_ERRORS_RETURN, un esclave disparu n'arrête pas le maître
+                esclaves[w].vivant = 0;
+                continue;
+            }
+            etats[b] = BLOC_EN_COURS;
+            copies[b]++;
+            esclaves[w].bloc = b;
+            esclaves[w].expire = 0;
+            esclaves[w].depart = maintenant;
+            esclaves[w].echeance = maintenant + echeance;
+            stats->morceaux++;
+            stats->messages++;
+        }
+
+        int vivants = 0;
+        for (int w = 1; w < nb_processus; w++) vivants += esclaves[w].vivant;
+        if (vivants == 0) {
+            fprintf(stderr, "Plus aucun esclave joignable, %ld blocs restants.\n", restants);
+            MPI_Abort(comm, 1);
+        }
+
+        int arrive;
+        MPI_Status statut;
+        MPI_Test(&reception, &arrive, &statut);
+        if (!arrive) {
+            usleep(ATTENTE_SCRUTATION);
+            continue;
+        }
+        stats->messages++;
+        int w = statut.MPI_SOURCE;
+        entete_morceau* e = (entete_morceau*)recu;
+        long b = e->premier / taille_bloc;
+        double duree = MPI_Wtime() - esclaves[w].depart;
+        duree_moyenne = (duree_moyenne * nb_durees + duree) / (nb_durees + 1);
+        nb_durees++;
+        esclaves[w].bloc = -1;
+        if (!esclaves[w].expire) copies[b]--;
+        if (etats[b] == BLOC_TERMINE) {
+            stats->doublons++;
+        } else {
+            char* resultat = recu + sizeof(entete_morceau);
+            memcpy(donnees + e->premier * c->taille_element, resultat, (size_t)e->nb * c->taille_element);
+            if (f.fd >= 0) sauver_bloc(&f, b, resultat, e->premier, e->nb, c->taille_element);
+            etats[b] = BLOC_TERMINE;
+            restants--;
+        }
+        // Plus de réception postée après le dernier bloc : la phase de grâce en poste une
+        // seulement s'il reste des copies en vol
+        if (restants > 0) {
+            MPI_Irecv(recu, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, TAG_RESULTAT, comm, &reception);
+        }
+    }
+
+    // Fin : les esclaves libres la reçoivent tout de suite, les retardataires quand leur copie
+    // inutile revient, dans la limite d'un délai de grâce
+    double grace = MPI_Wtime() + (duree_moyenne * FACTEUR_ECHEANCE > delai ? duree_moyenne * FACTEUR_ECHEANCE : delai);
+    int occupes = 0;
+    for (int w = 1; w < nb_processus; w++) {
+        if (!esclaves[w].vivant) continue;
+        if (esclaves[w].bloc < 0) {
+            MPI_Send(NULL, 0, MPI_BYTE, w, TAG_FIN, comm);
+            stats->messages++;
+        } else {
+            occupes++;
+        }
+    }
+    if (occupes > 0 && reception == MPI_REQUEST_NULL) {
+        MPI_Irecv(recu, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, TAG_RESULTAT, comm, &reception);
+    }
+    while (occupes > 0 && MPI_Wtime() < grace) {
+        int arrive;
+        MPI_Status statut;
+        MPI_Test(&reception, &arrive, &statut);
+        if (!arrive) {
+            usleep(ATTENTE_SCRUTATION);
+            continue;
+        }
+        int w = statut.MPI_SOURCE;
+        esclaves[w].bloc = -1;
+        stats->doublons++;
+        stats->messages += 2;
+        MPI_Send(NULL, 0, MPI_BYTE, w, TAG_FIN, comm);
+        occupes--;
+        if (occupes > 0) {
+            MPI_Irecv(recu, (int)taille_message, MPI_BYTE, MPI_ANY_SOURCE, TAG_RESULTAT, comm, &reception);
+        }
+    }
+    // Aucune réception ne doit survivre à free(recu) ni rester en attente au MPI_Finalize
+    if (reception != MPI_REQUEST_NULL) {
+        MPI_Cancel(&reception);
+        MPI_Wait(&reception, MPI_STATUS_IGNORE);
+    }
+
+    for (int w = 1; w < nb_processus; w++) {
+        if (esclaves[w].vivant && esclaves[w].bloc < 0) {
+            MPI_Wait(&envois[w], MPI_STATUS_IGNORE);
+            free(tampons[w]);
+        } else {
+            // Esclave perdu : son envoi ne sera peut-être jamais reçu, on ne l'attend pas et
+            // son tampon reste alloué
+            stats->perdus++;
+            if (envois[w] != MPI_REQUEST_NULL) MPI_Request_free(&envois[w]);
+        }
+    }
+    if (f.fd >= 0) close(f.fd);
+    free(etats);
+    free(copies);
+    free(esclaves);
+    free(tampons);
+    free(envois);
+    free(recu);
+}
+
+static void esclave_tolerant(const config_ferme* c, MPI_Comm comm) {
+    size_t taille_message = sizeof(entete_morceau) + (size_t)c->morceau_max * c->taille_element;
+    char* tampon = (char*)allouer(taille_message);
+    while (1) {
+        MPI_Status statut;
+        MPI_Recv(tampon, (int)taille_message, MPI_BYTE, 0, MPI_ANY_TAG, comm, &statut);
+        if (statut.MPI_TAG == TAG_FIN) break;
+        entete_morceau* e = (entete_morceau*)tampon;
+        appliquer_noyau(c, tampon + sizeof(entete_morceau), e->premier, e->nb);
+        MPI_Send(tampon, (int)(sizeof(entete_morceau) + (size_t)e->nb * c->taille_element), MPI_BYTE, 0,
+                 TAG_RESULTAT, comm);
+    }
+    free(tampon);
+}
+
+void ferme_tolerante(const config_ferme* config, void* donnees, const char* reprise, double delai,
+                     MPI_Comm comm, statistiques_ferme* stats) {
+    config_ferme hybride = config_hybride(config);
+    const config_ferme* c = &hybride;
+    int rang, nb_processus;
+    MPI_Comm_rank(comm, &rang);
+    MPI_Comm_size(comm, &nb_processus);
+
+    if (rang == 0) {
+        memset(stats, 0, sizeof(*stats));
+        double debut = MPI_Wtime();
+        if (nb_processus == 1) {
+            traiter_localement(c, donnees, stats);
+        } else {
+            MPI_Errhandler precedent;
+            MPI_Comm_get_errhandler(comm, &precedent);
+            MPI_Comm_set_errhandler(comm, MPI_ERRORS_RETURN);
+            maitre_tolerant(c, (char*)donnees, reprise, delai, comm, nb_processus, stats);
+            MPI_Comm_set_errhandler(comm, precedent);
+            MPI_Errhandler_free(&precedent);
+        }
+        stats->temps = MPI_Wtime() - debut;
+    } else {
+        esclave_tolerant(c, comm);
+    }
+}
+
+// Intervalle d'éléments confié à un esclave (message TAG_MORCEAU, le TAG_FIN est vide)
+typedef struct {
+    long premier;
+    long nb;
+} lot_fichier;
+
+// Auto-ordonnancement : chaque demande d'un esclave reçoit aussitôt le lot guidé suivant, ou
+// la fin quand tout est distribué. Le maître ne voit passer que des indices.
+static void maitre_fichier(const config_ferme* c, MPI_Comm comm, int nb_processus, statistiques_ferme* stats) {
+    int actifs = nb_processus - 1;
+    long prochain = 0;
+    while (actifs > 0) {
+        MPI_Status statut;
+        MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, TAG_DEMANDE, comm, &statut);
+        stats->messages += 2;
+        if (prochain >= c->nb_elements) {
+            MPI_Send(NULL, 0, MPI_BYTE, statut.MPI_SOURCE, TAG_FIN, comm);
+            actifs--;
+            continue;
+        }
+        lot_fichier lot;
+        lot.premier = prochain;
+        lot.nb = taille_guidee(c, c->nb_elements - prochain, nb_processus - 1);
+        prochain += lot.nb;
+        stats->morceaux++;
+        MPI_Send(&lot, sizeof(lot_fichier), MPI_BYTE, statut.MPI_SOURCE, TAG_MORCEAU, comm);
+    }
+}
+
+static void ouvrir_fichier(MPI_Comm comm, const char* nom, int mode, MPI_File* f) {
+    if (MPI_File_open(comm, nom, mode, MPI_INFO_NULL, f) != MPI_SUCCESS) {
+        fprintf(stderr, "Impossible d'ouvrir %s.\n", nom);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+static void esclave_fichier(const config_ferme* c, const char* entree, const char* sortie, MPI_Comm comm,
+                            MPI_Comm esclaves) {
+    MPI_File fe, fs;
+    int en_place = strcmp(entree, sortie) == 0;
+    if (en_place) {
+        ouvrir_fichier(esclaves, entree, MPI_MODE_RDWR, &fe);
+        fs = fe;
+    } else {
+        ouvrir_fichier(esclaves, entree, MPI_MODE_RDONLY, &fe);
+        ouvrir_fichier(esclaves, sortie, MPI_MODE_CREATE | MPI_MODE_WRONLY, &fs);
+        MPI_File_set_size(fs, (MPI_Offset)c->nb_elements * c->taille_element);
+    }
+
+    char* tampon = (char*)allouer((size_t)c->morceau_max * c->taille_element);
+    lot_fichier lot, suivant;
+    MPI_Status statut;
+    MPI_Send(NULL, 0, MPI_BYTE, 0, TAG_DEMANDE, comm);
+    MPI_Recv(&lot, sizeof(lot_fichier), MPI_BYTE, 0, MPI_ANY_TAG, comm, &statut);
+    while (statut.MPI_TAG != TAG_FIN) {
+        // Le lot suivant est demandé avant de traiter celui-ci : la réponse arrive pendant les
+        // entrées-sorties et le calcul
+        MPI_Request reception;
+        MPI_Send(NULL, 0, MPI_BYTE, 0, TAG_DEMANDE, comm);
+        MPI_Irecv(&suivant, sizeof(lot_fichier), MPI_BYTE, 0, MPI_ANY_TAG, comm, &reception);
+
+        // Accès indépendants : aucun esclave n'attend les autres
+        size_t octets = (size_t)lot.nb * c->taille_element;
+        if (octets > INT_MAX) {
+            fprintf(stderr, "Lot trop grand pour MPI-IO (%zu octets).\n", octets);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        MPI_Offset position = (MPI_Offset)lot.premier * c->taille_element;
+        MPI_File_read_at(fe, position, tampon, (int)octets, MPI_BYTE, MPI_STATUS_IGNORE);
+        appliquer_noyau(c, tampon, lot.premier, (int)lot.nb);
+        MPI_File_write_at(fs, position, tampon, (int)octets, MPI_BYTE, MPI_STATUS_IGNORE);
+
+        MPI_Wait(&reception, &statut);
+        lot = suivant;
+    }
+
+    free(tampon);
+    if (!en_place) MPI_File_close(&fs);
+    MPI_File_close(&fe);
+}
+
+void ferme_fichier(const config_ferme* config, const char* entree, const char* sortie, MPI_Comm comm,
+                   statistiques_ferme* stats) {
+    config_ferme hybride = config_hybride(config);
+    const config_ferme* c = &hybride;
+    int rang, nb_processus;
+    MPI_Comm_rank(comm, &rang);
+    MPI_Comm_size(comm, &nb_processus);
+    if (sortie == NULL) sortie = entree;
+    if (nb_processus == 1) {
+        fprintf(stderr, "ferme_fichier demande au moins un esclave.\n");
+        MPI_Abort(comm, 1);
+    }
+
+    // Le maître ne touche pas aux fichiers : ils sont ouverts par les seuls esclaves
+    MPI_Comm esclaves;
+    MPI_Comm_split(comm, rang == 0 ? MPI_UNDEFINED : 0, rang, &esclaves);
+    double debut = MPI_Wtime();
+    if (rang == 0) {
+        memset(stats, 0, sizeof(*stats));
+        maitre_fichier(c, comm, nb_processus, stats);
+    } else {
+        esclave_fichier(c, entree, sortie, comm, esclaves);
+        MPI_Comm_free(&esclaves);
+    }
+    // Au retour, les résultats sont dans le fichier
+    MPI_Barrier(comm);
+    if (rang == 0) stats->temps = MPI_Wtime() - debut;
+}
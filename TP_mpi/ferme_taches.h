@@ -0,0 +1,84 @@
+#ifndef FERME_TACHES_H
+#define FERME_TACHES_H
+
+#include <mpi.h>
+#include "../TP_pthreads/perf_counters.h"
+
+// Ferme de tâches maître / esclaves générique : le rang 0 découpe un tableau de
+// nb_elements éléments de taille_element octets en morceaux, les autres rangs appliquent
+// le noyau à chaque morceau et renvoient le résultat, qui remplace les données d'origine.
+
+// Traite sur place nb éléments consécutifs ; premier est l'indice global du premier.
+// En mode hybride, le noyau est appelé en parallèle sur des sous-morceaux disjoints.
+typedef void (*noyau_ferme)(void* contexte, void* donnees, long premier, int nb);
+
+typedef struct {
+    long nb_elements;
+    int taille_element;     // octets
+    int morceau_min;        // taille des morceaux en éléments ; morceau_min = morceau_max
+    int morceau_max;        //   donne des morceaux fixes
+    int prefetch;           // morceaux en vol par esclave
+    noyau_ferme noyau;
+    void* contexte;
+    int nb_threads;         // mode hybride : threads OpenMP par esclave (0 ou 1 : un seul)
+    perf_region* mesure;    // appels du noyau sur ce rang, un emplacement par thread ; NULL : aucune mesure
+} config_ferme;
+
+typedef struct {
+    long morceaux;          // morceaux distribués
+    long messages;          // messages envoyés et reçus par le maître, ou opérations atomiques
+    double temps;
+    long reemis;            // copies spéculatives de blocs en retard (ferme_tolerante)
+    long doublons;          // résultats arrivés après la copie gagnante
+    long repris;            // blocs relus depuis le fichier de reprise
+    int perdus;             // esclaves toujours muets à la fin
+} statistiques_ferme;
+
+// Protocole de main.c : un morceau de morceau_min éléments par aller-retour bloquant (l'indice
+// du morceau voyage dans un en-tête, pas dans l'étiquette MPI)
+void ferme_originale(const config_ferme* c, void* donnees, MPI_Comm comm, statistiques_ferme* stats);
+
+// Auto-ordonnancement avec préchargement : chaque esclave garde prefetch morceaux en vol
+// (réceptions déjà postées pendant qu'il calcule, résultats renvoyés par MPI_Isend) et la
+// taille des morceaux décroît avec le travail restant (ordonnancement guidé).
+// donnees et stats ne sont utilisés que sur le rang 0.
+// Avec nb_threads > 1, un rang par noeud suffit : les bornes de morceaux sont multipliées
+// par nb_threads (autant de messages en moins pour le maître) et chaque morceau reçu est
+// partagé entre les threads ; seul le thread principal appelle MPI (MPI_THREAD_FUNNELED).
+void ferme_dynamique(const config_ferme* c, void* donnees, MPI_Comm comm, statistiques_ferme* stats);
+
+// File de travail distribuée, sans maître : chaque rang, rang 0 compris, réserve le morceau
+// suivant par un MPI_Fetch_and_op sur un compteur partagé (accès mémoire distant, le rang 0
+// n'exécute aucun code pour servir les demandes). Les entrées ne sont jamais centralisées :
+// initialiser remplit les données d'un morceau à partir de ses indices. Les résultats restent
+// sur le rang qui les a calculés et sont écrits dans fichier par écritures collectives MPI-IO,
+// un tour de 256 Mo à la fois : la mémoire d'un rang ne dépend pas de la taille du tableau.
+// stats (rang 0) : morceaux et opérations atomiques cumulés sur tous les rangs, temps maximal.
+void ferme_distribuee(const config_ferme* c, noyau_ferme initialiser, const char* fichier,
+                      MPI_Comm comm, statistiques_ferme* stats);
+
+// Ferme tolérante aux esclaves lents, bloqués ou morts. Blocs fixes de morceau_max éléments,
+// un bloc en vol par esclave avec une échéance (au moins delai secondes, ou quelques fois la
+// durée moyenne observée d'un bloc). Un bloc en retard est recopié sur un esclave libre ; le
+// premier résultat reçu l'emporte, les suivants sont ignorés. Si reprise n'est pas NULL, chaque
+// bloc terminé y est écrit avec son état : après un arrêt, un nouvel appel avec la même
+// configuration recharge ces blocs et ne distribue que les autres.
+// Au retour, stats->perdus esclaves n'ont pas répondu dans le délai de grâce : ils ne recevront
+// jamais la fin, l'appelant doit alors terminer par MPI_Abort plutôt que MPI_Finalize.
+void ferme_tolerante(const config_ferme* c, void* donnees, const char* reprise, double delai,
+                     MPI_Comm comm, statistiques_ferme* stats);
+
+// Ferme sur fichier : entrée et sortie restent sur le système de fichiers partagé, le maître
+// n'échange que des intervalles d'indices. Chaque esclave demande un lot dès qu'il a fini le
+// précédent (taille guidée, la demande suivante part avant le calcul) et lit puis écrit son
+// intervalle par MPI_File_read_at / MPI_File_write_at indépendants : un esclave lent ne retarde
+// pas les autres. sortie peut être égale à entree (résultats écrits en place) ; entree contient
+// nb_elements * taille_element octets.
+void ferme_fichier(const config_ferme* c, const char* entree, const char* sortie, MPI_Comm comm,
+                   statistiques_ferme* stats);
+
+// MPI_Init_thread avec au moins MPI_THREAD_FUNNELED ; renvoie le niveau obtenu
+// (MPI_THREAD_MULTIPLE si disponible), arrête le programme si le mode hybride est impossible
+int ferme_init_hybride(int* argc, char*** argv);
+
+#endif
@@ -0,0 +1,266 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../TP_cuda/fft_nd.h"
+
+#define TAILLE_DEFAUT 128
+#define TAILLE_VERIFICATION_MAX (1 << 21) // au-delà, la vérification sur le rang 0 serait trop coûteuse
+
+// FFT 3D d'un volume n0 x n1 x n2 trop grand pour un noeud, découpé en tranches : chaque rang
+// possède n0 / P plans. Chaque rang transforme ses plans (axes 2 et 1, FFT 2D multithreadée de
+// TP_cuda/fft_nd.c), puis un MPI_Alltoall transpose le volume : chaque rang reçoit tout l'axe 0
+// pour n1 / P valeurs de l'axe 1 et le transforme. Le résultat reste distribué ainsi (tranches
+// selon l'axe 1) ; la transformée inverse repart de cette distribution.
+typedef struct {
+    int n0, n1, n2;
+    int P, rang;
+    int plans_locaux;       // n0 / P
+    int lignes_locales;     // n1 / P
+    size_t taille_locale;   // éléments par rang, identique avant et après la transposition
+    FFTPlanND* plan_plans[2];   // volume local [n0 / P][n1][n2], directe et inverse
+    FFTPlanND* plan_axe0[2];    // volume transposé [n0][n1 / P][n2]
+    double* envoi;
+    double* reception;
+    double temps_plans, temps_echange, temps_axe0;
+} fft_tranches;
+
+double valeur_initiale(long i, long j, long k, int partie);
+int initialiser_fft(fft_tranches* f, int n0, int n1, int n2, int rang, int P, ThreadPool* pool);
+void liberer_fft(fft_tranches* f);
+void transposer(fft_tranches* f, double* re, double* im, int vers_axe0);
+void fft_distribuee(fft_tranches* f, double* re, double* im, int sens);
+double verifier(fft_tranches* f, const double* re, const double* im, ThreadPool* pool);
+
+double valeur_initiale(long i, long j, long k, int partie) {
+    double x = 0.37 * i + 0.11 * j * j + 0.05 * k;
+    return partie == 0 ? sin(x) + 0.1 * cos(1.7 * k) : cos(0.5 * x) - 0.25;
+}
+
+int initialiser_fft(fft_tranches* f, int n0, int n1, int n2, int rang, int P, ThreadPool* pool) {
+    memset(f, 0, sizeof(*f));
+    f->n0 = n0;
+    f->n1 = n1;
+    f->n2 = n2;
+    f->P = P;
+    f->rang = rang;
+    f->plans_locaux = n0 / P;
+    f->lignes_locales = n1 / P;
+    f->taille_locale = (size_t)f->plans_locaux * n1 * n2;
+    int dims_plans[3] = {f->plans_locaux, n1, n2};
+    int dims_axe0[3] = {n0, f->lignes_locales, n2};
+    int sens[2] = {FFT_FORWARD, FFT_INVERSE};
+    for (int s = 0; s < 2; s++) {
+        f->plan_plans[s] = createFFTPlanND(3, dims_plans, sens[s], pool);
+        f->plan_axe0[s] = createFFTPlanND(3, dims_axe0, sens[s], pool);
+        if (f->plan_plans[s] == NULL || f->plan_axe0[s] == NULL) return 0;
+    }
+    f->envoi = (double*)malloc(2 * f->taille_locale * sizeof(double));
+    f->reception = (double*)malloc(2 * f->taille_locale * sizeof(double));
+    return f->envoi != NULL && f->reception != NULL;
+}
+
+void liberer_fft(fft_tranches* f) {
+    for (int s = 0; s < 2; s++) {
+        destroyFFTPlanND(f->plan_plans[s]);
+        destroyFFTPlanND(f->plan_axe0[s]);
+    }
+    free(f->envoi);
+    free(f->reception);
+}
+
+// Transposition globale par MPI_Alltoall. Vers l'axe 0 : [n0 / P][n1][n2] -> [n0][n1 / P][n2] ;
+// sinon l'inverse. Le bloc échangé avec le rang r contient les parties réelle puis imaginaire.
+void transposer(fft_tranches* f, double* re, double* im, int vers_axe0) {
+    int p0 = f->plans_locaux, p1 = f->lignes_locales, n1 = f->n1, n2 = f->n2;
+    size_t bloc = (size_t)p0 * p1 * n2;
+    // Vers l'axe 0, le bloc du rang r est [i0][j in tranche r][k], dispersé dans le volume local ;
+    // au retour c'est le bloc reçu qu'il faut disperser
+    for (int r = 0; r < f->P; r++) {
+        double* dest = f->envoi + 2 * bloc * r;
+        if (vers_axe0) {
+            for (int i = 0; i < p0; i++) {
+                size_t source = ((size_t)i * n1 + (size_t)r * p1) * n2;
+                memcpy(dest + (size_t)i * p1 * n2, re + source, (size_t)p1 * n2 * sizeof(double));
+                memcpy(dest + bloc + (size_t)i * p1 * n2, im + source, (size_t)p1 * n2 * sizeof(double));
+            }
+        } else {
+            // [n0][n1 / P][n2] : les lignes i de la tranche r sont contiguës
+            memcpy(dest, re + bloc * r, bloc * sizeof(double));
+            memcpy(dest + bloc, im + bloc * r, bloc * sizeof(double));
+        }
+    }
+    MPI_Alltoall(f->envoi, (int)(2 * bloc), MPI_DOUBLE, f->reception, (int)(2 * bloc), MPI_DOUBLE,
+                 MPI_COMM_WORLD);
+    for (int r = 0; r < f->P; r++) {
+        const double* source = f->reception + 2 * bloc * r;
+        if (vers_axe0) {
+            memcpy(re + bloc * r, source, bloc * sizeof(double));
+            memcpy(im + bloc * r, source + bloc, bloc * sizeof(double));
+        } else {
+            for (int i = 0; i < p0; i++) {
+                size_t dest = ((size_t)i * n1 + (size_t)r * p1) * n2;
+                memcpy(re + dest, source + (size_t)i * p1 * n2, (size_t)p1 * n2 * sizeof(double));
+                memcpy(im + dest, source + bloc + (size_t)i * p1 * n2, (size_t)p1 * n2 * sizeof(double));
+            }
+        }
+    }
+}
+
+// sens 0 : directe, des tranches de plans vers les tranches de l'axe 1 ; sens 1 : inverse
+void fft_distribuee(fft_tranches* f, double* re, double* im, int sens) {
+    double t0 = MPI_Wtime();
+    if (sens == 0) {
+        executeFFTAxisSplit(f->plan_plans[0], 2, re, im);
+        executeFFTAxisSplit(f->plan_plans[0], 1, re, im);
+    } else {
+        executeFFTAxisSplit(f->plan_axe0[1], 0, re, im);
+    }
+    double t1 = MPI_Wtime();
+    transposer(f, re, im, sens == 0);
+    double t2 = MPI_Wtime();
+    if (sens == 0) {
+        executeFFTAxisSplit(f->plan_axe0[0], 0, re, im);
+    } else {
+        executeFFTAxisSplit(f->plan_plans[1], 1, re, im);
+        executeFFTAxisSplit(f->plan_plans[1], 2, re, im);
+    }
+    double t3 = MPI_Wtime();
+    f->temps_plans += sens == 0 ? t1 - t0 : t3 - t2;
+    f->temps_echange += t2 - t1;
+    f->temps_axe0 += sens == 0 ? t3 - t2 : t1 - t0;
+}
+
+// Rassemble le résultat distribué sur le rang 0 et le compare à la FFT 3D d'un seul processus
+double verifier(fft_tranches* f, const double* re, const double* im, ThreadPool* pool) {
+    size_t total = (size_t)f->n0 * f->n1 * f->n2;
+    double* tout = f->rang == 0 ? (double*)malloc(2 * total * sizeof(double)) : NULL;
+    memcpy(f->envoi, re, f->taille_locale * sizeof(double));
+    memcpy(f->envoi + f->taille_locale, im, f->taille_locale * sizeof(double));
+    MPI_Gather(f->envoi, (int)(2 * f->taille_locale), MPI_DOUBLE, tout, (int)(2 * f->taille_locale), MPI_DOUBLE,
+               0, MPI_COMM_WORLD);
+    if (f->rang != 0) return 0;
+
+    double* ref_re = (double*)malloc(total * sizeof(double));
+    double* ref_im = (double*)malloc(total * sizeof(double));
+    size_t indice = 0;
+    for (long i = 0; i < f->n0; i++) {
+        for (long j = 0; j < f->n1; j++) {
+            for (long k = 0; k < f->n2; k++, indice++) {
+                ref_re[indice] = valeur_initiale(i, j, k, 0);
+                ref_im[indice] = valeur_initiale(i, j, k, 1);
+            }
+        }
+    }
+    int dims[3] = {f->n0, f->n1, f->n2};
+    FFTPlanND* plan = createFFTPlanND(3, dims, FFT_FORWARD, pool);
+    executeFFTNDSplit(plan, ref_re, ref_im, ref_re, ref_im);
+    destroyFFTPlanND(plan);
+
+    // Le rang r a envoyé [n0][n1 / P][n2] pour j dans sa tranche
+    double erreur = 0, norme = 0;
+    int p1 = f->lignes_locales;
+    for (int r = 0; r < f->P; r++) {
+        const double* bloc = tout + 2 * f->taille_locale * r;
+        for (long i = 0; i < f->n0; i++) {
+            for (long jj = 0; jj < p1; jj++) {
+                for (long k = 0; k < f->n2; k++) {
+                    size_t local = ((size_t)i * p1 + jj) * f->n2 + k;
+                    size_t global = ((size_t)i * f->n1 + r * p1 + jj) * f->n2 + k;
+                    erreur = fmax(erreur, hypot(bloc[local] - ref_re[global],
+                                                bloc[f->taille_locale + local] - ref_im[global]));
+                    norme = fmax(norme, hypot(ref_re[global], ref_im[global]));
+                }
+            }
+        }
+    }
+    free(ref_re);
+    free(ref_im);
+    free(tout);
+    return erreur / norme;
+}
+
+// Usage : mpirun -np P ./fft_tranches [n0] [n1] [n2] [threads par rang]
+// n0 et n1 doivent être des multiples de P ; par défaut un cube de 128^3.
+int main(int argc, char** argv) {
+    int rang, nb_processus;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nb_processus);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rang);
+
+    int n0 = argc > 1 ? atoi(argv[1]) : TAILLE_DEFAUT;
+    int n1 = argc > 2 ? atoi(argv[2]) : n0;
+    int n2 = argc > 3 ? atoi(argv[3]) : n0;
+    int threads = argc > 4 ? atoi(argv[4]) : 1;
+    if (n0 <= 0 || n1 <= 0 || n2 <= 0 || n0 % nb_processus != 0 || n1 % nb_processus != 0) {
+        if (rang == 0)
+            fprintf(stderr, "Erreur : n0 (%d) et n1 (%d) doivent être des multiples du nombre de processus (%d)\n",
+                    n0, n1, nb_processus);
+        MPI_Finalize();
+        return 1;
+    }
+
+    ThreadPool* pool = createThreadPool(threads);
+    fft_tranches f;
+    if (pool == NULL || !initialiser_fft(&f, n0, n1, n2, rang, nb_processus, pool)) {
+        fprintf(stderr, "Erreur : rang %d, allocation impossible\n", rang);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    double* re = (double*)malloc(f.taille_locale * sizeof(double));
+    double* im = (double*)malloc(f.taille_locale * sizeof(double));
+    double* init_re = (double*)malloc(f.taille_locale * sizeof(double));
+    if (re == NULL || im == NULL || init_re == NULL) {
+        fprintf(stderr, "Erreur : rang %d, allocation impossible\n", rang);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    size_t indice = 0;
+    for (long i = (long)rang * f.plans_locaux; i < (long)(rang + 1) * f.plans_locaux; i++) {
+        for (long j = 0; j < n1; j++) {
+            for (long k = 0; k < n2; k++, indice++) {
+                re[indice] = init_re[indice] = valeur_initiale(i, j, k, 0);
+                im[indice] = valeur_initiale(i, j, k, 1);
+            }
+        }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double debut = MPI_Wtime();
+    fft_distribuee(&f, re, im, 0);
+    double duree = MPI_Wtime() - debut;
+    double etapes[3] = {f.temps_plans, f.temps_echange, f.temps_axe0};
+    double duree_max;
+    MPI_Reduce(&duree, &duree_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    size_t total = (size_t)n0 * n1 * n2;
+    double erreur_reference = -1;
+    if (total <= TAILLE_VERIFICATION_MAX) erreur_reference = verifier(&f, re, im, pool);
+
+    // Aller-retour : inverse(directe(x)) = N x
+    fft_distribuee(&f, re, im, 1);
+    double erreur_locale = 0, norme_locale = 0;
+    for (size_t q = 0; q < f.taille_locale; q++) {
+        erreur_locale = fmax(erreur_locale, fabs(re[q] / total - init_re[q]));
+        norme_locale = fmax(norme_locale, fabs(init_re[q]));
+    }
+    double erreurs[2] = {erreur_locale, norme_locale}, maximums[2];
+    MPI_Reduce(erreurs, maximums, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rang == 0) {
+        double flops = 5.0 * total * log2((double)total);
+        printf("FFT 3D %d x %d x %d sur %d processus (%d threads chacun, %.1f Mo par rang)\n", n0, n1, n2,
+               nb_processus, threads, 2 * f.taille_locale * sizeof(double) / 1e6);
+        printf("Directe : %.3f s, %.2f GFLOP/s (rang 0 : plans %.3f s, échange %.3f s, axe 0 %.3f s)\n", duree_max,
+               flops / duree_max / 1e9, etapes[0], etapes[1], etapes[2]);
+        if (erreur_reference >= 0) printf("Erreur relative contre la FFT 3D d'un seul processus : %.2e\n", erreur_reference);
+        printf("Erreur relative de l'aller-retour : %.2e\n", maximums[0] / maximums[1]);
+    }
+
+    free(re);
+    free(im);
+    free(init_re);
+    liberer_fft(&f);
+    destroyThreadPool(pool);
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,396 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../TP_pthreads/perf_counters.h"
+
+#define TAILLE_MATRICE_DEFAUT 1024
+#define TAILLE_BLOC_DEFAUT 64
+#define TAILLE_VERIFICATION_MAX 1024 // au-delà, la vérification sur le rang 0 serait trop coûteuse
+
+// Décomposition LU (élimination de Gauss sans pivotage, comme gaussian() du TP OpenMP)
+// d'une matrice distribuée en blocs cycliques 2D sur une grille de P x Q processus.
+// Le bloc (I, J) appartient au processus (I % P, J % Q) : aucun rang ne stocke la matrice
+// entière, ce qui permet de factoriser des matrices plus grandes que la mémoire d'un noeud.
+typedef struct {
+    int n;                  // ordre de la matrice
+    int nb;                 // taille d'un bloc
+    int nb_blocs;           // n / nb
+    int P, Q;               // dimensions de la grille de processus
+    int ma_ligne, ma_colonne;
+    int blocs_lignes, blocs_colonnes;         // nombre de blocs locaux
+    int lignes_locales, colonnes_locales;
+    double* a;              // blocs locaux, ligne par ligne (pas = colonnes_locales)
+    double* diag;           // copie du bloc diagonal factorisé de l'étape courante
+    double* panneau_l[2];   // panneaux L diffusés le long des lignes de processus
+    double* panneau_u[2];   // panneaux U diffusés le long des colonnes de processus
+    MPI_Comm comm_ligne, comm_colonne;           // diffusions non bloquantes des panneaux
+    MPI_Comm comm_ligne_diag, comm_colonne_diag; // diffusions du bloc diagonal
+    perf_region* mesure;    // noyaux locaux (bloc diagonal, panneaux, mises à jour), hors communications
+} grille_lu;
+
+int nb_blocs_locaux(int nb_blocs, int coord, int nb_proc);
+double element_initial(int i, int j, int n);
+void initialiser_grille(grille_lu* g, int n, int nb, int rang, int nb_processus);
+void liberer_grille(grille_lu* g);
+void factoriser_panneau(grille_lu* g, int k, MPI_Request requetes[2]);
+void mettre_a_jour_blocs(grille_lu* g, int k, int bi_debut, int bi_fin, int bj_debut, int bj_fin);
+void factoriser_lu(grille_lu* g);
+double verifier_factorisation(grille_lu* g, int rang, int nb_processus);
+
+int main(int argc, char** argv) {
+    int rang, nb_processus;
+    int n = TAILLE_MATRICE_DEFAUT;
+    int nb = TAILLE_BLOC_DEFAUT;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &nb_processus);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rang);
+
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2) nb = atoi(argv[2]);
+    if (n <= 0 || nb <= 0 || n % nb != 0) {
+        if (rang == 0)
+            fprintf(stderr, "Erreur : l'ordre de la matrice (%d) doit être un multiple de la taille de bloc (%d)\n", n, nb);
+        MPI_Finalize();
+        return 1;
+    }
+
+    grille_lu g;
+    initialiser_grille(&g, n, nb, rang, nb_processus);
+
+    if (rang == 0) {
+        printf("Décomposition LU bloc-cyclique : n = %d, bloc = %d, grille %d x %d\n", n, nb, g.P, g.Q);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double debut = MPI_Wtime();
+    factoriser_lu(&g);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double fin = MPI_Wtime();
+
+    // Le rang le plus chargé borne le temps : l'écart restant est l'attente des panneaux
+    double calcul = perf_region_seconds(g.mesure);
+    double calcul_max = 0;
+    MPI_Reduce(&calcul, &calcul_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if (rang == 0) {
+        double temps = fin - debut;
+        double gflops = (2.0 / 3.0) * n * (double)n * n / temps / 1e9;
+        printf("Temps de factorisation : %f s (%.2f GFLOP/s), calcul local max %f s\n", temps, gflops,
+               calcul_max);
+        fflush(stdout);
+    }
+    for (int r = 0; r < nb_processus; r++) {
+        if (rang == r) {
+            perf_region_report(g.mesure, stdout);
+            fflush(stdout);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (n <= TAILLE_VERIFICATION_MAX) {
+        double residu = verifier_factorisation(&g, rang, nb_processus);
+        if (rang == 0) {
+            printf("Résidu relatif max |A - LU| / max |A| = %e\n", residu);
+        }
+    }
+
+    liberer_grille(&g);
+    MPI_Finalize();
+    return 0;
+}
+
+// Nombre de blocs d'indice < nb_blocs possédés par la coordonnée coord
+int nb_blocs_locaux(int nb_blocs, int coord, int nb_proc) {
+    return nb_blocs > coord ? (nb_blocs - coord - 1) / nb_proc + 1 : 0;
+}
+
+// Valeur déterministe de A[i][j] : chaque rang génère ses blocs sans communication.
+// La diagonale est dominante, l'élimination sans pivotage est donc stable.
+double element_initial(int i, int j, int n) {
+    unsigned int h = (unsigned int)i * 2654435761u ^ (unsigned int)j * 40503u;
+    double valeur = (double)((h >> 7) % 20 + 1);
+    if (i == j) valeur += 20.0 * n;
+    return valeur;
+}
+
+void initialiser_grille(grille_lu* g, int n, int nb, int rang, int nb_processus) {
+    int dims[2] = {0, 0};
+    MPI_Dims_create(nb_processus, 2, dims);
+
+    g->n = n;
+    g->nb = nb;
+    g->nb_blocs = n / nb;
+    g->P = dims[0];
+    g->Q = dims[1];
+    g->ma_ligne = rang / g->Q;
+    g->ma_colonne = rang % g->Q;
+    g->blocs_lignes = nb_blocs_locaux(g->nb_blocs, g->ma_ligne, g->P);
+    g->blocs_colonnes = nb_blocs_locaux(g->nb_blocs, g->ma_colonne, g->Q);
+    g->lignes_locales = g->blocs_lignes * nb;
+    g->colonnes_locales = g->blocs_colonnes * nb;
+    char nom[48];
+    snprintf(nom, sizeof(nom), "rang %d (%d, %d)", rang, g->ma_ligne, g->ma_colonne);
+    g->mesure = perf_region_create(nom, 1);
+
+    size_t taille_locale = (size_t)g->lignes_locales * g->colonnes_locales;
+    g->a = (double*)malloc((taille_locale > 0 ? taille_locale : 1) * sizeof(double));
+    g->diag = (double*)malloc((size_t)nb * nb * sizeof(double));
+    for (int p = 0; p < 2; p++) {
+        g->panneau_l[p] = (double*)malloc(((size_t)g->lignes_locales * nb + 1) * sizeof(double));
+        g->panneau_u[p] = (double*)malloc(((size_t)nb * g->colonnes_locales + 1) * sizeof(double));
+    }
+    if (g->a == NULL || g->diag == NULL || g->panneau_l[0] == NULL || g->panneau_l[1] == NULL ||
+        g->panneau_u[0] == NULL || g->panneau_u[1] == NULL) {
+        fprintf(stderr, "Erreur d'allocation mémoire sur le rang %d.\n", rang);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // Les processus d'une même ligne partagent leurs blocs de lignes, idem pour les colonnes
+    MPI_Comm_split(MPI_COMM_WORLD, g->ma_ligne, g->ma_colonne, &g->comm_ligne);
+    MPI_Comm_split(MPI_COMM_WORLD, g->ma_colonne, g->ma_ligne, &g->comm_colonne);
+    MPI_Comm_dup(g->comm_ligne, &g->comm_ligne_diag);
+    MPI_Comm_dup(g->comm_colonne, &g->comm_colonne_diag);
+
+    for (int bi = 0; bi < g->blocs_lignes; bi++) {
+        int I = bi * g->P + g->ma_ligne;
+        for (int bj = 0; bj < g->blocs_colonnes; bj++) {
+            int J = bj * g->Q + g->ma_colonne;
+            for (int r = 0; r < nb; r++) {
+                double* ligne = &g->a[(size_t)(bi * nb + r) * g->colonnes_locales + bj * nb];
+                for (int c = 0; c < nb; c++) {
+                    ligne[c] = element_initial(I * nb + r, J * nb + c, n);
+                }
+            }
+        }
+    }
+}
+
+void liberer_grille(grille_lu* g) {
+    MPI_Comm_free(&g->comm_ligne);
+    MPI_Comm_free(&g->comm_colonne);
+    MPI_Comm_free(&g->comm_ligne_diag);
+    MPI_Comm_free(&g->comm_colonne_diag);
+    for (int p = 0; p < 2; p++) {
+        free(g->panneau_l[p]);
+        free(g->panneau_u[p]);
+    }
+    free(g->diag);
+    free(g->a);
+    perf_region_free(g->mesure);
+}
+
+// LU en place d'un bloc nb x nb (L unitaire sous la diagonale, U au-dessus)
+void factoriser_bloc_diagonal(double* d, int pas, int nb) {
+    for (int i = 0; i < nb; i++) {
+        for (int j = i + 1; j < nb; j++) {
+            double l = d[j * pas + i] / d[i * pas + i];
+            d[j * pas + i] = l;
+            for (int k = i + 1; k < nb; k++) {
+                d[j * pas + k] -= l * d[i * pas + k];
+            }
+        }
+    }
+}
+
+// L_ik = A_ik * U_kk^-1 pour un panneau de 'lignes' lignes
+void resoudre_panneau_l(const double* diag, int nb, double* l, int pas, int lignes) {
+    for (int r = 0; r < lignes; r++) {
+        double* ligne = &l[(size_t)r * pas];
+        for (int c = 0; c < nb; c++) {
+            ligne[c] /= diag[c * nb + c];
+            for (int c2 = c + 1; c2 < nb; c2++) {
+                ligne[c2] -= ligne[c] * diag[c * nb + c2];
+            }
+        }
+    }
+}
+
+// U_kj = L_kk^-1 * A_kj pour un panneau de 'colonnes' colonnes
+void resoudre_panneau_u(const double* diag, int nb, double* u, int pas, int colonnes) {
+    for (int r = 1; r < nb; r++) {
+        double* ligne = &u[(size_t)r * pas];
+        for (int t = 0; t < r; t++) {
+            double l = diag[r * nb + t];
+            const double* ligne_t = &u[(size_t)t * pas];
+            for (int c = 0; c < colonnes; c++) {
+                ligne[c] -= l * ligne_t[c];
+            }
+        }
+    }
+}
+
+// Factorise le panneau k (bloc diagonal, colonne de blocs L, ligne de blocs U)
+// puis lance sa diffusion non bloquante : L le long des lignes de processus,
+// U le long des colonnes de processus.
+void factoriser_panneau(grille_lu* g, int k, MPI_Request requetes[2]) {
+    int nb = g->nb;
+    int ligne_proprio = k % g->P;
+    int colonne_proprio = k % g->Q;
+    int pas = g->colonnes_locales;
+    int premiere_ligne = nb_blocs_locaux(k + 1, g->ma_ligne, g->P) * nb;      // blocs I > k
+    int premiere_colonne = nb_blocs_locaux(k + 1, g->ma_colonne, g->Q) * nb;  // blocs J > k
+    int lignes_l = g->lignes_locales - premiere_ligne;
+    int colonnes_u = g->colonnes_locales - premiere_colonne;
+    double* panneau_l = g->panneau_l[k % 2];
+    double* panneau_u = g->panneau_u[k % 2];
+
+    if (g->ma_ligne == ligne_proprio && g->ma_colonne == colonne_proprio) {
+        double* d = &g->a[(size_t)(k / g->P) * nb * pas + (k / g->Q) * nb];
+        perf_region_begin(g->mesure, 0);
+        factoriser_bloc_diagonal(d, pas, nb);
+        perf_region_end(g->mesure, 0);
+        perf_region_add_work(g->mesure, 2.0 / 3.0 * nb * nb * nb, 2.0 * nb * nb * sizeof(double));
+        for (int r = 0; r < nb; r++) {
+            memcpy(&g->diag[r * nb], &d[(size_t)r * pas], nb * sizeof(double));
+        }
+    }
+
+    if (g->ma_colonne == colonne_proprio) {
+        MPI_Bcast(g->diag, nb * nb, MPI_DOUBLE, ligne_proprio, g->comm_colonne_diag);
+        double* l = &g->a[(size_t)premiere_ligne * pas + (k / g->Q) * nb];
+        perf_region_begin(g->mesure, 0);
+        resoudre_panneau_l(g->diag, nb, l, pas, lignes_l);
+        perf_region_end(g->mesure, 0);
+        perf_region_add_work(g->mesure, (double)lignes_l * nb * nb, 2.0 * lignes_l * nb * sizeof(double));
+        for (int r = 0; r < lignes_l; r++) {
+            memcpy(&panneau_l[(size_t)r * nb], &l[(size_t)r * pas], nb * sizeof(double));
+        }
+    }
+    if (g->ma_ligne == ligne_proprio) {
+        MPI_Bcast(g->diag, nb * nb, MPI_DOUBLE, colonne_proprio, g->comm_ligne_diag);
+        double* u = &g->a[(size_t)(k / g->P) * nb * pas + premiere_colonne];
+        perf_region_begin(g->mesure, 0);
+        resoudre_panneau_u(g->diag, nb, u, pas, colonnes_u);
+        perf_region_end(g->mesure, 0);
+        perf_region_add_work(g->mesure, (double)colonnes_u * nb * (nb - 1), 2.0 * nb * colonnes_u * sizeof(double));
+        for (int r = 0; r < nb; r++) {
+            memcpy(&panneau_u[(size_t)r * colonnes_u], &u[(size_t)r * pas], colonnes_u * sizeof(double));
+        }
+    }
+
+    MPI_Ibcast(panneau_l, lignes_l * nb, MPI_DOUBLE, colonne_proprio, g->comm_ligne, &requetes[0]);
+    MPI_Ibcast(panneau_u, nb * colonnes_u, MPI_DOUBLE, ligne_proprio, g->comm_colonne, &requetes[1]);
+}
+
+// A_IJ -= L_Ik * U_kJ pour les blocs locaux bi dans [bi_debut, bi_fin[, bj dans [bj_debut, bj_fin[
+void mettre_a_jour_blocs(grille_lu* g, int k, int bi_debut, int bi_fin, int bj_debut, int bj_fin) {
+    int nb = g->nb;
+    int pas = g->colonnes_locales;
+    int premiere_ligne = nb_blocs_locaux(k + 1, g->ma_ligne, g->P) * nb;
+    int premiere_colonne = nb_blocs_locaux(k + 1, g->ma_colonne, g->Q) * nb;
+    int colonnes_u = g->colonnes_locales - premiere_colonne;
+    const double* panneau_l = g->panneau_l[k % 2];
+    const double* panneau_u = g->panneau_u[k % 2];
+
+    if (bi_debut >= bi_fin || bj_debut >= bj_fin) return;
+
+    // Deux opérations par élément et par t ; le bloc est lu et écrit, les panneaux lus
+    int c_debut = bj_debut * nb, c_fin = bj_fin * nb;
+    double lignes = (double)(bi_fin - bi_debut) * nb, colonnes = (double)(c_fin - c_debut);
+    perf_region_begin(g->mesure, 0);
+    for (int r = bi_debut * nb; r < bi_fin * nb; r++) {
+        double* ligne = &g->a[(size_t)r * pas];
+        const double* l = &panneau_l[(size_t)(r - premiere_ligne) * nb];
+        for (int t = 0; t < nb; t++) {
+            double coef = l[t];
+            const double* u = &panneau_u[(size_t)t * colonnes_u];
+            for (int c = c_debut; c < c_fin; c++) {
+                ligne[c] -= coef * u[c - premiere_colonne];
+            }
+        }
+    }
+    perf_region_end(g->mesure, 0);
+    perf_region_add_work(g->mesure, 2.0 * lignes * colonnes * nb,
+                         (2.0 * lignes * colonnes + (lignes + colonnes) * nb) * sizeof(double));
+}
+
+// Élimination avec anticipation d'une étape : dès que les panneaux k sont reçus, on met
+// à jour la colonne et la ligne de blocs k+1, on factorise le panneau k+1 et on lance sa
+// diffusion, puis la mise à jour du reste de la sous-matrice recouvre cette diffusion.
+void factoriser_lu(grille_lu* g) {
+    MPI_Request requetes[2];
+
+    factoriser_panneau(g, 0, requetes);
+
+    for (int k = 0; k < g->nb_blocs; k++) {
+        MPI_Waitall(2, requetes, MPI_STATUSES_IGNORE);
+        if (k + 1 == g->nb_blocs) break;
+
+        int bi_k = nb_blocs_locaux(k + 1, g->ma_ligne, g->P);     // premier bloc local I > k
+        int bj_k = nb_blocs_locaux(k + 1, g->ma_colonne, g->Q);   // premier bloc local J > k
+        int bi_k1 = nb_blocs_locaux(k + 2, g->ma_ligne, g->P);    // premier bloc local I > k+1
+        int bj_k1 = nb_blocs_locaux(k + 2, g->ma_colonne, g->Q);  // premier bloc local J > k+1
+
+        // Colonne de blocs k+1 puis ligne de blocs k+1 : le prochain panneau
+        if (g->ma_colonne == (k + 1) % g->Q) {
+            mettre_a_jour_blocs(g, k, bi_k, g->blocs_lignes, bj_k, bj_k + 1);
+        }
+        if (g->ma_ligne == (k + 1) % g->P) {
+            mettre_a_jour_blocs(g, k, bi_k, bi_k + 1, bj_k1, g->blocs_colonnes);
+        }
+
+        MPI_Request requetes_suivantes[2];
+        factoriser_panneau(g, k + 1, requetes_suivantes);
+
+        // Reste de la sous-matrice, pendant que le panneau k+1 circule
+        mettre_a_jour_blocs(g, k, bi_k1, g->blocs_lignes, bj_k1, g->blocs_colonnes);
+
+        requetes[0] = requetes_suivantes[0];
+        requetes[1] = requetes_suivantes[1];
+    }
+}
+
+// Rassemble la matrice factorisée sur le rang 0 (petites tailles uniquement)
+// et calcule max |A - LU| / max |A|.
+double verifier_factorisation(grille_lu* g, int rang, int nb_processus) {
+    int n = g->n, nb = g->nb;
+    int taille_locale = g->lignes_locales * g->colonnes_locales;
+    double residu = 0.0;
+
+    if (rang != 0) {
+        MPI_Send(g->a, taille_locale, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+        return residu;
+    }
+
+    double* lu = (double*)malloc((size_t)n * n * sizeof(double));
+    double* tampon = (double*)malloc((size_t)n * n * sizeof(double));
+    for (int source = 0; source < nb_processus; source++) {
+        int pl = source / g->Q, pc = source % g->Q;
+        int blocs_l = nb_blocs_locaux(g->nb_blocs, pl, g->P);
+        int blocs_c = nb_blocs_locaux(g->nb_blocs, pc, g->Q);
+        int colonnes = blocs_c * nb;
+        if (source == 0) {
+            memcpy(tampon, g->a, (size_t)taille_locale * sizeof(double));
+        } else {
+            MPI_Recv(tampon, blocs_l * nb * colonnes, MPI_DOUBLE, source, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        for (int r = 0; r < blocs_l * nb; r++) {
+            int i = (r / nb * g->P + pl) * nb + r % nb;
+            for (int c = 0; c < colonnes; c++) {
+                int j = (c / nb * g->Q + pc) * nb + c % nb;
+                lu[(size_t)i * n + j] = tampon[(size_t)r * colonnes + c];
+            }
+        }
+    }
+
+    double max_a = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double somme = 0.0;
+            int t_max = i < j ? i : j;
+            for (int t = 0; t < t_max; t++) {
+                somme += lu[(size_t)i * n + t] * lu[(size_t)t * n + j];
+            }
+            somme += (i <= j) ? lu[(size_t)i * n + j] : lu[(size_t)i * n + j] * lu[(size_t)j * n + j];
+            double a = element_initial(i, j, n);
+            if (fabs(a) > max_a) max_a = fabs(a);
+            if (fabs(a - somme) > residu) residu = fabs(a - somme);
+        }
+    }
+
+    free(tampon);
+    free(lu);
+    return residu / max_a;
+}
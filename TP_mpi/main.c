@@ -1,6 +1,7 @@
 #include <mpi.h> 
 #include <stdio.h>
 #include <stdlib.h>
+#include "../TP_pthreads/perf_counters.h"
 
 #define TAILLE_BLOC 10
 #define TAILLE_MATRICE 100
@@ -74,6 +75,10 @@ void processus_maitre(int taille_bloc, int nb_processus) {
 void processus_esclave(int rang, int taille_bloc) {
     int bloc[taille_bloc];
     MPI_Status statut;
+    char nom[32];
+    snprintf(nom, sizeof(nom), "esclave %d", rang);
+    // Seul le traitement des blocs est mesuré, pas les attentes de communication
+    perf_region* region = perf_region_create(nom, 1);
 
     // Requête initiale pour demander des données
     MPI_Send(NULL, 0, MPI_INT, 0, TAG_REQUETE_INITIALE, MPI_COMM_WORLD);
@@ -86,13 +91,21 @@ void processus_esclave(int rang, int taille_bloc) {
             break;
 
         // Traiter les données
+        perf_region_begin(region, 0);
         for (int i = 0; i < taille_bloc; ++i) {
             bloc[i] = bloc[i] * bloc[i];
         }
+        perf_region_end(region, 0);
+        // Une multiplication entière, 4 octets lus et 4 écrits par élément
+        perf_region_add_work(region, taille_bloc, 8.0 * taille_bloc);
 
         // Envoyer les données traitées au maître, ce qui constitue également une nouvelle requête de données
         MPI_Send(bloc, taille_bloc, MPI_INT, 0, statut.MPI_TAG, MPI_COMM_WORLD);
     }
+
+    perf_region_report(region, stdout);
+    fflush(stdout);
+    perf_region_free(region);
 }
 
 void initialiser_matrice(int *matrice, int taille) {
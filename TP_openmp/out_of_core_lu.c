@@ -0,0 +1,628 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+#include "../TP_pthreads/matrix_file.h"
+#include "../TP_pthreads/perf_counters.h"
+
+// Élimination de Gauss (sans pivot, comme gaussian) sur une matrice qui ne tient pas en
+// mémoire. La matrice reste dans un fichier au format de matrix_file.h (tuiles brutes,
+// alignées sur des pages), où L (multiplicateurs) et U remplacent A. Les tuiles passent par
+// un cache LRU de taille bornée ; un thread d'E/S charge les tuiles du lot d'opérations
+// suivant et réécrit les tuiles évincées pendant que les threads OpenMP calculent le lot
+// courant.
+
+#define DEFAULT_N 4096
+#define DEFAULT_TILE 256
+#define DEFAULT_FILE "lu_tuiles.mat"
+#define IO_ALIGNMENT 4096
+
+#define OP_FACTOR 0     // A_kk = L_kk U_kk
+#define OP_ROW 1        // U_kj = L_kk^-1 A_kj
+#define OP_COLUMN 2     // L_ik = A_ik U_kk^-1
+#define OP_UPDATE 3     // A_ij -= L_ik U_kj
+
+#define SLOT_READY 0
+#define SLOT_BUSY 1     // lecture ou écriture en cours dans le thread d'E/S
+
+typedef struct {
+    float* data;
+    long tile;          // -1 : emplacement libre
+    int pins;
+    int dirty;
+    int state;
+    long last_use;
+} cache_slot;
+
+typedef struct {
+    int slot;
+    long write_tile;    // -1 : rien à réécrire
+    long read_tile;     // -1 : rien à lire
+} io_request;
+
+typedef struct {
+    int fd;
+    int direct;                 // O_DIRECT : transferts arrondis à la page, sans cache du noyau
+    const matrix_tile* directory;
+    cache_slot* slots;
+    int capacity;
+    long* where;                // tuile -> emplacement, -1 si absente
+    long clock;
+    io_request* queue;          // au plus une requête par emplacement
+    int head, count, stop;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;       // un emplacement a fini son transfert
+    pthread_cond_t work;        // requête en attente
+    pthread_t io_thread;
+    double stall;               // temps passé à attendre des tuiles
+    long bytes_read, bytes_written, hits, misses, prefetched;
+    int io_error;
+} tile_cache;
+
+typedef struct {
+    int type, k, i, j;
+    int operands[3];    // indices dans les tuiles du lot ; la première est modifiée
+} tile_op;
+
+typedef struct {
+    int k, phase;
+    long index;
+} op_iterator;
+
+typedef struct {
+    tile_op* ops;
+    int num_ops;
+    long* tiles;        // tuiles distinctes du lot
+    float** data;
+    int num_tiles;
+} op_batch;
+
+typedef struct {
+    int n, tile, tiles_per_row;
+} lu_shape;
+
+static int tile_dim(const lu_shape* s, int a) {
+    return s->n - a * s->tile < s->tile ? s->n - a * s->tile : s->tile;
+}
+
+// Élément (i, j) de la matrice de test, recalculable pour la vérification. La diagonale
+// dominante rend l'élimination sans pivot stable.
+static float element(long n, long i, long j) {
+    uint64_t z = (uint64_t)(i * n + j) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    float v = (float)((z ^ (z >> 31)) % 20 + 1);
+    return i == j ? v + 20.0f * n : v;
+}
+
+// ---------- Cache de tuiles ----------
+
+static size_t transfer_size(const tile_cache* c, const matrix_tile* t) {
+    return c->direct ? (t->size + IO_ALIGNMENT - 1) / IO_ALIGNMENT * IO_ALIGNMENT : t->size;
+}
+
+static int transfer(tile_cache* c, float* data, long tile, int write) {
+    const matrix_tile* t = &c->directory[tile];
+    size_t size = transfer_size(c, t), done = 0;
+    while (done < size) {
+        ssize_t k = write ? pwrite(c->fd, (char*)data + done, size - done, t->offset + done)
+                          : pread(c->fd, (char*)data + done, size - done, t->offset + done);
+        if (k <= 0) return 0;
+        done += k;
+    }
+    return 1;
+}
+
+static void* io_worker(void* arg) {
+    tile_cache* c = (tile_cache*)arg;
+    pthread_mutex_lock(&c->lock);
+    while (1) {
+        while (c->count == 0 && !c->stop) pthread_cond_wait(&c->work, &c->lock);
+        if (c->count == 0) break;
+        io_request r = c->queue[c->head];
+        c->head = (c->head + 1) % c->capacity;
+        c->count--;
+        pthread_mutex_unlock(&c->lock);
+
+        float* data = c->slots[r.slot].data;
+        int ok = 1;
+        if (r.write_tile >= 0) ok &= transfer(c, data, r.write_tile, 1);
+        if (r.read_tile >= 0) ok &= transfer(c, data, r.read_tile, 0);
+
+        pthread_mutex_lock(&c->lock);
+        if (r.write_tile >= 0) c->bytes_written += c->directory[r.write_tile].size;
+        if (r.read_tile >= 0) c->bytes_read += c->directory[r.read_tile].size;
+        if (!ok) c->io_error = 1;
+        c->slots[r.slot].state = SLOT_READY;
+        pthread_cond_broadcast(&c->ready);
+    }
+    pthread_mutex_unlock(&c->lock);
+    return NULL;
+}
+
+static tile_cache* create_tile_cache(int fd, int direct, const matrix_tile* directory, long num_tiles,
+                                     int capacity, int tile) {
+    tile_cache* c = (tile_cache*)calloc(1, sizeof(tile_cache));
+    c->fd = fd;
+    c->direct = direct;
+    c->directory = directory;
+    c->capacity = capacity;
+    c->slots = (cache_slot*)calloc(capacity, sizeof(cache_slot));
+    c->queue = (io_request*)malloc(capacity * sizeof(io_request));
+    c->where = (long*)malloc(num_tiles * sizeof(long));
+    for (long t = 0; t < num_tiles; t++) c->where[t] = -1;
+    size_t slot_size = ((size_t)tile * tile * sizeof(float) + IO_ALIGNMENT - 1) / IO_ALIGNMENT * IO_ALIGNMENT;
+    for (int s = 0; s < capacity; s++) {
+        if (posix_memalign((void**)&c->slots[s].data, IO_ALIGNMENT, slot_size) != 0) {
+            fprintf(stderr, "Erreur d'allocation mémoire.\n");
+            exit(1);
+        }
+        c->slots[s].tile = -1;
+    }
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->ready, NULL);
+    pthread_cond_init(&c->work, NULL);
+    pthread_create(&c->io_thread, NULL, io_worker, c);
+    return c;
+}
+
+static void destroy_tile_cache(tile_cache* c) {
+    pthread_mutex_lock(&c->lock);
+    c->stop = 1;
+    pthread_cond_signal(&c->work);
+    pthread_mutex_unlock(&c->lock);
+    pthread_join(c->io_thread, NULL);
+    for (int s = 0; s < c->capacity; s++) free(c->slots[s].data);
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->ready);
+    pthread_cond_destroy(&c->work);
+    free(c->slots);
+    free(c->queue);
+    free(c->where);
+    free(c);
+}
+
+// Emplacement libre, ou tuile non épinglée utilisée le moins récemment avant older_than
+static int find_victim(tile_cache* c, long older_than) {
+    int best = -1;
+    for (int s = 0; s < c->capacity; s++) {
+        cache_slot* slot = &c->slots[s];
+        if (slot->state != SLOT_READY || slot->pins > 0) continue;
+        if (slot->tile < 0) return s;
+        if (slot->last_use < older_than && (best < 0 || slot->last_use < c->slots[best].last_use)) best = s;
+    }
+    return best;
+}
+
+// Verrou tenu : l'emplacement s reçoit tile, son ancienne tuile est réécrite si modifiée
+static void start_load(tile_cache* c, int s, long tile) {
+    cache_slot* slot = &c->slots[s];
+    io_request r = {s, slot->tile >= 0 && slot->dirty ? slot->tile : -1, tile};
+    if (slot->tile >= 0) c->where[slot->tile] = -1;
+    slot->tile = tile;
+    slot->dirty = 0;
+    slot->state = SLOT_BUSY;
+    slot->last_use = ++c->clock;
+    c->where[tile] = s;
+    c->queue[(c->head + c->count) % c->capacity] = r;
+    c->count++;
+    pthread_cond_signal(&c->work);
+}
+
+static void wait_ready(tile_cache* c, int s) {
+    if (c->slots[s].state == SLOT_READY) return;
+    double start = perf_now();
+    while (c->slots[s].state != SLOT_READY) pthread_cond_wait(&c->ready, &c->lock);
+    c->stall += perf_now() - start;
+}
+
+static float* acquire_tile(tile_cache* c, long tile) {
+    pthread_mutex_lock(&c->lock);
+    long s = c->where[tile];
+    if (s < 0) {
+        // Tous les emplacements libérables peuvent être en cours de préchargement
+        double start = perf_now();
+        while ((s = find_victim(c, c->clock + 1)) < 0) {
+            int busy = 0;
+            for (int t = 0; t < c->capacity; t++) busy |= c->slots[t].state == SLOT_BUSY;
+            if (!busy) {
+                fprintf(stderr, "Erreur : Cache de tuiles trop petit.\n");
+                exit(1);
+            }
+            pthread_cond_wait(&c->ready, &c->lock);
+        }
+        c->stall += perf_now() - start;
+        start_load(c, (int)s, tile);
+        c->misses++;
+    } else {
+        c->hits++;
+    }
+    wait_ready(c, (int)s);
+    c->slots[s].pins++;
+    c->slots[s].last_use = ++c->clock;
+    pthread_mutex_unlock(&c->lock);
+    return c->slots[s].data;
+}
+
+static void release_tile(tile_cache* c, long tile, int dirty) {
+    pthread_mutex_lock(&c->lock);
+    cache_slot* slot = &c->slots[c->where[tile]];
+    slot->pins--;
+    slot->dirty |= dirty;
+    pthread_mutex_unlock(&c->lock);
+}
+
+// Tuiles du prochain lot : celles déjà présentes sont rajeunies, les autres chargées sans
+// évincer une tuile du lot
+static void prefetch_tiles(tile_cache* c, const long* tiles, int num_tiles) {
+    pthread_mutex_lock(&c->lock);
+    long first_stamp = c->clock + 1;
+    for (int t = 0; t < num_tiles; t++) {
+        if (c->where[tiles[t]] >= 0) c->slots[c->where[tiles[t]]].last_use = ++c->clock;
+    }
+    for (int t = 0; t < num_tiles; t++) {
+        if (c->where[tiles[t]] >= 0) continue;
+        int s = find_victim(c, first_stamp);
+        if (s < 0) break;
+        start_load(c, s, tiles[t]);
+        c->prefetched++;
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+// Réécrit toutes les tuiles modifiées et attend la fin des transferts
+static void flush_tile_cache(tile_cache* c) {
+    pthread_mutex_lock(&c->lock);
+    for (int s = 0; s < c->capacity; s++) {
+        cache_slot* slot = &c->slots[s];
+        wait_ready(c, s);
+        if (slot->tile < 0 || !slot->dirty) continue;
+        slot->dirty = 0;
+        slot->state = SLOT_BUSY;
+        c->queue[(c->head + c->count) % c->capacity] = (io_request){s, slot->tile, -1};
+        c->count++;
+        pthread_cond_signal(&c->work);
+    }
+    for (int s = 0; s < c->capacity; s++) wait_ready(c, s);
+    pthread_mutex_unlock(&c->lock);
+}
+
+// ---------- Noyaux sur les tuiles (ligne par ligne, pas = largeur de la tuile) ----------
+
+static void factor_tile(float* a, int m) {
+    for (int k = 0; k < m; k++) {
+        for (int i = k + 1; i < m; i++) {
+            float l = a[i * m + k] /= a[k * m + k];
+            for (int j = k + 1; j < m; j++) a[i * m + j] -= l * a[k * m + j];
+        }
+    }
+}
+
+// a (m x w) <- L^-1 a, L triangulaire inférieure unitaire (m x m)
+static void solve_row_tile(const float* l, int m, float* a, int w) {
+    for (int i = 1; i < m; i++) {
+        for (int p = 0; p < i; p++) {
+            float f = l[i * m + p];
+            for (int j = 0; j < w; j++) a[i * w + j] -= f * a[p * w + j];
+        }
+    }
+}
+
+// a (h x m) <- a U^-1, U triangulaire supérieure (m x m)
+static void solve_column_tile(const float* u, int m, float* a, int h) {
+    for (int r = 0; r < h; r++) {
+        float* row = a + (size_t)r * m;
+        for (int p = 0; p < m; p++) {
+            float f = row[p] /= u[p * m + p];
+            for (int j = p + 1; j < m; j++) row[j] -= f * u[p * m + j];
+        }
+    }
+}
+
+// c (h x w) -= l (h x m) u (m x w)
+static void update_tile(float* c, const float* l, const float* u, int h, int m, int w) {
+    for (int r = 0; r < h; r++) {
+        for (int p = 0; p < m; p++) {
+            float f = l[r * m + p];
+            for (int j = 0; j < w; j++) c[r * w + j] -= f * u[p * w + j];
+        }
+    }
+}
+
+static void run_op(const lu_shape* s, const tile_op* op, float* const* data) {
+    int mk = tile_dim(s, op->k);
+    if (op->type == OP_FACTOR) {
+        factor_tile(data[op->operands[0]], mk);
+    } else if (op->type == OP_ROW) {
+        solve_row_tile(data[op->operands[1]], mk, data[op->operands[0]], tile_dim(s, op->j));
+    } else if (op->type == OP_COLUMN) {
+        solve_column_tile(data[op->operands[1]], mk, data[op->operands[0]], tile_dim(s, op->i));
+    } else {
+        update_tile(data[op->operands[0]], data[op->operands[1]], data[op->operands[2]], tile_dim(s, op->i), mk,
+                    tile_dim(s, op->j));
+    }
+}
+
+// ---------- Suite des opérations, découpée en lots indépendants ----------
+
+// Opérations de l'étape k : phase 0 la tuile diagonale, phase 1 les panneaux ligne et colonne,
+// phase 2 la mise à jour du reste. Les opérations d'une même phase sont indépendantes.
+static long phase_size(const lu_shape* s, int k, int phase) {
+    long rest = s->tiles_per_row - 1 - k;
+    return phase == 0 ? 1 : phase == 1 ? 2 * rest : rest * rest;
+}
+
+static int op_tiles(const lu_shape* s, const tile_op* op, long* tiles) {
+    long T = s->tiles_per_row;
+    if (op->type == OP_FACTOR) {
+        tiles[0] = op->k * T + op->k;
+        return 1;
+    }
+    if (op->type == OP_ROW || op->type == OP_COLUMN) {
+        tiles[0] = op->i * T + op->j;
+        tiles[1] = op->k * T + op->k;
+        return 2;
+    }
+    tiles[0] = op->i * T + op->j;
+    tiles[1] = op->i * T + op->k;
+    tiles[2] = op->k * T + op->j;
+    return 3;
+}
+
+static int add_tile(op_batch* b, long tile) {
+    for (int t = 0; t < b->num_tiles; t++) {
+        if (b->tiles[t] == tile) return t;
+    }
+    b->tiles[b->num_tiles] = tile;
+    return b->num_tiles++;
+}
+
+// Lot suivant : opérations d'une seule phase, au plus max_tiles tuiles distinctes
+static int next_batch(const lu_shape* s, op_iterator* it, op_batch* b, int max_tiles) {
+    b->num_ops = 0;
+    b->num_tiles = 0;
+    while (it->k < s->tiles_per_row && it->index >= phase_size(s, it->k, it->phase)) {
+        it->index = 0;
+        if (++it->phase == 3) {
+            it->phase = 0;
+            it->k++;
+        }
+    }
+    if (it->k >= s->tiles_per_row) return 0;
+    long rest = s->tiles_per_row - 1 - it->k;
+    while (it->index < phase_size(s, it->k, it->phase)) {
+        tile_op op = {OP_FACTOR, it->k, it->k, it->k, {0, 0, 0}};
+        if (it->phase == 1) {
+            op.type = it->index < rest ? OP_ROW : OP_COLUMN;
+            if (op.type == OP_ROW) op.j = it->k + 1 + (int)it->index;
+            else op.i = it->k + 1 + (int)(it->index - rest);
+        } else if (it->phase == 2) {
+            op.type = OP_UPDATE;
+            op.i = it->k + 1 + (int)(it->index / rest);
+            op.j = it->k + 1 + (int)(it->index % rest);
+        }
+        long tiles[3];
+        int n = op_tiles(s, &op, tiles), added = 0;
+        for (int t = 0; t < n; t++) {
+            int known = 0;
+            for (int u = 0; u < b->num_tiles; u++) known |= b->tiles[u] == tiles[t];
+            added += !known;
+        }
+        if (b->num_tiles + added > max_tiles) break;
+        for (int t = 0; t < n; t++) op.operands[t] = add_tile(b, tiles[t]);
+        b->ops[b->num_ops++] = op;
+        it->index++;
+    }
+    return b->num_ops;
+}
+
+static op_batch* create_batch(int max_tiles) {
+    op_batch* b = (op_batch*)calloc(1, sizeof(op_batch));
+    b->ops = (tile_op*)malloc(max_tiles * sizeof(tile_op));  // au moins une tuile neuve par opération
+    b->tiles = (long*)malloc(max_tiles * sizeof(long));
+    b->data = (float**)malloc(max_tiles * sizeof(float*));
+    return b;
+}
+
+static void destroy_batch(op_batch* b) {
+    free(b->ops);
+    free(b->tiles);
+    free(b->data);
+    free(b);
+}
+
+// Renvoie le temps de calcul ; le lot suivant est préchargé pendant le calcul du lot courant.
+// Chaque thread OpenMP mesure sa part de chaque lot dans region (nowait : l'attente à la
+// barrière n'est pas comptée)
+static double factor_out_of_core(const lu_shape* s, tile_cache* c, int prefetch, perf_region* region) {
+    int max_tiles = c->capacity / 2;
+    op_batch* current = create_batch(max_tiles);
+    op_batch* next = create_batch(max_tiles);
+    op_iterator it = {0, 0, 0};
+    double compute = 0;
+    next_batch(s, &it, current, max_tiles);
+    while (current->num_ops > 0) {
+        for (int t = 0; t < current->num_tiles; t++) current->data[t] = acquire_tile(c, current->tiles[t]);
+        next_batch(s, &it, next, max_tiles);
+        if (prefetch) prefetch_tiles(c, next->tiles, next->num_tiles);
+
+        double start = perf_now();
+        #pragma omp parallel
+        {
+            int thread = omp_get_thread_num();
+            perf_region_begin(region, thread);
+            #pragma omp for schedule(dynamic) nowait
+            for (int o = 0; o < current->num_ops; o++) run_op(s, &current->ops[o], current->data);
+            perf_region_end(region, thread);
+        }
+        compute += perf_now() - start;
+
+        // Seule la première opérande de chaque opération est modifiée
+        for (int t = 0; t < current->num_tiles; t++) {
+            int dirty = 0;
+            for (int o = 0; o < current->num_ops; o++) dirty |= current->ops[o].operands[0] == t;
+            release_tile(c, current->tiles[t], dirty);
+        }
+        op_batch* swap = current;
+        current = next;
+        next = swap;
+    }
+    flush_tile_cache(c);
+    destroy_batch(current);
+    destroy_batch(next);
+    return compute;
+}
+
+// ---------- Création et vérification du fichier ----------
+
+static int fill_matrix(const lu_shape* s, const matrix_tile* directory, int fd) {
+    long T = s->tiles_per_row;
+    int ok = 1;
+    #pragma omp parallel
+    {
+        float* buffer = (float*)malloc((size_t)s->tile * s->tile * sizeof(float));
+        #pragma omp for schedule(dynamic) reduction(&& : ok)
+        for (long t = 0; t < T * T; t++) {
+            int a = (int)(t / T), b = (int)(t % T), h = tile_dim(s, a), w = tile_dim(s, b);
+            for (int i = 0; i < h; i++) {
+                for (int j = 0; j < w; j++) {
+                    buffer[i * w + j] = element(s->n, (long)a * s->tile + i, (long)b * s->tile + j);
+                }
+            }
+            ok = ok && pwrite(fd, buffer, directory[t].size, directory[t].offset) == (ssize_t)directory[t].size;
+        }
+        free(buffer);
+    }
+    return ok;
+}
+
+// Résidu relatif max |L U x - A x| / max |A x| pour un x fixé, en relisant le fichier tuile
+// par tuile : y = U x, puis z = L y
+static double lu_residual(const lu_shape* s, const matrix_tile* directory, int fd) {
+    long n = s->n, T = s->tiles_per_row;
+    double* x = (double*)malloc(n * sizeof(double));
+    double* y = (double*)calloc(n, sizeof(double));
+    double* z = (double*)calloc(n, sizeof(double));
+    for (long j = 0; j < n; j++) x[j] = 1.0 + (double)(j % 7) / 7;
+    for (int pass = 0; pass < 2; pass++) {
+        const double* in = pass == 0 ? x : y;
+        double* out = pass == 0 ? y : z;
+        #pragma omp parallel
+        {
+            float* buffer = (float*)malloc((size_t)s->tile * s->tile * sizeof(float));
+            #pragma omp for schedule(dynamic)
+            for (long a = 0; a < T; a++) {
+                int h = tile_dim(s, (int)a);
+                long first = pass == 0 ? a : 0, last = pass == 0 ? T - 1 : a;
+                for (long b = first; b <= last; b++) {
+                    const matrix_tile* t = &directory[a * T + b];
+                    if (pread(fd, buffer, t->size, t->offset) != (ssize_t)t->size) continue;
+                    int w = tile_dim(s, (int)b);
+                    for (int i = 0; i < h; i++) {
+                        long gi = a * s->tile + i;
+                        double sum = 0;
+                        for (int j = 0; j < w; j++) {
+                            long gj = b * s->tile + j;
+                            // U : diagonale comprise ; L : sous la diagonale, diagonale unitaire
+                            if (pass == 0 ? gj >= gi : gj < gi) sum += buffer[i * w + j] * in[gj];
+                        }
+                        out[gi] += sum;
+                    }
+                }
+                if (pass == 1) {
+                    for (int i = 0; i < h; i++) out[a * s->tile + i] += in[a * s->tile + i];
+                }
+            }
+            free(buffer);
+        }
+    }
+    double max_error = 0, max_value = 0;
+    #pragma omp parallel for reduction(max : max_error, max_value)
+    for (long i = 0; i < n; i++) {
+        double ax = 0;
+        for (long j = 0; j < n; j++) ax += element(n, i, j) * x[j];
+        max_error = fmax(max_error, fabs(z[i] - ax));
+        max_value = fmax(max_value, fabs(ax));
+    }
+    free(x);
+    free(y);
+    free(z);
+    return max_error / max_value;
+}
+
+// Usage : ./out_of_core_lu [n] [taille de tuile] [mémoire du cache en Mo] [fichier]
+// Par défaut le cache reçoit le quart de la matrice. La factorisation est faite deux fois,
+// sans puis avec préchargement.
+int main(int argc, char* argv[]) {
+    lu_shape s;
+    s.n = argc > 1 ? atoi(argv[1]) : DEFAULT_N;
+    s.tile = argc > 2 ? atoi(argv[2]) : DEFAULT_TILE;
+    s.tiles_per_row = (s.n + s.tile - 1) / s.tile;
+    double matrix_bytes = (double)s.n * s.n * sizeof(float);
+    double budget = argc > 3 ? atof(argv[3]) * 1e6 : matrix_bytes / 4;
+    const char* filename = argc > 4 ? argv[4] : DEFAULT_FILE;
+    int capacity = (int)(budget / ((double)s.tile * s.tile * sizeof(float)));
+    long num_tiles = (long)s.tiles_per_row * s.tiles_per_row;
+    if (capacity > num_tiles + 6) capacity = (int)num_tiles + 6;
+    if (s.n <= 0 || s.tile <= 0 || capacity < 6) {
+        fprintf(stderr, "Erreur : il faut n > 0 et un cache d'au moins 6 tuiles.\n");
+        return 1;
+    }
+
+    printf("Matrice %d x %d (%.1f Mo) en %ld tuiles de %d x %d, cache de %d tuiles (%.1f Mo), %d threads\n",
+           s.n, s.n, matrix_bytes / 1e6, num_tiles, s.tile, s.tile, capacity,
+           capacity * (double)s.tile * s.tile * sizeof(float) / 1e6, omp_get_max_threads());
+    printf("%-18s | %9s | %9s | %12s | %9s | %9s | %8s | %8s | %s\n", "variante", "total (s)", "calcul (s)",
+           "attente E/S", "lu (Mo)", "écrit (Mo)", "GFLOP/s", "calcul", "résidu");
+    double flops = 2.0 / 3.0 * s.n * (double)s.n * s.n;
+    int ok = 1;
+    perf_region* regions[2];
+    for (int prefetch = 0; prefetch <= 1; prefetch++) {
+        matrix_tile* directory = create_matrix_file(filename, MATRIX_FLOAT32, s.n, s.n, s.tile, s.tile);
+        int fd = directory == NULL ? -1 : open(filename, O_RDWR);
+        if (fd < 0 || !fill_matrix(&s, directory, fd)) {
+            fprintf(stderr, "Erreur : Impossible de créer %s\n", filename);
+            return 1;
+        }
+        fsync(fd);
+        // O_DIRECT si le système de fichiers l'accepte : les temps d'E/S ne sont pas ceux du
+        // cache de pages du noyau
+        int direct_fd = open(filename, O_RDWR | O_DIRECT);
+        int direct = direct_fd >= 0;
+        tile_cache* c = create_tile_cache(direct ? direct_fd : fd, direct, directory, num_tiles, capacity, s.tile);
+
+        regions[prefetch] = perf_region_create(prefetch ? "LU hors mémoire, préchargement" : "LU hors mémoire, à la demande",
+                                               omp_get_max_threads());
+        double start = perf_now();
+        double compute = factor_out_of_core(&s, c, prefetch, regions[prefetch]);
+        double total = perf_now() - start;
+        // Trafic réel avec le fichier ; les tuiles relues depuis le cache ne sont pas comptées
+        perf_region_add_work(regions[prefetch], flops, (double)c->bytes_read + c->bytes_written);
+        double residual = lu_residual(&s, directory, fd);
+        ok &= !c->io_error && residual < 1e-4;
+        printf("%-18s | %9.3f | %10.3f | %12.3f | %9.1f | %10.1f | %8.2f | %8.2f | %.2e%s\n",
+               prefetch ? "avec préchargement" : "à la demande", total, compute, c->stall, c->bytes_read / 1e6,
+               c->bytes_written / 1e6, flops / total / 1e9, flops / compute / 1e9, residual,
+               c->io_error ? " (erreur d'E/S)" : "");
+        if (prefetch) {
+            printf("Tuiles : %ld trouvées dans le cache, %ld chargées à la demande, %ld préchargées ; E/S %s\n",
+                   c->hits, c->misses, c->prefetched, direct ? "directes (O_DIRECT)" : "par le cache du noyau");
+        }
+        destroy_tile_cache(c);
+        if (direct) close(direct_fd);
+        close(fd);
+        free(directory);
+    }
+    for (int prefetch = 0; prefetch <= 1; prefetch++) {
+        perf_region_report(regions[prefetch], stdout);
+        perf_region_free(regions[prefetch]);
+    }
+    printf("Factorisation LU de %s (lisible avec matrix_view)\n", filename);
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include "../TP_pthreads/perf_counters.h"
 #define N 250
 
 void print_matrix(float matrix[N][N], int size)
@@ -38,6 +39,21 @@ void gaussian(float a[N][N], int size)
 }
 
 
+// Travail de gaussian : pour chaque pivot i et ligne j > i, une division puis une multiplication
+// et une soustraction par colonne k >= j ; chaque ligne j >= i est lue et réécrite en entier
+void gaussian_work(int size, double* flops, double* bytes)
+{
+    *flops = 0;
+    *bytes = 0;
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = i + 1; j < size; j++)
+            *flops += 1 + 2.0 * (size - j);
+        *bytes += 2.0 * sizeof(float) * size * (size - i);
+    }
+}
+
+
 void random_fill(float matrix[N][N], int size)
 {
 
@@ -59,13 +75,20 @@ int main(void)
     random_fill(a, size);     
     printf("***A***\n");
     print_matrix(a, size);
-    clock_t start_t=clock(); //Début_temps
+    perf_region* region = perf_region_create("élimination séquentielle", 1);
+    perf_region_begin(region, 0); //Début_temps
     gaussian(a, size);
-    clock_t end_t=clock(); //Fin_temps
-    double runing_t=(double)(end_t-start_t)/CLOCKS_PER_SEC;
+    perf_region_end(region, 0); //Fin_temps
+    double flops, bytes;
+    gaussian_work(size, &flops, &bytes);
+    perf_region_add_work(region, flops, bytes);
+    double runing_t = perf_region_seconds(region);
     printf("***U***\n");
     print_matrix(a, size);
     printf("\nOrdre de la matrice = %d \n " , N);
     printf("\nLe temps séquentiel pour le calcul de la décomposition Gaussienne de la matrice = %f s.\n " , runing_t);
+    printf("\n");
+    perf_region_report(region, stdout);
+    perf_region_free(region);
     return 0;
 }
@@ -3,6 +3,8 @@
 #include <time.h>
 #include <math.h>
 #include <omp.h> 
+#include "../TP_pthreads/matrix_file.h"
+#include "../TP_pthreads/perf_counters.h"
 #define N 8
 #define NUM_THREADS 8
 
@@ -98,6 +100,20 @@ void gaussian(float a[N][N], int size)
     }
 }
 
+// Travail de gaussian : pour chaque pivot i et ligne j > i, une division puis une multiplication
+// et une soustraction par colonne k >= j ; chaque ligne j >= i est lue et réécrite en entier
+void gaussian_work(int size, double* flops, double* bytes)
+{
+    *flops = 0;
+    *bytes = 0;
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = i + 1; j < size; j++)
+            *flops += 1 + 2.0 * (size - j);
+        *bytes += 2.0 * sizeof(float) * size * (size - i);
+    }
+}
+
 void random_fill(float matrix[N][N], int size)
 {
     srand(time(0));
@@ -121,23 +137,42 @@ void copy_matrix(float src[N][N], float dest[N][N], int size)
     }
 }
 
-int main(void)
+int main(int argc, char* argv[])
 {
     omp_set_num_threads(NUM_THREADS);
     int size = N;
     float a[N][N], b[N][N];
     random_fill(a, size);     
     copy_matrix(a, b, size);  
+    double flops, bytes;
+    gaussian_work(size, &flops, &bytes);
 
     //le code séquentiel 
+    // Horloge murale : clock() additionne le temps CPU des threads de gaussian.
+    // Les compteurs ne voient que le thread appelant.
     printf("*** Gaussian Séquentiel ***\n");
-    clock_t start_t = clock();
+    perf_region* sequential = perf_region_create("élimination (gaussian)", 1);
+    perf_region_begin(sequential, 0);
     gaussian(a, size);
-    clock_t end_t = clock();
-    double running_t = (double)(end_t - start_t) / CLOCKS_PER_SEC;
+    perf_region_end(sequential, 0);
+    perf_region_add_work(sequential, flops, bytes);
+    double running_t = perf_region_seconds(sequential);
     printf("***U Séquentiel***\n");
     print_matrix(a, size);
     printf("Le temps séquentiel pour la décomposition gaussienne = %f s.\n", running_t);
+    perf_region_report(sequential, stdout);
+    perf_region_free(sequential);
+
+    // ./sequentiel_code u.mat : U est aussi enregistrée au format binaire de matrix_file.h,
+    // pour l'examiner avec matrix_view quand N est trop grand pour print_matrix
+    if (argc > 1)
+    {
+        const float* rows[N];
+        for (int i = 0; i < size; i++)
+            rows[i] = a[i];
+        if (!write_matrix_file(argv[1], MATRIX_FLOAT32, (const void* const*)rows, size, size, NULL))
+            printf("Erreur : Impossible d'écrire %s\n", argv[1]);
+    }
 
     //1ere version du code parallele 
     // double start_t = omp_get_wtime();
@@ -147,32 +182,46 @@ int main(void)
     // printf("Le temps parallèle pour la décomposition gaussienne v1 = %f s.\n", running_t);
 
     //2eme version 
-    double start = omp_get_wtime();
+    perf_region* v2 = perf_region_create("élimination v2", 1);
+    perf_region_begin(v2, 0);
     #pragma omp parallel
     {
         #pragma omp single
         gaussian_paralel_v2(a, size);
     }
-    double end = omp_get_wtime();
+    perf_region_end(v2, 0);
+    perf_region_add_work(v2, flops, bytes);
     print_matrix(b, size);
-    double running = end - start;
+    double running = perf_region_seconds(v2);
     printf("Le temps parallèle pour la décomposition gaussienne v2 = %f s.\n", running);
+    perf_region_report(v2, stdout);
+    perf_region_free(v2);
 
     //3eme version 
-    double start_t = omp_get_wtime();
+    // Chaque thread mesure sa part de la boucle (nowait : l'attente à la barrière finale
+    // n'est pas comptée, le déséquilibre reste visible dans le détail par thread)
+    perf_region* v3 = perf_region_create("élimination v3", omp_get_max_threads());
+    double start_v3 = perf_now();
 
     #pragma omp parallel
     {
-        #pragma omp for
+        int thread = omp_get_thread_num();
+        perf_region_begin(v3, thread);
+        #pragma omp for nowait
         for (int i = 0; i < size; i++)
         {
             gaussian(a, size);
         }
+        perf_region_end(v3, thread);
     }
 
-    double end_t = omp_get_wtime(); 
-    double runing_t = (double)(end_t - start_t) / CLOCKS_PER_SEC;
+    double end_v3 = perf_now(); 
+    double runing_t = end_v3 - start_v3;
+    perf_region_add_work(v3, size * flops, size * bytes);
     printf("\nLe temps parallel pour le calcul de la décomposition Gaussienne de la matrice = %f s.\n ", runing_t);
+    printf("\n");
+    perf_region_report(v3, stdout);
+    perf_region_free(v3);
     return 0;
 }
 
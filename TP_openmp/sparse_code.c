@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "sparse_factor.h"
+
+// Comparaison de l'élimination creuse (sparse_factor.c) et de l'élimination dense de gaussian
+// sur des matrices à plus de 99 % de zéros : laplaciens de grilles 2D (5 points) et 3D
+// (7 points), ou une matrice au format Matrix Market.
+
+#define DEFAULT_SIZE 100
+#define DENSE_MAX_N 2000        // au-delà, le temps dense est extrapolé depuis une matrice de cette taille
+
+typedef struct {
+    int n;
+    int* row_ptr;
+    int* col_idx;
+    double* values;
+} csr_storage;
+
+// Grille de side^dim noeuds ; pour LU un terme de convection rend les valeurs non symétriques
+static void build_grid(csr_storage* A, int side, int dim, int symmetric) {
+    int n = dim == 2 ? side * side : side * side * side;
+    A->n = n;
+    A->row_ptr = (int*)malloc((n + 1) * sizeof(int));
+    A->col_idx = (int*)malloc((long)n * (2 * dim + 1) * sizeof(int));
+    A->values = (double*)malloc((long)n * (2 * dim + 1) * sizeof(double));
+    int nnz = 0;
+    for (int v = 0; v < n; v++) {
+        int x = v % side, y = (v / side) % side, z = v / (side * side);
+        int coord[3] = {x, y, z};
+        int stride[3] = {1, side, side * side};
+        A->row_ptr[v] = nnz;
+        // Colonnes croissantes : voisins -z, -y, -x, diagonale, +x, +y, +z
+        for (int d = dim - 1; d >= 0; d--) {
+            if (coord[d] > 0) {
+                A->col_idx[nnz] = v - stride[d];
+                A->values[nnz++] = symmetric ? -1.0 : -1.1;
+            }
+        }
+        A->col_idx[nnz] = v;
+        A->values[nnz++] = 2 * dim + 0.1;
+        for (int d = 0; d < dim; d++) {
+            if (coord[d] < side - 1) {
+                A->col_idx[nnz] = v + stride[d];
+                A->values[nnz++] = symmetric ? -1.0 : -0.9;
+            }
+        }
+    }
+    A->row_ptr[n] = nnz;
+}
+
+typedef struct {
+    int row, col;
+    double value;
+} mm_entry;
+
+static int compare_entries(const void* a, const void* b) {
+    const mm_entry* x = (const mm_entry*)a;
+    const mm_entry* y = (const mm_entry*)b;
+    if (x->row != y->row) return x->row < y->row ? -1 : 1;
+    return (x->col > y->col) - (x->col < y->col);
+}
+
+// Matrix Market « coordinate real » (general ou symmetric) ; renvoie 0 en cas d'erreur
+static int read_matrix_market(const char* filename, csr_storage* A) {
+    FILE* f = fopen(filename, "r");
+    if (f == NULL) return 0;
+    char line[1024];
+    int symmetric = 0, rows, cols;
+    long entries;
+    if (fgets(line, sizeof(line), f) == NULL || strncmp(line, "%%MatrixMarket", 14) != 0 ||
+        strstr(line, "coordinate") == NULL) {
+        fclose(f);
+        return 0;
+    }
+    symmetric = strstr(line, "symmetric") != NULL;
+    do {
+        if (fgets(line, sizeof(line), f) == NULL) {
+            fclose(f);
+            return 0;
+        }
+    } while (line[0] == '%');
+    if (sscanf(line, "%d %d %ld", &rows, &cols, &entries) != 3 || rows != cols || rows <= 0) {
+        fclose(f);
+        return 0;
+    }
+    mm_entry* e = (mm_entry*)malloc(2 * entries * sizeof(mm_entry));
+    long count = 0;
+    for (long k = 0; k < entries; k++) {
+        int i, j;
+        double v = 1;
+        if (fgets(line, sizeof(line), f) == NULL || sscanf(line, "%d %d %lf", &i, &j, &v) < 2 || i < 1 ||
+            j < 1 || i > rows || j > rows) {
+            free(e);
+            fclose(f);
+            return 0;
+        }
+        e[count++] = (mm_entry){i - 1, j - 1, v};
+        if (symmetric && i != j) e[count++] = (mm_entry){j - 1, i - 1, v};
+    }
+    fclose(f);
+    qsort(e, count, sizeof(mm_entry), compare_entries);
+    A->n = rows;
+    A->row_ptr = (int*)calloc(rows + 1, sizeof(int));
+    A->col_idx = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    A->values = (double*)malloc((count > 0 ? count : 1) * sizeof(double));
+    int nnz = 0;
+    for (long k = 0; k < count; k++) {
+        // Les doublons s'additionnent, comme dans le format
+        if (nnz > 0 && k > 0 && e[k].row == e[k - 1].row && e[k].col == e[k - 1].col) {
+            A->values[nnz - 1] += e[k].value;
+            continue;
+        }
+        A->row_ptr[e[k].row + 1]++;
+        A->col_idx[nnz] = e[k].col;
+        A->values[nnz++] = e[k].value;
+    }
+    for (int i = 0; i < rows; i++) A->row_ptr[i + 1] += A->row_ptr[i];
+    free(e);
+    return 1;
+}
+
+// max |A x - b| / (max |A| max |x| + max |b|)
+static double residual(const csr_storage* A, const double* values, const double* x, const double* b) {
+    double error = 0, norm_a = 0, norm_x = 0, norm_b = 0;
+    for (int i = 0; i < A->n; i++) {
+        double ax = 0, row = 0;
+        for (int q = A->row_ptr[i]; q < A->row_ptr[i + 1]; q++) {
+            ax += values[q] * x[A->col_idx[q]];
+            row += fabs(values[q]);
+        }
+        error = fmax(error, fabs(ax - b[i]));
+        norm_a = fmax(norm_a, row);
+        norm_x = fmax(norm_x, fabs(x[i]));
+        norm_b = fmax(norm_b, fabs(b[i]));
+    }
+    return error / (norm_a * norm_x + norm_b);
+}
+
+// Élimination dense sans pivot (celle de gaussian) sur les n premières lignes et colonnes de A
+static double dense_lu_time(const csr_storage* A, int n) {
+    double* a = (double*)calloc((size_t)n * n, sizeof(double));
+    if (a == NULL) return -1;
+    for (int i = 0; i < n; i++) {
+        for (int q = A->row_ptr[i]; q < A->row_ptr[i + 1]; q++) {
+            if (A->col_idx[q] < n) a[(long)i * n + A->col_idx[q]] = A->values[q];
+        }
+    }
+    double start = omp_get_wtime();
+    for (int k = 0; k < n - 1; k++) {
+        const double* pivot_row = a + (long)k * n;
+        #pragma omp parallel for schedule(static)
+        for (int i = k + 1; i < n; i++) {
+            double* row = a + (long)i * n;
+            double l = row[k] /= pivot_row[k];
+            for (int j = k + 1; j < n; j++) row[j] -= l * pivot_row[j];
+        }
+    }
+    double elapsed = omp_get_wtime() - start;
+    free(a);
+    return elapsed;
+}
+
+static const char* ordering_names[] = {"naturel", "md", "nd"};
+
+// Usage : ./sparse_code [grille2d|grille3d|fichier.mtx] [côté de la grille] [lu|cholesky]
+//                       [naturel|md|nd|tous]
+int main(int argc, char* argv[]) {
+    const char* source = argc > 1 ? argv[1] : "grille2d";
+    int side = argc > 2 ? atoi(argv[2]) : DEFAULT_SIZE;
+    int kind = argc > 3 && strcmp(argv[3], "cholesky") == 0 ? FACTOR_CHOLESKY : FACTOR_LU;
+    const char* order = argc > 4 ? argv[4] : "tous";
+    int first = ORDER_NATURAL, last = ORDER_NESTED_DISSECTION;
+    if (strcmp(order, "naturel") == 0) last = ORDER_NATURAL;
+    else if (strcmp(order, "md") == 0) first = last = ORDER_MINIMUM_DEGREE;
+    else if (strcmp(order, "nd") == 0) first = last = ORDER_NESTED_DISSECTION;
+
+    csr_storage A;
+    if (strcmp(source, "grille2d") == 0 || strcmp(source, "grille3d") == 0) {
+        if (side <= 1) {
+            fprintf(stderr, "Erreur : la grille doit avoir au moins 2 noeuds de côté.\n");
+            return 1;
+        }
+        build_grid(&A, side, source[6] == '2' ? 2 : 3, kind == FACTOR_CHOLESKY);
+    } else if (!read_matrix_market(source, &A)) {
+        fprintf(stderr, "Erreur : Impossible de lire la matrice %s\n", source);
+        return 1;
+    }
+    int n = A.n;
+    long nnz = A.row_ptr[n];
+    csr_matrix matrix = {n, A.row_ptr, A.col_idx, A.values};
+    printf("Matrice %s : n = %d, %ld non nuls (%.4f %%), %s, %d threads\n", source, n, nnz,
+           100.0 * nnz / ((double)n * n), kind == FACTOR_CHOLESKY ? "Cholesky" : "LU", omp_get_max_threads());
+
+    // Second jeu de valeurs de même structure : diagonale décalée
+    double* shifted = (double*)malloc(nnz * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        for (int q = A.row_ptr[i]; q < A.row_ptr[i + 1]; q++) {
+            shifted[q] = A.values[q] + (A.col_idx[q] == i ? 0.5 : 0);
+        }
+    }
+    double* b = (double*)malloc(n * sizeof(double));
+    double* x = (double*)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i % 7) * 0.25;
+
+    printf("%-14s | %10s | %12s | %7s | %6s | %10s | %10s | %12s | %9s | %9s | %s\n", "ordre", "analyse (s)",
+           "nnz(L)", "supern.", "front", "GFLOP", "facteur (s)", "refacteur (s)", "résol. (s)", "mémoire", "résidu");
+    int ok = 1;
+    double sparse_bytes = 0, sparse_time = 0;
+    for (int ordering = first; ordering <= last; ordering++) {
+        double start = omp_get_wtime();
+        sparse_symbolic* S = sparse_analyze(&matrix, ordering, kind);
+        double analyze = omp_get_wtime() - start;
+        if (S == NULL) {
+            fprintf(stderr, "Erreur : Analyse symbolique impossible.\n");
+            return 1;
+        }
+        start = omp_get_wtime();
+        sparse_numeric* N = sparse_factor(S, A.values);
+        double factor = omp_get_wtime() - start;
+        if (N == NULL) {
+            printf("%-14s | %11.3f | %12ld | %7d | %6d | %10.2f | mémoire insuffisante (%.1f Mo)\n",
+                   ordering_names[ordering], analyze, S->nnz_L, S->num_supernodes, S->max_front, S->flops / 1e9,
+                   S->factor_entries * 8.0 / 1e6);
+            free_sparse_symbolic(S);
+            continue;
+        }
+        double error = 1;
+        if (!N->failed) {
+            sparse_solve(N, b, x);
+            error = residual(&A, A.values, x, b);
+        }
+        start = omp_get_wtime();
+        int refactored = sparse_refactor(N, shifted);
+        double refactor = omp_get_wtime() - start;
+        start = omp_get_wtime();
+        sparse_solve(N, b, x);
+        double solve = omp_get_wtime() - start;
+        if (refactored) error = fmax(error, residual(&A, shifted, x, b));
+        double bytes = S->factor_entries * 8.0 + S->nnz_A * 16.0;
+        printf("%-14s | %11.3f | %12ld | %7d | %6d | %10.2f | %11.3f | %13.3f | %10.4f | %6.1f Mo | %.2e%s\n",
+               ordering_names[ordering], analyze, S->nnz_L, S->num_supernodes, S->max_front, S->flops / 1e9, factor,
+               refactor, solve, bytes / 1e6, error, N->failed || !refactored ? " (pivot inutilisable)" : "");
+        ok &= !N->failed && refactored && error < 1e-8;
+        sparse_bytes = bytes;
+        sparse_time = refactor;
+        free_sparse_numeric(N);
+        free_sparse_symbolic(S);
+    }
+
+    // Chemin dense : n^2 coefficients et n^3 / 3 multiplications-additions
+    int dense_n = n < DENSE_MAX_N ? n : DENSE_MAX_N;
+    double dense_time = dense_lu_time(&A, dense_n);
+    if (dense_time >= 0) {
+        double scale = (double)n / dense_n;
+        dense_time *= scale * scale * scale;
+        printf("Dense (gaussian) : %.1f Mo, %.2f GFLOP, %.3f s%s ; creux (dernier ordre) : %.0fx moins de mémoire, "
+               "%.0fx plus rapide\n",
+               (double)n * n * 8 / 1e6, 2.0 / 3.0 * n * (double)n * n / 1e9, dense_time,
+               dense_n < n ? " (extrapolé)" : "", (double)n * n * 8 / sparse_bytes,
+               dense_time / sparse_time);
+    }
+
+    free(A.row_ptr);
+    free(A.col_idx);
+    free(A.values);
+    free(shifted);
+    free(b);
+    free(x);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,851 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "sparse_factor.h"
+
+#define ND_LEAF_SIZE 64         // sous-graphe plus petit : numéroté tel quel
+#define TASK_MIN_FLOPS 1e6      // sous-arbre plus petit : traité dans la tâche parente
+#define SCHUR_TASK_ROWS 128     // front plus grand : complément de Schur découpé en tâches
+
+#define NODE_VARIABLE 0
+#define NODE_ELEMENT 1
+#define NODE_ABSORBED 2
+
+// Graphe d'adjacence de A + A^T, sans la diagonale
+typedef struct {
+    int n;
+    int* ptr;
+    int* adj;
+} graph;
+
+typedef struct {
+    int* data;
+    int size, capacity;
+} int_list;
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static void list_push(int_list* l, int v) {
+    if (l->size == l->capacity) {
+        l->capacity = l->capacity ? 2 * l->capacity : 4;
+        l->data = (int*)realloc(l->data, l->capacity * sizeof(int));
+    }
+    l->data[l->size++] = v;
+}
+
+static void list_free(int_list* l) {
+    free(l->data);
+    l->data = NULL;
+    l->size = l->capacity = 0;
+}
+
+static void build_graph(const csr_matrix* A, graph* g) {
+    int n = A->n;
+    int* count = (int*)calloc(n + 1, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        for (int q = A->row_ptr[i]; q < A->row_ptr[i + 1]; q++) {
+            int j = A->col_idx[q];
+            if (j != i) {
+                count[i]++;
+                count[j]++;
+            }
+        }
+    }
+    int* ptr = (int*)malloc((n + 1) * sizeof(int));
+    ptr[0] = 0;
+    for (int i = 0; i < n; i++) ptr[i + 1] = ptr[i] + count[i];
+    int* adj = (int*)malloc((ptr[n] > 0 ? ptr[n] : 1) * sizeof(int));
+    for (int i = 0; i < n; i++) count[i] = ptr[i];
+    for (int i = 0; i < n; i++) {
+        for (int q = A->row_ptr[i]; q < A->row_ptr[i + 1]; q++) {
+            int j = A->col_idx[q];
+            if (j != i) {
+                adj[count[i]++] = j;
+                adj[count[j]++] = i;
+            }
+        }
+    }
+    // Tri et suppression des doublons (les coefficients symétriques apparaissent deux fois)
+    int out = 0;
+    for (int i = 0; i < n; i++) {
+        int begin = ptr[i], end = ptr[i + 1];
+        qsort(adj + begin, end - begin, sizeof(int), compare_ints);
+        ptr[i] = out;
+        for (int q = begin; q < end; q++) {
+            if (q == begin || adj[q] != adj[q - 1]) adj[out++] = adj[q];
+        }
+    }
+    ptr[n] = out;
+    free(count);
+    g->n = n;
+    g->ptr = ptr;
+    g->adj = adj;
+}
+
+// ---------- Degré minimal ----------
+
+// Graphe quotient : chaque pivot éliminé devient un élément (la clique de ses voisins), que
+// l'on garde sous forme de liste au lieu d'ajouter ses arêtes. Les éléments voisins du pivot
+// sont absorbés dans le nouvel élément ; les degrés des voisins sont recalculés exactement.
+static void bucket_insert(int* head, int* next, int* prev, int d, int v) {
+    next[v] = head[d];
+    prev[v] = -1;
+    if (head[d] >= 0) prev[head[d]] = v;
+    head[d] = v;
+}
+
+static void bucket_remove(int* head, int* next, int* prev, int d, int v) {
+    if (prev[v] >= 0) next[prev[v]] = next[v];
+    else head[d] = next[v];
+    if (next[v] >= 0) prev[next[v]] = prev[v];
+}
+
+static void minimum_degree(const graph* g, int* perm) {
+    int n = g->n;
+    int_list* vars = (int_list*)calloc(n, sizeof(int_list));
+    int_list* elems = (int_list*)calloc(n, sizeof(int_list));
+    int_list* members = (int_list*)calloc(n, sizeof(int_list));
+    int* status = (int*)calloc(n, sizeof(int));
+    int* degree = (int*)malloc(n * sizeof(int));
+    int* mark = (int*)calloc(n, sizeof(int));
+    int* head = (int*)malloc((n + 1) * sizeof(int));
+    int* next = (int*)malloc(n * sizeof(int));
+    int* prev = (int*)malloc(n * sizeof(int));
+    for (int d = 0; d <= n; d++) head[d] = -1;
+    for (int i = 0; i < n; i++) {
+        for (int q = g->ptr[i]; q < g->ptr[i + 1]; q++) list_push(&vars[i], g->adj[q]);
+        degree[i] = vars[i].size;
+        bucket_insert(head, next, prev, degree[i], i);
+    }
+
+    int stamp = 0, min_degree = 0;
+    for (int k = 0; k < n; k++) {
+        while (head[min_degree] < 0) min_degree++;
+        int p = head[min_degree];
+        bucket_remove(head, next, prev, degree[p], p);
+        status[p] = NODE_ELEMENT;
+        perm[k] = p;
+
+        // Nouvel élément : voisins de p et membres des éléments voisins de p
+        int_list* Lp = &members[p];
+        mark[p] = ++stamp;
+        for (int q = 0; q < vars[p].size; q++) {
+            int v = vars[p].data[q];
+            if (status[v] == NODE_VARIABLE && mark[v] != stamp) {
+                mark[v] = stamp;
+                list_push(Lp, v);
+            }
+        }
+        for (int q = 0; q < elems[p].size; q++) {
+            int e = elems[p].data[q];
+            if (status[e] != NODE_ELEMENT) continue;
+            for (int r = 0; r < members[e].size; r++) {
+                int v = members[e].data[r];
+                if (status[v] == NODE_VARIABLE && mark[v] != stamp) {
+                    mark[v] = stamp;
+                    list_push(Lp, v);
+                }
+            }
+            status[e] = NODE_ABSORBED;
+            list_free(&members[e]);
+        }
+        list_free(&vars[p]);
+        list_free(&elems[p]);
+
+        // Les voisins de p n'ont plus besoin de leurs arêtes vers Lp : l'élément p les représente
+        int lp_stamp = stamp;
+        for (int q = 0; q < Lp->size; q++) {
+            int i = Lp->data[q], kept = 0;
+            for (int r = 0; r < elems[i].size; r++) {
+                if (status[elems[i].data[r]] == NODE_ELEMENT) elems[i].data[kept++] = elems[i].data[r];
+            }
+            elems[i].size = kept;
+            list_push(&elems[i], p);
+            kept = 0;
+            for (int r = 0; r < vars[i].size; r++) {
+                int v = vars[i].data[r];
+                if (status[v] == NODE_VARIABLE && mark[v] != lp_stamp) vars[i].data[kept++] = v;
+            }
+            vars[i].size = kept;
+        }
+        for (int q = 0; q < Lp->size; q++) {
+            int i = Lp->data[q], d = 0;
+            mark[i] = ++stamp;
+            for (int r = 0; r < vars[i].size; r++) {
+                mark[vars[i].data[r]] = stamp;
+                d++;
+            }
+            for (int r = 0; r < elems[i].size; r++) {
+                int_list* m = &members[elems[i].data[r]];
+                int kept = 0;
+                for (int s = 0; s < m->size; s++) {
+                    int v = m->data[s];
+                    if (status[v] != NODE_VARIABLE) continue;
+                    m->data[kept++] = v;
+                    if (mark[v] != stamp) {
+                        mark[v] = stamp;
+                        d++;
+                    }
+                }
+                m->size = kept;
+            }
+            bucket_remove(head, next, prev, degree[i], i);
+            degree[i] = d;
+            bucket_insert(head, next, prev, d, i);
+            if (d < min_degree) min_degree = d;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        list_free(&vars[i]);
+        list_free(&elems[i]);
+        list_free(&members[i]);
+    }
+    free(vars);
+    free(elems);
+    free(members);
+    free(status);
+    free(degree);
+    free(mark);
+    free(head);
+    free(next);
+    free(prev);
+}
+
+// ---------- Dissection emboîtée ----------
+
+typedef struct {
+    const graph* g;
+    int* perm;
+    int* region;    // sous-graphe courant de chaque noeud, -1 pour un séparateur déjà numéroté
+    int* level;
+    int* queue;
+    int* scratch;
+    int next_region;
+} dissection;
+
+// Parcours en largeur restreint à une région ; renvoie le nombre de noeuds atteints et
+// *levels le nombre de niveaux
+static int bfs(dissection* d, int root, int* levels) {
+    int label = d->region[root], head = 0, tail = 0;
+    d->queue[tail++] = root;
+    d->level[root] = 0;
+    d->region[root] = -2;   // vu
+    while (head < tail) {
+        int v = d->queue[head++];
+        for (int q = d->g->ptr[v]; q < d->g->ptr[v + 1]; q++) {
+            int w = d->g->adj[q];
+            if (d->region[w] == label) {
+                d->region[w] = -2;
+                d->level[w] = d->level[v] + 1;
+                d->queue[tail++] = w;
+            }
+        }
+    }
+    for (int q = 0; q < tail; q++) d->region[d->queue[q]] = label;
+    *levels = d->level[d->queue[tail - 1]] + 1;
+    return tail;
+}
+
+// nodes : les count noeuds d'une même région, numérotés first .. first + count - 1 :
+// d'abord les deux moitiés (récursivement), puis le séparateur
+static void dissect(dissection* d, int* nodes, int count, int first) {
+    if (count <= ND_LEAF_SIZE) {
+        for (int q = 0; q < count; q++) {
+            d->perm[first + q] = nodes[q];
+            d->region[nodes[q]] = -1;
+        }
+        return;
+    }
+    int levels;
+    int label = d->region[nodes[0]];
+    int reached = bfs(d, nodes[0], &levels);
+    if (reached < count) {
+        // Région non connexe : chaque composante reçoit sa propre étiquette et est traitée à part
+        int done = 0;
+        while (done < count) {
+            int size = bfs(d, nodes[done], &levels), component = d->next_region++;
+            memcpy(d->scratch, d->queue, size * sizeof(int));
+            for (int q = 0; q < size; q++) d->region[d->scratch[q]] = component;
+            int kept = done;
+            for (int q = done; q < count; q++) {
+                if (d->region[nodes[q]] == label) nodes[kept++] = nodes[q];
+            }
+            memmove(nodes + done + size, nodes + done, (kept - done) * sizeof(int));
+            memcpy(nodes + done, d->scratch, size * sizeof(int));
+            done += size;
+        }
+        for (int start = 0; start < count;) {
+            int end = start;
+            while (end < count && d->region[nodes[end]] == d->region[nodes[start]]) end++;
+            dissect(d, nodes + start, end - start, first + start);
+            start = end;
+        }
+        return;
+    }
+
+    // Noeud pseudo-périphérique : on repart du dernier noeud atteint tant que la profondeur croît
+    for (int tries = 0; tries < 4; tries++) {
+        int deeper;
+        bfs(d, d->queue[count - 1], &deeper);
+        int grew = deeper > levels;
+        levels = deeper;
+        if (!grew) break;
+    }
+    if (levels < 3) {
+        for (int q = 0; q < count; q++) {
+            d->perm[first + q] = nodes[q];
+            d->region[nodes[q]] = -1;
+        }
+        return;
+    }
+    // Niveau médian, puis seuls ses noeuds voisins du niveau suivant forment le séparateur
+    int mid = d->level[d->queue[count / 2]];
+    if (mid < 1) mid = 1;
+    if (mid > levels - 2) mid = levels - 2;
+    int label_a = d->next_region++, label_b = d->next_region++;
+    int size_a = 0, size_b = 0, size_s = 0;
+    int* part_b = d->scratch;
+    int* separator = d->scratch + count;
+    int* part_a = nodes;
+    int* order = (int*)malloc(count * sizeof(int));
+    memcpy(order, d->queue, count * sizeof(int));
+    for (int q = 0; q < count; q++) {
+        int v = order[q];
+        if (d->level[v] < mid) {
+            part_a[size_a++] = v;
+        } else if (d->level[v] > mid) {
+            part_b[size_b++] = v;
+        } else {
+            int cut = 0;
+            for (int r = d->g->ptr[v]; r < d->g->ptr[v + 1] && !cut; r++) {
+                int w = d->g->adj[r];
+                cut = d->region[w] == label && d->level[w] == mid + 1;
+            }
+            if (cut) separator[size_s++] = v;
+            else part_a[size_a++] = v;
+        }
+    }
+    free(order);
+    for (int q = 0; q < size_a; q++) d->region[part_a[q]] = label_a;
+    for (int q = 0; q < size_b; q++) d->region[part_b[q]] = label_b;
+    for (int q = 0; q < size_s; q++) {
+        d->region[separator[q]] = -1;
+        d->perm[first + size_a + size_b + q] = separator[q];
+    }
+    memcpy(nodes + size_a, part_b, size_b * sizeof(int));
+    memcpy(nodes + size_a + size_b, separator, size_s * sizeof(int));
+    dissect(d, nodes, size_a, first);
+    dissect(d, nodes + size_a, size_b, first + size_a);
+}
+
+static void nested_dissection(const graph* g, int* perm) {
+    int n = g->n;
+    dissection d = {g, perm, (int*)calloc(n, sizeof(int)), (int*)malloc(n * sizeof(int)),
+                    (int*)malloc(n * sizeof(int)), (int*)malloc(2 * n * sizeof(int)), 1};
+    int* nodes = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) nodes[i] = i;
+    if (n > 0) dissect(&d, nodes, n, 0);
+    free(nodes);
+    free(d.region);
+    free(d.level);
+    free(d.queue);
+    free(d.scratch);
+}
+
+// ---------- Analyse symbolique ----------
+
+// Arbre d'élimination de la matrice permutée (algorithme de Liu, compression des chemins)
+static void elimination_tree(const graph* g, const int* perm, const int* iperm, int* parent) {
+    int n = g->n;
+    int* ancestor = (int*)malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) {
+        parent[k] = -1;
+        ancestor[k] = -1;
+        int v = perm[k];
+        for (int q = g->ptr[v]; q < g->ptr[v + 1]; q++) {
+            int r = iperm[g->adj[q]];
+            if (r >= k) continue;
+            while (ancestor[r] != -1 && ancestor[r] != k) {
+                int up = ancestor[r];
+                ancestor[r] = k;
+                r = up;
+            }
+            if (ancestor[r] == -1) {
+                ancestor[r] = k;
+                parent[r] = k;
+            }
+        }
+    }
+    free(ancestor);
+}
+
+// post[k] : k-ième noeud du parcours postfixe (les enfants avant le parent)
+static void postorder(const int* parent, int n, int* post) {
+    int* head = (int*)malloc(n * sizeof(int));
+    int* next = (int*)malloc(n * sizeof(int));
+    int* stack = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) head[i] = -1;
+    for (int i = n - 1; i >= 0; i--) {
+        if (parent[i] >= 0) {
+            next[i] = head[parent[i]];
+            head[parent[i]] = i;
+        }
+    }
+    int k = 0;
+    for (int root = 0; root < n; root++) {
+        if (parent[root] >= 0) continue;
+        int top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            int v = stack[top - 1];
+            if (head[v] >= 0) {
+                int c = head[v];
+                head[v] = next[c];
+                stack[top++] = c;
+            } else {
+                top--;
+                post[k++] = v;
+            }
+        }
+    }
+    free(head);
+    free(next);
+    free(stack);
+}
+
+static int find_row(const int* rows, int count, int r) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (rows[mid] < r) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Position de la ligne r (numérotation permutée) dans le front du supernoeud s
+static int front_index(const sparse_symbolic* S, int s, int r) {
+    int f = S->sn_start[s], nc = S->sn_start[s + 1] - f;
+    if (r < f + nc) return r - f;
+    return nc + find_row(S->sn_rows + S->sn_rows_ptr[s], S->sn_rows_ptr[s + 1] - S->sn_rows_ptr[s], r);
+}
+
+sparse_symbolic* sparse_analyze(const csr_matrix* A, int ordering, int kind) {
+    int n = A->n;
+    if (n <= 0) return NULL;
+    graph g;
+    build_graph(A, &g);
+    sparse_symbolic* S = (sparse_symbolic*)calloc(1, sizeof(sparse_symbolic));
+    S->n = n;
+    S->kind = kind;
+    S->nnz_A = A->row_ptr[n];
+
+    int* order = (int*)malloc(n * sizeof(int));
+    if (ordering == ORDER_MINIMUM_DEGREE) {
+        minimum_degree(&g, order);
+    } else if (ordering == ORDER_NESTED_DISSECTION) {
+        nested_dissection(&g, order);
+    } else {
+        for (int i = 0; i < n; i++) order[i] = i;
+    }
+    int* iperm = (int*)malloc(n * sizeof(int));
+    int* parent = (int*)malloc(n * sizeof(int));
+    int* post = (int*)malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) iperm[order[k]] = k;
+    elimination_tree(&g, order, iperm, parent);
+
+    // Renumérotation postfixe : mêmes remplissage et arbre, mais les colonnes d'un supernoeud
+    // deviennent consécutives
+    postorder(parent, n, post);
+    S->perm = (int*)malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) S->perm[k] = order[post[k]];
+    for (int k = 0; k < n; k++) iperm[S->perm[k]] = k;
+    elimination_tree(&g, S->perm, iperm, parent);
+
+    // Nombre de coefficients hors diagonale de chaque colonne de L : la ligne k de L est
+    // la réunion des chemins de l'arbre entre les voisins i < k et k
+    int* count = (int*)calloc(n, sizeof(int));
+    int* mark = (int*)malloc(n * sizeof(int));
+    int* children = (int*)calloc(n, sizeof(int));
+    for (int k = 0; k < n; k++) {
+        mark[k] = k;
+        int v = S->perm[k];
+        for (int q = g.ptr[v]; q < g.ptr[v + 1]; q++) {
+            int j = iperm[g.adj[q]];
+            while (j < k && mark[j] != k) {
+                count[j]++;
+                mark[j] = k;
+                j = parent[j];
+            }
+        }
+        if (parent[k] >= 0) children[parent[k]]++;
+    }
+
+    // Supernoeuds fondamentaux : j prolonge le supernoeud de j - 1 s'il en est le seul enfant
+    // et que leurs structures coïncident
+    int* sn_of = (int*)malloc(n * sizeof(int));
+    S->sn_start = (int*)malloc((n + 1) * sizeof(int));
+    int ns = 0;
+    for (int j = 0; j < n; j++) {
+        if (j == 0 || !(parent[j - 1] == j && count[j - 1] == count[j] + 1 && children[j] == 1)) {
+            S->sn_start[ns++] = j;
+        }
+        sn_of[j] = ns - 1;
+    }
+    S->sn_start[ns] = n;
+    S->num_supernodes = ns;
+    S->sn_parent = (int*)malloc(ns * sizeof(int));
+    S->sn_rows_ptr = (int*)malloc((ns + 1) * sizeof(int));
+    S->sn_factor_offset = (long*)malloc((ns + 1) * sizeof(long));
+    S->sn_subtree_flops = (double*)calloc(ns, sizeof(double));
+    S->sn_child_ptr = (int*)calloc(ns + 1, sizeof(int));
+    S->sn_children = (int*)malloc((ns > 0 ? ns : 1) * sizeof(int));
+    S->sn_first_descendant = (int*)malloc((ns > 0 ? ns : 1) * sizeof(int));
+    for (int s = 0; s < ns; s++) S->sn_first_descendant[s] = s;
+    S->sn_rows_ptr[0] = 0;
+    S->sn_factor_offset[0] = 0;
+    for (int s = 0; s < ns; s++) {
+        int f = S->sn_start[s], l = S->sn_start[s + 1] - 1;
+        int nc = l - f + 1, m = count[f] - (nc - 1), F = nc + m;
+        S->sn_parent[s] = parent[l] >= 0 ? sn_of[parent[l]] : -1;
+        if (S->sn_parent[s] >= 0) S->sn_child_ptr[S->sn_parent[s] + 1]++;
+        S->sn_rows_ptr[s + 1] = S->sn_rows_ptr[s] + m;
+        S->sn_factor_offset[s + 1] = S->sn_factor_offset[s] + (long)F * nc * (kind == FACTOR_LU ? 2 : 1);
+        if (F > S->max_front) S->max_front = F;
+        for (int j = f; j <= l; j++) {
+            double c = count[j];
+            double flops = kind == FACTOR_LU ? c + 2 * c * c : c + c * c;
+            S->flops += flops;
+            S->sn_subtree_flops[s] += flops;
+            S->nnz_L += count[j] + 1;
+        }
+        if (S->sn_parent[s] >= 0) {
+            int p = S->sn_parent[s];
+            S->sn_subtree_flops[p] += S->sn_subtree_flops[s];
+            if (S->sn_first_descendant[s] < S->sn_first_descendant[p]) S->sn_first_descendant[p] = S->sn_first_descendant[s];
+        }
+    }
+    S->factor_entries = S->sn_factor_offset[ns];
+    for (int s = 0; s < ns; s++) S->sn_child_ptr[s + 1] += S->sn_child_ptr[s];
+    int* fill = (int*)malloc((ns > 0 ? ns : 1) * sizeof(int));
+    memcpy(fill, S->sn_child_ptr, ns * sizeof(int));
+    for (int s = 0; s < ns; s++) {
+        if (S->sn_parent[s] >= 0) S->sn_children[fill[S->sn_parent[s]]++] = s;
+    }
+    free(fill);
+
+    // Lignes de chaque supernoeud : celles de A sous ses colonnes et celles de ses enfants
+    S->sn_rows = (int*)malloc((S->sn_rows_ptr[ns] > 0 ? S->sn_rows_ptr[ns] : 1) * sizeof(int));
+    for (int j = 0; j < n; j++) mark[j] = -1;
+    for (int s = 0; s < ns; s++) {
+        int f = S->sn_start[s], l = S->sn_start[s + 1] - 1;
+        int* rows = S->sn_rows + S->sn_rows_ptr[s];
+        int m = 0;
+        for (int j = f; j <= l; j++) {
+            int v = S->perm[j];
+            for (int q = g.ptr[v]; q < g.ptr[v + 1]; q++) {
+                int r = iperm[g.adj[q]];
+                if (r > l && mark[r] != s) {
+                    mark[r] = s;
+                    rows[m++] = r;
+                }
+            }
+        }
+        for (int c = S->sn_child_ptr[s]; c < S->sn_child_ptr[s + 1]; c++) {
+            int child = S->sn_children[c];
+            for (int q = S->sn_rows_ptr[child]; q < S->sn_rows_ptr[child + 1]; q++) {
+                int r = S->sn_rows[q];
+                if (r > l && mark[r] != s) {
+                    mark[r] = s;
+                    rows[m++] = r;
+                }
+            }
+        }
+        qsort(rows, m, sizeof(int), compare_ints);
+    }
+
+    // Destination de chaque coefficient de A dans le front (ligne-major) de son supernoeud
+    long nnz = A->row_ptr[n];
+    S->assemble_ptr = (long*)calloc(ns + 1, sizeof(long));
+    S->assemble_src = (long*)malloc((nnz > 0 ? nnz : 1) * sizeof(long));
+    S->assemble_dst = (long*)malloc((nnz > 0 ? nnz : 1) * sizeof(long));
+    for (int pass = 0; pass < 2; pass++) {
+        long* next_slot = pass == 1 ? (long*)malloc(ns * sizeof(long)) : NULL;
+        if (pass == 1) {
+            for (int s = 0; s < ns; s++) S->assemble_ptr[s + 1] += S->assemble_ptr[s];
+            memcpy(next_slot, S->assemble_ptr, ns * sizeof(long));
+        }
+        for (int i = 0; i < n; i++) {
+            for (int q = A->row_ptr[i]; q < A->row_ptr[i + 1]; q++) {
+                int pi = iperm[i], pj = iperm[A->col_idx[q]];
+                if (kind == FACTOR_CHOLESKY && pi < pj) continue;
+                int s = sn_of[pi < pj ? pi : pj];
+                if (pass == 0) {
+                    S->assemble_ptr[s + 1]++;
+                    continue;
+                }
+                int F = S->sn_start[s + 1] - S->sn_start[s] + S->sn_rows_ptr[s + 1] - S->sn_rows_ptr[s];
+                long slot = next_slot[s]++;
+                S->assemble_src[slot] = q;
+                S->assemble_dst[slot] = (long)front_index(S, s, pi) * F + front_index(S, s, pj);
+            }
+        }
+        free(next_slot);
+    }
+
+    free(order);
+    free(iperm);
+    free(parent);
+    free(post);
+    free(count);
+    free(mark);
+    free(children);
+    free(sn_of);
+    free(g.ptr);
+    free(g.adj);
+    return S;
+}
+
+void free_sparse_symbolic(sparse_symbolic* S) {
+    if (S == NULL) return;
+    free(S->perm);
+    free(S->sn_start);
+    free(S->sn_parent);
+    free(S->sn_rows_ptr);
+    free(S->sn_rows);
+    free(S->sn_factor_offset);
+    free(S->sn_subtree_flops);
+    free(S->sn_child_ptr);
+    free(S->sn_children);
+    free(S->sn_first_descendant);
+    free(S->assemble_ptr);
+    free(S->assemble_src);
+    free(S->assemble_dst);
+    free(S);
+}
+
+// ---------- Factorisation numérique multifrontale ----------
+
+// Élimine les nc premiers pivots du front a (F x F, ligne-major) : L11 U11, L21, U12, puis
+// complément de Schur a22 -= L21 U12
+static int partial_lu(double* a, int F, int nc) {
+    for (int k = 0; k < nc; k++) {
+        double pivot = a[(long)k * F + k];
+        if (pivot == 0) return 0;
+        for (int i = k + 1; i < F; i++) {
+            double* row = a + (long)i * F;
+            double l = row[k] /= pivot;
+            // Lignes de pivots : toute la ligne ; autres lignes : les colonnes de pivots
+            int end = i < nc ? F : nc;
+            const double* pivot_row = a + (long)k * F;
+            for (int j = k + 1; j < end; j++) row[j] -= l * pivot_row[j];
+        }
+    }
+    int m = F - nc;
+    #pragma omp taskloop grainsize(16) if(m > SCHUR_TASK_ROWS)
+    for (int i = nc; i < F; i++) {
+        double* row = a + (long)i * F;
+        for (int p = 0; p < nc; p++) {
+            double l = row[p];
+            const double* u = a + (long)p * F;
+            for (int j = nc; j < F; j++) row[j] -= l * u[j];
+        }
+    }
+    return 1;
+}
+
+// Cholesky : seul le triangle inférieur du front est tenu à jour
+static int partial_cholesky(double* a, int F, int nc) {
+    for (int k = 0; k < nc; k++) {
+        double d = a[(long)k * F + k];
+        if (d <= 0) return 0;
+        d = sqrt(d);
+        a[(long)k * F + k] = d;
+        for (int i = k + 1; i < F; i++) a[(long)i * F + k] /= d;
+        for (int i = k + 1; i < F; i++) {
+            double* row = a + (long)i * F;
+            double l = row[k];
+            int end = i < nc ? i : nc - 1;
+            for (int j = k + 1; j <= end; j++) row[j] -= l * a[(long)j * F + k];
+        }
+    }
+    int m = F - nc;
+    #pragma omp taskloop grainsize(16) if(m > SCHUR_TASK_ROWS)
+    for (int i = nc; i < F; i++) {
+        double* row = a + (long)i * F;
+        for (int j = nc; j <= i; j++) {
+            const double* other = a + (long)j * F;
+            double sum = 0;
+            for (int p = 0; p < nc; p++) sum += row[p] * other[p];
+            row[j] -= sum;
+        }
+    }
+    return 1;
+}
+
+// Assemble et factorise le front du supernoeud s, dont les enfants sont déjà traités :
+// pending[s] reçoit la matrice de mise à jour (m x m) destinée au parent, NULL si m = 0
+static void factor_front(sparse_numeric* N, const double* values, int s, double** pending) {
+    const sparse_symbolic* S = N->symbolic;
+    int first_child = S->sn_child_ptr[s], num_children = S->sn_child_ptr[s + 1] - first_child;
+    int f = S->sn_start[s], nc = S->sn_start[s + 1] - f;
+    int m = S->sn_rows_ptr[s + 1] - S->sn_rows_ptr[s], F = nc + m;
+    int symmetric = S->kind == FACTOR_CHOLESKY;
+    double* front = (double*)calloc((size_t)F * F, sizeof(double));
+    for (long q = S->assemble_ptr[s]; q < S->assemble_ptr[s + 1]; q++) {
+        front[S->assemble_dst[q]] += values[S->assemble_src[q]];
+    }
+    // Assemblage étendu des mises à jour des enfants
+    int* position = (int*)malloc((F > 0 ? F : 1) * sizeof(int));
+    for (int c = 0; c < num_children; c++) {
+        int child = S->sn_children[first_child + c];
+        int mc = S->sn_rows_ptr[child + 1] - S->sn_rows_ptr[child];
+        const int* rows = S->sn_rows + S->sn_rows_ptr[child];
+        for (int a = 0; a < mc; a++) position[a] = front_index(S, s, rows[a]);
+        for (int a = 0; a < mc; a++) {
+            double* dst = front + (long)position[a] * F;
+            const double* src = pending[child] + (long)a * mc;
+            int end = symmetric ? a + 1 : mc;
+            for (int b = 0; b < end; b++) dst[position[b]] += src[b];
+        }
+        free(pending[child]);
+        pending[child] = NULL;
+    }
+    free(position);
+
+    int ok = symmetric ? partial_cholesky(front, F, nc) : partial_lu(front, F, nc);
+    if (!ok) N->failed = 1;
+
+    double* L = N->factor + S->sn_factor_offset[s];
+    for (int r = 0; r < F; r++) {
+        for (int c = 0; c < nc; c++) L[(long)r * nc + c] = r >= c ? front[(long)r * F + c] : 0;
+    }
+    if (!symmetric) {
+        double* U = L + (long)F * nc;
+        for (int c = 0; c < nc; c++) {
+            for (int r = 0; r < F; r++) U[(long)c * F + r] = r >= c ? front[(long)c * F + r] : 0;
+        }
+    }
+    double* update = NULL;
+    if (m > 0) {
+        update = (double*)malloc((size_t)m * m * sizeof(double));
+        for (int a = 0; a < m; a++) memcpy(update + (long)a * m, front + (long)(nc + a) * F + nc, m * sizeof(double));
+    }
+    free(front);
+    pending[s] = update;
+}
+
+// Le sous-arbre de s occupe les supernoeuds [sn_first_descendant[s], s] (ordre postfixe) : il est
+// parcouru dans l'ordre, sans récursion le long des chaînes de l'arbre. Seuls les enfants dont
+// le sous-arbre est coûteux, quand il y en a plusieurs, deviennent des tâches.
+static void factor_subtree(sparse_numeric* N, const double* values, int s, double** pending, char* done) {
+    const sparse_symbolic* S = N->symbolic;
+    int heavy = 0;
+    for (int c = S->sn_child_ptr[s]; c < S->sn_child_ptr[s + 1]; c++) {
+        heavy += S->sn_subtree_flops[S->sn_children[c]] > TASK_MIN_FLOPS;
+    }
+    if (heavy >= 2) {
+        for (int c = S->sn_child_ptr[s]; c < S->sn_child_ptr[s + 1]; c++) {
+            int child = S->sn_children[c];
+            if (S->sn_subtree_flops[child] <= TASK_MIN_FLOPS) continue;
+            #pragma omp task
+            factor_subtree(N, values, child, pending, done);
+        }
+        #pragma omp taskwait
+    }
+    for (int t = S->sn_first_descendant[s]; t <= s; t++) {
+        if (done[t]) continue;     // dans le sous-arbre d'une tâche
+        factor_front(N, values, t, pending);
+        done[t] = 1;
+    }
+}
+
+int sparse_refactor(sparse_numeric* N, const double* values) {
+    const sparse_symbolic* S = N->symbolic;
+    int ns = S->num_supernodes;
+    double** pending = (double**)calloc(ns, sizeof(double*));
+    char* done = (char*)calloc(ns, 1);
+    if (pending == NULL || done == NULL) {
+        free(pending);
+        free(done);
+        N->failed = 1;
+        return 0;
+    }
+    N->failed = 0;
+    #pragma omp parallel
+    #pragma omp single
+    for (int s = 0; s < ns; s++) {
+        if (S->sn_parent[s] >= 0) continue;
+        #pragma omp task if(S->sn_subtree_flops[s] > TASK_MIN_FLOPS)
+        factor_subtree(N, values, s, pending, done);
+    }
+    free(pending);
+    free(done);
+    return !N->failed;
+}
+
+sparse_numeric* sparse_factor(const sparse_symbolic* S, const double* values) {
+    sparse_numeric* N = (sparse_numeric*)calloc(1, sizeof(sparse_numeric));
+    if (N == NULL) return NULL;
+    N->symbolic = S;
+    N->factor = (double*)malloc((S->factor_entries > 0 ? S->factor_entries : 1) * sizeof(double));
+    if (N->factor == NULL) {
+        free(N);
+        return NULL;
+    }
+    sparse_refactor(N, values);
+    return N;
+}
+
+void sparse_solve(const sparse_numeric* N, const double* b, double* x) {
+    const sparse_symbolic* S = N->symbolic;
+    int n = S->n, symmetric = S->kind == FACTOR_CHOLESKY;
+    double* y = (double*)malloc(n * sizeof(double));
+    for (int k = 0; k < n; k++) y[k] = b[S->perm[k]];
+    // L y = P b
+    for (int s = 0; s < S->num_supernodes; s++) {
+        int f = S->sn_start[s], nc = S->sn_start[s + 1] - f, m = S->sn_rows_ptr[s + 1] - S->sn_rows_ptr[s];
+        const int* rows = S->sn_rows + S->sn_rows_ptr[s];
+        const double* L = N->factor + S->sn_factor_offset[s];
+        for (int c = 0; c < nc; c++) {
+            if (symmetric) y[f + c] /= L[(long)c * nc + c];
+            double v = y[f + c];
+            for (int r = c + 1; r < nc; r++) y[f + r] -= L[(long)r * nc + c] * v;
+            for (int r = 0; r < m; r++) y[rows[r]] -= L[(long)(nc + r) * nc + c] * v;
+        }
+    }
+    // U x = y (U = L^T pour Cholesky)
+    for (int s = S->num_supernodes - 1; s >= 0; s--) {
+        int f = S->sn_start[s], nc = S->sn_start[s + 1] - f, m = S->sn_rows_ptr[s + 1] - S->sn_rows_ptr[s];
+        int F = nc + m;
+        const int* rows = S->sn_rows + S->sn_rows_ptr[s];
+        const double* L = N->factor + S->sn_factor_offset[s];
+        const double* U = L + (long)F * nc;
+        for (int c = nc - 1; c >= 0; c--) {
+            double sum = y[f + c];
+            if (symmetric) {
+                for (int r = c + 1; r < nc; r++) sum -= L[(long)r * nc + c] * y[f + r];
+                for (int r = 0; r < m; r++) sum -= L[(long)(nc + r) * nc + c] * y[rows[r]];
+                y[f + c] = sum / L[(long)c * nc + c];
+            } else {
+                for (int r = c + 1; r < nc; r++) sum -= U[(long)c * F + r] * y[f + r];
+                for (int r = 0; r < m; r++) sum -= U[(long)c * F + nc + r] * y[rows[r]];
+                y[f + c] = sum / U[(long)c * F + c];
+            }
+        }
+    }
+    for (int k = 0; k < n; k++) x[S->perm[k]] = y[k];
+    free(y);
+}
+
+void free_sparse_numeric(sparse_numeric* N) {
+    if (N == NULL) return;
+    free(N->factor);
+    free(N);
+}
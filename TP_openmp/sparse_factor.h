@@ -0,0 +1,69 @@
+#ifndef SPARSE_FACTOR_H
+#define SPARSE_FACTOR_H
+
+// Élimination de Gauss creuse : LU sans pivot (comme gaussian) ou Cholesky pour une matrice
+// symétrique définie positive. L'analyse symbolique (renumérotation qui limite le remplissage,
+// arbre d'élimination, supernoeuds, placement de chaque coefficient de A) ne dépend que de la
+// structure : elle est faite une fois, puis chaque factorisation numérique de mêmes structure
+// et valeurs différentes ne coûte que le calcul. La phase numérique est multifrontale : les
+// sous-arbres indépendants de l'arbre d'élimination sont des tâches OpenMP.
+
+#define ORDER_NATURAL 0
+#define ORDER_MINIMUM_DEGREE 1      // degré minimal sur le graphe quotient
+#define ORDER_NESTED_DISSECTION 2   // dissection emboîtée par séparateurs de niveaux
+
+#define FACTOR_LU 0
+#define FACTOR_CHOLESKY 1           // seul le triangle inférieur de A est lu
+
+// Matrice n x n au format CSR (lignes compressées)
+typedef struct {
+    int n;
+    const int* row_ptr;     // n + 1
+    const int* col_idx;
+    const double* values;
+} csr_matrix;
+
+typedef struct {
+    int n, kind;
+    long nnz_A;
+    long nnz_L;             // diagonale comprise ; U a la même structure que L^T
+    double flops;           // de la factorisation numérique
+    int num_supernodes;
+    int max_front;
+    long factor_entries;    // coefficients stockés (L, plus U pour LU)
+
+    int* perm;              // perm[k] : ligne de A éliminée en k-ième
+    int* sn_start;          // colonnes [sn_start[s], sn_start[s + 1]) du supernoeud s
+    int* sn_parent;
+    int* sn_rows_ptr;       // lignes sous le supernoeud (numérotation permutée, croissantes)
+    int* sn_rows;
+    long* sn_factor_offset; // position des blocs du supernoeud dans le facteur
+    double* sn_subtree_flops;
+    int* sn_child_ptr;      // enfants de chaque supernoeud
+    int* sn_children;
+    int* sn_first_descendant;   // sous-arbre de s : supernoeuds [sn_first_descendant[s], s]
+    long* assemble_ptr;     // coefficients de A assemblés dans le front de chaque supernoeud :
+    long* assemble_src;     //   indice dans values -> position dans le front
+    long* assemble_dst;
+} sparse_symbolic;
+
+typedef struct {
+    const sparse_symbolic* symbolic;
+    double* factor;         // par supernoeud : bloc L (front x colonnes), puis U (colonnes x front)
+    int failed;             // pivot nul (LU) ou matrice non définie positive (Cholesky)
+} sparse_numeric;
+
+// Renvoie NULL si A n'est pas carrée ou si la mémoire manque
+sparse_symbolic* sparse_analyze(const csr_matrix* A, int ordering, int kind);
+void free_sparse_symbolic(sparse_symbolic* symbolic);
+
+// values : coefficients dans l'ordre de A (même structure que lors de l'analyse).
+// Renvoie NULL si la mémoire manque ; numeric->failed signale un pivot inutilisable.
+sparse_numeric* sparse_factor(const sparse_symbolic* symbolic, const double* values);
+// Refactorisation dans le même espace, sans aucune allocation du facteur ; renvoie 0 en cas d'échec
+int sparse_refactor(sparse_numeric* numeric, const double* values);
+// x = A^-1 b (x et b peuvent être confondus)
+void sparse_solve(const sparse_numeric* numeric, const double* b, double* x);
+void free_sparse_numeric(sparse_numeric* numeric);
+
+#endif
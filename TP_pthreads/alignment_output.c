@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "alignment_output.h"
+#include "edit_distance.h"
+
+#define MAX_IOV 64   // tampons regroupés par appel à writev
+
+int ops_to_cigar(const char* ops, int n, char* cigar) {
+    char* out = cigar;
+    for (int k = 0; k < n;) {
+        int run = k;
+        while (run < n && ops[run] == ops[k]) run++;
+        char code;
+        switch (ops[k]) {
+            case OP_MATCH: code = '='; break;
+            case OP_MISMATCH: code = 'X'; break;
+            case OP_DELETE: code = 'D'; break;
+            default: code = 'I'; break;
+        }
+        // Chiffres écrits à l'envers puis retournés : pas de snprintf par opération
+        int length = run - k;
+        char digits[12];
+        int d = 0;
+        do {
+            digits[d++] = (char)('0' + length % 10);
+            length /= 10;
+        } while (length > 0);
+        while (d > 0) *out++ = digits[--d];
+        *out++ = code;
+        k = run;
+    }
+    *out = '\0';
+    return (int)(out - cigar);
+}
+
+void ops_to_gapped(const char* ops, int n, const char* X, const char* Y, char* gapped_X, char* gapped_Y) {
+    int i = 0, j = 0;
+    for (int k = 0; k < n; k++) {
+        switch (ops[k]) {
+            case OP_DELETE:
+                gapped_X[k] = X[i++];
+                gapped_Y[k] = '-';
+                break;
+            case OP_INSERT:
+                gapped_X[k] = '-';
+                gapped_Y[k] = Y[j++];
+                break;
+            default:
+                gapped_X[k] = X[i++];
+                gapped_Y[k] = Y[j++];
+                break;
+        }
+    }
+}
+
+typedef struct pending_chunk {
+    char* data;
+    size_t size;
+    struct pending_chunk* next;
+} pending_chunk;
+
+struct output_writer {
+    int fd;
+    int background;
+    int closing;
+    int failed;
+    size_t max_pending, pending_bytes;
+    pending_chunk *head, *tail;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty, not_full;
+    pthread_t thread;
+};
+
+static int write_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        // Écriture partielle : on avance dans les vecteurs
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 1;
+}
+
+static void* writer_thread(void* arg) {
+    output_writer* w = (output_writer*)arg;
+    pending_chunk* batch[MAX_IOV];
+    struct iovec iov[MAX_IOV];
+    while (1) {
+        pthread_mutex_lock(&w->lock);
+        while (w->head == NULL && !w->closing) pthread_cond_wait(&w->not_empty, &w->lock);
+        if (w->head == NULL) {
+            pthread_mutex_unlock(&w->lock);
+            break;
+        }
+        int count = 0;
+        size_t bytes = 0;
+        while (w->head != NULL && count < MAX_IOV) {
+            batch[count] = w->head;
+            iov[count].iov_base = w->head->data;
+            iov[count].iov_len = w->head->size;
+            bytes += w->head->size;
+            w->head = w->head->next;
+            count++;
+        }
+        if (w->head == NULL) w->tail = NULL;
+        pthread_mutex_unlock(&w->lock);
+
+        int ok = write_all(w->fd, iov, count);
+        for (int c = 0; c < count; c++) {
+            free(batch[c]->data);
+            free(batch[c]);
+        }
+        pthread_mutex_lock(&w->lock);
+        if (!ok) w->failed = 1;
+        w->pending_bytes -= bytes;
+        pthread_cond_broadcast(&w->not_full);
+        pthread_mutex_unlock(&w->lock);
+    }
+    return NULL;
+}
+
+output_writer* create_output_writer(int fd, int background, size_t max_pending) {
+    output_writer* w = (output_writer*)calloc(1, sizeof(output_writer));
+    if (w == NULL) return NULL;
+    w->fd = fd;
+    w->background = background;
+    w->max_pending = max_pending;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->not_empty, NULL);
+    pthread_cond_init(&w->not_full, NULL);
+    if (background && pthread_create(&w->thread, NULL, writer_thread, w) != 0) w->background = 0;
+    return w;
+}
+
+int close_output_writer(output_writer* w) {
+    if (w->background) {
+        pthread_mutex_lock(&w->lock);
+        w->closing = 1;
+        pthread_cond_signal(&w->not_empty);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread, NULL);
+    }
+    int ok = !w->failed;
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->not_empty);
+    pthread_cond_destroy(&w->not_full);
+    free(w);
+    return ok;
+}
+
+// Confie le contenu du tampon à l'écrivain
+static void submit(output_buffer* b) {
+    output_writer* w = b->writer;
+    if (b->size == 0) return;
+    if (!w->background) {
+        struct iovec iov = {b->data, b->size};
+        pthread_mutex_lock(&w->lock);
+        if (!write_all(w->fd, &iov, 1)) w->failed = 1;
+        pthread_mutex_unlock(&w->lock);
+        b->size = 0;
+        return;
+    }
+    pending_chunk* chunk = (pending_chunk*)malloc(sizeof(pending_chunk));
+    char* fresh = (char*)malloc(b->capacity);
+    if (chunk == NULL || fresh == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    chunk->data = b->data;
+    chunk->size = b->size;
+    chunk->next = NULL;
+    pthread_mutex_lock(&w->lock);
+    while (w->pending_bytes > 0 && w->pending_bytes + chunk->size > w->max_pending) {
+        pthread_cond_wait(&w->not_full, &w->lock);
+    }
+    if (w->tail != NULL) {
+        w->tail->next = chunk;
+    } else {
+        w->head = chunk;
+    }
+    w->tail = chunk;
+    w->pending_bytes += chunk->size;
+    pthread_cond_signal(&w->not_empty);
+    pthread_mutex_unlock(&w->lock);
+    b->data = fresh;
+    b->size = 0;
+}
+
+void init_output_buffer(output_buffer* b, output_writer* writer, size_t capacity) {
+    b->writer = writer;
+    b->capacity = capacity;
+    b->size = 0;
+    b->data = (char*)malloc(capacity);
+    if (b->data == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+}
+
+char* buffer_reserve(output_buffer* b, size_t n) {
+    if (b->size + n > b->capacity) submit(b);
+    if (n > b->capacity) {
+        // Enregistrement plus grand que le tampon : on l'agrandit
+        b->data = (char*)realloc(b->data, n);
+        if (b->data == NULL) {
+            fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+            exit(1);
+        }
+        b->capacity = n;
+    }
+    return b->data + b->size;
+}
+
+void buffer_commit(output_buffer* b, size_t n) {
+    b->size += n;
+}
+
+void buffer_append(output_buffer* b, const char* data, size_t n) {
+    memcpy(buffer_reserve(b, n), data, n);
+    b->size += n;
+}
+
+void buffer_flush(output_buffer* b) {
+    submit(b);
+}
+
+void release_output_buffer(output_buffer* b) {
+    submit(b);
+    free(b->data);
+    b->data = NULL;
+}
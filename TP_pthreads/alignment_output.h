@@ -0,0 +1,43 @@
+#ifndef ALIGNMENT_OUTPUT_H
+#define ALIGNMENT_OUTPUT_H
+
+#include <stddef.h>
+
+// Mise en forme et écriture des alignements. Les opérations (OP_MATCH, OP_MISMATCH,
+// OP_DELETE, OP_INSERT de edit_distance.h) sont converties en CIGAR étendu (=, X, D, I ;
+// X est la référence) ou en chaînes avec gaps, dans des tampons fournis par l'appelant.
+
+// Taille maximale du CIGAR de n opérations, '\0' compris : une série de L opérations
+// s'écrit en au plus L chiffres et une lettre, soit 2 caractères par opération au pire
+#define CIGAR_MAX_LENGTH(n) (2 * (size_t)(n) + 1)
+
+int ops_to_cigar(const char* ops, int n, char* cigar);
+// gapped_X et gapped_Y reçoivent n caractères chacun (sans '\0')
+void ops_to_gapped(const char* ops, int n, const char* X, const char* Y, char* gapped_X, char* gapped_Y);
+
+// Écrivain : chaque thread de calcul remplit son propre tampon, dont le contenu est confié
+// à l'écrivain quand il est plein. En mode background, un thread dédié vide la file par
+// writev et les threads de calcul ne font jamais d'appel système d'écriture ; ils n'attendent
+// que si plus de max_pending octets sont en attente.
+typedef struct output_writer output_writer;
+
+typedef struct {
+    output_writer* writer;
+    char* data;
+    size_t size, capacity;
+} output_buffer;
+
+output_writer* create_output_writer(int fd, int background, size_t max_pending);
+// Renvoie 0 si une écriture a échoué
+int close_output_writer(output_writer* writer);
+
+void init_output_buffer(output_buffer* buffer, output_writer* writer, size_t capacity);
+// Place pour n octets (le tampon est confié à l'écrivain s'il le faut) ; buffer_commit
+// valide ensuite ceux qui ont été écrits
+char* buffer_reserve(output_buffer* buffer, size_t n);
+void buffer_commit(output_buffer* buffer, size_t n);
+void buffer_append(output_buffer* buffer, const char* data, size_t n);
+void buffer_flush(output_buffer* buffer);
+void release_output_buffer(output_buffer* buffer);
+
+#endif
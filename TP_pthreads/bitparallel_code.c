@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "edit_distance.h"
+#include "perf_counters.h"
+
+// Coûts unitaires exprimés en scores : maximiser le score revient à minimiser la distance
+#define UNIT_MATCH_SCORE 0
+#define UNIT_MISMATCH_SCORE -1
+#define UNIT_GAP_PENALTY -1
+#define CHECK_MAX_LENGTH 2000
+#define MUTATION_RATE 0.1
+
+// calculate_similarity_matrix de sequentiel_code.c, coûts en paramètres
+void calculate_similarity_matrix(char* X, char* Y, int lenX, int lenY, int** S, int match_score,
+                                 int mismatch_score, int gap_penalty) {
+    for (int i = 0; i <= lenX; i++) {
+        S[i][0] = i * gap_penalty;
+    }
+    for (int j = 0; j <= lenY; j++) {
+        S[0][j] = j * gap_penalty;
+    }
+
+    for (int i = 1; i <= lenX; i++) {
+        for (int j = 1; j <= lenY; j++) {
+            int match = S[i - 1][j - 1] + ((X[i - 1] == Y[j - 1]) ? match_score : mismatch_score);
+            int del = S[i - 1][j] + gap_penalty;
+            int insert = S[i][j - 1] + gap_penalty;
+            S[i][j] = fmax(fmax(match, del), insert);
+        }
+    }
+}
+
+// Même récurrence sur deux lignes, pour mesurer le temps de référence sur les grandes tailles
+int unit_cost_distance_two_rows(const char* X, const char* Y, int lenX, int lenY) {
+    int* previous = (int*)malloc((lenY + 1) * sizeof(int));
+    int* current = (int*)malloc((lenY + 1) * sizeof(int));
+    for (int j = 0; j <= lenY; j++) previous[j] = j;
+    for (int i = 1; i <= lenX; i++) {
+        current[0] = i;
+        for (int j = 1; j <= lenY; j++) {
+            int best = previous[j - 1] + (X[i - 1] != Y[j - 1]);
+            if (previous[j] + 1 < best) best = previous[j] + 1;
+            if (current[j - 1] + 1 < best) best = current[j - 1] + 1;
+            current[j] = best;
+        }
+        int* t = previous;
+        previous = current;
+        current = t;
+    }
+    int distance = previous[lenY];
+    free(previous);
+    free(current);
+    return distance;
+}
+
+// Vérifie qu'une suite d'opérations couvre X et Y et coûte exactement distance
+int check_alignment(const char* X, int lenX, const char* Y, int lenY, const char* ops, int ops_len, int distance) {
+    int i = 0, j = 0, cost = 0;
+    for (int k = 0; k < ops_len; k++) {
+        switch (ops[k]) {
+            case OP_MATCH:
+                if (i >= lenX || j >= lenY || X[i] != Y[j]) return 0;
+                i++;
+                j++;
+                break;
+            case OP_MISMATCH:
+                if (i >= lenX || j >= lenY || X[i] == Y[j]) return 0;
+                i++;
+                j++;
+                cost++;
+                break;
+            case OP_DELETE:
+                if (i >= lenX) return 0;
+                i++;
+                cost++;
+                break;
+            case OP_INSERT:
+                if (j >= lenY) return 0;
+                j++;
+                cost++;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return i == lenX && j == lenY && cost == distance;
+}
+
+// Copie de X avec substitutions, insertions et suppressions au taux rate
+int mutate(const char* X, int lenX, double rate, char* out) {
+    const char* alphabet = "ACGT";
+    int n = 0;
+    for (int i = 0; i < lenX; i++) {
+        double r = (double)rand() / RAND_MAX;
+        if (r < rate / 3) {
+            out[n++] = alphabet[rand() % 4];
+        } else if (r < 2 * rate / 3) {
+            out[n++] = alphabet[rand() % 4];
+            out[n++] = X[i];
+        } else if (r >= rate) {
+            out[n++] = X[i];
+        }
+    }
+    return n;
+}
+
+void read_sequence_from_file(const char* filename, char** sequence, int* length) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'ouvrir le fichier %s\n", filename);
+        exit(1);
+    }
+    fseek(file, 0, SEEK_END);
+    *length = ftell(file);
+    printf("Taille du fichier %s : %d\n", filename, *length);
+    rewind(file);
+
+    *sequence = (char*)malloc((*length + 1) * sizeof(char));
+    if (*sequence == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+
+    if (fread(*sequence, sizeof(char), *length, file) != (size_t)*length) {
+        fprintf(stderr, "Erreur : Lecture incomplète de %s\n", filename);
+        exit(1);
+    }
+    (*sequence)[*length] = '\0';
+    fclose(file);
+}
+
+// Usage : ./bitparallel [nombre de threads max]
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : 4;
+    char *X, *Y;
+    int lenX, lenY;
+    read_sequence_from_file("X.txt", &X, &lenX);
+    read_sequence_from_file("Y.txt", &Y, &lenY);
+
+    // Vérification contre le calcul de matrice d'origine aux coûts unitaires, sur des
+    // préfixes aléatoires et sur des copies mutées (distance faible)
+    int** S = (int**)malloc((CHECK_MAX_LENGTH + 1) * sizeof(int*));
+    for (int i = 0; i <= CHECK_MAX_LENGTH; i++) S[i] = (int*)malloc((2 * CHECK_MAX_LENGTH + 1) * sizeof(int));
+    char* mutated = (char*)malloc(2 * CHECK_MAX_LENGTH + 1);
+    char* ops = (char*)malloc(lenX + lenY + 1);
+    int* row = (int*)malloc((2 * CHECK_MAX_LENGTH + 1) * sizeof(int));
+    int failures = 0, tests = 0;
+    srand(42);
+    for (int t = 0; t < 200; t++) {
+        int m = 1 + rand() % (t < 100 ? 200 : CHECK_MAX_LENGTH);
+        int offset = rand() % (lenX - m);
+        char* A = X + offset;
+        char* B;
+        int n;
+        if (t % 2 == 0) {
+            n = 1 + rand() % (t < 100 ? 200 : CHECK_MAX_LENGTH);
+            B = Y + rand() % (lenY - n);
+        } else {
+            n = mutate(A, m, MUTATION_RATE, mutated);
+            B = mutated;
+        }
+        calculate_similarity_matrix(A, B, m, n, S, UNIT_MATCH_SCORE, UNIT_MISMATCH_SCORE, UNIT_GAP_PENALTY);
+        int expected = -S[m][n];
+        int threads = 1 + t % max_threads;
+        int distance = edit_distance(A, m, B, n, threads);
+        edit_distance_row(A, m, B, n, row, threads);
+        int row_ok = 1;
+        for (int j = 0; j <= n; j++) row_ok &= row[j] == -S[m][j];
+        int ops_len;
+        int aligned = edit_distance_align(A, m, B, n, threads, ops, &ops_len);
+        int ok = distance == expected && aligned == expected && row_ok &&
+                 check_alignment(A, m, B, n, ops, ops_len, expected);
+        if (!ok) {
+            printf("Échec : m = %d, n = %d, attendu %d, obtenu %d\n", m, n, expected, distance);
+            failures++;
+        }
+        tests++;
+    }
+    printf("Vérification contre la matrice à coûts unitaires : %d/%d cas corrects\n", tests - failures, tests);
+
+    // Modèles de travail : 5 opérations et 8 octets par cellule pour la DP, comme les autres
+    // aligneurs ; 17 opérations par mot de 64 cellules pour Myers / Hyyrö, avec les vecteurs
+    // verticaux (16 octets) relus et réécrits à chaque colonne. Les versions multithreadées
+    // sont mesurées par le thread appelant : temps complet, compteurs de sa seule part.
+    double cells = (double)lenX * lenY;
+    double words = ceil(lenX / 64.0) * lenY;
+    perf_region* dp = perf_region_create("DP cellule par cellule", 1);
+    perf_region_begin(dp, 0);
+    int reference = unit_cost_distance_two_rows(X, Y, lenX, lenY);
+    perf_region_end(dp, 0);
+    perf_region_add_work(dp, 5.0 * cells, 8.0 * cells);
+    double reference_time = perf_region_seconds(dp);
+    printf("\n%-24s | %10s | %12s | %8s | %s\n", "méthode", "temps (s)", "Gcellules/s", "accél.", "distance");
+    printf("%-23s | %10.4f | %12.3f | %8s | %d\n", "DP cellule par cellule", reference_time,
+           cells / reference_time / 1e9, "1.00x", reference);
+
+    perf_region* bitparallel = NULL;  // dernière mesure, au plus grand nombre de threads
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        perf_region_free(bitparallel);
+        bitparallel = perf_region_create("bit-parallèle", 1);
+        perf_region_begin(bitparallel, 0);
+        int distance = edit_distance(X, lenX, Y, lenY, threads);
+        perf_region_end(bitparallel, 0);
+        perf_region_add_work(bitparallel, 17.0 * words, 32.0 * words);
+        double t = perf_region_seconds(bitparallel);
+        char label[32];
+        snprintf(label, sizeof(label), "bit-parallèle, %d thr", threads);
+        printf("%-24s | %10.4f | %12.3f | %7.2fx | %d\n", label, t, cells / t / 1e9, reference_time / t, distance);
+        failures += distance != reference;
+    }
+
+    // Hirschberg recalcule chaque moitié : environ deux fois le travail de la distance seule
+    int ops_len;
+    perf_region* hirschberg = perf_region_create("alignement Hirschberg", 1);
+    perf_region_begin(hirschberg, 0);
+    int distance = edit_distance_align(X, lenX, Y, lenY, max_threads, ops, &ops_len);
+    perf_region_end(hirschberg, 0);
+    perf_region_add_work(hirschberg, 2 * 17.0 * words, 2 * 32.0 * words);
+    int valid = check_alignment(X, lenX, Y, lenY, ops, ops_len, distance);
+    failures += !valid;
+    printf("\nAlignement (Hirschberg, %d threads) : %.4f s, %d colonnes, %s\n", max_threads,
+           perf_region_seconds(hirschberg), ops_len, valid ? "valide" : "INVALIDE");
+    perf_region_report(dp, stdout);
+    perf_region_report(bitparallel, stdout);
+    perf_region_report(hirschberg, stdout);
+    perf_region_free(dp);
+    perf_region_free(bitparallel);
+    perf_region_free(hirschberg);
+
+    for (int i = 0; i <= CHECK_MAX_LENGTH; i++) free(S[i]);
+    free(S);
+    free(mutated);
+    free(ops);
+    free(row);
+    free(X);
+    free(Y);
+    return failures == 0 ? 0 : 1;
+}
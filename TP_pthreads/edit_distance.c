@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "edit_distance.h"
+
+#define WORD_BITS 64
+#define HIGH_BIT ((uint64_t)1 << 63)
+#define CHUNK_COLUMNS 512       // colonnes publiées d'un coup d'une bande à la suivante
+#define MIN_WORDS_PER_BAND 4    // en dessous, les threads coûtent plus qu'ils ne rapportent
+#define MIN_THREAD_COLUMNS 8192
+#define BASE_CELLS 4096         // Hirschberg : sous-problèmes traités par DP complète
+
+// Masques de correspondance : peq[code][w] a le bit i à 1 si X[64w + i] a ce code.
+// Le code 0 regroupe les caractères absents de X (aucun bit).
+typedef struct {
+    int num_words;
+    int num_symbols;
+    unsigned char code[256];
+    uint64_t* peq;
+} pattern_bits;
+
+static void* checked_malloc(size_t size) {
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void build_pattern(pattern_bits* p, const char* X, int lenX) {
+    memset(p->code, 0, sizeof(p->code));
+    p->num_symbols = 1;
+    for (int i = 0; i < lenX; i++) {
+        unsigned char c = (unsigned char)X[i];
+        if (p->code[c] == 0) p->code[c] = (unsigned char)p->num_symbols++;
+    }
+    p->num_words = (lenX + WORD_BITS - 1) / WORD_BITS;
+    p->peq = (uint64_t*)calloc((size_t)p->num_symbols * p->num_words, sizeof(uint64_t));
+    if (p->peq == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    for (int i = 0; i < lenX; i++) {
+        p->peq[(size_t)p->code[(unsigned char)X[i]] * p->num_words + i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+    }
+}
+
+// Un mot de la colonne : Pv/Mv codent les différences verticales +1/-1, hin la différence
+// horizontale entrant par le bas du mot précédent ; renvoie celle qui sort au bit hbit
+static inline int advance_block(uint64_t* Pv, uint64_t* Mv, uint64_t Eq, int hin, uint64_t hbit) {
+    uint64_t pv = *Pv, mv = *Mv;
+    uint64_t Xv = Eq | mv;
+    if (hin < 0) Eq |= 1;
+    uint64_t Xh = (((Eq & pv) + pv) ^ pv) | Eq;
+    uint64_t Ph = mv | ~(Xh | pv);
+    uint64_t Mh = pv & Xh;
+    int hout = (Ph & hbit) ? 1 : ((Mh & hbit) ? -1 : 0);
+    Ph <<= 1;
+    Mh <<= 1;
+    if (hin < 0) {
+        Mh |= 1;
+    } else if (hin > 0) {
+        Ph |= 1;
+    }
+    *Pv = Mh | ~(Xv | Ph);
+    *Mv = Ph & Xv;
+    return hout;
+}
+
+// Bande de mots [first_word, last_word) traitée par un thread. La première ligne de la
+// matrice vaut j (hin = +1) ; chaque bande lit les retenues horizontales de la précédente
+// et publie les siennes par paquets de CHUNK_COLUMNS colonnes.
+typedef struct band {
+    const pattern_bits* pattern;
+    const char* Y;
+    int lenX, lenY;
+    int first_word, last_word;
+    const signed char* carry_in;    // NULL : première bande
+    signed char* carry_out;         // NULL : dernière bande
+    int* row;                       // dernière bande : scores de la ligne lenX
+    struct band* previous;
+    int progress;                   // colonnes publiées
+    pthread_mutex_t lock;
+    pthread_cond_t advanced;
+} band;
+
+static void* run_band(void* arg) {
+    band* b = (band*)arg;
+    const pattern_bits* p = b->pattern;
+    int count = b->last_word - b->first_word;
+    uint64_t* Pv = (uint64_t*)checked_malloc(count * sizeof(uint64_t));
+    uint64_t* Mv = (uint64_t*)checked_malloc(count * sizeof(uint64_t));
+    for (int w = 0; w < count; w++) {
+        Pv[w] = ~(uint64_t)0;
+        Mv[w] = 0;
+    }
+    int last_band = b->carry_out == NULL;
+    uint64_t last_bit = (uint64_t)1 << ((b->lenX - 1) % WORD_BITS);
+    int score = b->lenX;
+    if (last_band && b->row != NULL) b->row[0] = score;
+
+    for (int j0 = 0; j0 < b->lenY; j0 += CHUNK_COLUMNS) {
+        int j1 = j0 + CHUNK_COLUMNS < b->lenY ? j0 + CHUNK_COLUMNS : b->lenY;
+        if (b->previous != NULL) {
+            pthread_mutex_lock(&b->previous->lock);
+            while (b->previous->progress < j1) pthread_cond_wait(&b->previous->advanced, &b->previous->lock);
+            pthread_mutex_unlock(&b->previous->lock);
+        }
+        for (int j = j0; j < j1; j++) {
+            const uint64_t* eq = p->peq + (size_t)p->code[(unsigned char)b->Y[j]] * p->num_words + b->first_word;
+            int h = b->carry_in != NULL ? b->carry_in[j] : 1;
+            for (int w = 0; w < count - 1; w++) h = advance_block(&Pv[w], &Mv[w], eq[w], h, HIGH_BIT);
+            h = advance_block(&Pv[count - 1], &Mv[count - 1], eq[count - 1], h, last_band ? last_bit : HIGH_BIT);
+            if (last_band) {
+                score += h;
+                if (b->row != NULL) b->row[j + 1] = score;
+            } else {
+                b->carry_out[j] = (signed char)h;
+            }
+        }
+        pthread_mutex_lock(&b->lock);
+        b->progress = j1;
+        pthread_cond_broadcast(&b->advanced);
+        pthread_mutex_unlock(&b->lock);
+    }
+    if (last_band) b->progress = score; // distance finale, lue après pthread_join
+    free(Pv);
+    free(Mv);
+    return NULL;
+}
+
+// Renvoie distance(X, Y) ; remplit row si non NULL
+static int score_row(const char* X, int lenX, const char* Y, int lenY, int* row, int num_threads) {
+    if (lenX == 0) {
+        if (row != NULL) for (int j = 0; j <= lenY; j++) row[j] = j;
+        return lenY;
+    }
+    pattern_bits p;
+    build_pattern(&p, X, lenX);
+
+    int num_bands = num_threads;
+    if (num_bands > p.num_words / MIN_WORDS_PER_BAND) num_bands = p.num_words / MIN_WORDS_PER_BAND;
+    if (lenY < MIN_THREAD_COLUMNS || num_bands < 1) num_bands = 1;
+
+    band* bands = (band*)checked_malloc(num_bands * sizeof(band));
+    signed char* carries = NULL;
+    if (num_bands > 1) carries = (signed char*)checked_malloc((size_t)(num_bands - 1) * lenY);
+    for (int t = 0; t < num_bands; t++) {
+        band* b = &bands[t];
+        b->pattern = &p;
+        b->Y = Y;
+        b->lenX = lenX;
+        b->lenY = lenY;
+        b->first_word = (int)((long)p.num_words * t / num_bands);
+        b->last_word = (int)((long)p.num_words * (t + 1) / num_bands);
+        b->carry_in = t > 0 ? carries + (size_t)(t - 1) * lenY : NULL;
+        b->carry_out = t < num_bands - 1 ? carries + (size_t)t * lenY : NULL;
+        b->row = row;
+        b->previous = t > 0 ? &bands[t - 1] : NULL;
+        b->progress = 0;
+        pthread_mutex_init(&b->lock, NULL);
+        pthread_cond_init(&b->advanced, NULL);
+    }
+
+    if (num_bands == 1) {
+        run_band(&bands[0]);
+    } else {
+        pthread_t* threads = (pthread_t*)checked_malloc(num_bands * sizeof(pthread_t));
+        for (int t = 0; t < num_bands; t++) pthread_create(&threads[t], NULL, run_band, &bands[t]);
+        for (int t = 0; t < num_bands; t++) pthread_join(threads[t], NULL);
+        free(threads);
+    }
+    int distance = bands[num_bands - 1].progress;
+
+    for (int t = 0; t < num_bands; t++) {
+        pthread_mutex_destroy(&bands[t].lock);
+        pthread_cond_destroy(&bands[t].advanced);
+    }
+    free(bands);
+    free(carries);
+    free(p.peq);
+    return distance;
+}
+
+int edit_distance(const char* X, int lenX, const char* Y, int lenY, int num_threads) {
+    return score_row(X, lenX, Y, lenY, NULL, num_threads);
+}
+
+void edit_distance_row(const char* X, int lenX, const char* Y, int lenY, int* row, int num_threads) {
+    score_row(X, lenX, Y, lenY, row, num_threads);
+}
+
+typedef struct {
+    const char *X, *Y;
+    char *revX, *revY;
+    int lenX, lenY;
+    int num_threads;
+    int *forward, *backward;
+    int* matrix;        // cas de base, BASE_CELLS cellules
+    char* ops;
+    int count;
+} hirschberg_state;
+
+// Cas de base : matrice complète et remontée, en préférant la diagonale
+static void align_base(hirschberg_state* h, int x0, int x1, int y0, int y1) {
+    int m = x1 - x0, n = y1 - y0;
+    int* D = h->matrix;
+    const char* X = h->X + x0;
+    const char* Y = h->Y + y0;
+    for (int i = 0; i <= m; i++) D[i * (n + 1)] = i;
+    for (int j = 0; j <= n; j++) D[j] = j;
+    for (int i = 1; i <= m; i++) {
+        for (int j = 1; j <= n; j++) {
+            int best = D[(i - 1) * (n + 1) + j - 1] + (X[i - 1] != Y[j - 1]);
+            int del = D[(i - 1) * (n + 1) + j] + 1;
+            int ins = D[i * (n + 1) + j - 1] + 1;
+            if (del < best) best = del;
+            if (ins < best) best = ins;
+            D[i * (n + 1) + j] = best;
+        }
+    }
+    // Remontée à l'envers puis retournement en place
+    char* out = h->ops + h->count;
+    int k = 0, i = m, j = n;
+    while (i > 0 || j > 0) {
+        int d = D[i * (n + 1) + j];
+        if (i > 0 && j > 0 && d == D[(i - 1) * (n + 1) + j - 1] + (X[i - 1] != Y[j - 1])) {
+            out[k++] = X[i - 1] == Y[j - 1] ? OP_MATCH : OP_MISMATCH;
+            i--;
+            j--;
+        } else if (i > 0 && d == D[(i - 1) * (n + 1) + j] + 1) {
+            out[k++] = OP_DELETE;
+            i--;
+        } else {
+            out[k++] = OP_INSERT;
+            j--;
+        }
+    }
+    for (int a = 0, b = k - 1; a < b; a++, b--) {
+        char t = out[a];
+        out[a] = out[b];
+        out[b] = t;
+    }
+    h->count += k;
+}
+
+// X[x0..x1) contre Y[y0..y1) : la ligne du milieu de X est coupée là où la somme des
+// distances avant (préfixes) et arrière (suffixes retournés) est minimale
+static void hirschberg(hirschberg_state* h, int x0, int x1, int y0, int y1) {
+    int m = x1 - x0, n = y1 - y0;
+    if (m == 0) {
+        memset(h->ops + h->count, OP_INSERT, n);
+        h->count += n;
+        return;
+    }
+    if (n == 0) {
+        memset(h->ops + h->count, OP_DELETE, m);
+        h->count += m;
+        return;
+    }
+    if (m == 1) {
+        // Un seul caractère de X : aligné sur sa première occurrence dans Y, sinon substitué
+        int j = 0;
+        while (j < n - 1 && h->Y[y0 + j] != h->X[x0]) j++;
+        memset(h->ops + h->count, OP_INSERT, n);
+        h->ops[h->count + j] = h->Y[y0 + j] == h->X[x0] ? OP_MATCH : OP_MISMATCH;
+        h->count += n;
+        return;
+    }
+    if ((long)(m + 1) * (n + 1) <= BASE_CELLS) {
+        align_base(h, x0, x1, y0, y1);
+        return;
+    }
+
+    int mid = x0 + m / 2;
+    score_row(h->X + x0, mid - x0, h->Y + y0, n, h->forward, h->num_threads);
+    score_row(h->revX + (h->lenX - x1), x1 - mid, h->revY + (h->lenY - y1), n, h->backward, h->num_threads);
+    int split = 0, best = h->forward[0] + h->backward[n];
+    for (int j = 1; j <= n; j++) {
+        int total = h->forward[j] + h->backward[n - j];
+        if (total < best) {
+            best = total;
+            split = j;
+        }
+    }
+    hirschberg(h, x0, mid, y0, y0 + split);
+    hirschberg(h, mid, x1, y0 + split, y1);
+}
+
+int edit_distance_align(const char* X, int lenX, const char* Y, int lenY, int num_threads, char* ops,
+                        int* ops_len) {
+    int distance = edit_distance(X, lenX, Y, lenY, num_threads);
+    if (ops == NULL) return distance;
+
+    hirschberg_state h = {X, Y, NULL, NULL, lenX, lenY, num_threads, NULL, NULL, NULL, ops, 0};
+    h.revX = (char*)checked_malloc(lenX);
+    h.revY = (char*)checked_malloc(lenY);
+    for (int i = 0; i < lenX; i++) h.revX[i] = X[lenX - 1 - i];
+    for (int j = 0; j < lenY; j++) h.revY[j] = Y[lenY - 1 - j];
+    // Les lignes servent avant chaque récursion : un seul exemplaire suffit
+    h.forward = (int*)checked_malloc((size_t)(lenY + 1) * sizeof(int));
+    h.backward = (int*)checked_malloc((size_t)(lenY + 1) * sizeof(int));
+    h.matrix = (int*)checked_malloc(BASE_CELLS * sizeof(int));
+
+    hirschberg(&h, 0, lenX, 0, lenY);
+    *ops_len = h.count;
+
+    free(h.revX);
+    free(h.revY);
+    free(h.forward);
+    free(h.backward);
+    free(h.matrix);
+    return distance;
+}
@@ -0,0 +1,25 @@
+#ifndef EDIT_DISTANCE_H
+#define EDIT_DISTANCE_H
+
+// Distance d'édition à coûts unitaires (substitution, insertion, suppression = 1) par
+// l'algorithme bit-parallèle de Myers / Hyyrö : X est codé en mots de 64 bits, une colonne
+// de la matrice (64 cellules par mot) est mise à jour en quelques opérations logiques.
+// Avec num_threads > 1, les mots sont répartis en bandes de lignes traitées en pipeline.
+
+// Opérations de l'alignement, dans l'ordre de X et Y
+#define OP_MATCH 'M'      // X[i] == Y[j]
+#define OP_MISMATCH 'X'   // X[i] != Y[j]
+#define OP_DELETE 'D'     // X[i] face à un gap
+#define OP_INSERT 'I'     // gap face à Y[j]
+
+int edit_distance(const char* X, int lenX, const char* Y, int lenY, int num_threads);
+
+// Ligne finale de la matrice : row[j] = distance(X, Y[0..j)), pour j = 0..lenY
+void edit_distance_row(const char* X, int lenX, const char* Y, int lenY, int* row, int num_threads);
+
+// Distance et alignement optimal par recalcul de Hirschberg (mémoire linéaire) ;
+// ops reçoit *ops_len opérations (au plus lenX + lenY), sans '\0' final
+int edit_distance_align(const char* X, int lenX, const char* Y, int lenY, int num_threads, char* ops,
+                        int* ops_len);
+
+#endif
@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "perf_counters.h"
+
+// Version native de generate_sequences.py pour les grandes entrées (1e8 à 1e9 bases).
+// Chaque base est une fonction pure de (graine, flux, position) : un générateur à compteur
+// (hachage splitmix64) remplace l'état séquentiel de random, si bien que le résultat ne
+// dépend que de la graine, quel que soit le nombre de threads. Y est soit indépendante de
+// X, soit dérivée de X par substitutions, insertions et délétions à des taux donnés.
+
+#define FORMAT_ASCII 0          // bases seules, comme generate_sequences.py
+#define FORMAT_FASTA 1          // en-tête ">X" puis lignes de FASTA_LINE bases
+#define FORMAT_2BIT 2           // longueur (uint64) puis 4 bases par octet, A=0 C=1 G=2 T=3,
+                                //   la première dans les bits de poids faible
+#define FASTA_LINE 60
+#define TWO_BIT_HEADER 8
+
+#define STREAM_X 1
+#define STREAM_Y 2
+#define STREAM_MUTATION 3
+
+static const char alphabet[4] = {'A', 'C', 'G', 'T'};
+
+typedef struct {
+    int format;
+    long length;
+    size_t header;
+    size_t size;
+    uint8_t* map;
+    int fd;
+} sequence_file;
+
+typedef struct {
+    uint64_t seed;
+    long length_X, length_Y;
+    int related;                        // Y dérivée de X
+    uint32_t substitution, insertion, deletion;     // seuils sur 32 bits
+    sequence_file* X;
+    sequence_file* Y;
+} generator;
+
+typedef struct {
+    const generator* g;
+    long lo, hi;            // positions de X (ou de Y si elle est indépendante)
+    long y_first;           // Y dérivée : première base de Y produite par ce bloc
+    long y_count;
+    void* (*work)(void*);
+    perf_region* region;    // emplacement thread, mesuré autour de work
+    int thread;
+} block_task;
+
+// Écriture d'une suite de bases consécutives d'un fichier à partir de la position next
+typedef struct {
+    sequence_file* f;
+    long next;
+    uint8_t pending;        // 2 bits : octet en cours
+    int shared;             //   partagé avec le bloc précédent
+} base_writer;
+
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Tirage numéro counter du flux stream : aucun état partagé entre threads
+static inline uint64_t counter_random(uint64_t seed, int stream, uint64_t counter) {
+    uint64_t key = mix64(seed ^ ((uint64_t)stream << 56));
+    return mix64(key + counter * 0x9e3779b97f4a7c15ULL);
+}
+
+static int open_sequence_file(const char* filename, int format, long length, const char* name, sequence_file* f) {
+    f->format = format;
+    f->length = length;
+    if (format == FORMAT_FASTA) {
+        f->header = strlen(name) + 2;
+        f->size = f->header + length + (length + FASTA_LINE - 1) / FASTA_LINE;
+    } else if (format == FORMAT_2BIT) {
+        f->header = TWO_BIT_HEADER;
+        f->size = f->header + (length + 3) / 4;
+    } else {
+        f->header = 0;
+        f->size = length;
+    }
+    f->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (f->fd < 0) return 0;
+    if (f->size == 0) {
+        f->map = NULL;
+        return 1;
+    }
+    // Fichier rempli de zéros à sa taille finale, écrit directement par les threads
+    if (ftruncate(f->fd, f->size) != 0) return 0;
+    f->map = (uint8_t*)mmap(NULL, f->size, PROT_READ | PROT_WRITE, MAP_SHARED, f->fd, 0);
+    if (f->map == MAP_FAILED) return 0;
+    if (format == FORMAT_FASTA) {
+        f->map[0] = '>';
+        memcpy(f->map + 1, name, f->header - 2);
+        f->map[f->header - 1] = '\n';
+    } else if (format == FORMAT_2BIT) {
+        uint64_t n = length;
+        memcpy(f->map, &n, sizeof(n));
+    }
+    return 1;
+}
+
+// msync : le temps mesuré comprend l'écriture sur disque
+static int close_sequence_file(sequence_file* f) {
+    int ok = 1;
+    if (f->map != NULL) {
+        ok = msync(f->map, f->size, MS_SYNC) == 0;
+        munmap(f->map, f->size);
+    }
+    return close(f->fd) == 0 && ok;
+}
+
+static void begin_writer(base_writer* w, sequence_file* f, long first) {
+    w->f = f;
+    w->next = first;
+    w->pending = 0;
+    w->shared = (first & 3) != 0;
+}
+
+// Les octets à cheval sur deux blocs sont complétés par un OU atomique
+static void flush_pending(base_writer* w, long index) {
+    uint8_t* byte = w->f->map + w->f->header + index / 4;
+    if (w->shared) {
+        __atomic_fetch_or(byte, w->pending, __ATOMIC_RELAXED);
+    } else {
+        *byte = w->pending;
+    }
+    w->pending = 0;
+    w->shared = 0;
+}
+
+static inline void put_base(base_writer* w, int b) {
+    sequence_file* f = w->f;
+    long i = w->next++;
+    if (f->format == FORMAT_ASCII) {
+        f->map[i] = alphabet[b];
+    } else if (f->format == FORMAT_FASTA) {
+        uint8_t* p = f->map + f->header + i + i / FASTA_LINE;
+        p[0] = alphabet[b];
+        if (i % FASTA_LINE == FASTA_LINE - 1 || i == f->length - 1) p[1] = '\n';
+    } else {
+        w->pending |= (uint8_t)(b << (2 * (i & 3)));
+        if ((i & 3) == 3) flush_pending(w, i);
+    }
+}
+
+static void end_writer(base_writer* w) {
+    if (w->f->format == FORMAT_2BIT && (w->next & 3) != 0) {
+        w->shared = 1;  // le bloc suivant complète cet octet
+        flush_pending(w, w->next - 1);
+    }
+}
+
+// 32 bases par tirage
+static void write_random(sequence_file* f, uint64_t seed, int stream, long lo, long hi) {
+    base_writer w;
+    begin_writer(&w, f, lo);
+    uint64_t word = 0;
+    for (long i = lo; i < hi; i++) {
+        if (i == lo || (i & 31) == 0) word = counter_random(seed, stream, i >> 5) >> (2 * (i & 31));
+        put_base(&w, (int)(word & 3));
+        word >>= 2;
+    }
+    end_writer(&w);
+}
+
+// Évènement de la position i de X : 0 délétion, 1 substitution, 2 insertion devant, 3 copie.
+// *extra reçoit la base insérée ou substituée.
+static inline int mutation_at(const generator* g, long i, int base, int* extra) {
+    uint64_t r = counter_random(g->seed, STREAM_MUTATION, i);
+    uint32_t u = (uint32_t)(r >> 32);
+    if (u < g->deletion) return 0;
+    u -= g->deletion;
+    if (u < g->substitution) {
+        *extra = (base + 1 + (int)((r & 0xffff) % 3)) & 3;
+        return 1;
+    }
+    u -= g->substitution;
+    if (u < g->insertion) {
+        *extra = (int)(r & 3);
+        return 2;
+    }
+    return 3;
+}
+
+static void* count_derived(void* arg) {
+    block_task* t = (block_task*)arg;
+    const generator* g = t->g;
+    long count = 0;
+    for (long i = t->lo; i < t->hi; i++) {
+        int extra;
+        int event = mutation_at(g, i, 0, &extra);     // la base ne change que extra
+        count += event == 0 ? 0 : event == 2 ? 2 : 1;
+    }
+    t->y_count = count;
+    return NULL;
+}
+
+static void* write_block(void* arg) {
+    block_task* t = (block_task*)arg;
+    const generator* g = t->g;
+    write_random(g->X, g->seed, STREAM_X, t->lo, t->hi);
+    if (!g->related) return NULL;
+    base_writer w;
+    begin_writer(&w, g->Y, t->y_first);
+    uint64_t word = 0;
+    for (long i = t->lo; i < t->hi; i++) {
+        if (i == t->lo || (i & 31) == 0) word = counter_random(g->seed, STREAM_X, i >> 5) >> (2 * (i & 31));
+        int base = (int)(word & 3), extra = 0;
+        word >>= 2;
+        int event = mutation_at(g, i, base, &extra);
+        if (event == 1) {
+            put_base(&w, extra);
+        } else if (event >= 2) {
+            if (event == 2) put_base(&w, extra);
+            put_base(&w, base);
+        }
+    }
+    end_writer(&w);
+    return NULL;
+}
+
+static void* write_independent(void* arg) {
+    block_task* t = (block_task*)arg;
+    write_random(t->g->Y, t->g->seed, STREAM_Y, t->lo, t->hi);
+    return NULL;
+}
+
+static void* measured_block(void* arg) {
+    block_task* t = (block_task*)arg;
+    perf_region_begin(t->region, t->thread);
+    t->work(arg);
+    perf_region_end(t->region, t->thread);
+    return NULL;
+}
+
+static void run_blocks(block_task* tasks, int num_threads, void* (*work)(void*), perf_region* region) {
+    pthread_t threads[num_threads];
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t].work = work;
+        tasks[t].region = region;
+        tasks[t].thread = t;
+        pthread_create(&threads[t], NULL, measured_block, &tasks[t]);
+    }
+    for (int t = 0; t < num_threads; t++) pthread_join(threads[t], NULL);
+}
+
+static void split(block_task* tasks, int num_threads, const generator* g, long length) {
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t].g = g;
+        tasks[t].lo = length * t / num_threads;
+        tasks[t].hi = length * (t + 1) / num_threads;
+    }
+}
+
+static uint32_t rate_threshold(double rate) {
+    return rate <= 0 ? 0 : rate >= 1 ? UINT32_MAX : (uint32_t)(rate * 4294967296.0);
+}
+
+// Usage : ./generate_sequences [-n longueur de X] [-m longueur de Y] [-s graine] [-t threads]
+//                              [-f ascii|fasta|2bit] [-u substitutions] [-i insertions]
+//                              [-d délétions] [-x fichier X] [-y fichier Y]
+// Sans taux de mutation, X et Y sont indépendantes (comme generate_sequences.py) ; avec,
+// Y est dérivée de X et -m est ignoré.
+int main(int argc, char* argv[]) {
+    long length_X = 40000, length_Y = -1;
+    uint64_t seed = 1;
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int format = FORMAT_ASCII;
+    double substitution = 0, insertion = 0, deletion = 0;
+    const char* name_X = NULL;
+    const char* name_Y = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:m:s:t:f:u:i:d:x:y:")) != -1) {
+        switch (opt) {
+            case 'n': length_X = atol(optarg); break;
+            case 'm': length_Y = atol(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 't': num_threads = atoi(optarg); break;
+            case 'f':
+                format = strcmp(optarg, "fasta") == 0 ? FORMAT_FASTA : strcmp(optarg, "2bit") == 0 ? FORMAT_2BIT
+                         : strcmp(optarg, "ascii") == 0 ? FORMAT_ASCII : -1;
+                break;
+            case 'u': substitution = atof(optarg); break;
+            case 'i': insertion = atof(optarg); break;
+            case 'd': deletion = atof(optarg); break;
+            case 'x': name_X = optarg; break;
+            case 'y': name_Y = optarg; break;
+            default: format = -1;
+        }
+    }
+    if (format < 0 || length_X < 0 || num_threads < 1 || substitution + insertion + deletion > 1) {
+        fprintf(stderr, "Usage : %s [-n longueur] [-m longueur] [-s graine] [-t threads] [-f ascii|fasta|2bit]\n"
+                        "        [-u substitutions] [-i insertions] [-d délétions] [-x fichier X] [-y fichier Y]\n",
+                argv[0]);
+        return 1;
+    }
+    const char* extensions[] = {"txt", "fa", "2bit"};
+    char default_X[16], default_Y[16];
+    snprintf(default_X, sizeof(default_X), "X.%s", extensions[format]);
+    snprintf(default_Y, sizeof(default_Y), "Y.%s", extensions[format]);
+    if (name_X == NULL) name_X = default_X;
+    if (name_Y == NULL) name_Y = default_Y;
+
+    generator g = {seed, length_X, length_Y < 0 ? length_X : length_Y, substitution + insertion + deletion > 0,
+                   rate_threshold(substitution), rate_threshold(insertion), rate_threshold(deletion), NULL, NULL};
+    sequence_file X, Y;
+    g.X = &X;
+    g.Y = &Y;
+    block_task tasks[num_threads];
+    perf_region* region = perf_region_create("génération", num_threads);
+    double start = perf_now();
+
+    split(tasks, num_threads, &g, length_X);
+    if (g.related) {
+        // Longueur de Y et début de chaque bloc : les mutations sont comptées avant l'écriture
+        run_blocks(tasks, num_threads, count_derived, region);
+        g.length_Y = 0;
+        for (int t = 0; t < num_threads; t++) {
+            tasks[t].y_first = g.length_Y;
+            g.length_Y += tasks[t].y_count;
+        }
+    }
+    if (!open_sequence_file(name_X, format, length_X, "X", &X) ||
+        !open_sequence_file(name_Y, format, g.length_Y, "Y", &Y)) {
+        fprintf(stderr, "Erreur : Impossible de créer %s et %s\n", name_X, name_Y);
+        return 1;
+    }
+    run_blocks(tasks, num_threads, write_block, region);
+    if (!g.related) {
+        split(tasks, num_threads, &g, g.length_Y);
+        run_blocks(tasks, num_threads, write_independent, region);
+    }
+    int ok = close_sequence_file(&X);
+    ok &= close_sequence_file(&Y);
+    double t = perf_now() - start;
+    if (!ok) {
+        fprintf(stderr, "Erreur : Écriture de %s ou %s incomplète\n", name_X, name_Y);
+        return 1;
+    }
+
+    printf("%s : %ld bases, %s : %ld bases%s, graine %llu, %d threads\n", name_X, length_X, name_Y, g.length_Y,
+           g.related ? " (dérivée de X)" : "", (unsigned long long)seed, num_threads);
+    printf("Temps : %.3f s (%.1f Mo/s écrits)\n", t, (X.size + Y.size) / t / 1e6);
+    // Une opération entière par base produite ; les fichiers projetés sont écrits une fois
+    perf_region_add_work(region, (double)length_X + g.length_Y, (double)X.size + Y.size);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
+    printf("Les fichiers %s et %s ont été générés avec succès.\n", name_X, name_Y);
+    return 0;
+}
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "kmer_index.h"
+
+#define INDEX_MAGIC "KMIDX01"
+#define NUM_BUCKETS 256
+#define WRITE_CHUNK (64 << 20)  // écritures par gros morceaux
+#define SCAN_CHUNK (1 << 20)     // bases traitées par appel à compute_minimizers
+
+typedef struct {
+    char magic[8];
+    int32_t k, w;
+    int64_t num_targets;
+    int64_t num_entries;
+    int64_t sequences_bytes;
+    int64_t reserved[3];
+} index_header;
+
+static unsigned char nt4[256];
+static pthread_once_t nt4_once = PTHREAD_ONCE_INIT;
+
+static void init_nt4(void) {
+    memset(nt4, 4, sizeof(nt4));
+    nt4['A'] = nt4['a'] = 0;
+    nt4['C'] = nt4['c'] = 1;
+    nt4['G'] = nt4['g'] = 2;
+    nt4['T'] = nt4['t'] = 3;
+}
+
+// Hachage inversible sur 2k bits : les k-mers voisins ont des hachages sans rapport
+static inline uint64_t hash64(uint64_t key, uint64_t mask) {
+    key = (~key + (key << 21)) & mask;
+    key = key ^ key >> 24;
+    key = ((key + (key << 3)) + (key << 8)) & mask;
+    key = key ^ key >> 14;
+    key = ((key + (key << 2)) + (key << 4)) & mask;
+    key = key ^ key >> 28;
+    key = (key + (key << 31)) & mask;
+    return key;
+}
+
+static inline int bucket_of(uint64_t hash, int k) {
+    return (int)(hash >> (2 * k - 8));
+}
+
+int compute_minimizers(const char* seq, int len, int k, int w, minimizer* out) {
+    pthread_once(&nt4_once, init_nt4);
+    uint64_t mask = k == 32 ? ~(uint64_t)0 : (((uint64_t)1 << (2 * k)) - 1);
+    uint64_t window_hash[256];
+    int window_pos[256];
+    int count = 0, valid = 0, filled = 0, min_slot = -1, last_pos = -1;
+    uint64_t code = 0;
+    if (w > 256) w = 256;
+
+    for (int i = 0; i < len; i++) {
+        int c = nt4[(unsigned char)seq[i]];
+        if (c > 3) {
+            // Caractère inconnu : on recommence un k-mer et une fenêtre
+            valid = 0;
+            filled = 0;
+            min_slot = -1;
+            continue;
+        }
+        code = ((code << 2) | c) & mask;
+        if (++valid < k) continue;
+
+        int slot = filled % w;
+        window_hash[slot] = hash64(code, mask);
+        window_pos[slot] = i - k + 1;
+        filled++;
+        if (min_slot < 0 || window_hash[slot] < window_hash[min_slot]) {
+            min_slot = slot;
+        } else if (min_slot == slot) {
+            // Le minimum vient de sortir de la fenêtre : on la parcourt à nouveau
+            int n = filled < w ? filled : w;
+            min_slot = -1;
+            for (int s = 0; s < n; s++) {
+                int t = (filled - n + s) % w;
+                if (min_slot < 0 || window_hash[t] < window_hash[min_slot]) min_slot = t;
+            }
+        }
+        if (filled >= w && window_pos[min_slot] != last_pos) {
+            out[count].hash = window_hash[min_slot];
+            out[count].pos = window_pos[min_slot];
+            last_pos = window_pos[min_slot];
+            count++;
+        }
+    }
+    return count;
+}
+
+static int compare_entries(const void* a, const void* b) {
+    const kmer_entry* x = (const kmer_entry*)a;
+    const kmer_entry* y = (const kmer_entry*)b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    if (x->target != y->target) return x->target < y->target ? -1 : 1;
+    return (x->pos > y->pos) - (x->pos < y->pos);
+}
+
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+// Positionne les pointeurs de l'index sur un bloc au format du fichier
+static int attach_block(kmer_index* index, void* block, size_t size) {
+    const index_header* h = (const index_header*)block;
+    if (size < sizeof(index_header) || memcmp(h->magic, INDEX_MAGIC, 8) != 0) return 0;
+    char* p = (char*)block + sizeof(index_header);
+    index->k = h->k;
+    index->w = h->w;
+    index->num_targets = (int)h->num_targets;
+    index->num_entries = h->num_entries;
+    index->buckets = (const uint64_t*)p;
+    p += (NUM_BUCKETS + 1) * sizeof(uint64_t);
+    index->target_offsets = (const uint64_t*)p;
+    p += align8((h->num_targets + 1) * sizeof(uint64_t));
+    index->entries = (const kmer_entry*)p;
+    p += h->num_entries * sizeof(kmer_entry);
+    index->sequences = p;
+    p += align8(h->sequences_bytes);
+    index->block = block;
+    index->block_size = size;
+    return (size_t)(p - (char*)block) <= size;
+}
+
+typedef struct {
+    const char* const* targets;
+    const int* lengths;
+    int first_target, last_target;
+    int k, w;
+    kmer_entry* local;
+    long local_count;
+    long bucket_count[NUM_BUCKETS];
+    kmer_entry* destination;        // phase 2 : tableau final
+    long bucket_cursor[NUM_BUCKETS];
+    // phase 3 : paquets à trier, distribués dynamiquement
+    pthread_mutex_t* lock;
+    int* next_bucket;
+    const uint64_t* buckets;
+} build_task;
+
+static void* grow(void* p, long* capacity, long needed, size_t element) {
+    if (needed <= *capacity) return p;
+    long n = *capacity > 0 ? *capacity : 1024;
+    while (n < needed) n *= 2;
+    p = realloc(p, n * element);
+    if (p == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    *capacity = n;
+    return p;
+}
+
+// Les cibles sont lues par morceaux de SCAN_CHUNK bases qui se recouvrent de w + k - 2 bases :
+// la première fenêtre d'un morceau suit la dernière du précédent, et les positions des
+// minimiseurs ne décroissant pas, il suffit d'écarter celles déjà émises. Le tampon des
+// entrées part de la densité attendue, environ 2 / (w + 1) par base, et grandit au besoin.
+static void* collect_minimizers(void* arg) {
+    build_task* task = (build_task*)arg;
+    long bases = 0;
+    for (int t = task->first_target; t < task->last_target; t++) bases += task->lengths[t];
+    long capacity = 0;
+    task->local = (kmer_entry*)grow(NULL, &capacity, 2 * bases / (task->w + 1) + 1024, sizeof(kmer_entry));
+    minimizer* m = (minimizer*)malloc(SCAN_CHUNK * sizeof(minimizer));
+    if (m == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    int overlap = task->w + task->k - 2;
+    memset(task->bucket_count, 0, sizeof(task->bucket_count));
+    task->local_count = 0;
+    for (int t = task->first_target; t < task->last_target; t++) {
+        int last_pos = -1;
+        for (int start = 0; start < task->lengths[t]; start += SCAN_CHUNK - overlap) {
+            int len = task->lengths[t] - start < SCAN_CHUNK ? task->lengths[t] - start : SCAN_CHUNK;
+            int n = compute_minimizers(task->targets[t] + start, len, task->k, task->w, m);
+            task->local = (kmer_entry*)grow(task->local, &capacity, task->local_count + n, sizeof(kmer_entry));
+            for (int i = 0; i < n; i++) {
+                int pos = start + m[i].pos;
+                if (pos <= last_pos) continue;
+                last_pos = pos;
+                kmer_entry* e = &task->local[task->local_count++];
+                e->hash = m[i].hash;
+                e->target = (uint32_t)t;
+                e->pos = (uint32_t)pos;
+                task->bucket_count[bucket_of(e->hash, task->k)]++;
+            }
+            if (start + len >= task->lengths[t]) break;
+        }
+    }
+    free(m);
+    return NULL;
+}
+
+static void* scatter_entries(void* arg) {
+    build_task* task = (build_task*)arg;
+    for (long i = 0; i < task->local_count; i++) {
+        const kmer_entry* e = &task->local[i];
+        task->destination[task->bucket_cursor[bucket_of(e->hash, task->k)]++] = *e;
+    }
+    free(task->local);
+    task->local = NULL;
+    return NULL;
+}
+
+static void* sort_buckets(void* arg) {
+    build_task* task = (build_task*)arg;
+    while (1) {
+        pthread_mutex_lock(task->lock);
+        int b = (*task->next_bucket)++;
+        pthread_mutex_unlock(task->lock);
+        if (b >= NUM_BUCKETS) break;
+        uint64_t start = task->buckets[b], end = task->buckets[b + 1];
+        qsort(task->destination + start, end - start, sizeof(kmer_entry), compare_entries);
+    }
+    return NULL;
+}
+
+static void run_phase(build_task* tasks, int num_threads, void* (*phase)(void*)) {
+    pthread_t threads[num_threads];
+    for (int t = 0; t < num_threads; t++) pthread_create(&threads[t], NULL, phase, &tasks[t]);
+    for (int t = 0; t < num_threads; t++) pthread_join(threads[t], NULL);
+}
+
+kmer_index* build_kmer_index(const char* const* targets, const int* lengths, int num_targets, int k, int w,
+                             int num_threads) {
+    if (k < 4 || k > KMER_MAX_K || w < 1 || num_threads < 1) return NULL;
+    if (num_threads > num_targets) num_threads = num_targets > 0 ? num_targets : 1;
+
+    // Phase 1 : minimiseurs par thread, cibles réparties selon leur longueur cumulée
+    long total_length = 0;
+    for (int t = 0; t < num_targets; t++) total_length += lengths[t];
+    build_task* tasks = (build_task*)calloc(num_threads, sizeof(build_task));
+    long cumulative = 0;
+    int t = 0;
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].targets = targets;
+        tasks[i].lengths = lengths;
+        tasks[i].k = k;
+        tasks[i].w = w;
+        tasks[i].first_target = t;
+        while (t < num_targets && (i == num_threads - 1 || cumulative < total_length * (i + 1) / num_threads)) {
+            cumulative += lengths[t++];
+        }
+        tasks[i].last_target = t;
+    }
+    run_phase(tasks, num_threads, collect_minimizers);
+
+    // Un seul bloc au format du fichier
+    long num_entries = 0;
+    for (int i = 0; i < num_threads; i++) num_entries += tasks[i].local_count;
+    size_t size = sizeof(index_header) + (NUM_BUCKETS + 1) * sizeof(uint64_t) +
+                  align8((num_targets + 1) * sizeof(uint64_t)) + num_entries * sizeof(kmer_entry) +
+                  align8(total_length);
+    char* block = (char*)calloc(1, size);
+    kmer_index* index = (kmer_index*)calloc(1, sizeof(kmer_index));
+    if (block == NULL || index == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    index_header* h = (index_header*)block;
+    memcpy(h->magic, INDEX_MAGIC, 8);
+    h->k = k;
+    h->w = w;
+    h->num_targets = num_targets;
+    h->num_entries = num_entries;
+    h->sequences_bytes = total_length;
+    attach_block(index, block, size);
+
+    uint64_t* buckets = (uint64_t*)index->buckets;
+    uint64_t* offsets = (uint64_t*)index->target_offsets;
+    offsets[0] = 0;
+    for (int i = 0; i < num_targets; i++) {
+        offsets[i + 1] = offsets[i] + lengths[i];
+        memcpy((char*)index->sequences + offsets[i], targets[i], lengths[i]);
+    }
+
+    // Phase 2 : chaque thread range ses entrées à sa place dans chaque paquet
+    uint64_t position = 0;
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+        buckets[b] = position;
+        for (int i = 0; i < num_threads; i++) {
+            tasks[i].bucket_cursor[b] = position;
+            position += tasks[i].bucket_count[b];
+        }
+    }
+    buckets[NUM_BUCKETS] = position;
+    for (int i = 0; i < num_threads; i++) tasks[i].destination = (kmer_entry*)index->entries;
+    run_phase(tasks, num_threads, scatter_entries);
+
+    // Phase 3 : tri des paquets
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    int next_bucket = 0;
+    for (int i = 0; i < num_threads; i++) {
+        tasks[i].lock = &lock;
+        tasks[i].next_bucket = &next_bucket;
+        tasks[i].buckets = buckets;
+    }
+    run_phase(tasks, num_threads, sort_buckets);
+    free(tasks);
+    return index;
+}
+
+int save_kmer_index(const kmer_index* index, const char* filename) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    const char* p = (const char*)index->block;
+    size_t remaining = index->block_size;
+    while (remaining > 0) {
+        ssize_t n = write(fd, p, remaining < WRITE_CHUNK ? remaining : WRITE_CHUNK);
+        if (n <= 0) {
+            close(fd);
+            return 0;
+        }
+        p += n;
+        remaining -= n;
+    }
+    return close(fd) == 0;
+}
+
+kmer_index* load_kmer_index(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    void* block = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (block == MAP_FAILED) return NULL;
+    kmer_index* index = (kmer_index*)calloc(1, sizeof(kmer_index));
+    if (index == NULL || !attach_block(index, block, st.st_size)) {
+        munmap(block, st.st_size);
+        free(index);
+        return NULL;
+    }
+    index->mapped = 1;
+    return index;
+}
+
+void free_kmer_index(kmer_index* index) {
+    if (index == NULL) return;
+    if (index->mapped) {
+        munmap(index->block, index->block_size);
+    } else {
+        free(index->block);
+    }
+    free(index);
+}
+
+long lookup_kmer(const kmer_index* index, uint64_t hash, const kmer_entry** first) {
+    int b = bucket_of(hash, index->k);
+    long lo = (long)index->buckets[b], hi = (long)index->buckets[b + 1];
+    while (lo < hi) {
+        long mid = (lo + hi) / 2;
+        if (index->entries[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    long end = lo;
+    while (end < (long)index->buckets[b + 1] && index->entries[end].hash == hash) end++;
+    *first = index->entries + lo;
+    return end - lo;
+}
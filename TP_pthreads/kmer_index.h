@@ -0,0 +1,56 @@
+#ifndef KMER_INDEX_H
+#define KMER_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Index de minimiseurs (k, w) sur un ensemble de séquences cibles : pour chaque fenêtre de w
+// k-mers consécutifs on ne garde que le k-mer de plus petit hachage. Les entrées sont triées
+// par hachage ; le tout tient dans un seul bloc mémoire au format du fichier, si bien qu'un
+// index enregistré se recharge par mmap sans aucune copie.
+
+#define KMER_MAX_K 31
+
+typedef struct {
+    uint64_t hash;
+    uint32_t target;
+    uint32_t pos;
+} kmer_entry;
+
+typedef struct {
+    uint64_t hash;
+    int pos;
+} minimizer;
+
+typedef struct {
+    int k, w;
+    int num_targets;
+    long num_entries;
+    const uint64_t* buckets;         // 257 débuts de paquets selon les 8 bits forts du hachage
+    const uint64_t* target_offsets;  // num_targets + 1 positions dans sequences
+    const kmer_entry* entries;
+    const char* sequences;           // cibles concaténées
+    void* block;                     // bloc au format du fichier
+    size_t block_size;
+    int mapped;                      // bloc obtenu par mmap
+} kmer_index;
+
+// Minimiseurs de seq ; out doit pouvoir contenir len entrées. Les k-mers contenant autre
+// chose que A, C, G, T sont ignorés.
+int compute_minimizers(const char* seq, int len, int k, int w, minimizer* out);
+
+kmer_index* build_kmer_index(const char* const* targets, const int* lengths, int num_targets, int k, int w,
+                             int num_threads);
+int save_kmer_index(const kmer_index* index, const char* filename);
+kmer_index* load_kmer_index(const char* filename);
+void free_kmer_index(kmer_index* index);
+
+// Occurrences d'un hachage : renvoie leur nombre et la première dans *first
+long lookup_kmer(const kmer_index* index, uint64_t hash, const kmer_entry** first);
+
+static inline const char* index_target(const kmer_index* index, int t, int* length) {
+    *length = (int)(index->target_offsets[t + 1] - index->target_offsets[t]);
+    return index->sequences + index->target_offsets[t];
+}
+
+#endif
@@ -0,0 +1,428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "kmer_index.h"
+#include "seed_chain.h"
+#include "edit_distance.h"
+#include "alignment_output.h"
+#include "perf_counters.h"
+
+#define DEFAULT_K 15
+#define DEFAULT_W 10
+#define DEMO_TARGETS 100
+#define DEMO_TARGET_LENGTH 100000
+#define DEMO_READS 5000
+#define DEMO_READ_LENGTH 1000
+#define DEMO_MUTATION_RATE 0.05
+#define DEMO_RANDOM_READS 0.1       // part de lectures sans origine
+#define POSITION_TOLERANCE 64
+#define FULL_DP_SAMPLES 3
+#define OUTPUT_BUFFER_SIZE (1 << 20)    // par thread de calcul
+#define OUTPUT_MAX_PENDING (64 << 20)
+
+typedef struct {
+    const kmer_index* index;
+    const mapping_options* options;
+    char** reads;
+    const int* lengths;
+    int num_reads;
+    read_mapping* results;
+    int* next_read;
+    pthread_mutex_t* lock;
+    output_writer* writer;      // NULL : résultats gardés dans results seulement
+    int gapped;                 // ajoute les deux chaînes avec gaps à chaque ligne
+    int* inconsistent;          // remontées dont le score recalculé diffère
+    perf_region* region;        // un emplacement par thread de calcul
+    int thread;
+} mapping_task;
+
+static unsigned long long rng_state = 88172645463325252ULL;
+
+unsigned long long next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+void random_sequence(char* out, int length) {
+    const char* alphabet = "ACGT";
+    for (int i = 0; i < length; i++) out[i] = alphabet[next_random() & 3];
+}
+
+// Copie de X avec substitutions, insertions et suppressions au taux rate
+int mutate(const char* X, int lenX, double rate, char* out) {
+    const char* alphabet = "ACGT";
+    int n = 0;
+    for (int i = 0; i < lenX; i++) {
+        double r = (double)(next_random() >> 11) / (double)(1ULL << 53);
+        if (r < rate / 3) {
+            out[n++] = alphabet[next_random() & 3];
+        } else if (r < 2 * rate / 3) {
+            out[n++] = alphabet[next_random() & 3];
+            out[n++] = X[i];
+        } else if (r >= rate) {
+            out[n++] = X[i];
+        }
+    }
+    return n;
+}
+
+// Une séquence par ligne, ou FASTA (les lignes '>' commencent un nouvel enregistrement).
+// Les séquences pointent dans *content, à libérer avec les deux tableaux.
+int read_sequences_from_file(const char* filename, char** content_out, char*** sequences, int** lengths) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'ouvrir le fichier %s\n", filename);
+        exit(1);
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char* content = (char*)malloc(size + 1);
+    if (content == NULL || fread(content, 1, size, file) != (size_t)size) {
+        fprintf(stderr, "Erreur : Lecture impossible de %s\n", filename);
+        exit(1);
+    }
+    content[size] = '\0';
+    fclose(file);
+    *content_out = content;
+
+    int fasta = size > 0 && content[0] == '>';
+    int capacity = 1024, count = 0;
+    *sequences = (char**)malloc(capacity * sizeof(char*));
+    *lengths = (int*)malloc(capacity * sizeof(int));
+    char* write = content;
+    char* start = NULL;
+    for (char* p = content; p <= content + size; p++) {
+        int line_end = p == content + size || *p == '\n';
+        if (fasta && (p == content + size || *p == '>')) {
+            if (start != NULL && write > start) {
+                if (count == capacity) {
+                    capacity *= 2;
+                    *sequences = (char**)realloc(*sequences, capacity * sizeof(char*));
+                    *lengths = (int*)realloc(*lengths, capacity * sizeof(int));
+                }
+                (*sequences)[count] = start;
+                (*lengths)[count++] = (int)(write - start);
+            }
+            while (p < content + size && *p != '\n') p++;  // en-tête ignoré
+            start = write;
+            continue;
+        }
+        if (!fasta && line_end) {
+            if (start != NULL && write > start) {
+                if (count == capacity) {
+                    capacity *= 2;
+                    *sequences = (char**)realloc(*sequences, capacity * sizeof(char*));
+                    *lengths = (int*)realloc(*lengths, capacity * sizeof(int));
+                }
+                (*sequences)[count] = start;
+                (*lengths)[count++] = (int)(write - start);
+            }
+            start = NULL;
+            continue;
+        }
+        if (*p == '\r' || *p == '\n') continue;
+        if (start == NULL) start = write;
+        *write++ = *p;
+    }
+    return count;
+}
+
+// Recalcule le score d'une suite d'opérations : elle doit couvrir la lecture et redonner le score
+int check_mapping(const read_mapping* m, const kmer_index* index, const char* read, int len) {
+    int target_len;
+    const char* target = index_target(index, m->target, &target_len);
+    int i = m->target_start, j = 0, score = 0;
+    for (int k = 0; k < m->ops_len; k++) {
+        if (m->ops[k] == OP_MATCH || m->ops[k] == OP_MISMATCH) {
+            if ((target[i] == read[j]) != (m->ops[k] == OP_MATCH)) return 0;
+            score += m->ops[k] == OP_MATCH ? MATCH_SCORE : MISMATCH_SCORE;
+            i++;
+            j++;
+        } else if (m->ops[k] == OP_DELETE) {
+            score += GAP_PENALTY;
+            i++;
+        } else {
+            score += GAP_PENALTY;
+            j++;
+        }
+    }
+    return j == len && i == m->target_end && score == m->score;
+}
+
+// Une ligne : lecture, cible, début, fin, score, CIGAR [, cible et lecture avec gaps]
+void format_mapping(output_buffer* out, int r, const read_mapping* m, const kmer_index* index, const char* read,
+                    int gapped) {
+    size_t bound = 80 + (m->target >= 0 ? CIGAR_MAX_LENGTH(m->ops_len) + (gapped ? 2 * (size_t)m->ops_len + 2 : 0) : 2);
+    char* line = buffer_reserve(out, bound);
+    char* p = line + sprintf(line, "%d\t%d\t%d\t%d\t%d\t", r, m->target, m->target_start, m->target_end, m->score);
+    if (m->target < 0) {
+        *p++ = '*';
+    } else {
+        p += ops_to_cigar(m->ops, m->ops_len, p);
+        if (gapped) {
+            int target_len;
+            const char* target = index_target(index, m->target, &target_len);
+            *p++ = '\t';
+            ops_to_gapped(m->ops, m->ops_len, target + m->target_start, read, p, p + m->ops_len + 1);
+            p[m->ops_len] = '\t';
+            p += 2 * m->ops_len + 1;
+        }
+    }
+    *p++ = '\n';
+    buffer_commit(out, p - line);
+}
+
+void* map_reads(void* arg) {
+    mapping_task* task = (mapping_task*)arg;
+    mapping_workspace* workspace = create_mapping_workspace();
+    output_buffer out;
+    int inconsistent = 0;
+    if (task->writer != NULL) init_output_buffer(&out, task->writer, OUTPUT_BUFFER_SIZE);
+    perf_region_begin(task->region, task->thread);
+    while (1) {
+        pthread_mutex_lock(task->lock);
+        int r = (*task->next_read)++;
+        pthread_mutex_unlock(task->lock);
+        if (r >= task->num_reads) break;
+        read_mapping* m = &task->results[r];
+        map_read(task->index, task->reads[r], task->lengths[r], task->options, workspace, m);
+        // m->ops n'est valable que jusqu'à la lecture suivante : vérification et sortie immédiates
+        if (task->options->traceback && m->target >= 0)
+            inconsistent += !check_mapping(m, task->index, task->reads[r], task->lengths[r]);
+        if (task->writer != NULL) format_mapping(&out, r, m, task->index, task->reads[r], task->gapped);
+    }
+    perf_region_end(task->region, task->thread);
+    if (task->writer != NULL) release_output_buffer(&out);
+    pthread_mutex_lock(task->lock);
+    *task->inconsistent += inconsistent;
+    pthread_mutex_unlock(task->lock);
+    destroy_mapping_workspace(workspace);
+    return NULL;
+}
+
+// Renvoie le nombre de remontées incohérentes (0 sans traceback). region a num_threads
+// emplacements ; le travail déclaré suit le modèle des aligneurs : 5 opérations et 8 octets
+// par cellule DP calculée
+int map_all_reads(const kmer_index* index, const mapping_options* options, char** reads, const int* lengths,
+                   int num_reads, read_mapping* results, int num_threads, output_writer* writer, int gapped,
+                   perf_region* region) {
+    pthread_t threads[num_threads];
+    mapping_task tasks[num_threads];
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    int next_read = 0, inconsistent = 0;
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t] = (mapping_task){index,  options,    reads, lengths, num_reads,    results,
+                                  &next_read, &lock, writer, gapped,  &inconsistent, region, t};
+        pthread_create(&threads[t], NULL, map_reads, &tasks[t]);
+    }
+    for (int t = 0; t < num_threads; t++) pthread_join(threads[t], NULL);
+    double cells = 0;
+    for (int r = 0; r < num_reads; r++) cells += results[r].dp_cells;
+    perf_region_add_work(region, 5.0 * cells, 8.0 * cells);
+    return inconsistent;
+}
+
+
+int demo(int num_threads) {
+    printf("Génération de %d cibles de %d pb et %d lectures de %d pb...\n", DEMO_TARGETS, DEMO_TARGET_LENGTH,
+           DEMO_READS, DEMO_READ_LENGTH);
+    char** targets = (char**)malloc(DEMO_TARGETS * sizeof(char*));
+    int* target_lengths = (int*)malloc(DEMO_TARGETS * sizeof(int));
+    for (int t = 0; t < DEMO_TARGETS; t++) {
+        targets[t] = (char*)malloc(DEMO_TARGET_LENGTH);
+        target_lengths[t] = DEMO_TARGET_LENGTH;
+        random_sequence(targets[t], DEMO_TARGET_LENGTH);
+    }
+    char** reads = (char**)malloc(DEMO_READS * sizeof(char*));
+    int* read_lengths = (int*)malloc(DEMO_READS * sizeof(int));
+    int* origin_target = (int*)malloc(DEMO_READS * sizeof(int));
+    int* origin_pos = (int*)malloc(DEMO_READS * sizeof(int));
+    for (int r = 0; r < DEMO_READS; r++) {
+        reads[r] = (char*)malloc(2 * DEMO_READ_LENGTH);
+        if (r < DEMO_READS * DEMO_RANDOM_READS) {
+            origin_target[r] = -1;
+            random_sequence(reads[r], DEMO_READ_LENGTH);
+            read_lengths[r] = DEMO_READ_LENGTH;
+        } else {
+            origin_target[r] = (int)(next_random() % DEMO_TARGETS);
+            origin_pos[r] = (int)(next_random() % (DEMO_TARGET_LENGTH - DEMO_READ_LENGTH));
+            read_lengths[r] = mutate(targets[origin_target[r]] + origin_pos[r], DEMO_READ_LENGTH,
+                                     DEMO_MUTATION_RATE, reads[r]);
+        }
+    }
+
+    double start = perf_now();
+    kmer_index* built = build_kmer_index((const char* const*)targets, target_lengths, DEMO_TARGETS, DEFAULT_K,
+                                         DEFAULT_W, num_threads);
+    printf("Index (k = %d, w = %d) : %ld minimiseurs, construit en %.3f s avec %d threads\n", DEFAULT_K,
+           DEFAULT_W, built->num_entries, perf_now() - start, num_threads);
+    const char* filename = "index.kmi";
+    if (!save_kmer_index(built, filename)) {
+        fprintf(stderr, "Erreur : Impossible d'écrire %s\n", filename);
+        return 1;
+    }
+    free_kmer_index(built);
+    start = perf_now();
+    kmer_index* index = load_kmer_index(filename);
+    double load_time = perf_now() - start;
+    if (index == NULL) {
+        fprintf(stderr, "Erreur : Impossible de relire %s\n", filename);
+        return 1;
+    }
+    printf("Index relu par mmap en %.6f s (%.1f Mo)\n", load_time, index->block_size / 1e6);
+
+    mapping_options options;
+    default_mapping_options(&options);
+    read_mapping* results = (read_mapping*)malloc(DEMO_READS * sizeof(read_mapping));
+    perf_region* mapping = perf_region_create("placement", num_threads);
+    start = perf_now();
+    map_all_reads(index, &options, reads, read_lengths, DEMO_READS, results, num_threads, NULL, 0, mapping);
+    double mapping_time = perf_now() - start;
+
+    // Même placement avec remontée et écriture des CIGAR par le thread d'écriture
+    const char* output_name = "alignements.tsv";
+    FILE* output = fopen(output_name, "w");
+    output_writer* writer = create_output_writer(fileno(output), 1, OUTPUT_MAX_PENDING);
+    options.traceback = 1;
+    perf_region* traceback = perf_region_create("placement avec remontée", num_threads);
+    start = perf_now();
+    int inconsistent = map_all_reads(index, &options, reads, read_lengths, DEMO_READS, results, num_threads, writer, 0,
+                                     traceback);
+    int written = close_output_writer(writer);
+    double traceback_time = perf_now() - start;
+    long output_size = (long)lseek(fileno(output), 0, SEEK_END);
+    fclose(output);
+    int tracebacks_ok = written && inconsistent == 0;
+
+    int mapped = 0, correct = 0, false_positives = 0, full_windows = 0;
+    long cells = 0;
+    double all_pairs_cells = 0;
+    for (int r = 0; r < DEMO_READS; r++) {
+        cells += results[r].dp_cells;
+        all_pairs_cells += (double)read_lengths[r] * DEMO_TARGETS * DEMO_TARGET_LENGTH;
+        full_windows += results[r].full_window;
+        if (results[r].target < 0) continue;
+        mapped++;
+        if (origin_target[r] < 0) {
+            false_positives++;
+        } else if (results[r].target == origin_target[r] &&
+                   abs(results[r].target_start - origin_pos[r]) <= POSITION_TOLERANCE) {
+            correct++;
+        }
+    }
+    int with_origin = DEMO_READS - (int)(DEMO_READS * DEMO_RANDOM_READS);
+    printf("Placement : %.3f s, %d lectures placées, %d/%d à la bonne position, %d lectures aléatoires placées\n",
+           mapping_time, mapped, correct, with_origin, false_positives);
+    printf("Cellules DP : %ld (bande complète sur la fenêtre : %d lectures)\n", cells, full_windows);
+    printf("Avec remontée et CIGAR : %.3f s, %ld octets écrits dans %s, alignements %s\n", traceback_time,
+           output_size, output_name, tracebacks_ok ? "cohérents" : "INCOHÉRENTS");
+
+    // Référence : DP complète d'une lecture contre sa cible, extrapolée à toutes les paires
+    mapping_workspace* workspace = create_mapping_workspace();
+    long reference_cells = 0;
+    perf_region* full_dp = perf_region_create("DP complète", 1);
+    perf_region_begin(full_dp, 0);
+    for (int s = 0; s < FULL_DP_SAMPLES; s++) {
+        int r = DEMO_READS - 1 - s;
+        int end_pos;
+        banded_alignment_score(reads[r], read_lengths[r], targets[origin_target[r]], DEMO_TARGET_LENGTH,
+                               -read_lengths[r], DEMO_TARGET_LENGTH, &end_pos, &reference_cells, workspace);
+    }
+    perf_region_end(full_dp, 0);
+    perf_region_add_work(full_dp, 5.0 * reference_cells, 8.0 * reference_cells);
+    double rate = reference_cells / perf_region_seconds(full_dp);
+    destroy_mapping_workspace(workspace);
+    printf("DP complète toutes paires : %.2e cellules, soit %.0f s estimées à %.2e cellules/s (%.0fx moins de cellules)\n",
+           all_pairs_cells, all_pairs_cells / rate, rate, all_pairs_cells / cells);
+    perf_region_report(mapping, stdout);
+    perf_region_report(traceback, stdout);
+    perf_region_report(full_dp, stdout);
+    perf_region_free(mapping);
+    perf_region_free(traceback);
+    perf_region_free(full_dp);
+
+    free_kmer_index(index);
+    for (int t = 0; t < DEMO_TARGETS; t++) free(targets[t]);
+    for (int r = 0; r < DEMO_READS; r++) free(reads[r]);
+    free(targets);
+    free(target_lengths);
+    free(reads);
+    free(read_lengths);
+    free(origin_target);
+    free(origin_pos);
+    free(results);
+    return correct >= with_origin * 0.95 && false_positives == 0 && tracebacks_ok ? 0 : 1;
+}
+
+// Usage : ./mapping demo [threads]
+//         ./mapping index cibles.txt index.kmi [k] [w] [threads]
+//         ./mapping map index.kmi lectures.txt [threads] [gapped]
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "demo") == 0) {
+        return demo(argc > 2 ? atoi(argv[2]) : 4);
+    }
+    if (argc >= 4 && strcmp(argv[1], "index") == 0) {
+        char *content, **targets;
+        int* lengths;
+        int num_targets = read_sequences_from_file(argv[2], &content, &targets, &lengths);
+        int k = argc > 4 ? atoi(argv[4]) : DEFAULT_K;
+        int w = argc > 5 ? atoi(argv[5]) : DEFAULT_W;
+        int num_threads = argc > 6 ? atoi(argv[6]) : 4;
+        double start = perf_now();
+        kmer_index* index = build_kmer_index((const char* const*)targets, lengths, num_targets, k, w, num_threads);
+        if (index == NULL || !save_kmer_index(index, argv[3])) {
+            fprintf(stderr, "Erreur : Construction ou écriture de l'index impossible\n");
+            return 1;
+        }
+        printf("%d cibles, %ld minimiseurs, %s écrit en %.3f s\n", num_targets, index->num_entries, argv[3],
+               perf_now() - start);
+        free_kmer_index(index);
+        free(content);
+        free(targets);
+        free(lengths);
+        return 0;
+    }
+    if (argc >= 4 && strcmp(argv[1], "map") == 0) {
+        kmer_index* index = load_kmer_index(argv[2]);
+        if (index == NULL) {
+            fprintf(stderr, "Erreur : Impossible de charger l'index %s\n", argv[2]);
+            return 1;
+        }
+        char *content, **reads;
+        int* lengths;
+        int num_reads = read_sequences_from_file(argv[3], &content, &reads, &lengths);
+        int num_threads = argc > 4 ? atoi(argv[4]) : 4;
+        int gapped = argc > 5 && strcmp(argv[5], "gapped") == 0;
+        mapping_options options;
+        default_mapping_options(&options);
+        options.traceback = 1;
+        read_mapping* results = (read_mapping*)malloc(num_reads * sizeof(read_mapping));
+        fflush(stdout);
+        output_writer* writer = create_output_writer(STDOUT_FILENO, 1, OUTPUT_MAX_PENDING);
+        perf_region* region = perf_region_create("placement", num_threads);
+        if (map_all_reads(index, &options, reads, lengths, num_reads, results, num_threads, writer, gapped, region) > 0)
+            fprintf(stderr, "Attention : Alignements incohérents\n");
+        if (!close_output_writer(writer)) {
+            fprintf(stderr, "Erreur : Écriture des résultats impossible\n");
+            return 1;
+        }
+        // Les alignements occupent la sortie standard : rapport sur la sortie d'erreur
+        perf_region_report(region, stderr);
+        perf_region_free(region);
+        free(results);
+        free_kmer_index(index);
+        free(content);
+        free(reads);
+        free(lengths);
+        return 0;
+    }
+    fprintf(stderr, "Usage : %s demo [threads]\n"
+                    "        %s index cibles.txt index.kmi [k] [w] [threads]\n"
+                    "        %s map index.kmi lectures.txt [threads] [gapped]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
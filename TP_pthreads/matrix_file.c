@@ -0,0 +1,415 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "matrix_file.h"
+
+#define MATRIX_VERSION 1
+#define PAGE_ALIGNMENT 4096
+#define DEFAULT_TILE 256
+#define DEFAULT_THREADS 4
+#define WRITE_CHUNK (1L << 26)
+
+typedef struct {
+    int type;
+    size_t element_size;
+    const uint8_t* const* rows;
+    long num_rows, num_cols;
+    long tile_rows, tile_cols;
+    long tiles_per_row;
+} matrix_layout;
+
+typedef struct {
+    const matrix_layout* layout;
+    uint8_t* data;              // tuiles brutes : fichier projeté ; compressées : tampon de la bande
+    matrix_tile* tiles;         // décalages dans data ; les tailles sont remplies par les threads
+    long first_tile, last_tile;
+    long* next_tile;
+    pthread_mutex_t* lock;
+    int compression;
+} tile_task;
+
+size_t matrix_element_size(int type) {
+    return type == MATRIX_FLOAT64 ? 8 : 4;
+}
+
+static size_t align_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static void tile_extent(long rows, long cols, long tile_rows, long tile_cols, long a, long b, long* h, long* w) {
+    *h = rows - a * tile_rows < tile_rows ? rows - a * tile_rows : tile_rows;
+    *w = cols - b * tile_cols < tile_cols ? cols - b * tile_cols : tile_cols;
+}
+
+// Pire cas : un varint de 5 octets par entier de 32 bits, de 10 par flottant de 64 bits
+static size_t max_encoded_size(size_t elements, size_t element_size) {
+    return elements * (element_size == 8 ? 10 : 5);
+}
+
+static uint64_t load_bits(const uint8_t* p, size_t element_size) {
+    if (element_size == 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static void store_bits(uint8_t* p, uint64_t v, size_t element_size) {
+    if (element_size == 8) {
+        memcpy(p, &v, 8);
+    } else {
+        uint32_t w = (uint32_t)v;
+        memcpy(p, &w, 4);
+    }
+}
+
+// Entiers : écart au prédicteur en zigzag (petits écarts, petits codes) ; flottants : ou-exclusif
+static uint64_t residual(int type, uint64_t value, uint64_t predicted) {
+    if (type != MATRIX_INT32) return value ^ predicted;
+    int32_t d = (int32_t)((uint32_t)value - (uint32_t)predicted);
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+static uint64_t apply_residual(int type, uint64_t r, uint64_t predicted) {
+    if (type != MATRIX_INT32) return r ^ predicted;
+    uint32_t d = ((uint32_t)r >> 1) ^ (0u - ((uint32_t)r & 1));
+    return (uint32_t)predicted + d;
+}
+
+// Prédicteur : voisin de gauche, ou voisin du dessus en première colonne de la tuile
+static size_t encode_tile(const matrix_layout* l, long a, long b, uint8_t* out) {
+    long h, w;
+    tile_extent(l->num_rows, l->num_cols, l->tile_rows, l->tile_cols, a, b, &h, &w);
+    size_t es = l->element_size;
+    uint8_t* p = out;
+    uint64_t above = 0;
+    for (long y = 0; y < h; y++) {
+        const uint8_t* row = l->rows[a * l->tile_rows + y] + b * l->tile_cols * es;
+        uint64_t predicted = above;
+        for (long x = 0; x < w; x++) {
+            uint64_t v = load_bits(row + x * es, es);
+            uint64_t r = residual(l->type, v, predicted);
+            while (r >= 0x80) {
+                *p++ = (uint8_t)(r | 0x80);
+                r >>= 7;
+            }
+            *p++ = (uint8_t)r;
+            if (x == 0) above = v;
+            predicted = v;
+        }
+    }
+    return p - out;
+}
+
+static int decode_tile(const matrix_header* hd, long a, long b, const uint8_t* in, size_t size, uint8_t* out) {
+    long h, w;
+    tile_extent(hd->rows, hd->cols, hd->tile_rows, hd->tile_cols, a, b, &h, &w);
+    size_t es = matrix_element_size(hd->type);
+    const uint8_t* end = in + size;
+    uint64_t above = 0;
+    for (long y = 0; y < h; y++) {
+        uint64_t predicted = above;
+        for (long x = 0; x < w; x++) {
+            uint64_t r = 0;
+            int shift = 0;
+            do {
+                if (in == end || shift > 63) return 0;
+                r |= (uint64_t)(*in & 0x7f) << shift;
+                shift += 7;
+            } while (*in++ & 0x80);
+            uint64_t v = apply_residual(hd->type, r, predicted);
+            store_bits(out + (y * w + x) * es, v, es);
+            if (x == 0) above = v;
+            predicted = v;
+        }
+    }
+    return in == end;
+}
+
+static void copy_tile(const matrix_layout* l, long a, long b, uint8_t* out) {
+    long h, w;
+    tile_extent(l->num_rows, l->num_cols, l->tile_rows, l->tile_cols, a, b, &h, &w);
+    size_t es = l->element_size;
+    for (long y = 0; y < h; y++) {
+        memcpy(out + y * w * es, l->rows[a * l->tile_rows + y] + b * l->tile_cols * es, w * es);
+    }
+}
+
+static void* tile_worker(void* arg) {
+    tile_task* task = (tile_task*)arg;
+    const matrix_layout* l = task->layout;
+    while (1) {
+        pthread_mutex_lock(task->lock);
+        long t = (*task->next_tile)++;
+        pthread_mutex_unlock(task->lock);
+        if (t >= task->last_tile) break;
+        long a = t / l->tiles_per_row, b = t % l->tiles_per_row;
+        matrix_tile* tile = &task->tiles[t - task->first_tile];
+        if (task->compression == MATRIX_DELTA) {
+            tile->size = encode_tile(l, a, b, task->data + tile->offset);
+        } else {
+            copy_tile(l, a, b, task->data + tile->offset);
+        }
+    }
+    return NULL;
+}
+
+static void run_tiles(tile_task* model, int num_threads) {
+    pthread_t threads[num_threads];
+    tile_task tasks[num_threads];
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    long next_tile = model->first_tile;
+    for (int t = 0; t < num_threads; t++) {
+        tasks[t] = *model;
+        tasks[t].next_tile = &next_tile;
+        tasks[t].lock = &lock;
+        pthread_create(&threads[t], NULL, tile_worker, &tasks[t]);
+    }
+    for (int t = 0; t < num_threads; t++) pthread_join(threads[t], NULL);
+}
+
+static int write_all(int fd, const uint8_t* p, size_t n, off_t offset) {
+    while (n > 0) {
+        ssize_t k = pwrite(fd, p, n < WRITE_CHUNK ? n : WRITE_CHUNK, offset);
+        if (k <= 0) return 0;
+        p += k;
+        n -= k;
+        offset += k;
+    }
+    return 1;
+}
+
+// Tuiles brutes : le fichier a sa taille finale dès le départ, chaque thread copie ses tuiles
+// directement dans la projection
+static size_t raw_layout(matrix_header* header, matrix_tile* tiles, long num_tiles) {
+    size_t data_start = align_up(sizeof(matrix_header) + num_tiles * sizeof(matrix_tile), PAGE_ALIGNMENT);
+    size_t offset = data_start;
+    long tiles_per_row = (header->cols + header->tile_cols - 1) / header->tile_cols;
+    for (long t = 0; t < num_tiles; t++) {
+        long h, w;
+        tile_extent(header->rows, header->cols, header->tile_rows, header->tile_cols, t / tiles_per_row,
+                    t % tiles_per_row, &h, &w);
+        tiles[t].offset = offset;
+        tiles[t].size = h * w * matrix_element_size(header->type);
+        offset += align_up(tiles[t].size, PAGE_ALIGNMENT);
+    }
+    header->data_size = offset - data_start;
+    return offset;
+}
+
+static int write_raw(int fd, matrix_header* header, matrix_tile* tiles, const matrix_layout* l, long num_tiles,
+                     int num_threads) {
+    size_t offset = raw_layout(header, tiles, num_tiles);
+    if (ftruncate(fd, offset) != 0) return 0;
+    uint8_t* map = (uint8_t*)mmap(NULL, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) return 0;
+    memcpy(map, header, sizeof(matrix_header));
+    memcpy(map + sizeof(matrix_header), tiles, num_tiles * sizeof(matrix_tile));
+    tile_task task = {l, map, tiles, 0, num_tiles, NULL, NULL, MATRIX_RAW};
+    run_tiles(&task, num_threads);
+    int ok = msync(map, offset, MS_SYNC) == 0;
+    munmap(map, offset);
+    return ok;
+}
+
+// Tuiles compressées : une ligne de tuiles à la fois (mémoire bornée), compressées en parallèle
+// dans des emplacements de taille maximale, tassées puis écrites en un seul bloc
+static int write_compressed(int fd, matrix_header* header, matrix_tile* tiles, const matrix_layout* l,
+                            long num_tiles, int num_threads) {
+    size_t data_start = align_up(sizeof(matrix_header) + num_tiles * sizeof(matrix_tile), PAGE_ALIGNMENT);
+    size_t band_capacity = max_encoded_size((size_t)l->tile_rows * l->tiles_per_row * l->tile_cols, l->element_size);
+    uint8_t* band = (uint8_t*)malloc(band_capacity);
+    if (band == NULL) return 0;
+    size_t offset = data_start;
+    int ok = 1;
+    for (long first = 0; first < num_tiles && ok; first += l->tiles_per_row) {
+        size_t slot = 0;
+        for (long t = first; t < first + l->tiles_per_row; t++) {
+            long h, w;
+            tile_extent(l->num_rows, l->num_cols, l->tile_rows, l->tile_cols, t / l->tiles_per_row,
+                        t % l->tiles_per_row, &h, &w);
+            tiles[t].offset = slot;
+            slot += max_encoded_size(h * w, l->element_size);
+        }
+        tile_task task = {l, band, tiles + first, first, first + l->tiles_per_row, NULL, NULL, MATRIX_DELTA};
+        run_tiles(&task, num_threads);
+        size_t packed = 0;
+        for (long t = first; t < first + l->tiles_per_row; t++) {
+            memmove(band + packed, band + tiles[t].offset, tiles[t].size);
+            tiles[t].offset = offset + packed;
+            packed += tiles[t].size;
+        }
+        ok = write_all(fd, band, packed, offset);
+        offset += packed;
+    }
+    free(band);
+    header->data_size = offset - data_start;
+    return ok && write_all(fd, (const uint8_t*)header, sizeof(matrix_header), 0) &&
+           write_all(fd, (const uint8_t*)tiles, num_tiles * sizeof(matrix_tile), sizeof(matrix_header));
+}
+
+static void init_header(matrix_header* header, int type, int compression, long num_rows, long num_cols,
+                        int tile_rows, int tile_cols) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, "MATX", 4);
+    header->version = MATRIX_VERSION;
+    header->type = type;
+    header->compression = compression;
+    header->rows = num_rows;
+    header->cols = num_cols;
+    header->tile_rows = tile_rows;
+    header->tile_cols = tile_cols;
+}
+
+int write_matrix_file(const char* filename, int type, const void* const* rows, long num_rows, long num_cols,
+                      const matrix_file_options* options) {
+    if (type < MATRIX_INT32 || type > MATRIX_FLOAT64 || num_rows <= 0 || num_cols <= 0) return 0;
+    matrix_file_options o = {DEFAULT_TILE, DEFAULT_TILE, MATRIX_RAW, DEFAULT_THREADS};
+    if (options != NULL) {
+        if (options->tile_rows > 0) o.tile_rows = options->tile_rows;
+        if (options->tile_cols > 0) o.tile_cols = options->tile_cols;
+        if (options->num_threads > 0) o.num_threads = options->num_threads;
+        o.compression = options->compression;
+    }
+
+    matrix_layout l = {type, matrix_element_size(type), (const uint8_t* const*)rows, num_rows, num_cols,
+                       o.tile_rows, o.tile_cols, (num_cols + o.tile_cols - 1) / o.tile_cols};
+    long num_tiles = (num_rows + o.tile_rows - 1) / o.tile_rows * l.tiles_per_row;
+    matrix_header header;
+    init_header(&header, type, o.compression, num_rows, num_cols, o.tile_rows, o.tile_cols);
+
+    matrix_tile* tiles = (matrix_tile*)malloc(num_tiles * sizeof(matrix_tile));
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (tiles == NULL || fd < 0) {
+        free(tiles);
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    int ok = o.compression == MATRIX_DELTA ? write_compressed(fd, &header, tiles, &l, num_tiles, o.num_threads)
+                                           : write_raw(fd, &header, tiles, &l, num_tiles, o.num_threads);
+    free(tiles);
+    return close(fd) == 0 && ok;
+}
+
+matrix_tile* create_matrix_file(const char* filename, int type, long num_rows, long num_cols, int tile_rows,
+                                int tile_cols) {
+    if (type < MATRIX_INT32 || type > MATRIX_FLOAT64 || num_rows <= 0 || num_cols <= 0 || tile_rows <= 0 ||
+        tile_cols <= 0)
+        return NULL;
+    long num_tiles = (num_rows + tile_rows - 1) / tile_rows * ((num_cols + tile_cols - 1) / tile_cols);
+    matrix_header header;
+    init_header(&header, type, MATRIX_RAW, num_rows, num_cols, tile_rows, tile_cols);
+    matrix_tile* tiles = (matrix_tile*)malloc(num_tiles * sizeof(matrix_tile));
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (tiles == NULL || fd < 0) {
+        free(tiles);
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    // ftruncate : les tuiles valent zéro sans qu'aucun octet ne soit écrit
+    size_t size = raw_layout(&header, tiles, num_tiles);
+    int ok = ftruncate(fd, size) == 0 && write_all(fd, (const uint8_t*)&header, sizeof(header), 0) &&
+             write_all(fd, (const uint8_t*)tiles, num_tiles * sizeof(matrix_tile), sizeof(matrix_header));
+    if (close(fd) != 0 || !ok) {
+        free(tiles);
+        return NULL;
+    }
+    return tiles;
+}
+
+static int valid_file(const uint8_t* base, size_t size) {
+    const matrix_header* h = (const matrix_header*)base;
+    if (size < sizeof(matrix_header) || memcmp(h->magic, "MATX", 4) != 0 || h->version != MATRIX_VERSION) return 0;
+    if (h->type < MATRIX_INT32 || h->type > MATRIX_FLOAT64 || h->rows == 0 || h->cols == 0 ||
+        h->tile_rows == 0 || h->tile_cols == 0 || (h->compression != MATRIX_RAW && h->compression != MATRIX_DELTA))
+        return 0;
+    uint64_t tiles_per_row = (h->cols + h->tile_cols - 1) / h->tile_cols;
+    uint64_t num_tiles = (h->rows + h->tile_rows - 1) / h->tile_rows * tiles_per_row;
+    if (num_tiles > (size - sizeof(matrix_header)) / sizeof(matrix_tile)) return 0;
+    const matrix_tile* tiles = (const matrix_tile*)(base + sizeof(matrix_header));
+    for (uint64_t t = 0; t < num_tiles; t++) {
+        if (tiles[t].offset > size || tiles[t].size > size - tiles[t].offset) return 0;
+        long th, tw;
+        tile_extent(h->rows, h->cols, h->tile_rows, h->tile_cols, t / tiles_per_row, t % tiles_per_row, &th, &tw);
+        if (h->compression == MATRIX_RAW && tiles[t].size != th * tw * matrix_element_size(h->type)) return 0;
+    }
+    return 1;
+}
+
+matrix_file* open_matrix_file(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+    matrix_file* file = (matrix_file*)calloc(1, sizeof(matrix_file));
+    if (file == NULL || !valid_file((const uint8_t*)base, st.st_size)) {
+        munmap(base, st.st_size);
+        free(file);
+        return NULL;
+    }
+    // Accès par tuiles : pas de lecture anticipée de tout le fichier
+    madvise(base, st.st_size, MADV_RANDOM);
+    file->base = (const uint8_t*)base;
+    file->size = st.st_size;
+    file->header = (const matrix_header*)base;
+    file->tiles = (const matrix_tile*)(file->base + sizeof(matrix_header));
+    file->scratch = malloc((size_t)file->header->tile_rows * file->header->tile_cols *
+                           matrix_element_size(file->header->type));
+    if (file->scratch == NULL) {
+        close_matrix_file(file);
+        return NULL;
+    }
+    return file;
+}
+
+void close_matrix_file(matrix_file* file) {
+    if (file == NULL) return;
+    munmap((void*)file->base, file->size);
+    free(file->scratch);
+    free(file);
+}
+
+int read_matrix_region(matrix_file* file, long row, long col, long num_rows, long num_cols, void* out) {
+    const matrix_header* h = file->header;
+    if (row < 0 || col < 0 || num_rows <= 0 || num_cols <= 0 || (uint64_t)(row + num_rows) > h->rows ||
+        (uint64_t)(col + num_cols) > h->cols)
+        return 0;
+    size_t es = matrix_element_size(h->type);
+    long tr = h->tile_rows, tc = h->tile_cols;
+    long tiles_per_row = (h->cols + tc - 1) / tc;
+    for (long a = row / tr; a <= (row + num_rows - 1) / tr; a++) {
+        for (long b = col / tc; b <= (col + num_cols - 1) / tc; b++) {
+            const matrix_tile* tile = &file->tiles[a * tiles_per_row + b];
+            const uint8_t* src = file->base + tile->offset;
+            if (h->compression == MATRIX_DELTA) {
+                if (!decode_tile(h, a, b, src, tile->size, (uint8_t*)file->scratch)) return 0;
+                src = (const uint8_t*)file->scratch;
+            }
+            long th, tw;
+            tile_extent(h->rows, h->cols, tr, tc, a, b, &th, &tw);
+            long y0 = row > a * tr ? row : a * tr;
+            long y1 = row + num_rows < a * tr + th ? row + num_rows : a * tr + th;
+            long x0 = col > b * tc ? col : b * tc;
+            long x1 = col + num_cols < b * tc + tw ? col + num_cols : b * tc + tw;
+            for (long y = y0; y < y1; y++) {
+                memcpy((uint8_t*)out + ((y - row) * num_cols + (x0 - col)) * es,
+                       src + ((y - a * tr) * tw + (x0 - b * tc)) * es, (x1 - x0) * es);
+            }
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,72 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Format binaire de matrice pour l'inspection après coup des grands calculs (matrices de
+// similarité, matrices d'élimination), à la place de print_matrix. Un en-tête de 64 octets,
+// un répertoire (décalage, taille) par tuile, puis les tuiles, rangées par lignes de tuiles.
+// Chaque tuile contient ses éléments ligne par ligne, bruts ou compressés : on peut extraire
+// une sous-région en ne lisant que les tuiles qu'elle touche.
+
+#define MATRIX_INT32 1
+#define MATRIX_FLOAT32 2
+#define MATRIX_FLOAT64 3
+
+#define MATRIX_RAW 0        // tuiles alignées sur 4096 octets, écrites par mmap
+#define MATRIX_DELTA 1      // écart au voisin de gauche (entiers) ou ou-exclusif (flottants),
+                            //   en varint : les matrices de programmation dynamique tiennent
+                            //   sur un octet par élément
+
+typedef struct {
+    char magic[4];          // "MATX"
+    uint32_t version;
+    uint32_t type;
+    uint32_t compression;
+    uint64_t rows, cols;
+    uint32_t tile_rows, tile_cols;
+    uint64_t data_size;     // octets de tuiles
+    uint8_t reserved[16];
+} matrix_header;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t size;
+} matrix_tile;
+
+typedef struct {
+    int tile_rows, tile_cols;   // 0 : 256 x 256
+    int compression;
+    int num_threads;            // 0 : 4
+} matrix_file_options;
+
+// rows[i] pointe sur les num_cols éléments de la ligne i ; options peut être NULL.
+// Renvoie 0 en cas d'erreur.
+int write_matrix_file(const char* filename, int type, const void* const* rows, long num_rows, long num_cols,
+                      const matrix_file_options* options);
+
+// Fichier brut dont toutes les tuiles valent zéro, pour un programme qui le remplit tuile par
+// tuile (pread/pwrite) : renvoie le répertoire des tuiles (à libérer), NULL en cas d'erreur
+matrix_tile* create_matrix_file(const char* filename, int type, long num_rows, long num_cols, int tile_rows,
+                                int tile_cols);
+
+// Fichier projeté en mémoire : seules les pages des tuiles lues sont chargées
+typedef struct {
+    const matrix_header* header;
+    const matrix_tile* tiles;
+    const uint8_t* base;
+    size_t size;
+    void* scratch;              // tuile décompressée
+} matrix_file;
+
+matrix_file* open_matrix_file(const char* filename);
+void close_matrix_file(matrix_file* file);
+size_t matrix_element_size(int type);
+
+// Copie la région [row, row + num_rows) x [col, col + num_cols) dans out, ligne par ligne
+// (num_cols éléments par ligne). Renvoie 0 si la région sort de la matrice ou si une tuile
+// est corrompue. Utilise le tampon de file : un seul thread à la fois par matrix_file.
+int read_matrix_region(matrix_file* file, long row, long col, long num_rows, long num_cols, void* out);
+
+#endif
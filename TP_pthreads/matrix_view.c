@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "matrix_file.h"
+
+#define DEFAULT_REGION 16
+
+// Usage : ./matrix_view fichier.mat                       description du fichier
+//         ./matrix_view fichier.mat ligne colonne [lignes colonnes]
+// Seules les tuiles qui recouvrent la région sont lues (et décompressées).
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 4 && argc != 6) {
+        fprintf(stderr, "Usage : %s fichier.mat [ligne colonne [lignes colonnes]]\n", argv[0]);
+        return 1;
+    }
+    matrix_file* file = open_matrix_file(argv[1]);
+    if (file == NULL) {
+        fprintf(stderr, "Erreur : %s n'est pas un fichier de matrice valide\n", argv[1]);
+        return 1;
+    }
+    const matrix_header* h = file->header;
+    const char* types[] = {"", "int32", "float32", "float64"};
+    size_t raw_size = h->rows * h->cols * matrix_element_size(h->type);
+    printf("%s : %llu x %llu %s, tuiles %u x %u, %s, %.1f Mo de tuiles (%.1f Mo bruts)\n", argv[1],
+           (unsigned long long)h->rows, (unsigned long long)h->cols, types[h->type], h->tile_rows, h->tile_cols,
+           h->compression == MATRIX_DELTA ? "compressé" : "brut", h->data_size / 1e6, raw_size / 1e6);
+    if (argc == 2) {
+        close_matrix_file(file);
+        return 0;
+    }
+
+    long row = atol(argv[2]), col = atol(argv[3]);
+    long num_rows = argc == 6 ? atol(argv[4]) : DEFAULT_REGION;
+    long num_cols = argc == 6 ? atol(argv[5]) : DEFAULT_REGION;
+    // Une région par défaut qui dépasse le bord est tronquée
+    if (argc == 4 && row + num_rows > (long)h->rows) num_rows = (long)h->rows - row;
+    if (argc == 4 && col + num_cols > (long)h->cols) num_cols = (long)h->cols - col;
+    void* region = num_rows > 0 && num_cols > 0 ? malloc(num_rows * num_cols * matrix_element_size(h->type)) : NULL;
+    if (region == NULL || !read_matrix_region(file, row, col, num_rows, num_cols, region)) {
+        fprintf(stderr, "Erreur : Région [%ld, %ld] x [%ld, %ld] illisible\n", row, row + num_rows, col,
+                col + num_cols);
+        free(region);
+        close_matrix_file(file);
+        return 1;
+    }
+
+    printf("%8s", "");
+    for (long j = 0; j < num_cols; j++) printf(h->type == MATRIX_INT32 ? " %6ld" : " %10ld", col + j);
+    printf("\n");
+    for (long i = 0; i < num_rows; i++) {
+        printf("%8ld", row + i);
+        for (long j = 0; j < num_cols; j++) {
+            long k = i * num_cols + j;
+            if (h->type == MATRIX_INT32) {
+                printf(" %6d", ((int32_t*)region)[k]);
+            } else if (h->type == MATRIX_FLOAT32) {
+                printf(" %10.4g", ((float*)region)[k]);
+            } else {
+                printf(" %10.4g", ((double*)region)[k]);
+            }
+        }
+        printf("\n");
+    }
+    free(region);
+    close_matrix_file(file);
+    return 0;
+}
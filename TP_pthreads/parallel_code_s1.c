@@ -3,11 +3,15 @@
 #include <string.h>
 #include <math.h>
 #include <pthread.h>
-#include <sys/time.h>
+#include "matrix_file.h"
+#include "perf_counters.h"
+#include "alignment_output.h"
+#include "edit_distance.h"
 
 #define MATCH_SCORE 1
 #define MISMATCH_SCORE -1
 #define GAP_PENALTY -2
+#define NUM_THREADS 8
 
 typedef struct {
     char* X;
@@ -43,7 +47,7 @@ void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY,
         S[0][j] = j * GAP_PENALTY;
     }
 
-    int num_threads = 8;  
+    int num_threads = NUM_THREADS;
     pthread_t threads[num_threads];
     ThreadData thread_data[num_threads];
 
@@ -77,46 +81,51 @@ void print_matrix(int lenX, int lenY, int** S) {
     }
 }
 
-void traceback(int** S, char* X, char* Y, int lenX, int lenY) {
-    char* aligned_X = (char*)malloc((lenX + lenY + 1) * sizeof(char));
-    char* aligned_Y = (char*)malloc((lenX + lenY + 1) * sizeof(char));
-    int index = 0;
+void traceback(int** S, char* X, char* Y, int lenX, int lenY, int gapped) {
+    // The operations are filled from the end of the buffer, then the CIGAR (and, with gapped,
+    // both aligned strings) is formatted into a preallocated buffer written in one block
+    int capacity = lenX + lenY;
+    char* ops = (char*)malloc((capacity + 1) * sizeof(char));
+    char* out = (char*)malloc(CIGAR_MAX_LENGTH(capacity) + 2 * (size_t)capacity + 3);
+    if (ops == NULL || out == NULL) {
+        printf("Error: cannot allocate the alignment buffer\n");
+        free(ops);
+        free(out);
+        return;
+    }
+    int index = capacity;
 
     int i = lenX;
     int j = lenY;
 
     while (i > 0 || j > 0) {
         if (i > 0 && j > 0 && S[i][j] == S[i - 1][j - 1] + ((X[i - 1] == Y[j - 1]) ? MATCH_SCORE : MISMATCH_SCORE)) {
-            aligned_X[index] = X[i - 1];
-            aligned_Y[index] = Y[j - 1];
+            ops[--index] = X[i - 1] == Y[j - 1] ? OP_MATCH : OP_MISMATCH;
             i--;
             j--;
         } else if (i > 0 && S[i][j] == S[i - 1][j] + GAP_PENALTY) {
-            aligned_X[index] = X[i - 1];
-            aligned_Y[index] = '-';
+            ops[--index] = OP_DELETE;
             i--;
         } else {
-            aligned_X[index] = '-';
-            aligned_Y[index] = Y[j - 1];
+            ops[--index] = OP_INSERT;
             j--;
         }
-        index++;
     }
 
-    aligned_X[index] = '\0';
-    aligned_Y[index] = '\0';
-
-    printf("Optimal Alignment:\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_X[k]);
-    }
-    printf("\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_Y[k]);
+    int n = capacity - index;
+    char* p = out + ops_to_cigar(ops + index, n, out);
+    *p++ = '\n';
+    if (gapped) {
+        ops_to_gapped(ops + index, n, X, Y, p, p + n + 1);
+        p[n] = '\n';
+        p[2 * n + 1] = '\n';
+        p += 2 * n + 2;
     }
-    printf("\n");
-    free(aligned_X);
-    free(aligned_Y);
+
+    printf("Optimal Alignment (CIGAR%s):\n", gapped ? ", gapped" : "");
+    fwrite(out, sizeof(char), p - out, stdout);
+    free(ops);
+    free(out);
 }
 
 void read_sequence_from_file(const char* filename, char** sequence, int* length) {
@@ -142,7 +151,10 @@ void read_sequence_from_file(const char* filename, char** sequence, int* length)
     fclose(file);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./program [matrix.mat] [gapped]: gapped also prints both aligned strings after the CIGAR
+    int gapped = argc > 1 && strcmp(argv[argc - 1], "gapped") == 0;
+    const char* matrix_name = argc > 1 + gapped ? argv[1] : NULL;
     char *X, *Y;
     int lenX, lenY; 
     read_sequence_from_file("X.txt", &X, &lenX);
@@ -153,17 +165,33 @@ int main() {
         S[i] = (int*)malloc((lenY + 1) * sizeof(int));
     }
 
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
+    // Per cell: 3 additions and 2 maximums (integer operations), 4 bytes written and 4 read
+    // back from the previous row. The threads only live for one row, so the row loop is
+    // measured from the main thread: opening counters in each of them would cost more system
+    // calls than the row itself. The counters therefore cover thread creation and joins, which
+    // dominate this version, not the cells computed by the workers.
+    perf_region* region = perf_region_create("row-parallel alignment", 1);
+    perf_region_begin(region, 0);
     calculate_similarity_matrix_parallel(X, Y, lenX, lenY, S);
-    gettimeofday(&end, NULL);
+    perf_region_end(region, 0);
+    double time_spent = perf_region_seconds(region);
+    perf_region_add_work(region, 5.0 * lenX * lenY, 8.0 * lenX * lenY);
 
     // Optional: print the S matrix
     // print_matrix(lenX, lenY, S);
-    traceback(S, X, Y, lenX, lenY);
+    // ./program matrix.mat: S is saved in the binary format of matrix_file.h
+    // (readable with matrix_view), much faster than print_matrix
+    if (matrix_name != NULL) {
+        matrix_file_options options = {0, 0, MATRIX_DELTA, 0};
+        if (!write_matrix_file(matrix_name, MATRIX_INT32, (const void* const*)S, lenX + 1, lenY + 1, &options)) {
+            printf("Error: cannot write %s\n", matrix_name);
+        }
+    }
+    traceback(S, X, Y, lenX, lenY, gapped);
     
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + (end.tv_usec - start.tv_usec) / 1e6; 
     printf("Execution time (paralel): %f seconds\n", time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
     
     for (int i = 0; i <= lenX; i++) {
         free(S[i]);
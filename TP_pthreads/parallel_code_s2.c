@@ -1,10 +1,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
-#include <sys/time.h>
 #include <math.h>
 #include <limits.h> 
+#include "matrix_file.h"
+#include "perf_counters.h"
+#include "alignment_output.h"
+#include "edit_distance.h"
 
 
 #define MATCH_SCORE 1
@@ -20,6 +24,8 @@ typedef struct {
     int lenY;
     int antidiagonal_start;
     int antidiagonal_end;
+    perf_region* region;
+    int thread;
 } ThreadData;
 
 pthread_mutex_t **mutex_matrix; 
@@ -59,6 +65,8 @@ void calculate_cell(ThreadData* data, int i, int j) {
 void* calculate_antidiagonals(void* arg) {
     ThreadData* data = (ThreadData*)arg;
 
+    // Le temps de chaque thread inclut les attentes sur les cellules de l'autre thread
+    perf_region_begin(data->region, data->thread);
     for (int k = data->antidiagonal_start; k <= data->antidiagonal_end; k++) {
         for (int i = 1; i <= data->lenX; i++) {
             int j = k - i;
@@ -67,10 +75,11 @@ void* calculate_antidiagonals(void* arg) {
             }
         }
     }
+    perf_region_end(data->region, data->thread);
     return NULL;
 }
 
-void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY, int** S) {
+void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY, int** S, perf_region* region) {
     // Initialize matrix boundaries with gap penalties
     for (int i = 0; i <= lenX; i++) S[i][0] = i * GAP_PENALTY;
     for (int j = 0; j <= lenY; j++) S[0][j] = j * GAP_PENALTY;
@@ -97,7 +106,7 @@ void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY,
     for (int t = 0; t < NUM_THREADS; t++) {
         int start = t * antidiags_per_thread + 2;
         int end = (t == NUM_THREADS - 1) ? max_antidiagonal : start + antidiags_per_thread - 1;
-        thread_data[t] = (ThreadData){S, X, Y, lenX, lenY, start, end};
+        thread_data[t] = (ThreadData){S, X, Y, lenX, lenY, start, end, region, t};
         pthread_create(&threads[t], NULL, calculate_antidiagonals, &thread_data[t]);
     }
 
@@ -128,46 +137,51 @@ void print_matrix(int lenX, int lenY, int** S) {
     }
 }
 
-void traceback(int** S, char* X, char* Y, int lenX, int lenY) {
-    char* aligned_X = (char*)malloc((lenX + lenY + 1) * sizeof(char)); 
-    char* aligned_Y = (char*)malloc((lenX + lenY + 1) * sizeof(char)); 
-    int index = 0; 
+void traceback(int** S, char* X, char* Y, int lenX, int lenY, int gapped) {
+    // Les opérations sont remplies depuis la fin du tampon, puis le CIGAR (et, avec gapped,
+    // les deux chaînes alignées) est formaté dans un tampon préalloué écrit d'un seul bloc
+    int capacity = lenX + lenY;
+    char* ops = (char*)malloc((capacity + 1) * sizeof(char));
+    char* out = (char*)malloc(CIGAR_MAX_LENGTH(capacity) + 2 * (size_t)capacity + 3);
+    if (ops == NULL || out == NULL) {
+        printf("Erreur : Allocation du tampon d'alignement impossible\n");
+        free(ops);
+        free(out);
+        return;
+    }
+    int index = capacity;
 
     int i = lenX;
     int j = lenY;
 
     while (i > 0 || j > 0) {
         if (i > 0 && j > 0 && S[i][j] == S[i - 1][j - 1] + ((X[i - 1] == Y[j - 1]) ? MATCH_SCORE : MISMATCH_SCORE)) {
-            aligned_X[index] = X[i - 1]; 
-            aligned_Y[index] = Y[j - 1];
+            ops[--index] = X[i - 1] == Y[j - 1] ? OP_MATCH : OP_MISMATCH;
             i--;
             j--;
         } else if (i > 0 && S[i][j] == S[i - 1][j] + GAP_PENALTY) {
-            aligned_X[index] = X[i - 1]; 
-            aligned_Y[index] = '-';       
+            ops[--index] = OP_DELETE;
             i--;
         } else {
-            aligned_X[index] = '-';       
-            aligned_Y[index] = Y[j - 1];  
+            ops[--index] = OP_INSERT;
             j--;
         }
-        index++;
     }
 
-    aligned_X[index] = '\0'; 
-    aligned_Y[index] = '\0'; 
-
-    printf("Alignement Optimal :\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_X[k]);
+    int n = capacity - index;
+    char* p = out + ops_to_cigar(ops + index, n, out);
+    *p++ = '\n';
+    if (gapped) {
+        ops_to_gapped(ops + index, n, X, Y, p, p + n + 1);
+        p[n] = '\n';
+        p[2 * n + 1] = '\n';
+        p += 2 * n + 2;
     }
-    printf("\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_Y[k]);
-    }
-    printf("\n");
-    free(aligned_X);
-    free(aligned_Y);
+
+    printf("Alignement Optimal (CIGAR%s) :\n", gapped ? ", avec gaps" : "");
+    fwrite(out, sizeof(char), p - out, stdout);
+    free(ops);
+    free(out);
 }
 
 void read_sequence_from_file(const char* filename, char** sequence, int* length) {
@@ -192,7 +206,10 @@ void read_sequence_from_file(const char* filename, char** sequence, int* length)
     fclose(file);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./programme [matrice.mat] [gapped] : gapped ajoute les deux chaînes alignées au CIGAR
+    int gapped = argc > 1 && strcmp(argv[argc - 1], "gapped") == 0;
+    const char* matrix_name = argc > 1 + gapped ? argv[1] : NULL;
     char *X, *Y;
     int lenX, lenY; 
     read_sequence_from_file("X.txt", &X, &lenX);
@@ -203,16 +220,27 @@ int main() {
         S[i] = (int*)malloc((lenY + 1) * sizeof(int));
     }
 
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
-    calculate_similarity_matrix_parallel(X, Y, lenX, lenY, S);
-    gettimeofday(&end, NULL);
-
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + (end.tv_usec - start.tv_usec) / 1e6; 
+    // Par cellule : 3 additions et 2 maximums (opérations entières), 4 octets écrits et 4 relus
+    // dans la ligne précédente
+    perf_region* region = perf_region_create("alignement par antidiagonales", NUM_THREADS);
+    double start = perf_now();
+    calculate_similarity_matrix_parallel(X, Y, lenX, lenY, S, region);
+    double time_spent = perf_now() - start;
+    perf_region_add_work(region, 5.0 * lenX * lenY, 8.0 * lenX * lenY);
     // print_matrix(lenX, lenY, S);
-    traceback(S, X, Y, lenX, lenY);
+    // ./programme matrice.mat : S est enregistrée au format binaire de matrix_file.h
+    // (lisible par matrix_view), bien plus vite qu'avec print_matrix
+    if (matrix_name != NULL) {
+        matrix_file_options options = {0, 0, MATRIX_DELTA, 0};
+        if (!write_matrix_file(matrix_name, MATRIX_INT32, (const void* const*)S, lenX + 1, lenY + 1, &options)) {
+            printf("Erreur : Impossible d'écrire %s\n", matrix_name);
+        }
+    }
+    traceback(S, X, Y, lenX, lenY, gapped);
 
     printf("Temps d'exécution : %.6f secondes\n", time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
 
     for (int i = 0; i <= lenX; i++) {
         free(S[i]);
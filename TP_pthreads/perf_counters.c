@@ -0,0 +1,328 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define CACHE_LINE 64
+
+typedef struct {
+    int fds[PERF_NUM_EVENTS];       // -1 : compteur fermé ou indisponible
+    long tid;                       // thread qui a ouvert les compteurs, 0 : aucun
+    int open_errno;                 // première erreur de perf_event_open
+    // Valeur brute, temps activé et temps d'exécution du compteur, lus par begin ; end cumule
+    // les trois différences séparément, extrapolées une seule fois au rapport (scaled_count)
+    uint64_t start[PERF_NUM_EVENTS][3];
+    uint64_t raw[PERF_NUM_EVENTS];
+    uint64_t enabled[PERF_NUM_EVENTS];
+    uint64_t running[PERF_NUM_EVENTS];
+    int available[PERF_NUM_EVENTS];
+    double start_time, seconds;
+    long calls;
+    char padding[CACHE_LINE];       // pas de faux partage entre emplacements voisins
+} perf_thread;
+
+struct perf_region {
+    char name[64];
+    int num_threads;
+    perf_thread* threads;
+    double flops, bytes;
+};
+
+static const char* const event_names[PERF_NUM_EVENTS] = {
+    "cycles", "instructions", "défauts LLC", "err. branch."
+};
+
+double perf_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+#ifdef __linux__
+static const uint64_t event_configs[PERF_NUM_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// gettid est un appel système : le résultat est gardé par thread, perf_region_begin ne
+// coûte alors qu'une lecture de variable locale au thread pour vérifier l'emplacement
+static long current_tid(void) {
+    static __thread long tid;
+    if (tid == 0) tid = (long)syscall(SYS_gettid);
+    return tid;
+}
+
+// Compteur du thread appelant, sur n'importe quel coeur ; espace utilisateur seulement,
+// ce qui suffit avec le réglage par défaut perf_event_paranoid = 2. Avec group_fd, le
+// compteur rejoint le groupe du meneur : le noyau les programme ensemble, si bien que les
+// rapports (IPC, taux d'erreurs) portent sur les mêmes intervalles même en multiplexage.
+static int open_event(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Valeur brute, temps activé, temps d'exécution : les trois croissent, leurs différences
+// entre begin et end ne peuvent pas être négatives (contrairement à une valeur extrapolée)
+static void read_event(int fd, uint64_t v[3]) {
+    if (read(fd, v, 3 * sizeof(uint64_t)) != (ssize_t)(3 * sizeof(uint64_t))) v[0] = v[1] = v[2] = 0;
+}
+
+static void close_events(perf_thread* t) {
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (t->fds[e] >= 0) close(t->fds[e]);
+        t->fds[e] = -1;
+    }
+    t->tid = 0;
+}
+
+static void open_events(perf_thread* t) {
+    close_events(t);
+    t->tid = current_tid();
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        // Les cycles mènent le groupe ; un compteur que le groupe refuse est ouvert seul
+        int leader = e > 0 ? t->fds[PERF_CYCLES] : -1;
+        t->fds[e] = open_event(event_configs[e], leader);
+        if (t->fds[e] < 0 && leader >= 0) t->fds[e] = open_event(event_configs[e], -1);
+        if (t->fds[e] < 0) {
+            if (t->open_errno == 0) t->open_errno = errno;
+            continue;
+        }
+        t->available[e] = 1;
+    }
+}
+#else
+static long current_tid(void) {
+    return 1;
+}
+
+static void read_event(int fd, uint64_t v[3]) {
+    (void)fd;
+    v[0] = v[1] = v[2] = 0;
+}
+
+static void close_events(perf_thread* t) {
+    t->tid = 0;
+}
+
+static void open_events(perf_thread* t) {
+    t->tid = current_tid();
+    if (t->open_errno == 0) t->open_errno = ENOSYS;
+}
+#endif
+
+perf_region* perf_region_create(const char* name, int num_threads) {
+    if (num_threads < 1) num_threads = 1;
+    perf_region* r = (perf_region*)calloc(1, sizeof(perf_region));
+    if (r == NULL) return NULL;
+    r->threads = (perf_thread*)calloc(num_threads, sizeof(perf_thread));
+    if (r->threads == NULL) {
+        free(r);
+        return NULL;
+    }
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->num_threads = num_threads;
+    for (int i = 0; i < num_threads; i++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) r->threads[i].fds[e] = -1;
+    }
+    return r;
+}
+
+void perf_region_begin(perf_region* region, int thread) {
+    if (region == NULL || thread < 0 || thread >= region->num_threads) return;
+    perf_thread* t = &region->threads[thread];
+    if (t->tid != current_tid()) open_events(t);
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (t->fds[e] >= 0) read_event(t->fds[e], t->start[e]);
+    }
+    // L'horloge en dernier : la lecture des compteurs n'est pas comptée dans le temps
+    t->start_time = perf_now();
+}
+
+void perf_region_end(perf_region* region, int thread) {
+    if (region == NULL || thread < 0 || thread >= region->num_threads) return;
+    perf_thread* t = &region->threads[thread];
+    t->seconds += perf_now() - t->start_time;
+    t->calls++;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (t->fds[e] < 0) continue;
+        uint64_t v[3];
+        read_event(t->fds[e], v);
+        t->raw[e] += v[0] - t->start[e][0];
+        t->enabled[e] += v[1] - t->start[e][1];
+        t->running[e] += v[2] - t->start[e][2];
+    }
+}
+
+// Compte extrapolé au temps activé quand le noyau a multiplexé le compteur
+static double scaled_count(const perf_thread* t, int e) {
+    if (t->running[e] == 0 || t->running[e] >= t->enabled[e]) return (double)t->raw[e];
+    return (double)t->raw[e] * t->enabled[e] / t->running[e];
+}
+
+void perf_region_add_work(perf_region* region, double flops, double bytes) {
+    if (region == NULL) return;
+    region->flops += flops;
+    region->bytes += bytes;
+}
+
+double perf_region_seconds(const perf_region* region) {
+    double seconds = 0;
+    if (region == NULL) return 0;
+    for (int i = 0; i < region->num_threads; i++) {
+        if (region->threads[i].seconds > seconds) seconds = region->threads[i].seconds;
+    }
+    return seconds;
+}
+
+double perf_region_count(const perf_region* region, int event) {
+    double total = 0;
+    int available = 0;
+    if (region == NULL || event < 0 || event >= PERF_NUM_EVENTS) return -1;
+    for (int i = 0; i < region->num_threads; i++) {
+        if (!region->threads[i].available[event]) continue;
+        available = 1;
+        total += scaled_count(&region->threads[i], event);
+    }
+    return available ? total : -1;
+}
+
+static const char* unavailable_reason(int err) {
+    switch (err) {
+    case EACCES:
+    case EPERM:
+        return "accès refusé, voir /proc/sys/kernel/perf_event_paranoid";
+    case ENOENT:
+    case ENODEV:
+    case EOPNOTSUPP:
+        return "pas de PMU exposée (machine virtuelle ?)";
+    case ENOSYS:
+        return "perf_event_open absent de ce système";
+    default:
+        return strerror(err);
+    }
+}
+
+// Alignement à droite en caractères et non en octets (accents UTF-8)
+static void print_padded(FILE* out, int width, const char* text) {
+    int length = 0;
+    for (const char* c = text; *c; c++) length += ((unsigned char)*c & 0xC0) != 0x80;
+    fprintf(out, " %*s%s", width > length ? width - length : 0, "", text);
+}
+
+static void print_count(FILE* out, int width, double value) {
+    if (value < 0) fprintf(out, " %*s", width, "n/d");
+    else fprintf(out, " %*.4g", width, value);
+}
+
+static void print_row(FILE* out, const char* label, double seconds, long calls, const double* counts) {
+    fprintf(out, "  %7s %10.4g %8ld", label, seconds, calls);
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) print_count(out, 12, counts[e]);
+    double ipc = counts[PERF_CYCLES] > 0 && counts[PERF_INSTRUCTIONS] >= 0
+                     ? counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES] : -1;
+    if (ipc < 0) fprintf(out, " %5s\n", "n/d");
+    else fprintf(out, " %5.2f\n", ipc);
+}
+
+// Plafond de la machine donné par l'environnement (0 si absent ou invalide)
+static double peak_from_env(const char* variable) {
+    const char* value = getenv(variable);
+    return value != NULL ? atof(value) : 0;
+}
+
+void perf_region_report(const perf_region* region, FILE* out) {
+    if (region == NULL) return;
+    double seconds = perf_region_seconds(region);
+    int any = 0, err = 0;
+    for (int i = 0; i < region->num_threads; i++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) any |= region->threads[i].available[e];
+        if (err == 0) err = region->threads[i].open_errno;
+    }
+
+    fprintf(out, "[%s] %d thread(s), %.6g s (horloge monotone)\n", region->name, region->num_threads, seconds);
+    if (!any && err != 0) {
+        fprintf(out, "  compteurs matériels indisponibles : %s ; temps seuls\n", unavailable_reason(err));
+    }
+    fprintf(out, "  %7s %10s %8s", "thread", "temps (s)", "appels");
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) print_padded(out, 12, event_names[e]);
+    fprintf(out, " %5s\n", "IPC");
+    double totals[PERF_NUM_EVENTS];
+    long calls = 0;
+    for (int i = 0; i < region->num_threads; i++) {
+        const perf_thread* t = &region->threads[i];
+        double counts[PERF_NUM_EVENTS];
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) counts[e] = t->available[e] ? scaled_count(t, e) : -1;
+        char label[16];
+        snprintf(label, sizeof(label), "%d", i);
+        if (region->num_threads > 1) print_row(out, label, t->seconds, t->calls, counts);
+        calls += t->calls;
+    }
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) totals[e] = perf_region_count(region, e);
+    print_row(out, "total", seconds, calls, totals);
+    double enabled = 0, running = 0;
+    for (int i = 0; i < region->num_threads; i++) {
+        if (!region->threads[i].available[PERF_CYCLES]) continue;
+        enabled += region->threads[i].enabled[PERF_CYCLES];
+        running += region->threads[i].running[PERF_CYCLES];
+    }
+    if (running > 0 && running < enabled) {
+        fprintf(out, "  compteurs multiplexés : actifs %.1f %% du temps, valeurs extrapolées\n",
+                100 * running / enabled);
+    }
+    if (totals[PERF_INSTRUCTIONS] > 0) {
+        if (totals[PERF_BRANCH_MISSES] >= 0) {
+            fprintf(out, "  erreurs de branchement : %.3f pour 1000 instructions\n",
+                    1e3 * totals[PERF_BRANCH_MISSES] / totals[PERF_INSTRUCTIONS]);
+        }
+        if (totals[PERF_CACHE_MISSES] >= 0) {
+            fprintf(out, "  défauts LLC : %.3f pour 1000 instructions\n",
+                    1e3 * totals[PERF_CACHE_MISSES] / totals[PERF_INSTRUCTIONS]);
+        }
+    }
+
+    if (region->flops <= 0 || seconds <= 0) return;
+    double gflops = region->flops / seconds / 1e9;
+    double intensity = region->bytes > 0 ? region->flops / region->bytes : 0;
+    fprintf(out, "  roofline : %.4g GFLOP, %.4g Go (modèle) -> %.3g FLOP/octet, %.4g GFLOP/s, %.4g Go/s\n",
+            region->flops / 1e9, region->bytes / 1e9, intensity, gflops, region->bytes / seconds / 1e9);
+    // Estimation : les défauts du dernier niveau comptent les lignes lues en mémoire, pas les
+    // réécritures ; faute de compteurs du contrôleur mémoire, c'est le trafic mesurable ici
+    if (totals[PERF_CACHE_MISSES] >= 0) {
+        double measured = totals[PERF_CACHE_MISSES] * CACHE_LINE;
+        fprintf(out, "             trafic mesuré (défauts LLC x %d o) : %.4g Go, %.4g Go/s", CACHE_LINE,
+                measured / 1e9, measured / seconds / 1e9);
+        if (measured > 0) fprintf(out, " -> %.3g FLOP/octet", region->flops / measured);
+        fprintf(out, "\n");
+    }
+    double peak_gflops = peak_from_env("PERF_PEAK_GFLOPS");
+    double peak_gbs = peak_from_env("PERF_PEAK_GBS");
+    if (peak_gflops > 0 && peak_gbs > 0 && intensity > 0) {
+        double memory_bound = intensity * peak_gbs;
+        double attainable = memory_bound < peak_gflops ? memory_bound : peak_gflops;
+        fprintf(out, "             atteignable %.4g GFLOP/s (crête %.4g GFLOP/s, %.4g Go/s), borné par %s : %.1f %%\n",
+                attainable, peak_gflops, peak_gbs, memory_bound < peak_gflops ? "la mémoire" : "le calcul",
+                100 * gflops / attainable);
+    }
+}
+
+void perf_region_free(perf_region* region) {
+    if (region == NULL) return;
+    for (int i = 0; i < region->num_threads; i++) close_events(&region->threads[i]);
+    free(region->threads);
+    free(region);
+}
@@ -0,0 +1,45 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+
+// Instrumentation commune des noyaux (alignement, élimination, DFT, esclaves MPI) : horloge
+// monotone et compteurs matériels perf_event_open par thread (cycles, instructions, défauts
+// du dernier niveau de cache, erreurs de prédiction de branchement), puis un résumé roofline.
+// Chaque thread ouvre ses compteurs, en un groupe mené par les cycles, à son premier
+// perf_region_begin ; ensuite begin et end ne coûtent qu'une lecture par compteur et peuvent
+// entourer une boucle interne. En cas de multiplexage, l'extrapolation est faite au rapport.
+// Sans compteurs (perf_event_paranoid trop élevé, machine virtuelle sans PMU, autre système
+// que Linux), seuls les temps sont mesurés et le rapport l'indique.
+
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_CACHE_MISSES 2         // dernier niveau de cache : lignes de 64 octets lues en mémoire
+#define PERF_BRANCH_MISSES 3
+#define PERF_NUM_EVENTS 4
+
+typedef struct perf_region perf_region;
+
+// Horloge monotone (CLOCK_MONOTONIC), en secondes
+double perf_now(void);
+
+// Région de num_threads emplacements ; NULL si la mémoire manque
+perf_region* perf_region_create(const char* name, int num_threads);
+// Mesure de l'emplacement thread par le thread appelant : chaque emplacement n'est utilisé
+// que par un thread à la fois (s'il change de thread, ses compteurs sont rouverts)
+void perf_region_begin(perf_region* region, int thread);
+void perf_region_end(perf_region* region, int thread);
+// Travail selon le modèle du programme : opérations flottantes (ou entières pour
+// l'alignement) et octets échangés avec la mémoire. Appelée par un seul thread.
+void perf_region_add_work(perf_region* region, double flops, double bytes);
+// Temps de la région : le plus long des temps cumulés des threads
+double perf_region_seconds(const perf_region* region);
+// Compteur cumulé sur tous les threads, -1 s'il n'a pu être ouvert
+double perf_region_count(const perf_region* region, int event);
+// Temps et compteurs par thread, IPC, taux d'erreurs, puis roofline : intensité (FLOP/octet)
+// et GFLOP/s du modèle, trafic mesuré (défauts x 64 octets) et, si PERF_PEAK_GFLOPS et
+// PERF_PEAK_GBS sont définies, la performance atteignable et la borne (calcul ou mémoire)
+void perf_region_report(const perf_region* region, FILE* out);
+void perf_region_free(perf_region* region);
+
+#endif
@@ -3,7 +3,10 @@
 #include <string.h>
 #include <math.h>
 #include <time.h>
-#include <sys/time.h>
+#include "matrix_file.h"
+#include "perf_counters.h"
+#include "alignment_output.h"
+#include "edit_distance.h"
 #include <pthread.h>
 
 
@@ -19,10 +22,13 @@ typedef struct {
     int lenY;      // Length of second sequence
     int start;     // Starting index for row or column
     int end;       // Ending index for row or column
+    int thread;    // Emplacement de mesure : 0 pour les lignes, 1 pour les colonnes
+    perf_region* region;
 } ThreadData;
 
 void* calculate_rows(void* arg) {
     ThreadData* data = (ThreadData*)arg;
+    perf_region_begin(data->region, data->thread);
     for (int i = data->start; i <= data->end; i++) {
         for (int j = 1; j <= data->lenY; j++) {
             int match = data->S[i - 1][j - 1] + ((data->X[i - 1] == data->Y[j - 1]) ? MATCH_SCORE : MISMATCH_SCORE);
@@ -31,11 +37,13 @@ void* calculate_rows(void* arg) {
             data->S[i][j] = fmax(fmax(match, del), insert);
         }
     }
+    perf_region_end(data->region, data->thread);
     return NULL;
 }
 
 void* calculate_cols(void* arg) {
     ThreadData* data = (ThreadData*)arg;
+    perf_region_begin(data->region, data->thread);
     for (int j = data->start; j <= data->end; j++) {
         for (int i = 1; i <= data->lenX; i++) {
             int match = data->S[i - 1][j - 1] + ((data->X[i - 1] == data->Y[j - 1]) ? MATCH_SCORE : MISMATCH_SCORE);
@@ -44,10 +52,13 @@ void* calculate_cols(void* arg) {
             data->S[i][j] = fmax(fmax(match, del), insert);
         }
     }
+    perf_region_end(data->region, data->thread);
     return NULL;
 }
 
-void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY, int** S) {
+// Deux threads neufs par paire de lignes : les compteurs de chaque emplacement sont rouverts
+// à chaque paire, hors de l'intervalle mesuré
+void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY, int** S, perf_region* region) {
     // Initialisation des bordures de la matrice
     for (int i = 0; i <= lenX; i++) S[i][0] = i * GAP_PENALTY;
     for (int j = 0; j <= lenY; j++) S[0][j] = j * GAP_PENALTY;
@@ -56,8 +67,8 @@ void calculate_similarity_matrix_parallel(char* X, char* Y, int lenX, int lenY,
     
     // Création des threads pour chaque paire d'indices de la diagonale
     for (int i = 1; i <= lenX; i += 2) {
-        ThreadData row_data = {S, X, Y, lenX, lenY, i, fmin(i + 1, lenX)}; // calculate two rows
-        ThreadData col_data = {S, X, Y, lenX, lenY, i, fmin(i + 1, lenY)}; // calculate two columns
+        ThreadData row_data = {S, X, Y, lenX, lenY, i, fmin(i + 1, lenX), 0, region}; // calculate two rows
+        ThreadData col_data = {S, X, Y, lenX, lenY, i, fmin(i + 1, lenY), 1, region}; // calculate two columns
         
         pthread_create(&t_row, NULL, calculate_rows, &row_data);
         pthread_create(&t_col, NULL, calculate_cols, &col_data);
@@ -77,46 +88,51 @@ void print_matrix(int lenX, int lenY, int** S) {
     }
 }
 
-void traceback(int** S, char* X, char* Y, int lenX, int lenY) {
-    char* aligned_X = (char*)malloc((lenX + lenY + 1) * sizeof(char)); 
-    char* aligned_Y = (char*)malloc((lenX + lenY + 1) * sizeof(char)); 
-    int index = 0; 
+void traceback(int** S, char* X, char* Y, int lenX, int lenY, int gapped) {
+    // Les opérations sont remplies depuis la fin du tampon, puis le CIGAR (et, avec gapped,
+    // les deux chaînes alignées) est formaté dans un tampon préalloué écrit d'un seul bloc
+    int capacity = lenX + lenY;
+    char* ops = (char*)malloc((capacity + 1) * sizeof(char));
+    char* out = (char*)malloc(CIGAR_MAX_LENGTH(capacity) + 2 * (size_t)capacity + 3);
+    if (ops == NULL || out == NULL) {
+        printf("Erreur : Allocation du tampon d'alignement impossible\n");
+        free(ops);
+        free(out);
+        return;
+    }
+    int index = capacity;
 
     int i = lenX;
     int j = lenY;
 
     while (i > 0 || j > 0) {
         if (i > 0 && j > 0 && S[i][j] == S[i - 1][j - 1] + ((X[i - 1] == Y[j - 1]) ? MATCH_SCORE : MISMATCH_SCORE)) {
-            aligned_X[index] = X[i - 1]; 
-            aligned_Y[index] = Y[j - 1];
+            ops[--index] = X[i - 1] == Y[j - 1] ? OP_MATCH : OP_MISMATCH;
             i--;
             j--;
         } else if (i > 0 && S[i][j] == S[i - 1][j] + GAP_PENALTY) {
-            aligned_X[index] = X[i - 1]; 
-            aligned_Y[index] = '-';       
+            ops[--index] = OP_DELETE;
             i--;
         } else {
-            aligned_X[index] = '-';       
-            aligned_Y[index] = Y[j - 1];  
+            ops[--index] = OP_INSERT;
             j--;
         }
-        index++;
     }
 
-    aligned_X[index] = '\0'; 
-    aligned_Y[index] = '\0'; 
-
-    printf("Alignement Optimal :\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_X[k]);
+    int n = capacity - index;
+    char* p = out + ops_to_cigar(ops + index, n, out);
+    *p++ = '\n';
+    if (gapped) {
+        ops_to_gapped(ops + index, n, X, Y, p, p + n + 1);
+        p[n] = '\n';
+        p[2 * n + 1] = '\n';
+        p += 2 * n + 2;
     }
-    printf("\n");
-    for (int k = index - 1; k >= 0; k--) {
-        printf("%c", aligned_Y[k]);
-    }
-    printf("\n");
-    free(aligned_X);
-    free(aligned_Y);
+
+    printf("Alignement Optimal (CIGAR%s) :\n", gapped ? ", avec gaps" : "");
+    fwrite(out, sizeof(char), p - out, stdout);
+    free(ops);
+    free(out);
 }
 
 void read_sequence_from_file(const char* filename, char** sequence, int* length) {
@@ -142,7 +158,10 @@ void read_sequence_from_file(const char* filename, char** sequence, int* length)
     fclose(file);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./programme [matrice.mat] [gapped] : gapped ajoute les deux chaînes alignées au CIGAR
+    int gapped = argc > 1 && strcmp(argv[argc - 1], "gapped") == 0;
+    const char* matrix_name = argc > 1 + gapped ? argv[1] : NULL;
     // char X[] = "AGCTGACGTAAGCTAGCTA";  
     // char Y[] = "GCTAGCAGTAGCAGTACGTA";  
     // int lenX = sizeof(X) / sizeof(X[0]) - 1; 
@@ -158,16 +177,28 @@ int main() {
         S[i] = (int*)malloc((lenY + 1) * sizeof(int));
     }
 
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
-    calculate_similarity_matrix_parallel(X, Y, lenX, lenY, S);
-    gettimeofday(&end, NULL);
-
-    double time_spent = (end.tv_sec - start.tv_sec) * 1.0 + (end.tv_usec - start.tv_usec) / 1e6; 
+    // Cellules calculées : toutes les lignes, plus les colonnes d'indice <= lenX (les deux
+    // threads recalculent leur intersection) ; par cellule, comme parallel_code_s2.c
+    double cells = (double)lenX * lenY + (double)lenX * (lenX < lenY ? lenX : lenY);
+    perf_region* region = perf_region_create("alignement lignes et colonnes", 2);
+    double start = perf_now();
+    calculate_similarity_matrix_parallel(X, Y, lenX, lenY, S, region);
+    double time_spent = perf_now() - start;
+    perf_region_add_work(region, 5.0 * cells, 8.0 * cells);
 
     // print_matrix(lenX, lenY, S);
-    traceback(S, X, Y, lenX, lenY);
+    // ./programme matrice.mat : S est enregistrée au format binaire de matrix_file.h
+    // (lisible par matrix_view), bien plus vite qu'avec print_matrix
+    if (matrix_name != NULL) {
+        matrix_file_options options = {0, 0, MATRIX_DELTA, 0};
+        if (!write_matrix_file(matrix_name, MATRIX_INT32, (const void* const*)S, lenX + 1, lenY + 1, &options)) {
+            printf("Erreur : Impossible d'écrire %s\n", matrix_name);
+        }
+    }
+    traceback(S, X, Y, lenX, lenY, gapped);
     printf("Temps d'exécution : %f secondes\n", time_spent);
+    perf_region_report(region, stdout);
+    perf_region_free(region);
     for (int i = 0; i <= lenX; i++) {
         free(S[i]);
     }
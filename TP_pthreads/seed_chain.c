@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "seed_chain.h"
+#include "edit_distance.h"
+
+#define CHAIN_LOOKBACK 64   // prédécesseurs examinés par ancre
+#define NEG_INF (INT_MIN / 2)
+
+// Provenance d'une cellule, pour la remontée
+#define FROM_DIAGONAL 0
+#define FROM_UP 1       // caractère de la lecture face à un gap
+#define FROM_LEFT 2     // caractère de la cible face à un gap
+#define FROM_START 3
+
+typedef struct {
+    uint32_t target;
+    int32_t tpos;
+    int32_t qpos;
+} anchor;
+
+struct mapping_workspace {
+    minimizer* minimizers;
+    int minimizers_capacity;
+    anchor* anchors;
+    long anchors_capacity;
+    int* chain_score;
+    int* chain_previous;
+    int* chain_length;
+    long chain_capacity;
+    int* rows;
+    int rows_capacity;
+    unsigned char* directions;  // (len + 1) lignes de dhi - dlo + 1 cases
+    long directions_capacity;
+    char* ops;
+    long ops_capacity;
+};
+
+static void* grow(void* p, long* capacity, long needed, size_t element) {
+    if (needed <= *capacity) return p;
+    long n = *capacity > 0 ? *capacity : 1024;
+    while (n < needed) n *= 2;
+    p = realloc(p, n * element);
+    if (p == NULL) {
+        fprintf(stderr, "Erreur : Impossible d'allouer la mémoire\n");
+        exit(1);
+    }
+    *capacity = n;
+    return p;
+}
+
+void default_mapping_options(mapping_options* options) {
+    options->max_occurrences = 200;
+    options->min_anchors = 3;
+    options->max_gap = 50;
+    options->band_margin = 32;
+    options->min_score_per_base = 0.3;
+    options->traceback = 0;
+}
+
+mapping_workspace* create_mapping_workspace(void) {
+    return (mapping_workspace*)calloc(1, sizeof(mapping_workspace));
+}
+
+void destroy_mapping_workspace(mapping_workspace* workspace) {
+    if (workspace == NULL) return;
+    free(workspace->minimizers);
+    free(workspace->anchors);
+    free(workspace->chain_score);
+    free(workspace->chain_previous);
+    free(workspace->chain_length);
+    free(workspace->rows);
+    free(workspace->directions);
+    free(workspace->ops);
+    free(workspace);
+}
+
+static int compare_anchors(const void* a, const void* b) {
+    const anchor* x = (const anchor*)a;
+    const anchor* y = (const anchor*)b;
+    if (x->target != y->target) return x->target < y->target ? -1 : 1;
+    if (x->tpos != y->tpos) return x->tpos < y->tpos ? -1 : 1;
+    return (x->qpos > y->qpos) - (x->qpos < y->qpos);
+}
+
+// Cœur de la programmation dynamique en bande ; directions (ou NULL) reçoit la provenance
+// de chaque cellule, la cellule (i, j) étant rangée en i * (dhi - dlo + 1) + j - i - dlo
+static int banded_alignment(const char* read, int len, const char* target, int target_len, int dlo, int dhi,
+                            int* end, long* cells, mapping_workspace* workspace, unsigned char* directions) {
+    int width = dhi - dlo + 1;
+    long capacity = workspace->rows_capacity;
+    workspace->rows = (int*)grow(workspace->rows, &capacity, 2 * (long)(target_len + 2), sizeof(int));
+    workspace->rows_capacity = (int)capacity;
+    int* prev = workspace->rows;
+    int* cur = workspace->rows + target_len + 2;
+
+    // Ligne 0 : début gratuit dans la cible ; les cases voisines de la bande valent -inf
+    int lo = dlo > 0 ? dlo : 0;
+    int hi = dhi < target_len ? dhi : target_len;
+    if (lo > hi) return NEG_INF;
+    for (int j = lo; j <= hi; j++) prev[j] = 0;
+    if (directions != NULL) for (int j = lo; j <= hi; j++) directions[j - dlo] = FROM_START;
+    if (lo > 0) prev[lo - 1] = NEG_INF;
+    if (hi < target_len) prev[hi + 1] = NEG_INF;
+    *cells += hi - lo + 1;
+
+    for (int i = 1; i <= len; i++) {
+        int row_lo = i + dlo > 0 ? i + dlo : 0;
+        int row_hi = i + dhi < target_len ? i + dhi : target_len;
+        if (row_lo > row_hi) return NEG_INF;
+        if (row_lo > 0) cur[row_lo - 1] = NEG_INF;
+        char r = read[i - 1];
+        if (directions == NULL) {
+            for (int j = row_lo; j <= row_hi; j++) {
+                int best = prev[j] + GAP_PENALTY;
+                if (j > 0) {
+                    int diag = prev[j - 1] + (r == target[j - 1] ? MATCH_SCORE : MISMATCH_SCORE);
+                    int left = cur[j - 1] + GAP_PENALTY;
+                    if (diag > best) best = diag;
+                    if (left > best) best = left;
+                }
+                cur[j] = best;
+            }
+        } else {
+            unsigned char* from = directions + (size_t)i * width - i - dlo;
+            for (int j = row_lo; j <= row_hi; j++) {
+                // Même ordre de préférence que traceback : diagonale, puis haut, puis gauche
+                int best = prev[j] + GAP_PENALTY;
+                unsigned char d = FROM_UP;
+                if (j > 0) {
+                    int diag = prev[j - 1] + (r == target[j - 1] ? MATCH_SCORE : MISMATCH_SCORE);
+                    int left = cur[j - 1] + GAP_PENALTY;
+                    if (left > best) {
+                        best = left;
+                        d = FROM_LEFT;
+                    }
+                    if (diag >= best) {
+                        best = diag;
+                        d = FROM_DIAGONAL;
+                    }
+                }
+                cur[j] = best;
+                from[j] = d;
+            }
+        }
+        if (row_hi < target_len) cur[row_hi + 1] = NEG_INF;
+        *cells += row_hi - row_lo + 1;
+        int* t = prev;
+        prev = cur;
+        cur = t;
+        lo = row_lo;
+        hi = row_hi;
+    }
+
+    int best = NEG_INF;
+    for (int j = lo; j <= hi; j++) {
+        if (prev[j] > best) {
+            best = prev[j];
+            *end = j;
+        }
+    }
+    return best;
+}
+
+int banded_alignment_score(const char* read, int len, const char* target, int target_len, int dlo, int dhi,
+                           int* end, long* cells, mapping_workspace* workspace) {
+    return banded_alignment(read, len, target, target_len, dlo, dhi, end, cells, workspace, NULL);
+}
+
+// Remontée depuis (len, end) jusqu'à la ligne 0 ; les opérations sont écrites depuis la fin
+// de ws->ops puis ramenées au début. Renvoie la colonne de départ dans la cible.
+static int banded_traceback(const char* read, int len, const char* target, int dlo, int dhi, int end,
+                            mapping_workspace* ws, int* ops_len) {
+    int width = dhi - dlo + 1;
+    ws->ops = (char*)grow(ws->ops, &ws->ops_capacity, (long)len + end + 1, sizeof(char));
+    long k = ws->ops_capacity;
+    int i = len, j = end;
+    while (i > 0) {
+        unsigned char d = ws->directions[(size_t)i * width + j - i - dlo];
+        if (d == FROM_DIAGONAL) {
+            ws->ops[--k] = read[i - 1] == target[j - 1] ? OP_MATCH : OP_MISMATCH;
+            i--;
+            j--;
+        } else if (d == FROM_UP) {
+            ws->ops[--k] = OP_INSERT;
+            i--;
+        } else {
+            ws->ops[--k] = OP_DELETE;
+            j--;
+        }
+    }
+    *ops_len = (int)(ws->ops_capacity - k);
+    memmove(ws->ops, ws->ops + k, *ops_len);
+    return j;
+}
+
+void map_read(const kmer_index* index, const char* read, int len, const mapping_options* options,
+              mapping_workspace* workspace, read_mapping* out) {
+    memset(out, 0, sizeof(*out));
+    out->target = -1;
+    mapping_workspace* ws = workspace;
+
+    // Ancres : occurrences dans l'index des minimiseurs de la lecture
+    long capacity = ws->minimizers_capacity;
+    ws->minimizers = (minimizer*)grow(ws->minimizers, &capacity, len > 0 ? len : 1, sizeof(minimizer));
+    ws->minimizers_capacity = (int)capacity;
+    int num_minimizers = compute_minimizers(read, len, index->k, index->w, ws->minimizers);
+    long num_anchors = 0;
+    for (int m = 0; m < num_minimizers; m++) {
+        const kmer_entry* first;
+        long count = lookup_kmer(index, ws->minimizers[m].hash, &first);
+        if (count == 0 || count > options->max_occurrences) continue;
+        ws->anchors = (anchor*)grow(ws->anchors, &ws->anchors_capacity, num_anchors + count, sizeof(anchor));
+        for (long e = 0; e < count; e++) {
+            anchor* a = &ws->anchors[num_anchors++];
+            a->target = first[e].target;
+            a->tpos = (int32_t)first[e].pos;
+            a->qpos = ws->minimizers[m].pos;
+        }
+    }
+    if (num_anchors < options->min_anchors) return;
+    qsort(ws->anchors, num_anchors, sizeof(anchor), compare_anchors);
+
+    // Chaînage : f[i] = meilleur score d'une chaîne finissant à l'ancre i ; le gain d'une
+    // ancre est borné par k et par les distances, l'écart de diagonale est pénalisé
+    long chain_capacity = ws->chain_capacity;
+    ws->chain_score = (int*)grow(ws->chain_score, &chain_capacity, num_anchors, sizeof(int));
+    chain_capacity = ws->chain_capacity;
+    ws->chain_previous = (int*)grow(ws->chain_previous, &chain_capacity, num_anchors, sizeof(int));
+    chain_capacity = ws->chain_capacity;
+    ws->chain_length = (int*)grow(ws->chain_length, &chain_capacity, num_anchors, sizeof(int));
+    ws->chain_capacity = chain_capacity;
+    int* f = ws->chain_score;
+    int* previous = ws->chain_previous;
+    int* length = ws->chain_length;
+    const anchor* a = ws->anchors;
+    int k = index->k;
+    long best_end = -1;
+    for (long i = 0; i < num_anchors; i++) {
+        f[i] = k;
+        previous[i] = -1;
+        length[i] = 1;
+        long stop = i - CHAIN_LOOKBACK > 0 ? i - CHAIN_LOOKBACK : 0;
+        for (long j = i - 1; j >= stop; j--) {
+            if (a[j].target != a[i].target) break;
+            int dt = a[i].tpos - a[j].tpos;
+            int dq = a[i].qpos - a[j].qpos;
+            if (dt > len + options->max_gap) break;
+            if (dq <= 0 || dt <= 0) continue;
+            int dd = dt > dq ? dt - dq : dq - dt;
+            if (dd > options->max_gap) continue;
+            int gain = dq < dt ? dq : dt;
+            if (gain > k) gain = k;
+            gain -= dd;
+            if (f[j] + gain > f[i]) {
+                f[i] = f[j] + gain;
+                previous[i] = (int)j;
+                length[i] = length[j] + 1;
+            }
+        }
+        if (best_end < 0 || f[i] > f[best_end]) best_end = i;
+    }
+    if (length[best_end] < options->min_anchors) return;
+
+    // Diagonales (tpos - qpos) couvertes par la chaîne
+    long first = best_end;
+    int dmin = a[best_end].tpos - a[best_end].qpos, dmax = dmin;
+    while (previous[first] >= 0) {
+        first = previous[first];
+        int d = a[first].tpos - a[first].qpos;
+        if (d < dmin) dmin = d;
+        if (d > dmax) dmax = d;
+    }
+
+    int target_len;
+    const char* target = index_target(index, a[best_end].target, &target_len);
+    int margin = options->band_margin + (dmax - dmin);
+    int window_start = dmin - margin > 0 ? dmin - margin : 0;
+    int window_end = dmax + len + margin < target_len ? dmax + len + margin : target_len;
+    int window_len = window_end - window_start;
+    int dlo = dmin - options->band_margin - window_start;
+    int dhi = dmax + options->band_margin - window_start;
+    out->full_window = dlo <= -len && dhi >= window_len;
+
+    int end = 0;
+    unsigned char* directions = NULL;
+    if (options->traceback) {
+        ws->directions = (unsigned char*)grow(ws->directions, &ws->directions_capacity,
+                                              (long)(len + 1) * (dhi - dlo + 1), sizeof(unsigned char));
+        directions = ws->directions;
+    }
+    out->score = banded_alignment(read, len, target + window_start, window_len, dlo, dhi, &end, &out->dp_cells,
+                                  ws, directions);
+    if (out->score < options->min_score_per_base * len) return;
+    out->target = (int)a[best_end].target;
+    out->target_start = a[first].tpos - a[first].qpos;
+    out->target_end = window_start + end;
+    out->anchors = length[best_end];
+    if (options->traceback) {
+        out->target_start = window_start +
+                            banded_traceback(read, len, target + window_start, dlo, dhi, end, ws, &out->ops_len);
+        out->ops = ws->ops;
+    }
+}
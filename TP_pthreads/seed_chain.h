@@ -0,0 +1,51 @@
+#ifndef SEED_CHAIN_H
+#define SEED_CHAIN_H
+
+#include "kmer_index.h"
+
+// Placement d'une lecture sur les cibles d'un index : minimiseurs de la lecture cherchés
+// dans l'index (ancres), chaînage des ancres colinéaires d'une même cible, puis alignement
+// semi-global (extrémités de la cible gratuites) restreint à une bande de diagonales
+// autour de la meilleure chaîne. Scores de calculate_similarity_matrix.
+
+#define MATCH_SCORE 1
+#define MISMATCH_SCORE -1
+#define GAP_PENALTY -2
+
+typedef struct {
+    int max_occurrences;    // minimiseurs plus fréquents ignorés (répétitions)
+    int min_anchors;        // une chaîne plus courte ne place pas la lecture
+    int max_gap;            // écart de diagonale maximal entre deux ancres chaînées
+    int band_margin;        // marge de la bande autour des diagonales de la chaîne
+    double min_score_per_base;  // en dessous, l'alignement est rejeté (lecture sans rapport)
+    int traceback;          // 1 : opérations de l'alignement dans read_mapping::ops
+} mapping_options;
+
+typedef struct {
+    int target;             // -1 : lecture non placée
+    int target_start;       // début de la lecture sur la cible (chaîne, ou remontée)
+    int target_end;         // fin de l'alignement sur la cible (exclue)
+    int score;
+    int anchors;            // ancres de la chaîne retenue
+    long dp_cells;          // cellules de programmation dynamique calculées
+    int full_window;        // 1 : la bande couvrait toute la fenêtre
+    const char* ops;        // avec traceback : cible = X, lecture = Y (OP_* de edit_distance.h),
+    int ops_len;            //   valable jusqu'au prochain map_read sur le même espace de travail
+} read_mapping;
+
+// Tampons réutilisés d'une lecture à l'autre : un par thread
+typedef struct mapping_workspace mapping_workspace;
+
+void default_mapping_options(mapping_options* options);
+mapping_workspace* create_mapping_workspace(void);
+void destroy_mapping_workspace(mapping_workspace* workspace);
+
+void map_read(const kmer_index* index, const char* read, int len, const mapping_options* options,
+              mapping_workspace* workspace, read_mapping* out);
+
+// Alignement semi-global de read sur target limité aux cellules (i, j) telles que
+// dlo <= j - i <= dhi ; *end reçoit la fin dans target, *cells est incrémenté
+int banded_alignment_score(const char* read, int len, const char* target, int target_len, int dlo, int dhi,
+                           int* end, long* cells, mapping_workspace* workspace);
+
+#endif